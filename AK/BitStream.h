@@ -26,11 +26,13 @@
 
 #pragma once
 
-#include <AK/Optional.h>
 #include <AK/Stream.h>
 
 namespace AK {
 
+// Reads bits least significant bit first, which is the order used by DEFLATE.
+// Bits are buffered in a word, but the buffer is only ever refilled one byte at a time and only when
+// the caller needs more bits, so nothing past the end of the bit stream is taken from the underlying stream.
 class InputBitStream final : public InputStream {
 public:
     explicit InputBitStream(InputStream& stream)
@@ -43,14 +45,13 @@ public:
         if (has_any_error())
             return 0;
 
-        size_t nread = 0;
-        if (bytes.size() >= 1) {
-            if (m_next_byte.has_value()) {
-                bytes[0] = m_next_byte.value();
-                m_next_byte.clear();
+        align_to_byte_boundary();
 
-                ++nread;
-            }
+        size_t nread = 0;
+        while (nread < bytes.size() && m_bit_count > 0) {
+            bytes[nread++] = static_cast<u8>(m_bit_buffer);
+            m_bit_buffer >>= 8;
+            m_bit_count -= 8;
         }
 
         return nread + m_stream.read(bytes.slice(nread));
@@ -66,15 +67,16 @@ public:
         return true;
     }
 
-    bool unreliable_eof() const override { return !m_next_byte.has_value() && m_stream.unreliable_eof(); }
+    bool unreliable_eof() const override { return m_bit_count == 0 && m_stream.unreliable_eof(); }
 
     bool discard_or_error(size_t count) override
     {
-        if (count >= 1) {
-            if (m_next_byte.has_value()) {
-                m_next_byte.clear();
-                --count;
-            }
+        align_to_byte_boundary();
+
+        while (count > 0 && m_bit_count > 0) {
+            m_bit_buffer >>= 8;
+            m_bit_count -= 8;
+            --count;
         }
 
         return m_stream.discard_or_error(count);
@@ -82,45 +84,136 @@ public:
 
     u32 read_bits(size_t count)
     {
-        u32 result = 0;
+        ASSERT(count <= 32);
 
-        size_t nread = 0;
-        while (nread < count) {
-            if (m_stream.has_any_error()) {
-                set_fatal_error();
+        while (m_bit_count < count) {
+            if (!refill_byte())
                 return 0;
-            }
-
-            if (m_next_byte.has_value()) {
-                const auto bit = (m_next_byte.value() >> m_bit_offset) & 1;
-                result |= bit << nread;
-                ++nread;
-
-                if (m_bit_offset++ == 7)
-                    m_next_byte.clear();
-            } else {
-                m_stream >> m_next_byte;
-                m_bit_offset = 0;
-            }
         }
 
+        const auto result = peek_bits(count);
+        discard_bits(count);
         return result;
     }
 
     bool read_bit() { return static_cast<bool>(read_bits(1)); }
 
-    void align_to_byte_boundary()
+    // Appends one more byte from the underlying stream to the bit buffer.
+    bool refill_byte()
     {
-        if (m_next_byte.has_value())
-            m_next_byte.clear();
+        ASSERT(m_bit_count + 8 <= 64);
+
+        u8 byte;
+        if (m_stream.has_any_error() || !m_stream.read_or_error({ &byte, sizeof(byte) })) {
+            set_fatal_error();
+            return false;
+        }
+
+        m_bit_buffer |= static_cast<u64>(byte) << m_bit_count;
+        m_bit_count += 8;
+        return true;
     }
 
+    size_t buffered_bit_count() const { return m_bit_count; }
+
+    // Returns the next count buffered bits without consuming them.
+    u32 peek_bits(size_t count) const
+    {
+        ASSERT(count <= 32 && count <= m_bit_count);
+        return static_cast<u32>(m_bit_buffer & ((static_cast<u64>(1) << count) - 1));
+    }
+
+    void discard_bits(size_t count)
+    {
+        ASSERT(count <= m_bit_count);
+        m_bit_buffer >>= count;
+        m_bit_count -= count;
+    }
+
+    void align_to_byte_boundary() { discard_bits(m_bit_count % 8); }
+
 private:
-    Optional<u8> m_next_byte;
-    size_t m_bit_offset { 0 };
+    u64 m_bit_buffer { 0 };
+    size_t m_bit_count { 0 };
     InputStream& m_stream;
 };
 
+// Writes bits least significant bit first, which is the order used by DEFLATE.
+class OutputBitStream final : public OutputStream {
+public:
+    explicit OutputBitStream(OutputStream& stream)
+        : m_stream(stream)
+    {
+    }
+
+    size_t write(ReadonlyBytes bytes) override
+    {
+        if (has_any_error())
+            return 0;
+
+        align_to_byte_boundary();
+        if (has_any_error())
+            return 0;
+
+        return m_stream.write(bytes);
+    }
+
+    bool write_or_error(ReadonlyBytes bytes) override
+    {
+        if (write(bytes) < bytes.size()) {
+            set_fatal_error();
+            return false;
+        }
+
+        return true;
+    }
+
+    void write_bits(u32 bits, size_t count)
+    {
+        ASSERT(count <= 32);
+        ASSERT(count == 32 || bits >> count == 0);
+
+        m_bit_buffer |= static_cast<u64>(bits) << m_bit_count;
+        m_bit_count += count;
+
+        if (m_bit_count >= 32) {
+            u8 bytes[4] = {
+                static_cast<u8>(m_bit_buffer),
+                static_cast<u8>(m_bit_buffer >> 8),
+                static_cast<u8>(m_bit_buffer >> 16),
+                static_cast<u8>(m_bit_buffer >> 24),
+            };
+            if (!m_stream.write_or_error({ bytes, sizeof(bytes) }))
+                set_fatal_error();
+            m_bit_buffer >>= 32;
+            m_bit_count -= 32;
+        }
+    }
+
+    void write_bit(bool bit) { write_bits(bit, 1); }
+
+    // Flushes any buffered bits, padding the last byte with zero bits if necessary.
+    void align_to_byte_boundary()
+    {
+        while (m_bit_count > 0) {
+            u8 byte = static_cast<u8>(m_bit_buffer);
+            if (!m_stream.write_or_error({ &byte, sizeof(byte) }))
+                set_fatal_error();
+            m_bit_buffer >>= 8;
+            m_bit_count = m_bit_count > 8 ? m_bit_count - 8 : 0;
+        }
+        m_bit_buffer = 0;
+    }
+
+    size_t bit_offset() const { return m_bit_count % 8; }
+
+private:
+    u64 m_bit_buffer { 0 };
+    size_t m_bit_count { 0 };
+    OutputStream& m_stream;
+};
+
 }
 
 using AK::InputBitStream;
+using AK::OutputBitStream;
@@ -31,8 +31,6 @@
 
 namespace AK {
 
-// FIXME: There are a lot of raw loops here, that's not necessary an issue but it
-//        has to be verified that the optimizer is able to insert memcpy instead.
 template<size_t Capacity>
 class CircularDuplexStream : public AK::DuplexStream {
 public:
@@ -40,9 +38,12 @@ public:
     {
         const auto nwritten = min(bytes.size(), Capacity - m_queue.size());
 
-        for (size_t idx = 0; idx < nwritten; ++idx)
-            m_queue.enqueue(bytes[idx]);
+        const auto write_index = m_total_written % Capacity;
+        const auto first_part = min(nwritten, Capacity - write_index);
+        __builtin_memcpy(m_queue.m_storage + write_index, bytes.data(), first_part);
+        __builtin_memcpy(m_queue.m_storage, bytes.data() + first_part, nwritten - first_part);
 
+        m_queue.m_size += nwritten;
         m_total_written += nwritten;
         return nwritten;
     }
@@ -66,9 +67,12 @@ public:
 
         const auto nread = min(bytes.size(), m_queue.size());
 
-        for (size_t idx = 0; idx < nread; ++idx)
-            bytes[idx] = m_queue.dequeue();
+        const auto first_part = min(nread, Capacity - m_queue.m_head);
+        __builtin_memcpy(bytes.data(), m_queue.m_storage + m_queue.m_head, first_part);
+        __builtin_memcpy(bytes.data() + first_part, m_queue.m_storage, nread - first_part);
 
+        m_queue.m_head = (m_queue.m_head + nread) % Capacity;
+        m_queue.m_size -= nread;
         return nread;
     }
 
@@ -89,6 +93,36 @@ public:
         return nread;
     }
 
+    // Appends count bytes that start distance bytes before the end of the stream. The source may overlap
+    // the bytes being written, in which case the pattern repeats, as LZ77 back-references require.
+    bool copy_from_seekback(size_t distance, size_t count)
+    {
+        if (distance == 0 || distance > Capacity || distance > m_total_written || count > remaining_space()) {
+            set_recoverable_error();
+            return false;
+        }
+
+        auto* storage = m_queue.m_storage;
+        auto write_index = m_total_written % Capacity;
+        auto read_index = (m_total_written - distance) % Capacity;
+
+        if (distance >= count && read_index + count <= Capacity && write_index + count <= Capacity) {
+            __builtin_memmove(storage + write_index, storage + read_index, count);
+        } else {
+            for (size_t idx = 0; idx < count; ++idx) {
+                storage[write_index] = storage[read_index];
+                if (++write_index == Capacity)
+                    write_index = 0;
+                if (++read_index == Capacity)
+                    read_index = 0;
+            }
+        }
+
+        m_queue.m_size += count;
+        m_total_written += count;
+        return true;
+    }
+
     bool read_or_error(Bytes bytes) override
     {
         if (m_queue.size() < bytes.size()) {
@@ -116,6 +150,8 @@ public:
     bool unreliable_eof() const override { return eof(); }
     bool eof() const { return m_queue.size() == 0; }
 
+    size_t remaining_space() const { return Capacity - m_queue.size(); }
+
     size_t remaining_contigous_space() const
     {
         return min(Capacity - m_queue.size(), m_queue.capacity() - (m_queue.head_index() + m_queue.size()) % Capacity);
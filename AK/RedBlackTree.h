@@ -0,0 +1,526 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Assertions.h>
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+
+namespace AK {
+
+// An ordered map with O(log n) insertion, removal and lookup, including lookups of the
+// nearest key on either side. This makes it suitable for keeping track of non-overlapping
+// intervals keyed by their start, like the regions of an address space.
+template<typename K, typename V>
+class RedBlackTree {
+private:
+    struct Node {
+        Node(K key, V&& value)
+            : key(key)
+            , value(move(value))
+        {
+        }
+
+        K key;
+        V value;
+        Node* parent { nullptr };
+        Node* left { nullptr };
+        Node* right { nullptr };
+        bool is_red { true };
+    };
+
+public:
+    RedBlackTree() = default;
+
+    RedBlackTree(const RedBlackTree& other)
+        : m_root(clone_subtree(other.m_root, nullptr))
+        , m_size(other.m_size)
+    {
+    }
+
+    RedBlackTree(RedBlackTree&& other)
+        : m_root(exchange(other.m_root, nullptr))
+        , m_size(exchange(other.m_size, 0))
+    {
+    }
+
+    ~RedBlackTree() { clear(); }
+
+    RedBlackTree& operator=(const RedBlackTree& other)
+    {
+        if (this != &other) {
+            RedBlackTree copy(other);
+            swap(*this, copy);
+        }
+        return *this;
+    }
+
+    RedBlackTree& operator=(RedBlackTree&& other)
+    {
+        if (this != &other) {
+            clear();
+            m_root = exchange(other.m_root, nullptr);
+            m_size = exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    friend void swap(RedBlackTree& a, RedBlackTree& b)
+    {
+        AK::swap(a.m_root, b.m_root);
+        AK::swap(a.m_size, b.m_size);
+    }
+
+    size_t size() const { return m_size; }
+    bool is_empty() const { return m_size == 0; }
+
+    void clear()
+    {
+        delete_subtree(m_root);
+        m_root = nullptr;
+        m_size = 0;
+    }
+
+    bool contains(K key) const { return find_node(key) != nullptr; }
+
+    V* find(K key)
+    {
+        auto* node = find_node(key);
+        return node ? &node->value : nullptr;
+    }
+    const V* find(K key) const { return const_cast<RedBlackTree*>(this)->find(key); }
+
+    // Returns the value with the largest key that is less than or equal to the given key.
+    V* find_largest_not_above(K key)
+    {
+        Node* candidate = nullptr;
+        for (auto* node = m_root; node;) {
+            if (node->key == key)
+                return &node->value;
+            if (node->key < key) {
+                candidate = node;
+                node = node->right;
+            } else {
+                node = node->left;
+            }
+        }
+        return candidate ? &candidate->value : nullptr;
+    }
+    const V* find_largest_not_above(K key) const { return const_cast<RedBlackTree*>(this)->find_largest_not_above(key); }
+
+    // Returns the value with the smallest key that is greater than or equal to the given key.
+    V* find_smallest_not_below(K key)
+    {
+        Node* candidate = nullptr;
+        for (auto* node = m_root; node;) {
+            if (node->key == key)
+                return &node->value;
+            if (key < node->key) {
+                candidate = node;
+                node = node->left;
+            } else {
+                node = node->right;
+            }
+        }
+        return candidate ? &candidate->value : nullptr;
+    }
+    const V* find_smallest_not_below(K key) const { return const_cast<RedBlackTree*>(this)->find_smallest_not_below(key); }
+
+    // Inserts a new entry. The key must not be in the tree already.
+    V& insert(K key, V&& value)
+    {
+        auto* node = new Node(key, move(value));
+
+        Node* parent = nullptr;
+        for (auto* current = m_root; current;) {
+            parent = current;
+            ASSERT(key != current->key);
+            current = key < current->key ? current->left : current->right;
+        }
+
+        node->parent = parent;
+        if (!parent)
+            m_root = node;
+        else if (key < parent->key)
+            parent->left = node;
+        else
+            parent->right = node;
+
+        ++m_size;
+        insert_fixup(node);
+        return node->value;
+    }
+
+    V& insert(K key, const V& value)
+    {
+        V copy = value;
+        return insert(key, move(copy));
+    }
+
+    Optional<V> take(K key)
+    {
+        auto* node = find_node(key);
+        if (!node)
+            return {};
+        V value = move(node->value);
+        remove_node(node);
+        return value;
+    }
+
+    bool remove(K key)
+    {
+        auto* node = find_node(key);
+        if (!node)
+            return false;
+        remove_node(node);
+        return true;
+    }
+
+    template<typename ElementType>
+    class IteratorBase {
+    public:
+        bool operator!=(const IteratorBase& other) const { return m_node != other.m_node; }
+        bool operator==(const IteratorBase& other) const { return m_node == other.m_node; }
+
+        IteratorBase& operator++()
+        {
+            m_node = successor(m_node);
+            return *this;
+        }
+
+        ElementType& operator*() { return m_node->value; }
+        ElementType* operator->() { return &m_node->value; }
+        K key() const { return m_node->key; }
+        bool is_end() const { return !m_node; }
+
+    private:
+        friend class RedBlackTree;
+        explicit IteratorBase(Node* node)
+            : m_node(node)
+        {
+        }
+
+        Node* m_node { nullptr };
+    };
+
+    using Iterator = IteratorBase<V>;
+    using ConstIterator = IteratorBase<const V>;
+
+    Iterator begin() { return Iterator(leftmost(m_root)); }
+    Iterator end() { return Iterator(nullptr); }
+    ConstIterator begin() const { return ConstIterator(leftmost(m_root)); }
+    ConstIterator end() const { return ConstIterator(nullptr); }
+
+    // Returns an iterator to the first entry with a key greater than or equal to the given key.
+    Iterator lower_bound(K key)
+    {
+        Node* candidate = nullptr;
+        for (auto* node = m_root; node;) {
+            if (key <= node->key) {
+                candidate = node;
+                node = node->left;
+            } else {
+                node = node->right;
+            }
+        }
+        return Iterator(candidate);
+    }
+
+    // Walks the whole tree and checks the red-black invariants: a black root, no red node with a
+    // red child, the same number of black nodes on every path down, and consistent parent links.
+    // This is for tests, as it's linear in the size of the tree.
+    bool has_valid_structure() const
+    {
+        if (is_red(m_root))
+            return false;
+        return black_height(m_root, nullptr) >= 0;
+    }
+
+private:
+    static ssize_t black_height(const Node* node, const Node* parent)
+    {
+        if (!node)
+            return 1;
+        if (node->parent != parent)
+            return -1;
+        if (node->is_red && (is_red(node->left) || is_red(node->right)))
+            return -1;
+        if ((node->left && !(node->left->key < node->key)) || (node->right && !(node->key < node->right->key)))
+            return -1;
+        auto left_height = black_height(node->left, node);
+        if (left_height < 0 || left_height != black_height(node->right, node))
+            return -1;
+        return left_height + (node->is_red ? 0 : 1);
+    }
+
+    static Node* leftmost(Node* node)
+    {
+        if (!node)
+            return nullptr;
+        while (node->left)
+            node = node->left;
+        return node;
+    }
+
+    static Node* successor(Node* node)
+    {
+        if (node->right)
+            return leftmost(node->right);
+        while (node->parent && node == node->parent->right)
+            node = node->parent;
+        return node->parent;
+    }
+
+    static Node* clone_subtree(const Node* node, Node* parent)
+    {
+        if (!node)
+            return nullptr;
+        V value = node->value;
+        auto* clone = new Node(node->key, move(value));
+        clone->parent = parent;
+        clone->is_red = node->is_red;
+        clone->left = clone_subtree(node->left, clone);
+        clone->right = clone_subtree(node->right, clone);
+        return clone;
+    }
+
+    static void delete_subtree(Node* node)
+    {
+        while (node) {
+            delete_subtree(node->right);
+            auto* left = node->left;
+            delete node;
+            node = left;
+        }
+    }
+
+    Node* find_node(K key) const
+    {
+        auto* node = m_root;
+        while (node && node->key != key)
+            node = key < node->key ? node->left : node->right;
+        return node;
+    }
+
+    static bool is_red(const Node* node) { return node && node->is_red; }
+
+    void rotate_left(Node* node)
+    {
+        auto* pivot = node->right;
+        node->right = pivot->left;
+        if (pivot->left)
+            pivot->left->parent = node;
+        pivot->parent = node->parent;
+        if (!node->parent)
+            m_root = pivot;
+        else if (node == node->parent->left)
+            node->parent->left = pivot;
+        else
+            node->parent->right = pivot;
+        pivot->left = node;
+        node->parent = pivot;
+    }
+
+    void rotate_right(Node* node)
+    {
+        auto* pivot = node->left;
+        node->left = pivot->right;
+        if (pivot->right)
+            pivot->right->parent = node;
+        pivot->parent = node->parent;
+        if (!node->parent)
+            m_root = pivot;
+        else if (node == node->parent->right)
+            node->parent->right = pivot;
+        else
+            node->parent->left = pivot;
+        pivot->right = node;
+        node->parent = pivot;
+    }
+
+    void insert_fixup(Node* node)
+    {
+        while (node != m_root && is_red(node->parent)) {
+            auto* parent = node->parent;
+            auto* grandparent = parent->parent;
+            if (parent == grandparent->left) {
+                auto* uncle = grandparent->right;
+                if (is_red(uncle)) {
+                    parent->is_red = false;
+                    uncle->is_red = false;
+                    grandparent->is_red = true;
+                    node = grandparent;
+                    continue;
+                }
+                if (node == parent->right) {
+                    node = parent;
+                    rotate_left(node);
+                    parent = node->parent;
+                }
+                parent->is_red = false;
+                grandparent->is_red = true;
+                rotate_right(grandparent);
+            } else {
+                auto* uncle = grandparent->left;
+                if (is_red(uncle)) {
+                    parent->is_red = false;
+                    uncle->is_red = false;
+                    grandparent->is_red = true;
+                    node = grandparent;
+                    continue;
+                }
+                if (node == parent->left) {
+                    node = parent;
+                    rotate_right(node);
+                    parent = node->parent;
+                }
+                parent->is_red = false;
+                grandparent->is_red = true;
+                rotate_left(grandparent);
+            }
+        }
+        m_root->is_red = false;
+    }
+
+    void transplant(Node* node, Node* replacement)
+    {
+        if (!node->parent)
+            m_root = replacement;
+        else if (node == node->parent->left)
+            node->parent->left = replacement;
+        else
+            node->parent->right = replacement;
+        if (replacement)
+            replacement->parent = node->parent;
+    }
+
+    void remove_node(Node* node)
+    {
+        // The child that takes the place of the removed node, which may be null,
+        // so we also have to keep track of its parent.
+        Node* child;
+        Node* child_parent;
+        bool removed_black = !node->is_red;
+
+        if (!node->left) {
+            child = node->right;
+            child_parent = node->parent;
+            transplant(node, node->right);
+        } else if (!node->right) {
+            child = node->left;
+            child_parent = node->parent;
+            transplant(node, node->left);
+        } else {
+            auto* next = leftmost(node->right);
+            removed_black = !next->is_red;
+            child = next->right;
+            if (next->parent == node) {
+                child_parent = next;
+            } else {
+                child_parent = next->parent;
+                transplant(next, next->right);
+                next->right = node->right;
+                next->right->parent = next;
+            }
+            transplant(node, next);
+            next->left = node->left;
+            next->left->parent = next;
+            next->is_red = node->is_red;
+        }
+
+        delete node;
+        --m_size;
+
+        if (removed_black)
+            remove_fixup(child, child_parent);
+    }
+
+    void remove_fixup(Node* node, Node* parent)
+    {
+        while (node != m_root && !is_red(node)) {
+            if (node == parent->left) {
+                auto* sibling = parent->right;
+                if (is_red(sibling)) {
+                    sibling->is_red = false;
+                    parent->is_red = true;
+                    rotate_left(parent);
+                    sibling = parent->right;
+                }
+                if (!is_red(sibling->left) && !is_red(sibling->right)) {
+                    sibling->is_red = true;
+                    node = parent;
+                    parent = node->parent;
+                    continue;
+                }
+                if (!is_red(sibling->right)) {
+                    sibling->left->is_red = false;
+                    sibling->is_red = true;
+                    rotate_right(sibling);
+                    sibling = parent->right;
+                }
+                sibling->is_red = parent->is_red;
+                parent->is_red = false;
+                sibling->right->is_red = false;
+                rotate_left(parent);
+            } else {
+                auto* sibling = parent->left;
+                if (is_red(sibling)) {
+                    sibling->is_red = false;
+                    parent->is_red = true;
+                    rotate_right(parent);
+                    sibling = parent->left;
+                }
+                if (!is_red(sibling->left) && !is_red(sibling->right)) {
+                    sibling->is_red = true;
+                    node = parent;
+                    parent = node->parent;
+                    continue;
+                }
+                if (!is_red(sibling->left)) {
+                    sibling->right->is_red = false;
+                    sibling->is_red = true;
+                    rotate_left(sibling);
+                    sibling = parent->left;
+                }
+                sibling->is_red = parent->is_red;
+                parent->is_red = false;
+                sibling->left->is_red = false;
+                rotate_right(parent);
+            }
+            node = m_root;
+        }
+        if (node)
+            node->is_red = false;
+    }
+
+    Node* m_root { nullptr };
+    size_t m_size { 0 };
+};
+
+}
+
+using AK::RedBlackTree;
@@ -82,4 +82,35 @@ TEST_CASE(overwritting_is_well_defined)
     EXPECT(stream.eof());
 }
 
+TEST_CASE(copy_from_seekback)
+{
+    constexpr size_t capacity = 16;
+
+    CircularDuplexStream<capacity> stream;
+
+    stream << static_cast<u8>(1) << static_cast<u8>(2) << static_cast<u8>(3);
+    Array<u8, 3> prefix;
+    stream >> prefix;
+
+    // Overlapping copies repeat the pattern.
+    EXPECT(stream.copy_from_seekback(2, 5));
+    Array<u8, 5> repeated;
+    stream >> repeated;
+    u8 expected_repeated[] = { 2, 3, 2, 3, 2 };
+    for (size_t idx = 0; idx < repeated.size(); ++idx)
+        EXPECT_EQ(repeated[idx], expected_repeated[idx]);
+
+    // Copies may wrap around the end of the buffer.
+    EXPECT(stream.copy_from_seekback(3, 10));
+    Array<u8, 10> wrapped;
+    stream >> wrapped;
+    u8 expected_wrapped[] = { 2, 3, 2, 2, 3, 2, 2, 3, 2, 2 };
+    for (size_t idx = 0; idx < wrapped.size(); ++idx)
+        EXPECT_EQ(wrapped[idx], expected_wrapped[idx]);
+
+    EXPECT(!stream.copy_from_seekback(capacity + 1, 1));
+    EXPECT(stream.handle_recoverable_error());
+    EXPECT(stream.eof());
+}
+
 TEST_MAIN(CircularDuplexStream)
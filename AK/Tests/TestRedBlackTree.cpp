@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/NonnullOwnPtr.h>
+#include <AK/RedBlackTree.h>
+#include <AK/String.h>
+
+TEST_CASE(construct)
+{
+    RedBlackTree<int, int> tree;
+    EXPECT(tree.is_empty());
+    EXPECT_EQ(tree.size(), 0u);
+    EXPECT(tree.begin() == tree.end());
+}
+
+TEST_CASE(insert_and_find)
+{
+    RedBlackTree<int, String> tree;
+    tree.insert(5, "five");
+    tree.insert(1, "one");
+    tree.insert(3, "three");
+
+    EXPECT_EQ(tree.size(), 3u);
+    EXPECT_EQ(*tree.find(1), "one");
+    EXPECT_EQ(*tree.find(3), "three");
+    EXPECT_EQ(*tree.find(5), "five");
+    EXPECT(!tree.find(2));
+}
+
+TEST_CASE(nearest_keys)
+{
+    RedBlackTree<int, int> tree;
+    for (int i = 10; i <= 100; i += 10)
+        tree.insert(i, i);
+
+    EXPECT_EQ(*tree.find_largest_not_above(35), 30);
+    EXPECT_EQ(*tree.find_largest_not_above(40), 40);
+    EXPECT_EQ(*tree.find_largest_not_above(1000), 100);
+    EXPECT(!tree.find_largest_not_above(9));
+
+    EXPECT_EQ(*tree.find_smallest_not_below(35), 40);
+    EXPECT_EQ(*tree.find_smallest_not_below(40), 40);
+    EXPECT_EQ(*tree.find_smallest_not_below(0), 10);
+    EXPECT(!tree.find_smallest_not_below(101));
+
+    EXPECT_EQ(tree.lower_bound(41).key(), 50);
+    EXPECT(tree.lower_bound(101).is_end());
+}
+
+TEST_CASE(iterates_in_order)
+{
+    RedBlackTree<int, int> tree;
+    for (int i = 0; i < 1000; ++i)
+        tree.insert((i * 7919) % 1000, i);
+
+    int expected_key = 0;
+    for (auto it = tree.begin(); it != tree.end(); ++it) {
+        EXPECT_EQ(it.key(), expected_key);
+        ++expected_key;
+    }
+    EXPECT_EQ(expected_key, 1000);
+    EXPECT(tree.has_valid_structure());
+}
+
+TEST_CASE(remove_and_take)
+{
+    RedBlackTree<int, NonnullOwnPtr<String>> tree;
+    for (int i = 0; i < 100; ++i)
+        tree.insert(i, make<String>(String::number(i)));
+
+    for (int i = 0; i < 100; i += 2)
+        EXPECT(tree.remove(i));
+    EXPECT(!tree.remove(0));
+    EXPECT_EQ(tree.size(), 50u);
+
+    auto taken = tree.take(51);
+    EXPECT(taken.has_value());
+    EXPECT_EQ(*taken.value(), "51");
+    EXPECT(!tree.find(51));
+    EXPECT_EQ(tree.size(), 49u);
+
+    int count = 0;
+    for (auto& value : tree) {
+        EXPECT(value->to_int().value() % 2 == 1);
+        ++count;
+    }
+    EXPECT_EQ(count, 49);
+    EXPECT(tree.has_valid_structure());
+}
+
+TEST_CASE(copy_and_move)
+{
+    RedBlackTree<int, int> tree;
+    for (int i = 0; i < 10; ++i)
+        tree.insert(i, i * i);
+
+    auto copy = tree;
+    EXPECT(copy.remove(3));
+    EXPECT_EQ(copy.size(), 9u);
+    EXPECT_EQ(tree.size(), 10u);
+    EXPECT_EQ(*tree.find(3), 9);
+
+    auto moved = move(tree);
+    EXPECT(tree.is_empty());
+    EXPECT_EQ(*moved.find(9), 81);
+}
+
+TEST_CASE(random_operations)
+{
+    // Mirror random insertions and removals in a flag array and check that
+    // the tree agrees with it, including its in-order traversal.
+    constexpr int key_count = 512;
+    bool present[key_count] {};
+    RedBlackTree<int, int> tree;
+    u32 state = 0xdeadbeef;
+
+    for (int step = 0; step < 20000; ++step) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        int key = state % key_count;
+        if (present[key]) {
+            EXPECT(tree.remove(key));
+            present[key] = false;
+        } else {
+            tree.insert(key, key);
+            present[key] = true;
+        }
+        if (step % 1000 == 0)
+            EXPECT(tree.has_valid_structure());
+    }
+    EXPECT(tree.has_valid_structure());
+
+    size_t expected_size = 0;
+    for (int key = 0; key < key_count; ++key) {
+        if (present[key])
+            ++expected_size;
+        EXPECT_EQ(tree.contains(key), present[key]);
+    }
+    EXPECT_EQ(tree.size(), expected_size);
+
+    int previous_key = -1;
+    for (auto it = tree.begin(); it != tree.end(); ++it) {
+        EXPECT(it.key() > previous_key);
+        previous_key = it.key();
+    }
+}
+
+TEST_MAIN(RedBlackTree)
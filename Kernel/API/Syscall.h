@@ -37,6 +37,8 @@ constexpr int syscall_vector = 0x82;
 
 extern "C" {
 struct pollfd;
+struct epoll_event;
+struct iovec;
 struct timeval;
 struct timespec;
 struct sockaddr;
@@ -191,7 +193,14 @@ namespace Kernel {
     S(set_coredump_metadata)  \
     S(abort)                  \
     S(anon_create)            \
-    S(msyscall)
+    S(msyscall)               \
+    S(epoll_create)           \
+    S(epoll_ctl)              \
+    S(epoll_wait)             \
+    S(readv)                  \
+    S(preadv)                 \
+    S(pwritev)                \
+    S(sendfile)
 
 namespace Syscall {
 
@@ -269,6 +278,20 @@ struct SC_select_params {
     const u32* sigmask;
 };
 
+struct SC_positional_io_params {
+    int fd;
+    const struct iovec* iov;
+    int iov_count;
+    ssize_t offset;
+};
+
+struct SC_sendfile_params {
+    int out_fd;
+    int in_fd;
+    ssize_t* offset;
+    size_t count;
+};
+
 struct SC_poll_params {
     struct pollfd* fds;
     unsigned nfds;
@@ -276,6 +299,21 @@ struct SC_poll_params {
     const u32* sigmask;
 };
 
+struct SC_epoll_ctl_params {
+    int epfd;
+    int op;
+    int fd;
+    const struct epoll_event* event;
+};
+
+struct SC_epoll_wait_params {
+    int epfd;
+    struct epoll_event* events;
+    int maxevents;
+    const struct timespec* timeout;
+    const u32* sigmask;
+};
+
 struct SC_clock_nanosleep_params {
     int clock_id;
     int flags;
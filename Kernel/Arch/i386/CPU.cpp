@@ -1055,6 +1055,7 @@ void Processor::early_initialize(u32 cpu)
     m_current_thread = nullptr;
     m_scheduler_data = nullptr;
     m_mm_data = nullptr;
+    m_kmalloc_data = nullptr;
     m_info = nullptr;
 
     m_halt_requested = false;
@@ -1786,6 +1787,20 @@ u32 Processor::smp_wake_n_idle_processors(u32 wake_count)
     return did_wake_count;
 }
 
+bool Processor::smp_wake_idle_processor(u32 cpu)
+{
+    ASSERT(Processor::current().in_critical());
+    if (!s_smp_enabled || cpu == Processor::current().id())
+        return false;
+
+    // Flip it to busy first, so only one of us sends it an IPI.
+    u32 cpu_mask = 1u << cpu;
+    if (!(s_idle_cpu_mask.fetch_and(~cpu_mask, AK::MemoryOrder::memory_order_acq_rel) & cpu_mask))
+        return false;
+    APIC::the().send_ipi(cpu);
+    return true;
+}
+
 void Processor::smp_enable()
 {
     size_t msg_pool_size = Processor::count() * 100u;
@@ -640,6 +640,7 @@ static_assert(GDT_SELECTOR_CODE0 + 24 == GDT_SELECTOR_DATA3); // SS3 = CS0 + 32
 
 class ProcessorInfo;
 class SchedulerPerProcessorData;
+struct KmallocPerProcessorData;
 struct MemoryManagerData;
 struct ProcessorMessageEntry;
 
@@ -720,6 +721,7 @@ class Processor {
     ProcessorInfo* m_info;
     MemoryManagerData* m_mm_data;
     SchedulerPerProcessorData* m_scheduler_data;
+    KmallocPerProcessorData* m_kmalloc_data;
     Thread* m_current_thread;
     Thread* m_idle_thread;
 
@@ -774,6 +776,11 @@ public:
         s_idle_cpu_mask.fetch_and(~(1u << m_cpu), AK::MemoryOrder::memory_order_relaxed);
     }
 
+    static u32 idle_processor_mask()
+    {
+        return s_idle_cpu_mask.load(AK::MemoryOrder::memory_order_relaxed);
+    }
+
     static u32 count()
     {
         // NOTE: because this value never changes once all APs are booted,
@@ -851,6 +858,16 @@ public:
         return *m_mm_data;
     }
 
+    ALWAYS_INLINE void set_kmalloc_data(KmallocPerProcessorData& kmalloc_data)
+    {
+        m_kmalloc_data = &kmalloc_data;
+    }
+
+    ALWAYS_INLINE KmallocPerProcessorData* get_kmalloc_data() const
+    {
+        return m_kmalloc_data;
+    }
+
     ALWAYS_INLINE Thread* idle_thread() const
     {
         return m_idle_thread;
@@ -1022,6 +1039,7 @@ public:
     static void smp_unicast(u32 cpu, void (*callback)(void*), void* data, void (*free_data)(void*), bool async);
     static void smp_broadcast_flush_tlb(const PageDirectory*, VirtualAddress, size_t);
     static u32 smp_wake_n_idle_processors(u32 wake_count);
+    static bool smp_wake_idle_processor(u32 cpu);
 
     template<typename Callback>
     static void deferred_call_queue(Callback callback)
@@ -25,110 +25,241 @@
  */
 
 #include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/QuickSort.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/KBuffer.h>
 #include <Kernel/Process.h>
+#include <Kernel/VM/MemoryManager.h>
 
 namespace Kernel {
 
 struct CacheEntry {
+    enum class Queue : u8 {
+        Free,
+        Probation,
+        Protected,
+        Dirty,
+    };
+
     IntrusiveListNode list_node;
     u32 block_index { 0 };
     u8* data { nullptr };
     bool has_data { false };
+    bool is_hot { false };
+    bool was_referenced { false };
+    Queue queue { Queue::Free };
+};
+
+struct DiskCacheSegment {
+    NonnullOwnPtr<KBuffer> cached_block_data;
+    NonnullOwnPtr<KBuffer> entries;
+
+    CacheEntry* entry_array() { return (CacheEntry*)entries->data(); }
 };
 
+// The disk cache is a simplified 2Q cache. A block that is brought into the cache
+// starts out in the probationary queue, and is only promoted to the protected queue
+// once it's used again. Eviction prefers the probationary queue as long as it holds
+// more than its share of the cache, so a one-pass scan (e.g. `find /`) churns through
+// the probationary queue without pushing frequently used metadata blocks out.
+//
+// The cache is made up of fixed-size segments. It grows by one segment at a time while
+// the protected working set fills the cache and there's plenty of free physical memory,
+// and gives segments back when the system starts running low on memory.
 class DiskCache {
 public:
+    static constexpr size_t entries_per_segment = 1024;
+    static constexpr size_t max_segment_count = 32;
+    static constexpr size_t write_back_batch_size = 32;
+
     explicit DiskCache(BlockBasedFS& fs)
         : m_fs(fs)
-        , m_cached_block_data(KBuffer::create_with_size(m_entry_count * m_fs.block_size()))
-        , m_entries(KBuffer::create_with_size(m_entry_count * sizeof(CacheEntry)))
     {
-        for (size_t i = 0; i < m_entry_count; ++i) {
-            entries()[i].data = m_cached_block_data.data() + i * m_fs.block_size();
-            m_clean_list.append(entries()[i]);
-        }
+        bool did_grow = try_grow();
+        ASSERT(did_grow);
     }
 
-    ~DiskCache() { }
+    ~DiskCache()
+    {
+        for (auto& entry_list : m_queues)
+            entry_list.clear();
+    }
 
-    bool is_dirty() const { return m_dirty; }
-    void set_dirty(bool b) { m_dirty = b; }
+    bool is_dirty() const { return queue_size(CacheEntry::Queue::Dirty) != 0; }
 
     void mark_all_clean()
     {
-        while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
-        m_dirty = false;
+        while (auto* entry = queue(CacheEntry::Queue::Dirty).first())
+            mark_clean(*entry);
     }
 
     void mark_dirty(CacheEntry& entry)
     {
-        m_dirty_list.prepend(entry);
-        m_dirty = true;
+        enqueue(entry, CacheEntry::Queue::Dirty);
     }
 
     void mark_clean(CacheEntry& entry)
     {
-        m_clean_list.prepend(entry);
+        enqueue(entry, entry.is_hot ? CacheEntry::Queue::Protected : CacheEntry::Queue::Probation);
     }
 
-    CacheEntry& get(u32 block_index) const
+    CacheEntry* oldest_dirty_entry() { return queue(CacheEntry::Queue::Dirty).last(); }
+
+    bool has_data_for(u32 block_index) const
+    {
+        auto it = m_hash.find(block_index);
+        return it != m_hash.end() && it->value->has_data;
+    }
+
+    // Blocks fetched by read-ahead are not considered referenced until someone actually asks for them.
+    CacheEntry& get(u32 block_index, bool is_prefetch = false)
     {
         if (auto it = m_hash.find(block_index); it != m_hash.end()) {
-            auto& entry = const_cast<CacheEntry&>(*it->value);
+            auto& entry = *it->value;
             ASSERT(entry.block_index == block_index);
+            if (!is_prefetch)
+                touch(entry);
             return entry;
         }
 
-        if (m_clean_list.is_empty()) {
-            // Not a single clean entry! Flush writes and try again.
-            // NOTE: We want to make sure we only call FileBackedFS flush here,
-            //       not some FileBackedFS subclass flush!
-            m_fs.flush_writes_impl();
-            return get(block_index);
-        }
-
-        ASSERT(m_clean_list.last());
-        auto& new_entry = *m_clean_list.last();
-        m_clean_list.prepend(new_entry);
-
-        m_hash.remove(new_entry.block_index);
-        m_hash.set(block_index, &new_entry);
+        if (is_under_memory_pressure() && m_segments.size() > 1)
+            release_last_segment();
 
+        auto& new_entry = take_entry_for_reuse();
         new_entry.block_index = block_index;
         new_entry.has_data = false;
+        new_entry.is_hot = false;
+        new_entry.was_referenced = !is_prefetch;
+        enqueue(new_entry, CacheEntry::Queue::Probation);
+        m_hash.set(block_index, &new_entry);
 
         return new_entry;
     }
 
-    const CacheEntry* entries() const { return (const CacheEntry*)m_entries.data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries.data(); }
-
     template<typename Callback>
-    void for_each_clean_entry(Callback callback)
+    void for_each_dirty_entry(Callback callback)
     {
-        for (auto& entry : m_clean_list)
+        for (auto& entry : queue(CacheEntry::Queue::Dirty))
             callback(entry);
     }
 
-    template<typename Callback>
-    void for_each_dirty_entry(Callback callback)
+private:
+    using EntryList = IntrusiveList<CacheEntry, &CacheEntry::list_node>;
+
+    EntryList& queue(CacheEntry::Queue queue) { return m_queues[static_cast<size_t>(queue)]; }
+    size_t queue_size(CacheEntry::Queue queue) const { return m_queue_sizes[static_cast<size_t>(queue)]; }
+    size_t capacity() const { return m_segments.size() * entries_per_segment; }
+    size_t probation_target() const { return capacity() / 4; }
+
+    void enqueue(CacheEntry& entry, CacheEntry::Queue new_queue)
     {
-        for (auto& entry : m_dirty_list)
-            callback(entry);
+        --m_queue_sizes[static_cast<size_t>(entry.queue)];
+        queue(new_queue).prepend(entry);
+        entry.queue = new_queue;
+        ++m_queue_sizes[static_cast<size_t>(new_queue)];
+    }
+
+    void touch(CacheEntry& entry)
+    {
+        if (!entry.was_referenced) {
+            entry.was_referenced = true;
+            return;
+        }
+        entry.is_hot = true;
+        if (entry.queue != CacheEntry::Queue::Dirty)
+            enqueue(entry, CacheEntry::Queue::Protected);
+    }
+
+    CacheEntry* pick_victim()
+    {
+        auto& probation_queue = queue(CacheEntry::Queue::Probation);
+        auto& protected_queue = queue(CacheEntry::Queue::Protected);
+        if (!probation_queue.is_empty() && (queue_size(CacheEntry::Queue::Probation) >= probation_target() || protected_queue.is_empty()))
+            return probation_queue.last();
+        return protected_queue.last();
+    }
+
+    CacheEntry& take_entry_for_reuse()
+    {
+        if (auto* entry = queue(CacheEntry::Queue::Free).first())
+            return *entry;
+
+        if (should_grow() && try_grow())
+            return *queue(CacheEntry::Queue::Free).first();
+
+        auto* victim = pick_victim();
+        if (!victim) {
+            // Not a single clean entry! Write back the oldest dirty entries and try again.
+            // We only write back a small batch so that the caller doesn't have to wait for
+            // the entire cache to hit the disk.
+            m_fs.flush_oldest_writes(write_back_batch_size);
+            victim = pick_victim();
+            ASSERT(victim);
+        }
+
+        m_hash.remove(victim->block_index);
+        return *victim;
+    }
+
+    static bool is_under_memory_pressure()
+    {
+        return MM.user_physical_pages_uncommitted() < MM.user_physical_pages() / 16;
+    }
+
+    bool should_grow() const
+    {
+        if (m_segments.size() >= max_segment_count)
+            return false;
+        // Only grow if blocks are actually being reused; a scan has no use for a larger cache.
+        if (queue_size(CacheEntry::Queue::Protected) + queue_size(CacheEntry::Queue::Dirty) < capacity() / 2)
+            return false;
+        size_t segment_pages = PAGE_ROUND_UP(entries_per_segment * m_fs.block_size()) / PAGE_SIZE;
+        return MM.user_physical_pages_uncommitted() > segment_pages + MM.user_physical_pages() / 4;
+    }
+
+    bool try_grow()
+    {
+        auto cached_block_data = KBuffer::try_create_with_size(entries_per_segment * m_fs.block_size(), Region::Access::Read | Region::Access::Write, "DiskCache");
+        if (!cached_block_data)
+            return false;
+        auto entries = KBuffer::try_create_with_size(entries_per_segment * sizeof(CacheEntry), Region::Access::Read | Region::Access::Write, "DiskCache entries");
+        if (!entries)
+            return false;
+
+        auto segment = make<DiskCacheSegment>(cached_block_data.release_nonnull(), entries.release_nonnull());
+        for (size_t i = 0; i < entries_per_segment; ++i) {
+            auto* entry = new (&segment->entry_array()[i]) CacheEntry;
+            entry->data = segment->cached_block_data->data() + i * m_fs.block_size();
+            queue(CacheEntry::Queue::Free).append(*entry);
+        }
+        m_queue_sizes[static_cast<size_t>(CacheEntry::Queue::Free)] += entries_per_segment;
+        m_segments.append(move(segment));
+        dbgln<BBFS_DEBUG>("DiskCache: Grew to {} entries", capacity());
+        return true;
+    }
+
+    void release_last_segment()
+    {
+        auto segment = m_segments.take_last();
+        for (size_t i = 0; i < entries_per_segment; ++i) {
+            auto& entry = segment->entry_array()[i];
+            if (entry.queue == CacheEntry::Queue::Dirty)
+                m_fs.flush_cache_entry(entry);
+            if (entry.queue != CacheEntry::Queue::Free)
+                m_hash.remove(entry.block_index);
+            --m_queue_sizes[static_cast<size_t>(entry.queue)];
+            entry.~CacheEntry();
+        }
+        dbgln<BBFS_DEBUG>("DiskCache: Shrunk to {} entries", capacity());
     }
 
-private:
     BlockBasedFS& m_fs;
-    size_t m_entry_count { 10000 };
-    mutable HashMap<u32, CacheEntry*> m_hash;
-    mutable IntrusiveList<CacheEntry, &CacheEntry::list_node> m_clean_list;
-    mutable IntrusiveList<CacheEntry, &CacheEntry::list_node> m_dirty_list;
-    KBuffer m_cached_block_data;
-    KBuffer m_entries;
-    bool m_dirty { false };
+    HashMap<u32, CacheEntry*> m_hash;
+    EntryList m_queues[4];
+    size_t m_queue_sizes[4] {};
+    NonnullOwnPtrVector<DiskCacheSegment> m_segments;
 };
 
 BlockBasedFS::BlockBasedFS(FileDescription& file_description)
@@ -160,13 +291,14 @@ KResult BlockBasedFS::write_block(unsigned index, const UserOrKernelBuffer& data
         return KSuccess;
     }
 
-    auto& entry = cache().get(index);
     if (count < block_size()) {
-        // Fill the cache first.
+        // Fill the cache first. This may read ahead and evict other entries,
+        // so only look up our entry once it's done.
         auto result = read_block(index, nullptr, block_size());
         if (result.is_error())
             return result;
     }
+    auto& entry = cache().get(index);
     if (!data.read(entry.data + offset, count))
         return EFAULT;
 
@@ -237,6 +369,15 @@ KResult BlockBasedFS::read_block(unsigned index, UserOrKernelBuffer* buffer, siz
     klog() << "BlockBasedFileSystem::read_block " << index;
 #endif
 
+    if (allow_cache)
+        prefetch_for_read(index, 1);
+    return read_block_impl(index, buffer, count, offset, allow_cache);
+}
+
+// Like read_block(), but leaves the read-ahead state alone. Callers are expected to have
+// done their own prefetch_for_read() for the whole request.
+KResult BlockBasedFS::read_block_impl(unsigned index, UserOrKernelBuffer* buffer, size_t count, size_t offset, bool allow_cache) const
+{
     if (!allow_cache) {
         const_cast<BlockBasedFS*>(this)->flush_specific_block_if_needed(index);
         u32 base_offset = static_cast<u32>(index) * static_cast<u32>(block_size()) + static_cast<u32>(offset);
@@ -271,9 +412,11 @@ KResult BlockBasedFS::read_blocks(unsigned index, unsigned count, UserOrKernelBu
         return EINVAL;
     if (count == 1)
         return read_block(index, &buffer, block_size(), 0, allow_cache);
+    if (allow_cache)
+        prefetch_for_read(index, count);
     auto out = buffer;
     for (unsigned i = 0; i < count; ++i) {
-        auto result = read_block(index + i, &out, block_size(), 0, allow_cache);
+        auto result = read_block_impl(index + i, &out, block_size(), 0, allow_cache);
         if (result.is_error())
             return result;
         out = out.offset(block_size());
@@ -282,6 +425,147 @@ KResult BlockBasedFS::read_blocks(unsigned index, unsigned count, UserOrKernelBu
     return KSuccess;
 }
 
+KResult BlockBasedFS::read_cluster(unsigned index, unsigned count, UserOrKernelBuffer& buffer) const
+{
+    // NOTE: The underlying device may complete the request in several smaller pieces.
+    u32 base_offset = static_cast<u32>(index) * static_cast<u32>(block_size());
+    size_t total_size = count * block_size();
+    size_t nread_total = 0;
+    while (nread_total < total_size) {
+        file_description().seek(base_offset + nread_total, SEEK_SET);
+        auto out = buffer.offset(nread_total);
+        auto nread = file_description().read(out, total_size - nread_total);
+        if (nread.is_error())
+            return nread.error();
+        if (nread.value() == 0)
+            return EIO;
+        nread_total += nread.value();
+    }
+    return KSuccess;
+}
+
+KResult BlockBasedFS::write_cluster(unsigned index, unsigned count, const UserOrKernelBuffer& buffer)
+{
+    u32 base_offset = static_cast<u32>(index) * static_cast<u32>(block_size());
+    size_t total_size = count * block_size();
+    size_t nwritten_total = 0;
+    while (nwritten_total < total_size) {
+        file_description().seek(base_offset + nwritten_total, SEEK_SET);
+        auto nwritten = file_description().write(buffer.offset(nwritten_total), total_size - nwritten_total);
+        if (nwritten.is_error())
+            return nwritten.error();
+        if (nwritten.value() == 0)
+            return EIO;
+        nwritten_total += nwritten.value();
+    }
+    return KSuccess;
+}
+
+unsigned BlockBasedFS::max_cluster_block_count() const
+{
+    return max(max_cluster_size / block_size(), (size_t)1);
+}
+
+void BlockBasedFS::prefetch_for_read(unsigned index, unsigned count) const
+{
+    LOCKER(m_lock);
+
+    // Keep track of where the previous read ended, so we can tell when a caller is reading
+    // its way through consecutive blocks and grow the read-ahead window accordingly.
+    bool is_sequential = index == m_next_sequential_block;
+    m_next_sequential_block = index + count;
+    if (!is_sequential)
+        m_readahead_block_count = 0;
+
+    if (cache().has_data_for(index))
+        return;
+
+    if (is_sequential) {
+        m_readahead_block_count = min(max(m_readahead_block_count * 2, min_readahead_block_count), max_cluster_block_count());
+        dbgln<BBFS_DEBUG>("BlockBasedFS: Sequential read of {} x{}, read-ahead window is now {} blocks", index, count, m_readahead_block_count);
+    }
+
+    if (count + m_readahead_block_count <= 1)
+        return;
+
+    prefetch_blocks(index, count + m_readahead_block_count);
+}
+
+void BlockBasedFS::prefetch_blocks(unsigned index, unsigned count) const
+{
+    if (!m_read_cluster_buffer)
+        m_read_cluster_buffer = KBuffer::try_create_with_size(max_cluster_size, Region::Access::Read | Region::Access::Write, "BlockBasedFS read cluster");
+    if (!m_read_cluster_buffer)
+        return;
+
+    unsigned end = index + count;
+    for (unsigned block = index; block < end;) {
+        if (cache().has_data_for(block)) {
+            ++block;
+            continue;
+        }
+
+        unsigned run_start = block;
+        while (block < end && block - run_start < max_cluster_block_count() && !cache().has_data_for(block))
+            ++block;
+        unsigned run_length = block - run_start;
+
+        auto cluster_buffer = UserOrKernelBuffer::for_kernel_buffer(m_read_cluster_buffer->data());
+        // Prefetching is opportunistic, so we simply stop here and let read_block() surface any errors.
+        if (read_cluster(run_start, run_length, cluster_buffer).is_error())
+            return;
+
+        for (unsigned i = 0; i < run_length; ++i) {
+            auto& entry = cache().get(run_start + i, true);
+            if (entry.has_data)
+                continue;
+            memcpy(entry.data, m_read_cluster_buffer->data() + i * block_size(), block_size());
+            entry.has_data = true;
+        }
+    }
+
+#if BBFS_DEBUG
+    klog() << "BlockBasedFileSystem::prefetch_blocks " << index << " x" << count;
+#endif
+}
+
+void BlockBasedFS::flush_cache_entry(CacheEntry& entry)
+{
+    u32 base_offset = static_cast<u32>(entry.block_index) * static_cast<u32>(block_size());
+    file_description().seek(base_offset, SEEK_SET);
+    // FIXME: Should this error path be surfaced somehow?
+    auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+    [[maybe_unused]] auto rc = file_description().write(entry_data_buffer, block_size());
+}
+
+void BlockBasedFS::flush_cache_entries(Vector<CacheEntry*, 32>& entries)
+{
+    if (!m_write_cluster_buffer)
+        m_write_cluster_buffer = KBuffer::try_create_with_size(max_cluster_size, Region::Access::Read | Region::Access::Write, "BlockBasedFS write cluster");
+
+    // Write back runs of adjacent blocks with a single request each.
+    quick_sort(entries, [](auto* a, auto* b) { return a->block_index < b->block_index; });
+    for (size_t i = 0; i < entries.size();) {
+        size_t run_length = 1;
+        if (m_write_cluster_buffer) {
+            while (i + run_length < entries.size()
+                && run_length < max_cluster_block_count()
+                && entries[i + run_length]->block_index == entries[i]->block_index + run_length)
+                ++run_length;
+        }
+
+        if (run_length == 1) {
+            flush_cache_entry(*entries[i]);
+        } else {
+            for (size_t j = 0; j < run_length; ++j)
+                memcpy(m_write_cluster_buffer->data() + j * block_size(), entries[i + j]->data, block_size());
+            // FIXME: Should this error path be surfaced somehow?
+            [[maybe_unused]] auto rc = write_cluster(entries[i]->block_index, run_length, UserOrKernelBuffer::for_kernel_buffer(m_write_cluster_buffer->data()));
+        }
+        i += run_length;
+    }
+}
+
 void BlockBasedFS::flush_specific_block_if_needed(unsigned index)
 {
     LOCKER(m_lock);
@@ -289,37 +573,42 @@ void BlockBasedFS::flush_specific_block_if_needed(unsigned index)
         return;
     Vector<CacheEntry*, 32> cleaned_entries;
     cache().for_each_dirty_entry([&](CacheEntry& entry) {
-        if (entry.block_index != index) {
-            u32 base_offset = static_cast<u32>(entry.block_index) * static_cast<u32>(block_size());
-            file_description().seek(base_offset, SEEK_SET);
-            // FIXME: Should this error path be surfaced somehow?
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(entry_data_buffer, block_size());
+        if (entry.block_index != index)
             cleaned_entries.append(&entry);
-        }
     });
+    flush_cache_entries(cleaned_entries);
     // NOTE: We make a separate pass to mark entries clean since marking them clean
     //       moves them out of the dirty list which would disturb the iteration above.
     for (auto* entry : cleaned_entries)
         cache().mark_clean(*entry);
 }
 
+void BlockBasedFS::flush_oldest_writes(size_t max_count)
+{
+    LOCKER(m_lock);
+    Vector<CacheEntry*, 32> cleaned_entries;
+    while (cleaned_entries.size() < max_count) {
+        auto* entry = cache().oldest_dirty_entry();
+        if (!entry)
+            break;
+        cache().mark_clean(*entry);
+        cleaned_entries.append(entry);
+    }
+    flush_cache_entries(cleaned_entries);
+}
+
 void BlockBasedFS::flush_writes_impl()
 {
     LOCKER(m_lock);
     if (!cache().is_dirty())
         return;
-    u32 count = 0;
+    Vector<CacheEntry*, 32> dirty_entries;
     cache().for_each_dirty_entry([&](CacheEntry& entry) {
-        u32 base_offset = static_cast<u32>(entry.block_index) * static_cast<u32>(block_size());
-        file_description().seek(base_offset, SEEK_SET);
-        // FIXME: Should this error path be surfaced somehow?
-        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-        [[maybe_unused]] auto rc = file_description().write(entry_data_buffer, block_size());
-        ++count;
+        dirty_entries.append(&entry);
     });
+    flush_cache_entries(dirty_entries);
     cache().mark_all_clean();
-    dbgln("{}: Flushed {} blocks to disk", class_name(), count);
+    dbgln("{}: Flushed {} blocks to disk", class_name(), dirty_entries.size());
 }
 
 void BlockBasedFS::flush_writes()
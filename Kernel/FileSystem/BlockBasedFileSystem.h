@@ -30,7 +30,11 @@
 
 namespace Kernel {
 
+struct CacheEntry;
+
 class BlockBasedFS : public FileBackedFS {
+    friend class DiskCache;
+
 public:
     virtual ~BlockBasedFS() override;
 
@@ -57,10 +61,28 @@ protected:
     size_t m_logical_block_size { 512 };
 
 private:
+    static constexpr size_t max_cluster_size = 64 * KiB;
+    static constexpr unsigned min_readahead_block_count = 4;
+
     DiskCache& cache() const;
+    unsigned max_cluster_block_count() const;
+
+    KResult read_block_impl(unsigned index, UserOrKernelBuffer* buffer, size_t count, size_t offset, bool allow_cache) const;
+    KResult read_cluster(unsigned index, unsigned count, UserOrKernelBuffer&) const;
+    KResult write_cluster(unsigned index, unsigned count, const UserOrKernelBuffer&);
+    void prefetch_for_read(unsigned index, unsigned count) const;
+    void prefetch_blocks(unsigned index, unsigned count) const;
+
+    void flush_cache_entry(CacheEntry&);
+    void flush_cache_entries(Vector<CacheEntry*, 32>&);
     void flush_specific_block_if_needed(unsigned index);
+    void flush_oldest_writes(size_t max_count);
 
     mutable OwnPtr<DiskCache> m_cache;
+    mutable OwnPtr<KBuffer> m_read_cluster_buffer;
+    OwnPtr<KBuffer> m_write_cluster_buffer;
+    mutable unsigned m_next_sequential_block { 0 };
+    mutable unsigned m_readahead_block_count { 0 };
 };
 
 }
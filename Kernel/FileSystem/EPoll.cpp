@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <Kernel/FileSystem/EPoll.h>
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+NonnullRefPtr<EPoll> EPoll::create()
+{
+    return adopt(*new EPoll);
+}
+
+EPoll::EPoll()
+{
+}
+
+EPoll::~EPoll()
+{
+    // Watches unlink themselves from the ready list, so they have to go before it does.
+    m_watches.clear();
+}
+
+bool EPoll::can_read(const FileDescription&, size_t) const
+{
+    ScopedSpinLock lock(m_ready_lock);
+    return !m_ready_watches.is_empty();
+}
+
+EPoll::Watch::Watch(EPoll& epoll, int fd, FileDescription& description, const epoll_event& event)
+    : m_epoll(epoll)
+    , m_fd(fd)
+    , m_description(description.make_weak_ptr())
+    , m_file(description.file())
+{
+    update(event);
+    set_block_condition(m_file->block_condition());
+}
+
+EPoll::Watch::~Watch()
+{
+    // Make sure no readiness notification can race with us before unlinking from the ready list.
+    m_file->block_condition().remove_blocker(*this, nullptr);
+    ScopedSpinLock lock(m_epoll.m_ready_lock);
+    if (m_ready_list_node.is_in_list())
+        m_epoll.m_ready_watches.remove(*this);
+}
+
+void EPoll::Watch::update(const epoll_event& event)
+{
+    ScopedSpinLock lock(m_epoll.m_ready_lock);
+    m_events = event.events;
+    m_data = event.data;
+    m_disabled = false;
+}
+
+bool EPoll::Watch::unblock(bool from_add_blocker, void*)
+{
+    // We stay registered with the file for as long as we're in the interest set.
+    if (!from_add_blocker)
+        m_epoll.mark_ready(*this);
+    return false;
+}
+
+void EPoll::mark_ready(Watch& watch)
+{
+    {
+        ScopedSpinLock lock(m_ready_lock);
+        if (watch.m_disabled || watch.m_ready_list_node.is_in_list())
+            return;
+        m_ready_watches.append(watch);
+    }
+    m_wait_queue.wake_all();
+    evaluate_block_conditions();
+}
+
+KResult EPoll::add(int fd, FileDescription& description, const epoll_event& event)
+{
+    LOCKER(m_lock);
+    if (auto it = m_watches.find(fd); it != m_watches.end()) {
+        // The fd may have been closed and reused since it was added; replace the stale watch.
+        if (it->value->m_description.strong_ref().ptr() == &description)
+            return EEXIST;
+        m_watches.remove(it);
+    }
+    auto watch = make<Watch>(*this, fd, description, event);
+    auto& watch_ref = *watch;
+    m_watches.set(fd, move(watch));
+    description.did_add_to_epoll({}, *this);
+    // Pick up readiness that predates the watch.
+    mark_ready(watch_ref);
+    return KSuccess;
+}
+
+KResult EPoll::modify(int fd, FileDescription& description, const epoll_event& event)
+{
+    LOCKER(m_lock);
+    auto it = m_watches.find(fd);
+    if (it == m_watches.end() || it->value->m_description.strong_ref().ptr() != &description)
+        return ENOENT;
+    auto& watch = *it->value;
+    watch.update(event);
+    mark_ready(watch);
+    return KSuccess;
+}
+
+KResult EPoll::remove(int fd)
+{
+    LOCKER(m_lock);
+    auto it = m_watches.find(fd);
+    if (it == m_watches.end())
+        return ENOENT;
+    m_watches.remove(it);
+    return KSuccess;
+}
+
+void EPoll::remove_watches_for(Badge<FileDescription>, FileDescription& description)
+{
+    LOCKER(m_lock);
+    // The description is being destroyed, so it can't be strong_ref()'d anymore.
+    Vector<int, 4> fds;
+    for (auto& it : m_watches) {
+        if (it.value->m_description.unsafe_ptr() == &description)
+            fds.append(it.key);
+    }
+    for (auto fd : fds)
+        m_watches.remove(fd);
+}
+
+size_t EPoll::collect_events(const Process& process, epoll_event* events, size_t max_events)
+{
+    // Dropping one of these may destroy its description, which removes its watches. Hold on to
+    // them until we're done with the watches and have let go of the lock.
+    Vector<NonnullRefPtr<FileDescription>, 32> descriptions;
+    LOCKER(m_lock);
+    Vector<Watch*, 32> level_triggered_watches;
+    size_t event_count = 0;
+    while (event_count < max_events) {
+        Watch* watch;
+        {
+            ScopedSpinLock lock(m_ready_lock);
+            watch = m_ready_watches.take_first();
+        }
+        if (!watch)
+            break;
+
+        auto description = watch->m_description.strong_ref();
+        if (!description || process.file_description(watch->m_fd) != description) {
+            m_watches.remove(watch->m_fd);
+            continue;
+        }
+        descriptions.append(*description);
+
+        u32 block_flags = (u32)Thread::FileBlocker::BlockFlags::None;
+        if (watch->m_events & EPOLLIN)
+            block_flags |= (u32)Thread::FileBlocker::BlockFlags::Read;
+        if (watch->m_events & EPOLLOUT)
+            block_flags |= (u32)Thread::FileBlocker::BlockFlags::Write;
+        if (watch->m_events & EPOLLPRI)
+            block_flags |= (u32)Thread::FileBlocker::BlockFlags::ReadPriority;
+        auto unblocked_flags = (u32)description->should_unblock((Thread::FileBlocker::BlockFlags)block_flags);
+
+        u32 revents = 0;
+        if (unblocked_flags & (u32)Thread::FileBlocker::BlockFlags::Read)
+            revents |= EPOLLIN;
+        if (unblocked_flags & (u32)Thread::FileBlocker::BlockFlags::Write)
+            revents |= EPOLLOUT;
+        if (unblocked_flags & (u32)Thread::FileBlocker::BlockFlags::ReadPriority)
+            revents |= EPOLLPRI;
+        if (!revents)
+            continue;
+
+        events[event_count++] = { revents, watch->m_data };
+
+        if (watch->m_events & EPOLLONESHOT) {
+            ScopedSpinLock lock(m_ready_lock);
+            watch->m_disabled = true;
+        } else if (!(watch->m_events & EPOLLET)) {
+            level_triggered_watches.append(watch);
+        }
+    }
+
+    // Level-triggered watches stay ready until a call finds them not to be.
+    if (!level_triggered_watches.is_empty()) {
+        ScopedSpinLock lock(m_ready_lock);
+        for (auto* watch : level_triggered_watches) {
+            if (!watch->m_ready_list_node.is_in_list())
+                m_ready_watches.append(*watch);
+        }
+    }
+    return event_count;
+}
+
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Badge.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/WeakPtr.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Lock.h>
+#include <Kernel/SpinLock.h>
+#include <Kernel/UnixTypes.h>
+#include <Kernel/WaitQueue.h>
+
+namespace Kernel {
+
+// An interest set of file descriptors that persists across calls to epoll_wait().
+// Each watched description has a blocker registered on its file's block condition,
+// so readiness changes put it on a ready list instead of requiring a full scan.
+class EPoll final : public File {
+public:
+    static NonnullRefPtr<EPoll> create();
+    virtual ~EPoll() override;
+
+    virtual bool can_read(const FileDescription&, size_t) const override;
+    virtual bool can_write(const FileDescription&, size_t) const override { return false; }
+    virtual KResultOr<size_t> read(FileDescription&, size_t, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual KResultOr<size_t> write(FileDescription&, size_t, const UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual String absolute_path(const FileDescription&) const override { return "epoll"; }
+    virtual const char* class_name() const override { return "EPoll"; }
+    virtual bool is_epoll() const override { return true; }
+
+    KResult add(int fd, FileDescription&, const epoll_event&);
+    KResult modify(int fd, FileDescription&, const epoll_event&);
+    KResult remove(int fd);
+
+    // Called when the last reference to a watched description goes away.
+    void remove_watches_for(Badge<FileDescription>, FileDescription&);
+
+    // Pops up to max_events ready entries into events and returns how many were written.
+    // Entries whose fd has been closed or reused by the process are dropped along the way.
+    size_t collect_events(const Process&, epoll_event* events, size_t max_events);
+
+    WaitQueue& wait_queue() { return m_wait_queue; }
+
+private:
+    class Watch final : public Thread::FileBlocker {
+    public:
+        Watch(EPoll&, int fd, FileDescription&, const epoll_event&);
+        virtual ~Watch() override;
+
+        virtual const char* state_string() const override { return "EPoll"; }
+        virtual void not_blocking(bool) override { }
+        virtual bool unblock(bool, void*) override;
+
+        void update(const epoll_event&);
+
+        EPoll& m_epoll;
+        int m_fd { -1 };
+        WeakPtr<FileDescription> m_description;
+        NonnullRefPtr<File> m_file;
+        u32 m_events { 0 };
+        epoll_data_t m_data {};
+        bool m_disabled { false };
+        IntrusiveListNode m_ready_list_node;
+    };
+
+    EPoll();
+
+    void mark_ready(Watch&);
+
+    Lock m_lock { "EPoll" };
+    HashMap<int, NonnullOwnPtr<Watch>> m_watches;
+
+    mutable SpinLock<u8> m_ready_lock;
+    IntrusiveList<Watch, &Watch::m_ready_list_node> m_ready_watches;
+
+    WaitQueue m_wait_queue;
+};
+
+}
@@ -29,6 +29,7 @@
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/Devices/CharacterDevice.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/EPoll.h>
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/FileDescription.h>
 #include <Kernel/FileSystem/FileSystem.h>
@@ -77,6 +78,12 @@ FileDescription::FileDescription(File& file)
 
 FileDescription::~FileDescription()
 {
+    // Like on Linux, the last close of a description takes it out of every epoll interest set.
+    for (auto& weak_epoll : m_epolls) {
+        if (auto epoll = weak_epoll.strong_ref())
+            epoll->remove_watches_for({}, *this);
+    }
+
     m_file->detach(*this);
     if (is_fifo())
         static_cast<FIFO*>(m_file.ptr())->detach(m_fifo_direction);
@@ -190,6 +197,28 @@ KResultOr<size_t> FileDescription::write(const UserOrKernelBuffer& data, size_t
     return nwritten_or_error;
 }
 
+KResultOr<size_t> FileDescription::read(UserOrKernelBuffer& buffer, off_t offset, size_t count)
+{
+    ASSERT(m_file->is_seekable());
+    if (Checked<off_t>::addition_would_overflow(offset, count))
+        return EOVERFLOW;
+    auto nread_or_error = m_file->read(*this, offset, buffer, count);
+    if (!nread_or_error.is_error())
+        evaluate_block_conditions();
+    return nread_or_error;
+}
+
+KResultOr<size_t> FileDescription::write(off_t offset, const UserOrKernelBuffer& data, size_t size)
+{
+    ASSERT(m_file->is_seekable());
+    if (Checked<off_t>::addition_would_overflow(offset, size))
+        return EOVERFLOW;
+    auto nwritten_or_error = m_file->write(*this, offset, data, size);
+    if (!nwritten_or_error.is_error())
+        evaluate_block_conditions();
+    return nwritten_or_error;
+}
+
 bool FileDescription::can_write() const
 {
     return m_file->can_write(*this, offset());
@@ -393,4 +422,13 @@ FileBlockCondition& FileDescription::block_condition()
     return m_file->block_condition();
 }
 
+void FileDescription::did_add_to_epoll(Badge<EPoll>, EPoll& epoll)
+{
+    LOCKER(m_lock);
+    m_epolls.remove_all_matching([&](auto& weak_epoll) {
+        return weak_epoll.is_null() || weak_epoll.unsafe_ptr() == &epoll;
+    });
+    m_epolls.append(epoll.make_weak_ptr<EPoll>());
+}
+
 }
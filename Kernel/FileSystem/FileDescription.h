@@ -29,6 +29,8 @@
 #include <AK/Badge.h>
 #include <AK/ByteBuffer.h>
 #include <AK/RefCounted.h>
+#include <AK/WeakPtr.h>
+#include <AK/Weakable.h>
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/FileSystem/InodeMetadata.h>
@@ -43,7 +45,9 @@ public:
     virtual ~FileDescriptionData() { }
 };
 
-class FileDescription : public RefCounted<FileDescription> {
+class FileDescription
+    : public RefCounted<FileDescription>
+    , public Weakable<FileDescription> {
     MAKE_SLAB_ALLOCATED(FileDescription)
 public:
     static KResultOr<NonnullRefPtr<FileDescription>> create(Custody&);
@@ -69,6 +73,9 @@ public:
     off_t seek(off_t, int whence);
     KResultOr<size_t> read(UserOrKernelBuffer&, size_t);
     KResultOr<size_t> write(const UserOrKernelBuffer& data, size_t);
+    // Positional I/O: these neither use nor update the current offset, so they don't serialize on it.
+    KResultOr<size_t> read(UserOrKernelBuffer&, off_t offset, size_t);
+    KResultOr<size_t> write(off_t offset, const UserOrKernelBuffer& data, size_t);
     KResult stat(::stat&);
 
     KResult chmod(mode_t);
@@ -139,6 +146,8 @@ public:
 
     FileBlockCondition& block_condition();
 
+    void did_add_to_epoll(Badge<EPoll>, EPoll&);
+
 private:
     friend class VFS;
     explicit FileDescription(File&);
@@ -168,6 +177,9 @@ private:
     bool m_direct : 1 { false };
     FIFO::Direction m_fifo_direction { FIFO::Direction::Neither };
 
+    // The interest sets watching us, so we can leave them when we go away.
+    Vector<WeakPtr<EPoll>> m_epolls;
+
     Lock m_lock { "FileDescription" };
 };
 
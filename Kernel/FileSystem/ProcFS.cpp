@@ -85,6 +85,7 @@ enum ProcFileType {
     FI_Root_all,
     FI_Root_memstat,
     FI_Root_cpuinfo,
+    FI_Root_scheduler,
     FI_Root_dmesg,
     FI_Root_interrupts,
     FI_Root_dmi,
@@ -319,33 +320,33 @@ static bool procfs$pid_vm(InodeIdentifier identifier, KBufferBuilder& builder)
     {
         ScopedSpinLock lock(process->get_lock());
         for (auto& region : process->regions()) {
-            if (!region.is_user_accessible() && !Process::current()->is_superuser())
+            if (!region->is_user_accessible() && !Process::current()->is_superuser())
                 continue;
             auto region_object = array.add_object();
-            region_object.add("readable", region.is_readable());
-            region_object.add("writable", region.is_writable());
-            region_object.add("executable", region.is_executable());
-            region_object.add("stack", region.is_stack());
-            region_object.add("shared", region.is_shared());
-            region_object.add("syscall", region.is_syscall_region());
-            region_object.add("user_accessible", region.is_user_accessible());
-            region_object.add("purgeable", region.vmobject().is_anonymous());
-            if (region.vmobject().is_anonymous()) {
-                region_object.add("volatile", static_cast<const AnonymousVMObject&>(region.vmobject()).is_any_volatile());
+            region_object.add("readable", region->is_readable());
+            region_object.add("writable", region->is_writable());
+            region_object.add("executable", region->is_executable());
+            region_object.add("stack", region->is_stack());
+            region_object.add("shared", region->is_shared());
+            region_object.add("syscall", region->is_syscall_region());
+            region_object.add("user_accessible", region->is_user_accessible());
+            region_object.add("purgeable", region->vmobject().is_anonymous());
+            if (region->vmobject().is_anonymous()) {
+                region_object.add("volatile", static_cast<const AnonymousVMObject&>(region->vmobject()).is_any_volatile());
             }
-            region_object.add("cacheable", region.is_cacheable());
-            region_object.add("kernel", region.is_kernel());
-            region_object.add("address", region.vaddr().get());
-            region_object.add("size", region.size());
-            region_object.add("amount_resident", region.amount_resident());
-            region_object.add("amount_dirty", region.amount_dirty());
-            region_object.add("cow_pages", region.cow_pages());
-            region_object.add("name", region.name());
-            region_object.add("vmobject", region.vmobject().class_name());
+            region_object.add("cacheable", region->is_cacheable());
+            region_object.add("kernel", region->is_kernel());
+            region_object.add("address", region->vaddr().get());
+            region_object.add("size", region->size());
+            region_object.add("amount_resident", region->amount_resident());
+            region_object.add("amount_dirty", region->amount_dirty());
+            region_object.add("cow_pages", region->cow_pages());
+            region_object.add("name", region->name());
+            region_object.add("vmobject", region->vmobject().class_name());
 
             StringBuilder pagemap_builder;
-            for (size_t i = 0; i < region.page_count(); ++i) {
-                auto* page = region.physical_page(i);
+            for (size_t i = 0; i < region->page_count(); ++i) {
+                auto* page = region->physical_page(i);
                 if (!page)
                     pagemap_builder.append('N');
                 else if (page->is_shared_zero_page() || page->is_lazy_committed_page())
@@ -546,6 +547,16 @@ static bool procfs$net_tcp(InodeIdentifier, KBufferBuilder& builder)
         obj.add("bytes_in", socket.bytes_in());
         obj.add("packets_out", socket.packets_out());
         obj.add("bytes_out", socket.bytes_out());
+        obj.add("retransmissions", socket.retransmissions());
+        obj.add("congestion_window", socket.congestion_window());
+        obj.add("slow_start_threshold", socket.slow_start_threshold());
+        obj.add("bytes_in_flight", socket.bytes_in_flight());
+        obj.add("smoothed_rtt", socket.smoothed_rtt());
+        obj.add("rtt_variance", socket.rtt_variance());
+        obj.add("retransmission_timeout", socket.retransmission_timeout());
+        obj.add("send_window", socket.send_window());
+        obj.add("receive_window", socket.receive_window());
+        obj.add("delayed_acks", socket.delayed_acks());
     });
     array.finish();
     return true;
@@ -713,6 +724,24 @@ static bool procfs$cpuinfo(InodeIdentifier, KBufferBuilder& builder)
     return true;
 }
 
+static bool procfs$scheduler(InodeIdentifier, KBufferBuilder& builder)
+{
+    JsonArraySerializer array { builder };
+    Processor::for_each(
+        [&](Processor& proc) -> IterationDecision {
+            auto statistics = Scheduler::processor_statistics(proc.get_id());
+            auto obj = array.add_object();
+            obj.add("processor", proc.get_id());
+            obj.add("runnable_threads", statistics.runnable_threads);
+            obj.add("migrations_in", statistics.migrations_in);
+            obj.add("migrations_out", statistics.migrations_out);
+            obj.add("steals", statistics.steals);
+            return IterationDecision::Continue;
+        });
+    array.finish();
+    return true;
+}
+
 static bool procfs$memstat(InodeIdentifier, KBufferBuilder& builder)
 {
     InterruptDisabler disabler;
@@ -725,6 +754,7 @@ static bool procfs$memstat(InodeIdentifier, KBufferBuilder& builder)
     auto user_physical_pages_used = MM.user_physical_pages_used();
     auto user_physical_pages_committed = MM.user_physical_pages_committed();
     auto user_physical_pages_uncommitted = MM.user_physical_pages_uncommitted();
+    auto user_physical_pages_zeroed = MM.user_physical_pages_zeroed();
 
     auto super_physical_total = MM.super_physical_pages();
     auto super_physical_used = MM.super_physical_pages_used();
@@ -738,6 +768,7 @@ static bool procfs$memstat(InodeIdentifier, KBufferBuilder& builder)
     json.add("user_physical_available", user_physical_pages_total - user_physical_pages_used);
     json.add("user_physical_committed", user_physical_pages_committed);
     json.add("user_physical_uncommitted", user_physical_pages_uncommitted);
+    json.add("user_physical_zeroed", user_physical_pages_zeroed);
     json.add("super_physical_allocated", super_physical_used);
     json.add("super_physical_available", super_physical_total - super_physical_used);
     json.add("kmalloc_call_count", stats.kmalloc_call_count);
@@ -747,6 +778,15 @@ static bool procfs$memstat(InodeIdentifier, KBufferBuilder& builder)
         json.add(String::formatted("{}_num_allocated", prefix), num_allocated);
         json.add(String::formatted("{}_num_free", prefix), num_free);
     });
+    Processor::for_each([&json](Processor& processor) {
+        kmalloc_processor_stats processor_stats;
+        get_kmalloc_processor_stats(processor, processor_stats);
+        auto prefix = String::formatted("kmalloc_cpu{}", processor.get_id());
+        json.add(String::formatted("{}_cache_hit_count", prefix), processor_stats.cache_hit_count);
+        json.add(String::formatted("{}_cache_miss_count", prefix), processor_stats.cache_miss_count);
+        json.add(String::formatted("{}_cache_bytes", prefix), processor_stats.bytes_cached);
+        return IterationDecision::Continue;
+    });
     json.finish();
     return true;
 }
@@ -1654,6 +1694,7 @@ ProcFS::ProcFS()
     m_entries[FI_Root_all] = { "all", FI_Root_all, false, procfs$all };
     m_entries[FI_Root_memstat] = { "memstat", FI_Root_memstat, false, procfs$memstat };
     m_entries[FI_Root_cpuinfo] = { "cpuinfo", FI_Root_cpuinfo, false, procfs$cpuinfo };
+    m_entries[FI_Root_scheduler] = { "scheduler", FI_Root_scheduler, false, procfs$scheduler };
     m_entries[FI_Root_dmesg] = { "dmesg", FI_Root_dmesg, true, procfs$dmesg };
     m_entries[FI_Root_self] = { "self", FI_Root_self, false, procfs$self };
     m_entries[FI_Root_pci] = { "pci", FI_Root_pci, false, procfs$pci };
@@ -35,6 +35,7 @@ class Custody;
 class Device;
 class DiskCache;
 class DoubleBuffer;
+class EPoll;
 class File;
 class FileDescription;
 class FutexQueue;
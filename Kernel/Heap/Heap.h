@@ -68,6 +68,21 @@ public:
         return needed_chunks * CHUNK_SIZE + (needed_chunks + 7) / 8;
     }
 
+    static size_t chunks_for_allocation(size_t size)
+    {
+        return (size + sizeof(AllocationHeader) + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    }
+
+    static size_t usable_size_for_chunks(size_t chunks)
+    {
+        return chunks * CHUNK_SIZE - sizeof(AllocationHeader);
+    }
+
+    static size_t allocation_size_in_chunks(const void* ptr)
+    {
+        return ((const AllocationHeader*)((const u8*)ptr - sizeof(AllocationHeader)))->allocation_size_in_chunks;
+    }
+
     void* allocate(size_t size)
     {
         // We need space for the AllocationHeader at the head of the block.
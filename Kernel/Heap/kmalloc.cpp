@@ -50,6 +50,10 @@
 #define POOL_SIZE (2 * MiB)
 #define ETERNAL_RANGE_SIZE (2 * MiB)
 
+// Allocations of up to MAGAZINE_SIZE_CLASS_COUNT chunks are served from per-processor magazines.
+#define MAGAZINE_SIZE_CLASS_COUNT 4
+#define MAGAZINE_CAPACITY 32
+
 static RecursiveSpinLock s_lock; // needs to be recursive because of dump_backtrace()
 
 static void kmalloc_allocate_backup_memory();
@@ -185,6 +189,36 @@ struct KmallocGlobalHeap {
     }
 };
 
+typedef KmallocGlobalHeap::HeapType::HeapType KmallocHeapType;
+
+// A magazine holds recently freed objects of a single size class. The objects are
+// still allocated as far as the global heap is concerned, which means they keep their
+// allocation header and kfree() can tell which magazine a pointer belongs to.
+struct KmallocMagazine {
+    size_t count { 0 };
+    void* objects[MAGAZINE_CAPACITY];
+};
+
+namespace Kernel {
+
+struct KmallocPerProcessorData {
+    KmallocMagazine magazines[MAGAZINE_SIZE_CLASS_COUNT];
+    size_t cache_hit_count { 0 };
+    size_t cache_miss_count { 0 };
+    size_t kmalloc_call_count { 0 };
+    size_t kfree_call_count { 0 };
+
+    size_t bytes_cached() const
+    {
+        size_t bytes = 0;
+        for (size_t i = 0; i < MAGAZINE_SIZE_CLASS_COUNT; ++i)
+            bytes += magazines[i].count * (i + 1) * CHUNK_SIZE;
+        return bytes;
+    }
+};
+
+}
+
 static KmallocGlobalHeap* g_kmalloc_global;
 static u8 g_kmalloc_global_heap[sizeof(KmallocGlobalHeap)];
 
@@ -235,8 +269,92 @@ void* kmalloc_eternal(size_t size)
     return ptr;
 }
 
+void kmalloc_init_processor_caches()
+{
+    auto& processor = Processor::current();
+    ASSERT(!processor.get_kmalloc_data());
+    processor.set_kmalloc_data(*new KmallocPerProcessorData);
+}
+
+static KmallocPerProcessorData* current_processor_kmalloc_data()
+{
+    if (!Processor::is_initialized())
+        return nullptr;
+    return Processor::current().get_kmalloc_data();
+}
+
+static void* kmalloc_from_processor_cache(size_t size)
+{
+    size_t chunks = KmallocHeapType::chunks_for_allocation(size);
+    if (chunks > MAGAZINE_SIZE_CLASS_COUNT)
+        return nullptr;
+
+    // Disabling interrupts keeps us on this processor and keeps interrupt handlers out of the magazine.
+    InterruptDisabler disabler;
+    auto* data = current_processor_kmalloc_data();
+    if (!data)
+        return nullptr;
+
+    auto& magazine = data->magazines[chunks - 1];
+    size_t usable_size = KmallocHeapType::usable_size_for_chunks(chunks);
+    ++data->kmalloc_call_count;
+    if (magazine.count == 0) {
+        ++data->cache_miss_count;
+        // Refill half the magazine in one go, so we don't come back here for the next few allocations.
+        ScopedSpinLock lock(s_lock);
+        while (magazine.count < MAGAZINE_CAPACITY / 2) {
+            void* ptr = g_kmalloc_global->m_heap.allocate(usable_size);
+            if (!ptr)
+                break;
+            magazine.objects[magazine.count++] = ptr;
+        }
+        if (magazine.count == 0)
+            return nullptr;
+    } else {
+        ++data->cache_hit_count;
+    }
+
+    void* ptr = magazine.objects[--magazine.count];
+    __builtin_memset(ptr, KMALLOC_SCRUB_BYTE, usable_size);
+    return ptr;
+}
+
+static bool kfree_to_processor_cache(void* ptr)
+{
+    size_t chunks = KmallocHeapType::allocation_size_in_chunks(ptr);
+    if (chunks > MAGAZINE_SIZE_CLASS_COUNT)
+        return false;
+
+    InterruptDisabler disabler;
+    auto* data = current_processor_kmalloc_data();
+    if (!data)
+        return false;
+
+    auto& magazine = data->magazines[chunks - 1];
+    ++data->kfree_call_count;
+    if (magazine.count == MAGAZINE_CAPACITY) {
+        // Give the older half of the magazine back to the global heap, and keep the recently used objects.
+        ScopedSpinLock lock(s_lock);
+        constexpr size_t release_count = MAGAZINE_CAPACITY / 2;
+        for (size_t i = 0; i < release_count; ++i)
+            g_kmalloc_global->m_heap.deallocate(magazine.objects[i]);
+        for (size_t i = release_count; i < MAGAZINE_CAPACITY; ++i)
+            magazine.objects[i - release_count] = magazine.objects[i];
+        magazine.count -= release_count;
+    }
+
+    __builtin_memset(ptr, KFREE_SCRUB_BYTE, KmallocHeapType::usable_size_for_chunks(chunks));
+    magazine.objects[magazine.count++] = ptr;
+    return true;
+}
+
 void* kmalloc_impl(size_t size)
 {
+    if (!g_dump_kmalloc_stacks) {
+        if (void* ptr = kmalloc_from_processor_cache(size))
+            return ptr;
+    }
+
     ScopedSpinLock lock(s_lock);
     ++g_kmalloc_call_count;
 
@@ -260,6 +378,9 @@ void kfree(void* ptr)
     if (!ptr)
         return;
 
+    if (kfree_to_processor_cache(ptr))
+        return;
+
     ScopedSpinLock lock(s_lock);
     ++g_kfree_call_count;
 
@@ -290,4 +411,29 @@ void get_kmalloc_stats(kmalloc_stats& stats)
     stats.bytes_eternal = g_kmalloc_bytes_eternal;
     stats.kmalloc_call_count = g_kmalloc_call_count;
     stats.kfree_call_count = g_kfree_call_count;
+
+    // Objects sitting in a magazine are allocated from the global heap's point of view, but free for everyone else.
+    Processor::for_each([&](Processor& processor) {
+        auto* data = processor.get_kmalloc_data();
+        if (!data)
+            return IterationDecision::Continue;
+        auto bytes_cached = data->bytes_cached();
+        stats.bytes_allocated -= bytes_cached;
+        stats.bytes_free += bytes_cached;
+        stats.kmalloc_call_count += data->kmalloc_call_count;
+        stats.kfree_call_count += data->kfree_call_count;
+        return IterationDecision::Continue;
+    });
+}
+
+void get_kmalloc_processor_stats(const Processor& processor, kmalloc_processor_stats& stats)
+{
+    auto* data = processor.get_kmalloc_data();
+    if (!data) {
+        stats = {};
+        return;
+    }
+    stats.cache_hit_count = data->cache_hit_count;
+    stats.cache_miss_count = data->cache_miss_count;
+    stats.bytes_cached = data->bytes_cached();
 }
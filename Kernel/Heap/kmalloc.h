@@ -48,6 +48,18 @@ struct kmalloc_stats {
 };
 void get_kmalloc_stats(kmalloc_stats&);
 
+namespace Kernel {
+class Processor;
+}
+
+struct kmalloc_processor_stats {
+    size_t cache_hit_count;
+    size_t cache_miss_count;
+    size_t bytes_cached;
+};
+void get_kmalloc_processor_stats(const Kernel::Processor&, kmalloc_processor_stats&);
+void kmalloc_init_processor_caches();
+
 extern bool g_dump_kmalloc_stacks;
 
 inline void* operator new(size_t, void* p) { return p; }
@@ -40,6 +40,7 @@
 #include <Kernel/Net/UDP.h>
 #include <Kernel/Net/UDPSocket.h>
 #include <Kernel/Process.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
@@ -48,6 +49,7 @@ static void handle_ipv4(const EthernetFrameHeader&, size_t frame_size, const tim
 static void handle_icmp(const EthernetFrameHeader&, const IPv4Packet&, const timeval& packet_timestamp);
 static void handle_udp(const IPv4Packet&, const timeval& packet_timestamp);
 static void handle_tcp(const IPv4Packet&, const timeval& packet_timestamp);
+static void handle_tcp_timers();
 
 [[noreturn]] static void NetworkTask_main(void*);
 
@@ -102,11 +104,21 @@ void NetworkTask_main(void*)
     auto buffer = (u8*)buffer_region->vaddr().get();
     timeval packet_timestamp;
 
+    // We wake up at least this often to check the TCP retransmission and delayed ACK timers.
+    constexpr u64 tcp_timer_interval_ms = 100;
+    timeval tcp_timer_interval { 0, tcp_timer_interval_ms * 1000 };
+    u64 next_tcp_timer_check = 0;
+
     klog() << "NetworkTask: Enter main loop.";
     for (;;) {
+        if (auto now = TimeManagement::the().uptime_ms(); now >= next_tcp_timer_check) {
+            handle_tcp_timers();
+            next_tcp_timer_check = now + tcp_timer_interval_ms;
+        }
+
         size_t packet_size = dequeue_packet(buffer, buffer_size, packet_timestamp);
         if (!packet_size) {
-            packet_wait_queue.wait_on({}, "NetworkTask");
+            [[maybe_unused]] auto result = packet_wait_queue.wait_on(Thread::BlockTimeout(false, &tcp_timer_interval), "NetworkTask");
             continue;
         }
         if (packet_size < sizeof(EthernetFrameHeader)) {
@@ -426,6 +438,7 @@ void handle_tcp(const IPv4Packet& ipv4_packet, const timeval& packet_timestamp)
 #endif
             client->set_sequence_number(1000);
             client->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            client->process_syn_options(tcp_packet);
             [[maybe_unused]] auto rc2 = client->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             client->set_state(TCPSocket::State::SynReceived);
             return;
@@ -583,16 +596,41 @@ void handle_tcp(const IPv4Packet& ipv4_packet, const timeval& packet_timestamp)
             return;
         }
 
-        socket->set_ack_number(tcp_packet.sequence_number() + payload_size);
+        if (!payload_size)
+            return;
+
+        if (tcp_packet.sequence_number() != socket->ack_number()) {
+            // We don't queue out-of-order segments. Acknowledge right away so the peer notices the gap. See RFC 5681, section 4.2.
+            unused_rc = socket->send_tcp_packet(TCPFlags::ACK);
+            return;
+        }
+
+        if (socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), KBuffer::copy(&ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size()), packet_timestamp)) {
+            socket->set_ack_number(tcp_packet.sequence_number() + payload_size);
+            socket->acknowledge_received_data();
+        }
 
 #if TCP_DEBUG
         klog() << "Got packet with ack_no=" << tcp_packet.ack_number() << ", seq_no=" << tcp_packet.sequence_number() << ", payload_size=" << payload_size << ", acking it with new ack_no=" << socket->ack_number() << ", seq_no=" << socket->sequence_number();
 #endif
+    }
+}
 
-        if (payload_size) {
-            if (socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), KBuffer::copy(&ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size()), packet_timestamp))
-                unused_rc = socket->send_tcp_packet(TCPFlags::ACK);
-        }
+void handle_tcp_timers()
+{
+    // We must keep the sockets alive while we handle their timers, but we can't hold
+    // the socket table lock while taking the individual socket locks.
+    Vector<RefPtr<TCPSocket>, 16> sockets;
+    {
+        LOCKER(TCPSocket::sockets_by_tuple().lock(), Lock::Mode::Shared);
+        for (auto& it : TCPSocket::sockets_by_tuple().resource())
+            sockets.append(*it.value);
+    }
+
+    for (auto& socket : sockets) {
+        LOCKER(socket->lock());
+        socket->retransmit_packets();
+        socket->send_delayed_ack();
     }
 }
 
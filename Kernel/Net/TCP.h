@@ -41,6 +41,16 @@ struct TCPFlags {
     };
 };
 
+struct TCPOptionKind {
+    enum : u8 {
+        End = 0,
+        NoOperation = 1,
+        MSS = 2,
+        WindowScale = 3,
+        Timestamp = 8,
+    };
+};
+
 class [[gnu::packed]] TCPPacket {
 public:
     TCPPacket() = default;
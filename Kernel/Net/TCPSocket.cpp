@@ -35,9 +35,33 @@
 #include <Kernel/Net/TCPSocket.h>
 #include <Kernel/Process.h>
 #include <Kernel/Random.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
+static constexpr u32 min_retransmission_timeout = 1000;
+static constexpr u32 max_retransmission_timeout = 60000;
+static constexpr u32 delayed_ack_timeout = 200;
+
+static constexpr size_t max_tcp_options_size = 40;
+static constexpr size_t timestamp_option_size = 12;
+static constexpr size_t max_ipv4_and_tcp_header_size = 60 + 60;
+
+// Our receive buffer is small enough to be advertised without scaling, but we still
+// negotiate window scaling so that the peer may use a larger window.
+static constexpr u8 receive_window_scale = 0;
+
+static bool sequence_number_less_than(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) < 0;
+}
+
+static u32 initial_congestion_window(u32 mss)
+{
+    // See RFC 5681, section 3.1.
+    return min(4 * mss, max(2 * mss, 4380u));
+}
+
 void TCPSocket::for_each(Function<void(const TCPSocket&)> callback)
 {
     LOCKER(sockets_by_tuple().lock(), Lock::Mode::Shared);
@@ -178,125 +202,517 @@ KResultOr<size_t> TCPSocket::protocol_receive(ReadonlyBytes raw_ipv4_packet, Use
 
 KResultOr<size_t> TCPSocket::protocol_send(const UserOrKernelBuffer& data, size_t data_length)
 {
-    int err = send_tcp_packet(TCPFlags::PUSH | TCPFlags::ACK, &data, data_length);
-    if (err < 0)
-        return KResult((ErrnoCode)-err);
+    auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
+    if (routing_decision.is_zero())
+        return EHOSTUNREACH;
+    m_mss = min(static_cast<u32>(routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket)), m_peer_mss);
+
+    size_t max_segment_size = max_segment_payload_size();
+    for (size_t offset = 0; offset < data_length;) {
+        size_t segment_size = min(data_length - offset, max_segment_size);
+        auto segment = data.offset(offset);
+        int err = send_tcp_packet(TCPFlags::PUSH | TCPFlags::ACK, &segment, segment_size);
+        if (err < 0) {
+            if (offset > 0)
+                return offset;
+            return KResult((ErrnoCode)-err);
+        }
+        offset += segment_size;
+    }
     return data_length;
 }
 
+size_t TCPSocket::max_segment_payload_size() const
+{
+    return m_mss - (m_timestamps_enabled ? timestamp_option_size : 0);
+}
+
+u32 TCPSocket::receive_window() const
+{
+    // IPv4Socket::did_receive() checks whole packets against the free buffer space, so leave room for the headers.
+    size_t space = receive_buffer_space();
+    if (space <= max_ipv4_and_tcp_header_size)
+        return 0;
+    return space - max_ipv4_and_tcp_header_size;
+}
+
 KResult TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* payload, size_t payload_size)
 {
-    const size_t buffer_size = sizeof(TCPPacket) + payload_size;
-    alignas(TCPPacket) u8 buffer[buffer_size];
-    new (buffer) TCPPacket;
-    auto& tcp_packet = *(TCPPacket*)(buffer);
     ASSERT(local_port());
-    tcp_packet.set_source_port(local_port());
-    tcp_packet.set_destination_port(peer_port());
-    tcp_packet.set_window_size(1024);
-    tcp_packet.set_sequence_number(m_sequence_number);
-    tcp_packet.set_data_offset(sizeof(TCPPacket) / sizeof(u32));
-    tcp_packet.set_flags(flags);
 
-    if (flags & TCPFlags::ACK)
-        tcp_packet.set_ack_number(m_ack_number);
+    if (!(flags & (TCPFlags::SYN | TCPFlags::FIN)) && !payload_size)
+        return send_segment(m_sequence_number, flags, {});
 
-    if (payload && !payload->read(tcp_packet.payload(), payload_size))
-        return EFAULT;
+    LOCKER(m_not_acked_lock);
+
+    // Coalesce small writes into the last segment if it hasn't been sent yet.
+    if (payload_size && !m_not_acked.is_empty()) {
+        auto& last_packet = m_not_acked.last();
+        if (!last_packet.tx_counter && last_packet.flags == flags && last_packet.payload.size() + payload_size <= max_segment_payload_size()) {
+            size_t old_size = last_packet.payload.size();
+            last_packet.payload.grow(old_size + payload_size);
+            if (!payload->read(last_packet.payload.data() + old_size, payload_size)) {
+                last_packet.payload.trim(old_size);
+                return EFAULT;
+            }
+            last_packet.sequence_length += payload_size;
+            m_sequence_number += payload_size;
+            send_outgoing_packets();
+            return KSuccess;
+        }
+    }
+
+    ByteBuffer payload_buffer;
+    if (payload_size) {
+        payload_buffer = ByteBuffer::create_uninitialized(payload_size);
+        if (!payload->read(payload_buffer.data(), payload_size))
+            return EFAULT;
+    }
+
+    // SYN and FIN each occupy one sequence number.
+    u32 sequence_length = payload_size;
+    if (flags & TCPFlags::SYN)
+        ++sequence_length;
+    if (flags & TCPFlags::FIN)
+        ++sequence_length;
+
+    m_not_acked.append({ m_sequence_number, flags, move(payload_buffer), 0, 0, sequence_length });
+    m_sequence_number += sequence_length;
+    send_outgoing_packets();
+    return KSuccess;
+}
+
+static void write_network_u32(u8* destination, u32 value)
+{
+    destination[0] = value >> 24;
+    destination[1] = value >> 16;
+    destination[2] = value >> 8;
+    destination[3] = value;
+}
 
+static u32 read_network_u32(const u8* source)
+{
+    return ((u32)source[0] << 24) | ((u32)source[1] << 16) | ((u32)source[2] << 8) | source[3];
+}
+
+size_t TCPSocket::write_options(u8* options, u16 flags, u16 mss) const
+{
+    size_t offset = 0;
     if (flags & TCPFlags::SYN) {
-        ++m_sequence_number;
-    } else {
-        m_sequence_number += payload_size;
+        options[offset++] = TCPOptionKind::MSS;
+        options[offset++] = 4;
+        options[offset++] = mss >> 8;
+        options[offset++] = mss & 0xff;
+
+        // We offer every option in our own SYN, but only answer with those the peer offered.
+        bool is_active_open = !(flags & TCPFlags::ACK);
+        if (is_active_open || m_window_scaling_enabled) {
+            options[offset++] = TCPOptionKind::NoOperation;
+            options[offset++] = TCPOptionKind::WindowScale;
+            options[offset++] = 3;
+            options[offset++] = receive_window_scale;
+        }
+        if (!is_active_open && !m_timestamps_enabled)
+            return offset;
+    } else if (!m_timestamps_enabled) {
+        return offset;
     }
 
-    tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    options[offset++] = TCPOptionKind::NoOperation;
+    options[offset++] = TCPOptionKind::NoOperation;
+    options[offset++] = TCPOptionKind::Timestamp;
+    options[offset++] = 10;
+    write_network_u32(options + offset, TimeManagement::the().uptime_ms());
+    write_network_u32(options + offset + 4, m_timestamp_recent);
+    offset += 8;
+    return offset;
+}
 
-    if (tcp_packet.has_syn() || payload_size > 0) {
-        LOCKER(m_not_acked_lock);
-        m_not_acked.append({ m_sequence_number, ByteBuffer::copy(buffer, buffer_size) });
-        send_outgoing_packets();
-        return KSuccess;
+struct TCPOptions {
+    Optional<u16> mss;
+    Optional<u8> window_scale;
+    Optional<u32> timestamp_value;
+    u32 timestamp_echo_reply { 0 };
+};
+
+static TCPOptions parse_tcp_options(const TCPPacket& packet)
+{
+    TCPOptions result;
+    if (packet.header_size() <= sizeof(TCPPacket))
+        return result;
+
+    auto* options = reinterpret_cast<const u8*>(&packet) + sizeof(TCPPacket);
+    size_t options_size = packet.header_size() - sizeof(TCPPacket);
+    for (size_t offset = 0; offset < options_size;) {
+        u8 kind = options[offset];
+        if (kind == TCPOptionKind::End)
+            break;
+        if (kind == TCPOptionKind::NoOperation) {
+            ++offset;
+            continue;
+        }
+        if (offset + 1 >= options_size)
+            break;
+        u8 length = options[offset + 1];
+        if (length < 2 || offset + length > options_size)
+            break;
+
+        switch (kind) {
+        case TCPOptionKind::MSS:
+            if (length == 4)
+                result.mss = (options[offset + 2] << 8) | options[offset + 3];
+            break;
+        case TCPOptionKind::WindowScale:
+            // See RFC 7323, section 2.3.
+            if (length == 3)
+                result.window_scale = min(options[offset + 2], (u8)14);
+            break;
+        case TCPOptionKind::Timestamp:
+            if (length == 10) {
+                result.timestamp_value = read_network_u32(options + offset + 2);
+                result.timestamp_echo_reply = read_network_u32(options + offset + 6);
+            }
+            break;
+        default:
+            break;
+        }
+        offset += length;
     }
+    return result;
+}
 
+KResult TCPSocket::send_segment(u32 sequence_number, u16 flags, ReadonlyBytes payload)
+{
     auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
-    ASSERT(!routing_decision.is_zero());
+    if (routing_decision.is_zero())
+        return EHOSTUNREACH;
+
+    u16 mss = min(routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket), (size_t)0xffff);
+    u8 options[max_tcp_options_size];
+    size_t options_size = write_options(options, flags, mss);
+    size_t header_size = sizeof(TCPPacket) + options_size;
+    ASSERT(header_size % sizeof(u32) == 0);
 
-    auto packet_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer);
+    auto buffer = ByteBuffer::create_zeroed(header_size + payload.size());
+    auto& tcp_packet = *new (buffer.data()) TCPPacket;
+    tcp_packet.set_source_port(local_port());
+    tcp_packet.set_destination_port(peer_port());
+    tcp_packet.set_sequence_number(sequence_number);
+    tcp_packet.set_data_offset(header_size / sizeof(u32));
+    tcp_packet.set_flags(flags);
+
+    // The window field of a SYN segment is never scaled.
+    u32 window = receive_window();
+    if (!(flags & TCPFlags::SYN) && m_window_scaling_enabled)
+        window >>= receive_window_scale;
+    tcp_packet.set_window_size(min(window, 0xffffu));
+
+    if (flags & TCPFlags::ACK) {
+        tcp_packet.set_ack_number(m_ack_number);
+        // Any segment carrying an acknowledgment makes a pending delayed ACK unnecessary.
+        m_advertised_window = receive_window();
+        m_unacknowledged_segments = 0;
+        m_delayed_ack_deadline = 0;
+    }
+
+    memcpy(buffer.data() + sizeof(TCPPacket), options, options_size);
+    if (!payload.is_empty())
+        memcpy(tcp_packet.payload(), payload.data(), payload.size());
+    tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload.size()));
+
+#if TCP_SOCKET_DEBUG
+    klog() << "sending tcp packet from " << local_address().to_string().characters() << ":" << local_port() << " to " << peer_address().to_string().characters() << ":" << peer_port() << " with (" << (tcp_packet.has_syn() ? "SYN " : "") << (tcp_packet.has_ack() ? "ACK " : "") << (tcp_packet.has_fin() ? "FIN " : "") << (tcp_packet.has_rst() ? "RST " : "") << ") seq_no=" << tcp_packet.sequence_number() << ", ack_no=" << tcp_packet.ack_number() << ", window=" << tcp_packet.window_size();
+#endif
+    auto packet_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer.data());
     auto result = routing_decision.adapter->send_ipv4(
         routing_decision.next_hop, peer_address(), IPv4Protocol::TCP,
-        packet_buffer, buffer_size, ttl());
-    if (result.is_error())
+        packet_buffer, buffer.size(), ttl());
+    if (result.is_error()) {
+        klog() << "Error (" << result.error() << ") sending tcp packet from " << local_address().to_string().characters() << ":" << local_port() << " to " << peer_address().to_string().characters() << ":" << peer_port() << " with (" << (tcp_packet.has_syn() ? "SYN " : "") << (tcp_packet.has_ack() ? "ACK " : "") << (tcp_packet.has_fin() ? "FIN " : "") << (tcp_packet.has_rst() ? "RST " : "") << ") seq_no=" << tcp_packet.sequence_number() << ", ack_no=" << tcp_packet.ack_number();
         return result;
+    }
 
     m_packets_out++;
-    m_bytes_out += buffer_size;
+    m_bytes_out += buffer.size();
     return KSuccess;
 }
 
-void TCPSocket::send_outgoing_packets()
+KResult TCPSocket::transmit_packet(OutgoingPacket& packet)
 {
-    auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
-    ASSERT(!routing_decision.is_zero());
+    packet.tx_time = TimeManagement::the().uptime_ms();
+    packet.tx_counter++;
+    return send_segment(packet.sequence_number, packet.flags, packet.payload.bytes());
+}
 
-    auto now = kgettimeofday();
+void TCPSocket::send_outgoing_packets()
+{
+    LOCKER(m_not_acked_lock);
+    if (!m_congestion_window)
+        m_congestion_window = initial_congestion_window(m_mss);
 
-    LOCKER(m_not_acked_lock, Lock::Mode::Shared);
+    u32 window = min(m_congestion_window, m_send_window);
     for (auto& packet : m_not_acked) {
-        timeval diff;
-        timeval_sub(packet.tx_time, now, diff);
-        if (diff.tv_sec == 0 && diff.tv_usec <= 500000)
+        if (packet.tx_counter)
             continue;
-        packet.tx_time = now;
-        packet.tx_counter++;
+        // Always allow one segment when nothing is in flight, otherwise a tiny window could stall us forever.
+        // With a closed peer window, this segment and its retransmissions act as window probes.
+        if (m_bytes_in_flight && m_bytes_in_flight + packet.sequence_length > window)
+            break;
+        // Nagle's algorithm: Hold back a small trailing segment while data is unacknowledged, so that
+        // further writes can be coalesced into it. See RFC 896 and RFC 1122, section 4.2.3.4.
+        if (!m_no_delay && m_bytes_in_flight && &packet == &m_not_acked.last() && !(packet.flags & (TCPFlags::SYN | TCPFlags::FIN)) && packet.payload.size() < max_segment_payload_size())
+            break;
+        // NOTE: If the packet couldn't be sent, the retransmission timer will take care of it.
+        [[maybe_unused]] auto result = transmit_packet(packet);
+        m_bytes_in_flight += packet.sequence_length;
+    }
 
-#if TCP_SOCKET_DEBUG
-        auto& tcp_packet = *(TCPPacket*)(packet.buffer.data());
-        klog() << "sending tcp packet from " << local_address().to_string().characters() << ":" << local_port() << " to " << peer_address().to_string().characters() << ":" << peer_port() << " with (" << (tcp_packet.has_syn() ? "SYN " : "") << (tcp_packet.has_ack() ? "ACK " : "") << (tcp_packet.has_fin() ? "FIN " : "") << (tcp_packet.has_rst() ? "RST " : "") << ") seq_no=" << tcp_packet.sequence_number() << ", ack_no=" << tcp_packet.ack_number() << ", tx_counter=" << packet.tx_counter;
-#endif
-        auto packet_buffer = UserOrKernelBuffer::for_kernel_buffer(packet.buffer.data());
-        int err = routing_decision.adapter->send_ipv4(
-            routing_decision.next_hop, peer_address(), IPv4Protocol::TCP,
-            packet_buffer, packet.buffer.size(), ttl());
-        if (err < 0) {
-            auto& tcp_packet = *(TCPPacket*)(packet.buffer.data());
-            klog() << "Error (" << err << ") sending tcp packet from " << local_address().to_string().characters() << ":" << local_port() << " to " << peer_address().to_string().characters() << ":" << peer_port() << " with (" << (tcp_packet.has_syn() ? "SYN " : "") << (tcp_packet.has_ack() ? "ACK " : "") << (tcp_packet.has_fin() ? "FIN " : "") << (tcp_packet.has_rst() ? "RST " : "") << ") seq_no=" << tcp_packet.sequence_number() << ", ack_no=" << tcp_packet.ack_number() << ", tx_counter=" << packet.tx_counter;
-        } else {
-            m_packets_out++;
-            m_bytes_out += packet.buffer.size();
-        }
+    if (m_bytes_in_flight && !m_retransmission_deadline)
+        restart_retransmission_timer();
+}
+
+void TCPSocket::restart_retransmission_timer()
+{
+    m_retransmission_deadline = TimeManagement::the().uptime_ms() + m_retransmission_timeout;
+}
+
+void TCPSocket::retransmit_packets()
+{
+    LOCKER(m_not_acked_lock);
+    if (!m_retransmission_deadline || TimeManagement::the().uptime_ms() < m_retransmission_deadline)
+        return;
+
+    if (m_not_acked.is_empty() || !m_not_acked.first().tx_counter) {
+        m_retransmission_deadline = 0;
+        return;
+    }
+
+    auto& packet = m_not_acked.first();
+
+    // The retransmission timer expired, so we consider the oldest segment lost. See RFC 5681, section 3.1.
+    if (packet.tx_counter == 1)
+        m_slow_start_threshold = max(m_bytes_in_flight / 2, 2 * m_mss);
+    m_congestion_window = m_mss;
+    m_in_fast_recovery = false;
+    m_duplicate_ack_count = 0;
+
+    // Back off the timer. See RFC 6298, section 5.
+    m_retransmission_timeout = min(m_retransmission_timeout * 2, max_retransmission_timeout);
+
+    dbgln<TCP_SOCKET_DEBUG>("TCPSocket: Retransmission timeout for {}, new RTO {} ms", packet.sequence_number, m_retransmission_timeout);
+
+    [[maybe_unused]] auto result = transmit_packet(packet);
+    m_retransmissions++;
+    restart_retransmission_timer();
+}
+
+void TCPSocket::update_rtt(u32 rtt_sample)
+{
+    // See RFC 6298, section 2.
+    if (!m_has_rtt_sample) {
+        m_smoothed_rtt = rtt_sample;
+        m_rtt_variance = rtt_sample / 2;
+        m_has_rtt_sample = true;
+    } else {
+        u32 deviation = m_smoothed_rtt > rtt_sample ? m_smoothed_rtt - rtt_sample : rtt_sample - m_smoothed_rtt;
+        m_rtt_variance = (3 * m_rtt_variance + deviation) / 4;
+        m_smoothed_rtt = (7 * m_smoothed_rtt + rtt_sample) / 8;
     }
+    m_retransmission_timeout = clamp(m_smoothed_rtt + max(1u, 4 * m_rtt_variance), min_retransmission_timeout, max_retransmission_timeout);
 }
 
-void TCPSocket::receive_tcp_packet(const TCPPacket& packet, u16 size)
+void TCPSocket::handle_ack(u32 ack_number, u16 window_size, size_t payload_size, u16 flags, Optional<u32> timestamp_echo_reply)
 {
-    if (packet.has_ack()) {
-        u32 ack_number = packet.ack_number();
+    dbgln<TCP_SOCKET_DEBUG>("TCPSocket: receive_tcp_packet: {}", ack_number);
 
-        dbgln<TCP_SOCKET_DEBUG>("TCPSocket: receive_tcp_packet: {}", ack_number);
+    LOCKER(m_not_acked_lock);
 
-        int removed = 0;
-        LOCKER(m_not_acked_lock);
-        while (!m_not_acked.is_empty()) {
-            auto& packet = m_not_acked.first();
+    auto now = TimeManagement::the().uptime_ms();
+    u32 acked_bytes = 0;
+    Optional<u32> rtt_sample;
+    int removed = 0;
+    while (!m_not_acked.is_empty()) {
+        auto& packet = m_not_acked.first();
 
-            dbgln<TCP_SOCKET_DEBUG>("TCPSocket: iterate: {}", packet.ack_number);
+        dbgln<TCP_SOCKET_DEBUG>("TCPSocket: iterate: {}", packet.end_sequence_number());
 
-            if (packet.ack_number <= ack_number) {
-                m_not_acked.take_first();
-                removed++;
+        if (sequence_number_less_than(ack_number, packet.end_sequence_number()))
+            break;
+
+        if (packet.tx_counter) {
+            acked_bytes += packet.sequence_length;
+            m_bytes_in_flight -= min(m_bytes_in_flight, packet.sequence_length);
+        }
+        // Karn's algorithm: Retransmitted segments don't give us a usable RTT sample.
+        if (packet.tx_counter == 1)
+            rtt_sample = now - packet.tx_time;
+        m_not_acked.take_first();
+        removed++;
+    }
+
+    dbgln<TCP_SOCKET_DEBUG>("TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
+
+    if (acked_bytes) {
+        // Timestamps give us a sample even for retransmitted segments. See RFC 7323, section 4.1.
+        if (timestamp_echo_reply.has_value())
+            rtt_sample = static_cast<u32>(now) - timestamp_echo_reply.value();
+        if (rtt_sample.has_value())
+            update_rtt(rtt_sample.value());
+        m_duplicate_ack_count = 0;
+        m_last_ack_number_received = ack_number;
+
+        if (m_in_fast_recovery) {
+            if (!sequence_number_less_than(ack_number, m_recovery_point)) {
+                // Full acknowledgment, deflate the window and leave fast recovery. See RFC 6582, section 3.2.
+                m_congestion_window = min(m_slow_start_threshold, max(m_bytes_in_flight, m_mss) + m_mss);
+                m_in_fast_recovery = false;
             } else {
-                break;
+                // Partial acknowledgment, the first unacknowledged segment was lost as well.
+                if (!m_not_acked.is_empty() && m_not_acked.first().tx_counter) {
+                    [[maybe_unused]] auto result = transmit_packet(m_not_acked.first());
+                    m_retransmissions++;
+                }
+                m_congestion_window -= min(acked_bytes, m_congestion_window);
+                if (acked_bytes >= m_mss)
+                    m_congestion_window += m_mss;
             }
+        } else if (m_congestion_window < m_slow_start_threshold) {
+            // Slow start.
+            m_congestion_window += min(acked_bytes, m_mss);
+        } else {
+            // Congestion avoidance.
+            m_congestion_window += max(m_mss * m_mss / m_congestion_window, 1u);
         }
 
-        dbgln<TCP_SOCKET_DEBUG>("TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
+        if (m_bytes_in_flight)
+            restart_retransmission_timer();
+        else
+            m_retransmission_deadline = 0;
+    } else if (ack_number == m_last_ack_number_received && window_size == m_last_window_size_received && m_bytes_in_flight && !payload_size && !(flags & (TCPFlags::SYN | TCPFlags::FIN))) {
+        // Duplicate acknowledgment. See RFC 5681, sections 2 and 3.2.
+        m_duplicate_ack_count++;
+        if (m_duplicate_ack_count == 3 && !m_in_fast_recovery) {
+            m_slow_start_threshold = max(m_bytes_in_flight / 2, 2 * m_mss);
+            m_recovery_point = m_last_ack_number_received;
+            for (auto& packet : m_not_acked) {
+                if (packet.tx_counter)
+                    m_recovery_point = packet.end_sequence_number();
+            }
+            [[maybe_unused]] auto result = transmit_packet(m_not_acked.first());
+            m_retransmissions++;
+            m_congestion_window = m_slow_start_threshold + 3 * m_mss;
+            m_in_fast_recovery = true;
+        } else if (m_in_fast_recovery) {
+            m_congestion_window += m_mss;
+        }
     }
+    // A window update with the same acknowledgment number isn't a duplicate.
+    m_last_window_size_received = window_size;
+
+    send_outgoing_packets();
+}
+
+void TCPSocket::receive_tcp_packet(const TCPPacket& packet, u16 size)
+{
+    Optional<u32> timestamp_echo_reply;
+    if (packet.has_syn()) {
+        // Listening sockets leave the options to the client socket they create.
+        if (m_state == State::SynSent)
+            process_syn_options(packet);
+    } else {
+        if (packet.has_ack())
+            update_send_window(packet);
+
+        if (m_timestamps_enabled) {
+            auto options = parse_tcp_options(packet);
+            if (options.timestamp_value.has_value()) {
+                // See RFC 7323, section 4.3.
+                if (!sequence_number_less_than(m_ack_number, packet.sequence_number()) && !sequence_number_less_than(options.timestamp_value.value(), m_timestamp_recent))
+                    m_timestamp_recent = options.timestamp_value.value();
+                if (packet.has_ack() && options.timestamp_echo_reply)
+                    timestamp_echo_reply = options.timestamp_echo_reply;
+            }
+        }
+    }
+
+    if (packet.has_ack())
+        handle_ack(packet.ack_number(), packet.window_size(), size - packet.header_size(), packet.flags(), timestamp_echo_reply);
 
     m_packets_in++;
     m_bytes_in += packet.header_size() + size;
 }
 
+void TCPSocket::process_syn_options(const TCPPacket& packet)
+{
+    ASSERT(packet.has_syn());
+    auto options = parse_tcp_options(packet);
+
+    // See RFC 1122, section 4.2.2.6.
+    m_peer_mss = options.mss.value_or(536);
+
+    // Window scaling and timestamps are only enabled if both sides asked for them.
+    m_window_scaling_enabled = options.window_scale.has_value();
+    m_send_window_scale = options.window_scale.value_or(0);
+    m_timestamps_enabled = options.timestamp_value.has_value();
+    m_timestamp_recent = options.timestamp_value.value_or(0);
+
+    // The window field of a SYN segment is never scaled.
+    m_send_window = packet.window_size();
+    m_send_window_update_sequence_number = packet.sequence_number();
+    m_send_window_update_ack_number = packet.ack_number();
+}
+
+void TCPSocket::update_send_window(const TCPPacket& packet)
+{
+    ASSERT(packet.has_ack());
+
+    // Segments can arrive out of order, so only take the window from one that is newer than
+    // the one we last took it from (SND.WL1 and SND.WL2). See RFC 793, section 3.9.
+    auto sequence_number = packet.sequence_number();
+    auto ack_number = packet.ack_number();
+    if (sequence_number_less_than(sequence_number, m_send_window_update_sequence_number))
+        return;
+    if (sequence_number == m_send_window_update_sequence_number && sequence_number_less_than(ack_number, m_send_window_update_ack_number))
+        return;
+
+    m_send_window = static_cast<u32>(packet.window_size()) << m_send_window_scale;
+    m_send_window_update_sequence_number = sequence_number;
+    m_send_window_update_ack_number = ack_number;
+}
+
+void TCPSocket::acknowledge_received_data()
+{
+    // Acknowledge at least every second segment, and never hold an acknowledgment
+    // back for longer than 500 ms. See RFC 1122, section 4.2.3.2.
+    if (++m_unacknowledged_segments >= 2) {
+        [[maybe_unused]] auto rc = send_tcp_packet(TCPFlags::ACK);
+        return;
+    }
+    if (!m_delayed_ack_deadline)
+        m_delayed_ack_deadline = TimeManagement::the().uptime_ms() + delayed_ack_timeout;
+}
+
+void TCPSocket::send_delayed_ack()
+{
+    if (!m_delayed_ack_deadline || TimeManagement::the().uptime_ms() < m_delayed_ack_deadline)
+        return;
+    m_delayed_acks++;
+    [[maybe_unused]] auto rc = send_tcp_packet(TCPFlags::ACK);
+}
+
+void TCPSocket::protocol_did_read_received_data()
+{
+    if (m_state != State::Established)
+        return;
+
+    // Let the peer know that the window opened up again, but only once it has grown
+    // by a meaningful amount to avoid the silly window syndrome. See RFC 1122, section 4.2.3.3.
+    u32 window = receive_window();
+    if (window > m_advertised_window && window - m_advertised_window >= min(m_mss, window / 2)) {
+        [[maybe_unused]] auto rc = send_tcp_packet(TCPFlags::ACK);
+    }
+}
+
 NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(const IPv4Address& source, const IPv4Address& destination, const TCPPacket& packet, u16 payload_size)
 {
     struct [[gnu::packed]] PseudoHeader {
@@ -307,7 +723,7 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(const IPv4Address& source, c
         NetworkOrdered<u16> payload_size;
     };
 
-    PseudoHeader pseudo_header { source, destination, 0, (u8)IPv4Protocol::TCP, sizeof(TCPPacket) + payload_size };
+    PseudoHeader pseudo_header { source, destination, 0, (u8)IPv4Protocol::TCP, static_cast<u16>(packet.header_size() + payload_size) };
 
     u32 checksum = 0;
     auto* w = (const NetworkOrdered<u16>*)&pseudo_header;
@@ -317,12 +733,11 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(const IPv4Address& source, c
             checksum = (checksum >> 16) + (checksum & 0xffff);
     }
     w = (const NetworkOrdered<u16>*)&packet;
-    for (size_t i = 0; i < sizeof(packet) / sizeof(u16); ++i) {
+    for (size_t i = 0; i < packet.header_size() / sizeof(u16); ++i) {
         checksum += w[i];
         if (checksum > 0xffff)
             checksum = (checksum >> 16) + (checksum & 0xffff);
     }
-    ASSERT(packet.data_offset() * 4 == sizeof(TCPPacket));
     w = (const NetworkOrdered<u16>*)packet.payload();
     for (size_t i = 0; i < payload_size / sizeof(u16); ++i) {
         checksum += w[i];
@@ -475,4 +890,54 @@ KResult TCPSocket::close()
     return result;
 }
 
+KResult TCPSocket::setsockopt(int level, int option, Userspace<const void*> user_value, socklen_t user_value_size)
+{
+    if (level != IPPROTO_TCP)
+        return IPv4Socket::setsockopt(level, option, user_value, user_value_size);
+
+    switch (option) {
+    case TCP_NODELAY: {
+        if (user_value_size < sizeof(int))
+            return EINVAL;
+        int value;
+        if (!copy_from_user(&value, static_ptr_cast<const int*>(user_value)))
+            return EFAULT;
+        Locker locker(lock());
+        m_no_delay = value != 0;
+        // Anything Nagle's algorithm was holding back can go out now.
+        if (m_no_delay)
+            send_outgoing_packets();
+        return KSuccess;
+    }
+    default:
+        return ENOPROTOOPT;
+    }
+}
+
+KResult TCPSocket::getsockopt(FileDescription& description, int level, int option, Userspace<void*> value, Userspace<socklen_t*> value_size)
+{
+    if (level != IPPROTO_TCP)
+        return IPv4Socket::getsockopt(description, level, option, value, value_size);
+
+    socklen_t size;
+    if (!copy_from_user(&size, value_size.unsafe_userspace_ptr()))
+        return EFAULT;
+
+    switch (option) {
+    case TCP_NODELAY: {
+        if (size < sizeof(int))
+            return EINVAL;
+        int no_delay = m_no_delay;
+        if (!copy_to_user(static_ptr_cast<int*>(value), &no_delay))
+            return EFAULT;
+        size = sizeof(int);
+        if (!copy_to_user(value_size, &size))
+            return EFAULT;
+        return KSuccess;
+    }
+    default:
+        return ENOPROTOOPT;
+    }
+}
+
 }
@@ -147,10 +147,25 @@ public:
     u32 bytes_in() const { return m_bytes_in; }
     u32 packets_out() const { return m_packets_out; }
     u32 bytes_out() const { return m_bytes_out; }
+    u32 retransmissions() const { return m_retransmissions; }
+
+    u32 congestion_window() const { return m_congestion_window; }
+    u32 slow_start_threshold() const { return m_slow_start_threshold; }
+    u32 smoothed_rtt() const { return m_smoothed_rtt; }
+    u32 rtt_variance() const { return m_rtt_variance; }
+    u32 retransmission_timeout() const { return m_retransmission_timeout; }
+    u32 bytes_in_flight() const { return m_bytes_in_flight; }
+    u32 send_window() const { return m_send_window; }
+    u32 receive_window() const;
+    u32 delayed_acks() const { return m_delayed_acks; }
 
     KResult send_tcp_packet(u16 flags, const UserOrKernelBuffer* = nullptr, size_t = 0);
     void send_outgoing_packets();
+    void retransmit_packets();
+    void send_delayed_ack();
+    void acknowledge_received_data();
     void receive_tcp_packet(const TCPPacket&, u16 size);
+    void process_syn_options(const TCPPacket&);
 
     static Lockable<HashMap<IPv4SocketTuple, TCPSocket*>>& sockets_by_tuple();
     static RefPtr<TCPSocket> from_tuple(const IPv4SocketTuple& tuple);
@@ -165,6 +180,8 @@ public:
     void release_for_accept(RefPtr<TCPSocket>);
 
     virtual KResult close() override;
+    virtual KResult setsockopt(int level, int option, Userspace<const void*>, socklen_t) override;
+    virtual KResult getsockopt(FileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>) override;
 
 protected:
     void set_direction(Direction direction) { m_direction = direction; }
@@ -175,6 +192,16 @@ private:
 
     static NetworkOrdered<u16> compute_tcp_checksum(const IPv4Address& source, const IPv4Address& destination, const TCPPacket&, u16 payload_size);
 
+    struct OutgoingPacket;
+    KResult transmit_packet(OutgoingPacket&);
+    KResult send_segment(u32 sequence_number, u16 flags, ReadonlyBytes payload);
+    size_t write_options(u8* options, u16 flags, u16 mss) const;
+    size_t max_segment_payload_size() const;
+    void update_rtt(u32 rtt_sample);
+    void update_send_window(const TCPPacket&);
+    void restart_retransmission_timer();
+    void handle_ack(u32 ack_number, u16 window_size, size_t payload_size, u16 flags, Optional<u32> timestamp_echo_reply);
+
     virtual void shut_down_for_writing() override;
 
     virtual KResultOr<size_t> protocol_receive(ReadonlyBytes raw_ipv4_packet, UserOrKernelBuffer& buffer, size_t buffer_size, int flags) override;
@@ -182,6 +209,7 @@ private:
     virtual KResult protocol_connect(FileDescription&, ShouldBlock) override;
     virtual int protocol_allocate_local_port() override;
     virtual bool protocol_is_disconnected() const override;
+    virtual void protocol_did_read_received_data() override;
     virtual KResult protocol_bind() override;
     virtual KResult protocol_listen() override;
 
@@ -197,12 +225,52 @@ private:
     u32 m_bytes_in { 0 };
     u32 m_packets_out { 0 };
     u32 m_bytes_out { 0 };
+    u32 m_retransmissions { 0 };
+
+    // All timing values are in milliseconds. See RFC 6298.
+    u32 m_smoothed_rtt { 0 };
+    u32 m_rtt_variance { 0 };
+    u32 m_retransmission_timeout { 1000 };
+    bool m_has_rtt_sample { false };
+    u64 m_retransmission_deadline { 0 };
+
+    // NewReno congestion control. See RFC 5681 and RFC 6582.
+    u32 m_mss { 536 };
+    u32 m_congestion_window { 0 };
+    u32 m_slow_start_threshold { 0xffffffff };
+    u32 m_bytes_in_flight { 0 };
+    u32 m_last_ack_number_received { 0 };
+    u16 m_last_window_size_received { 0 };
+    u32 m_duplicate_ack_count { 0 };
+    bool m_in_fast_recovery { false };
+    u32 m_recovery_point { 0 };
+
+    // Flow control and TCP options. See RFC 793 and RFC 7323.
+    u32 m_peer_mss { 536 };
+    u32 m_send_window { 0xffff };
+    u32 m_send_window_update_sequence_number { 0 };
+    u32 m_send_window_update_ack_number { 0 };
+    u8 m_send_window_scale { 0 };
+    bool m_window_scaling_enabled { false };
+    bool m_timestamps_enabled { false };
+    u32 m_timestamp_recent { 0 };
+    u32 m_advertised_window { 0 };
+    bool m_no_delay { false };
+
+    // Delayed acknowledgments. See RFC 1122, section 4.2.3.2.
+    u32 m_unacknowledged_segments { 0 };
+    u64 m_delayed_ack_deadline { 0 };
+    u32 m_delayed_acks { 0 };
 
     struct OutgoingPacket {
-        u32 ack_number { 0 };
-        ByteBuffer buffer;
+        u32 sequence_number { 0 };
+        u16 flags { 0 };
+        ByteBuffer payload;
         int tx_counter { 0 };
-        timeval tx_time { 0, 0 };
+        u64 tx_time { 0 };
+        u32 sequence_length { 0 };
+
+        u32 end_sequence_number() const { return sequence_number + sequence_length; }
     };
 
     Lock m_not_acked_lock { "TCPSocket unacked packets" };
@@ -113,9 +113,9 @@ bool PerformanceEventBuffer::to_json(KBufferBuilder& builder, ProcessID pid, con
         auto region_array = object.add_array("regions");
         for (const auto& region : process->regions()) {
             auto region_object = region_array.add_object();
-            region_object.add("base", region.vaddr().get());
-            region_object.add("size", region.size());
-            region_object.add("name", region.name());
+            region_object.add("base", region->vaddr().get());
+            region_object.add("size", region->size());
+            region_object.add("name", region->name());
         }
         region_array.finish();
     }
@@ -184,13 +184,11 @@ bool Process::deallocate_region(Region& region)
 
     if (m_region_lookup_cache.region.unsafe_ptr() == &region)
         m_region_lookup_cache.region = nullptr;
-    for (size_t i = 0; i < m_regions.size(); ++i) {
-        if (&m_regions[i] == &region) {
-            region_protector = m_regions.unstable_take(i);
-            return true;
-        }
-    }
-    return false;
+    auto* entry = m_regions.find(region.vaddr().get());
+    if (!entry || entry->ptr() != &region)
+        return false;
+    region_protector = m_regions.take(region.vaddr().get()).release_value();
+    return true;
 }
 
 Region* Process::find_region_from_range(const Range& range)
@@ -200,24 +198,21 @@ Region* Process::find_region_from_range(const Range& range)
         return m_region_lookup_cache.region.unsafe_ptr();
 
     size_t size = PAGE_ROUND_UP(range.size());
-    for (auto& region : m_regions) {
-        if (region.vaddr() == range.base() && region.size() == size) {
-            m_region_lookup_cache.range = range;
-            m_region_lookup_cache.region = region;
-            return &region;
-        }
-    }
-    return nullptr;
+    auto* region = m_regions.find(range.base().get());
+    if (!region || (*region)->size() != size)
+        return nullptr;
+    m_region_lookup_cache.range = range;
+    m_region_lookup_cache.region = **region;
+    return region->ptr();
 }
 
 Region* Process::find_region_containing(const Range& range)
 {
     ScopedSpinLock lock(m_lock);
-    for (auto& region : m_regions) {
-        if (region.contains(range))
-            return &region;
-    }
-    return nullptr;
+    auto* region = m_regions.find_largest_not_above(range.base().get());
+    if (!region || !(*region)->contains(range))
+        return nullptr;
+    return region->ptr();
 }
 
 void Process::kill_threads_except_self()
@@ -375,16 +370,8 @@ void Process::dump_regions()
 
     ScopedSpinLock lock(m_lock);
 
-    Vector<Region*> sorted_regions;
-    sorted_regions.ensure_capacity(m_regions.size());
-    for (auto& region : m_regions)
-        sorted_regions.append(&region);
-    quick_sort(sorted_regions, [](auto& a, auto& b) {
-        return a->vaddr() < b->vaddr();
-    });
-
-    for (auto& sorted_region : sorted_regions) {
-        auto& region = *sorted_region;
+    for (auto& region_ptr : m_regions) {
+        auto& region = *region_ptr;
         klog() << String::format("%08x", region.vaddr().get()) << " -- " << String::format("%08x", region.vaddr().offset(region.size() - 1).get()) << "    " << String::format("%08zx", region.size()) << "    " << (region.is_readable() ? 'R' : ' ') << (region.is_writable() ? 'W' : ' ') << (region.is_executable() ? 'X' : ' ') << (region.is_shared() ? 'S' : ' ') << (region.is_stack() ? 'T' : ' ') << (region.vmobject().is_anonymous() ? 'A' : ' ') << "    " << region.name().characters();
     }
     MM.dump_kernel_regions();
@@ -694,8 +681,8 @@ size_t Process::amount_dirty_private() const
     size_t amount = 0;
     ScopedSpinLock lock(m_lock);
     for (auto& region : m_regions) {
-        if (!region.is_shared())
-            amount += region.amount_dirty();
+        if (!region->is_shared())
+            amount += region->amount_dirty();
     }
     return amount;
 }
@@ -706,8 +693,8 @@ size_t Process::amount_clean_inode() const
     {
         ScopedSpinLock lock(m_lock);
         for (auto& region : m_regions) {
-            if (region.vmobject().is_inode())
-                vmobjects.set(&static_cast<const InodeVMObject&>(region.vmobject()));
+            if (region->vmobject().is_inode())
+                vmobjects.set(&static_cast<const InodeVMObject&>(region->vmobject()));
         }
     }
     size_t amount = 0;
@@ -721,7 +708,7 @@ size_t Process::amount_virtual() const
     size_t amount = 0;
     ScopedSpinLock lock(m_lock);
     for (auto& region : m_regions) {
-        amount += region.size();
+        amount += region->size();
     }
     return amount;
 }
@@ -732,7 +719,7 @@ size_t Process::amount_resident() const
     size_t amount = 0;
     ScopedSpinLock lock(m_lock);
     for (auto& region : m_regions) {
-        amount += region.amount_resident();
+        amount += region->amount_resident();
     }
     return amount;
 }
@@ -746,7 +733,7 @@ size_t Process::amount_shared() const
     size_t amount = 0;
     ScopedSpinLock lock(m_lock);
     for (auto& region : m_regions) {
-        amount += region.amount_shared();
+        amount += region->amount_shared();
     }
     return amount;
 }
@@ -756,8 +743,8 @@ size_t Process::amount_purgeable_volatile() const
     size_t amount = 0;
     ScopedSpinLock lock(m_lock);
     for (auto& region : m_regions) {
-        if (region.vmobject().is_anonymous() && static_cast<const AnonymousVMObject&>(region.vmobject()).is_any_volatile())
-            amount += region.amount_resident();
+        if (region->vmobject().is_anonymous() && static_cast<const AnonymousVMObject&>(region->vmobject()).is_any_volatile())
+            amount += region->amount_resident();
     }
     return amount;
 }
@@ -767,8 +754,8 @@ size_t Process::amount_purgeable_nonvolatile() const
     size_t amount = 0;
     ScopedSpinLock lock(m_lock);
     for (auto& region : m_regions) {
-        if (region.vmobject().is_anonymous() && !static_cast<const AnonymousVMObject&>(region.vmobject()).is_any_volatile())
-            amount += region.amount_resident();
+        if (region->vmobject().is_anonymous() && !static_cast<const AnonymousVMObject&>(region->vmobject()).is_any_volatile())
+            amount += region->amount_resident();
     }
     return amount;
 }
@@ -877,7 +864,7 @@ Region& Process::add_region(NonnullOwnPtr<Region> region)
 {
     auto* ptr = region.ptr();
     ScopedSpinLock lock(m_lock);
-    m_regions.append(move(region));
+    m_regions.insert(ptr->vaddr().get(), move(region));
     return *ptr;
 }
 
@@ -31,6 +31,7 @@
 #include <AK/InlineLinkedList.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/NonnullRefPtrVector.h>
+#include <AK/RedBlackTree.h>
 #include <AK/String.h>
 #include <AK/Userspace.h>
 #include <AK/WeakPtr.h>
@@ -253,6 +254,10 @@ public:
     ssize_t sys$read(int fd, Userspace<u8*>, ssize_t);
     ssize_t sys$write(int fd, const u8*, ssize_t);
     ssize_t sys$writev(int fd, Userspace<const struct iovec*> iov, int iov_count);
+    ssize_t sys$readv(int fd, Userspace<const struct iovec*> iov, int iov_count);
+    ssize_t sys$preadv(Userspace<const Syscall::SC_positional_io_params*>);
+    ssize_t sys$pwritev(Userspace<const Syscall::SC_positional_io_params*>);
+    ssize_t sys$sendfile(Userspace<const Syscall::SC_sendfile_params*>);
     int sys$fstat(int fd, Userspace<stat*>);
     int sys$stat(Userspace<const Syscall::SC_stat_params*>);
     int sys$lseek(int fd, off_t, int whence);
@@ -270,6 +275,9 @@ public:
     int sys$purge(int mode);
     int sys$select(const Syscall::SC_select_params*);
     int sys$poll(Userspace<const Syscall::SC_poll_params*>);
+    int sys$epoll_create(int flags);
+    int sys$epoll_ctl(Userspace<const Syscall::SC_epoll_ctl_params*>);
+    int sys$epoll_wait(Userspace<const Syscall::SC_epoll_wait_params*>);
     ssize_t sys$get_dir_entries(int fd, void*, ssize_t);
     int sys$getcwd(Userspace<char*>, size_t);
     int sys$chdir(Userspace<const char*>, size_t);
@@ -382,7 +390,7 @@ public:
     void set_tty(TTY*);
 
     size_t region_count() const { return m_regions.size(); }
-    const NonnullOwnPtrVector<Region>& regions() const
+    const RedBlackTree<FlatPtr, NonnullOwnPtr<Region>>& regions() const
     {
         ASSERT(m_lock.is_locked());
         return m_regions;
@@ -537,6 +545,7 @@ private:
 
     int do_exec(NonnullRefPtr<FileDescription> main_program_description, Vector<String> arguments, Vector<String> environment, RefPtr<FileDescription> interpreter_description, Thread*& new_main_thread, u32& prev_flags, const Elf32_Ehdr& main_program_header);
     ssize_t do_write(FileDescription&, const UserOrKernelBuffer&, size_t);
+    KResult copy_iovecs_from_user(Vector<iovec, 32>&, Userspace<const struct iovec*>, int iov_count);
 
     KResultOr<RefPtr<FileDescription>> find_elf_interpreter_for_executable(const String& path, const Elf32_Ehdr& elf_header, int nread, size_t file_size);
 
@@ -628,7 +637,8 @@ private:
     Region* find_region_from_range(const Range&);
     Region* find_region_containing(const Range&);
 
-    NonnullOwnPtrVector<Region> m_regions;
+    // Keyed by base address, so the region containing an address can be found in O(log n).
+    RedBlackTree<FlatPtr, NonnullOwnPtr<Region>> m_regions;
     struct RegionLookupCache {
         Optional<Range> range;
         WeakPtr<Region> region;
@@ -51,6 +51,8 @@ public:
     WeakPtr<Thread> m_pending_beneficiary;
     const char* m_pending_donate_reason { nullptr };
     bool m_in_scheduler { true };
+    u32 m_ticks_since_load_balance { 0 };
+    bool m_should_balance_load { false };
 };
 
 RecursiveSpinLock g_scheduler_lock;
@@ -71,15 +73,40 @@ static Process* s_colonel_process;
 struct ThreadReadyQueue {
     IntrusiveList<Thread, &Thread::m_ready_queue_node> thread_list;
 };
-static SpinLock<u8> g_ready_queues_lock;
-static u32 g_ready_queues_mask;
-static constexpr u32 g_ready_queue_buckets = sizeof(g_ready_queues_mask) * 8;
-static ThreadReadyQueue* g_ready_queues; // g_ready_queue_buckets entries
+
+// Every processor has its own set of ready queues, so picking the next thread
+// only has to look at (and lock) the local queues. Idle processors steal work
+// from the busiest processor, and every processor periodically pulls a thread
+// over if its load is noticeably lower than that of the busiest one.
+struct ProcessorReadyQueues {
+    SpinLock<u8> lock;
+    u32 mask { 0 };
+    Atomic<u32> thread_count { 0 };
+    ThreadReadyQueue queues[sizeof(mask) * 8];
+
+    Atomic<u64> migrations_in { 0 };
+    Atomic<u64> migrations_out { 0 };
+    Atomic<u64> steals { 0 };
+
+    void append(u32 processor, Thread&, u32 priority);
+    void remove(Thread&);
+    // Finds the highest priority thread that may run on the given processor.
+    Thread* find_runnable_thread(u32 processor);
+};
+static constexpr u32 g_ready_queue_buckets = sizeof(ProcessorReadyQueues::mask) * 8;
+static constexpr u32 g_max_processors = sizeof(u32) * 8;
+static ProcessorReadyQueues* g_ready_queues; // g_max_processors entries
+
+// Processors that are picking threads from their ready queues.
+static Atomic<u32> s_scheduling_processors_mask { 0 };
+
+// How often (in timer ticks) a processor compares its load against the busiest processor.
+static constexpr u32 load_balance_interval = 25;
 
 static inline u32 thread_priority_to_priority_index(u32 thread_priority)
 {
     // Converts the priority in the range of THREAD_PRIORITY_MIN...THREAD_PRIORITY_MAX
-    // to a index into g_ready_queues where 0 is the highest priority bucket
+    // to a index into the ready queues where 0 is the highest priority bucket
     ASSERT(thread_priority >= THREAD_PRIORITY_MIN && thread_priority <= THREAD_PRIORITY_MAX);
     constexpr u32 thread_priority_count = THREAD_PRIORITY_MAX - THREAD_PRIORITY_MIN + 1;
     static_assert(thread_priority_count > 0);
@@ -88,65 +115,219 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+void ProcessorReadyQueues::append(u32 processor, Thread& thread, u32 priority)
+{
+    ASSERT(lock.is_locked());
+    ASSERT(!thread.m_ready_queue_node.is_in_list());
+    thread.m_runnable_priority = (int)priority;
+    thread.m_runnable_processor = processor;
+    auto& ready_queue = queues[priority];
+    bool was_empty = ready_queue.thread_list.is_empty();
+    ready_queue.thread_list.append(thread);
+    if (was_empty)
+        mask |= (1u << priority);
+    thread_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+}
+
+void ProcessorReadyQueues::remove(Thread& thread)
 {
-    auto affinity_mask = 1u << Processor::current().id();
+    ASSERT(lock.is_locked());
+    auto priority = thread.m_runnable_priority;
+    ASSERT(priority >= 0);
+    ASSERT(mask & (1u << priority));
+    auto& ready_queue = queues[priority];
+    ready_queue.thread_list.remove(thread);
+    thread.m_runnable_priority = -1;
+    if (ready_queue.thread_list.is_empty())
+        mask &= ~(1u << priority);
+    thread_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+}
 
-    ScopedSpinLock lock(g_ready_queues_lock);
-    auto priority_mask = g_ready_queues_mask;
+Thread* ProcessorReadyQueues::find_runnable_thread(u32 processor)
+{
+    ASSERT(lock.is_locked());
+    auto affinity_mask = 1u << processor;
+    auto priority_mask = mask;
     while (priority_mask != 0) {
         auto priority = __builtin_ffsl(priority_mask);
         ASSERT(priority > 0);
-        auto& ready_queue = g_ready_queues[--priority];
+        auto& ready_queue = queues[--priority];
         for (auto& thread : ready_queue.thread_list) {
             ASSERT(thread.m_runnable_priority == (int)priority);
             if (thread.is_active())
                 continue;
+            // Its state changes before it is dequeued, which needs our lock.
+            if (thread.state() != Thread::Runnable)
+                continue;
             if (!(thread.affinity() & affinity_mask))
                 continue;
-            thread.m_runnable_priority = -1;
-            ready_queue.thread_list.remove(thread);
-            if (ready_queue.thread_list.is_empty())
-                g_ready_queues_mask &= ~(1u << priority);
-            // Mark it as active because we are using this thread. This is similar
-            // to comparing it with Processor::current_thread, but when there are
-            // multiple processors there's no easy way to check whether the thread
-            // is actually still needed. This prevents accidental finalization when
-            // a thread is no longer in Running state, but running on another core.
-
-            // We need to mark it active here so that this thread won't be
-            // scheduled on another core if it were to be queued before actually
-            // switching to it.
-            // FIXME: Figure out a better way maybe?
-            thread.set_active(true);
-            return thread;
+            return &thread;
         }
         priority_mask &= ~(1u << priority);
     }
-    return *Processor::current().idle_thread();
+    return nullptr;
+}
+
+static Optional<u32> busiest_processor_other_than(u32 processor)
+{
+    Optional<u32> busiest;
+    u32 busiest_count = 0;
+    auto candidates = s_scheduling_processors_mask.load(AK::MemoryOrder::memory_order_relaxed) & ~(1u << processor);
+    while (candidates != 0) {
+        u32 candidate = __builtin_ffsl(candidates) - 1;
+        candidates &= ~(1u << candidate);
+        auto count = g_ready_queues[candidate].thread_count.load(AK::MemoryOrder::memory_order_relaxed);
+        if (count > busiest_count) {
+            busiest = candidate;
+            busiest_count = count;
+        }
+    }
+    return busiest;
+}
+
+// Moves one thread that may run on the given processor over from the busiest processor.
+// Both queues stay locked while the thread moves, so a concurrent state change always finds
+// it on one of them. Without queue_locally, the thread is handed to the caller to run instead.
+static Thread* migrate_thread_from_busiest_processor(u32 processor, u32 minimum_imbalance, bool queue_locally)
+{
+    auto busiest = busiest_processor_other_than(processor);
+    if (!busiest.has_value())
+        return nullptr;
+
+    auto& local_queues = g_ready_queues[processor];
+    auto& remote_queues = g_ready_queues[busiest.value()];
+    auto local_count = local_queues.thread_count.load(AK::MemoryOrder::memory_order_relaxed);
+    if (remote_queues.thread_count.load(AK::MemoryOrder::memory_order_relaxed) < local_count + minimum_imbalance)
+        return nullptr;
+
+    Thread* thread;
+    {
+        // Always take the lower processor's lock first, so two processors pulling from each other can't deadlock.
+        bool local_first = processor < busiest.value();
+        ScopedSpinLock first_lock(local_first ? local_queues.lock : remote_queues.lock);
+        ScopedSpinLock second_lock(local_first ? remote_queues.lock : local_queues.lock);
+        thread = remote_queues.find_runnable_thread(processor);
+        if (!thread)
+            return nullptr;
+        remote_queues.remove(*thread);
+        if (queue_locally)
+            local_queues.append(processor, *thread, thread_priority_to_priority_index(thread->priority()));
+    }
+
+    remote_queues.migrations_out.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    local_queues.migrations_in.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    dbgln<SCHEDULER_DEBUG>("Scheduler[{}]: Migrating {} from processor {}", processor, *thread, busiest.value());
+    return thread;
+}
+
+// Picks the processor whose ready queue a thread that just became runnable should go to.
+static u32 select_processor_for(const Thread& thread)
+{
+    auto candidates = thread.affinity() & s_scheduling_processors_mask.load(AK::MemoryOrder::memory_order_relaxed);
+    if (candidates == 0) {
+        // Nobody that this thread may run on is scheduling yet, so just park it
+        // on the first processor that it's allowed on.
+        ASSERT(thread.affinity() != 0);
+        return __builtin_ffsl(thread.affinity()) - 1;
+    }
+
+    // Prefer the processor that this thread last ran on, as its caches are probably still warm,
+    // unless it's busy while another processor that the thread may run on is sitting idle.
+    auto last_processor = thread.cpu();
+    bool may_run_on_last_processor = last_processor < g_max_processors && (candidates & (1u << last_processor));
+
+    auto idle_candidates = candidates & Processor::idle_processor_mask();
+    if (idle_candidates != 0) {
+        if (may_run_on_last_processor && (idle_candidates & (1u << last_processor)))
+            return last_processor;
+        return __builtin_ffsl(idle_candidates) - 1;
+    }
+
+    if (may_run_on_last_processor && g_ready_queues[last_processor].thread_count.load(AK::MemoryOrder::memory_order_relaxed) == 0)
+        return last_processor;
+
+    u32 least_loaded = may_run_on_last_processor ? last_processor : __builtin_ffsl(candidates) - 1;
+    u32 least_loaded_count = g_ready_queues[least_loaded].thread_count.load(AK::MemoryOrder::memory_order_relaxed);
+    while (candidates != 0) {
+        u32 candidate = __builtin_ffsl(candidates) - 1;
+        candidates &= ~(1u << candidate);
+        auto count = g_ready_queues[candidate].thread_count.load(AK::MemoryOrder::memory_order_relaxed);
+        if (count < least_loaded_count) {
+            least_loaded = candidate;
+            least_loaded_count = count;
+        }
+    }
+    return least_loaded;
+}
+
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    auto& processor = Processor::current();
+    auto processor_id = processor.id();
+    auto& ready_queues = g_ready_queues[processor_id];
+    auto& scheduler_data = processor.get_scheduler_data();
+
+    if (scheduler_data.m_should_balance_load) {
+        scheduler_data.m_should_balance_load = false;
+        migrate_thread_from_busiest_processor(processor_id, 2, true);
+    }
+
+    Thread* thread;
+    {
+        ScopedSpinLock lock(ready_queues.lock);
+        thread = ready_queues.find_runnable_thread(processor_id);
+        if (thread)
+            ready_queues.remove(*thread);
+    }
+
+    if (!thread) {
+        // Nothing to do here, see if another processor has more work than it can handle.
+        thread = migrate_thread_from_busiest_processor(processor_id, 1, false);
+        if (thread)
+            ready_queues.steals.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    }
+
+    if (!thread)
+        return *processor.idle_thread();
+
+    // Mark it as active because we are using this thread. This is similar
+    // to comparing it with Processor::current_thread, but when there are
+    // multiple processors there's no easy way to check whether the thread
+    // is actually still needed. This prevents accidental finalization when
+    // a thread is no longer in Running state, but running on another core.
+
+    // We need to mark it active here so that this thread won't be
+    // scheduled on another core if it were to be queued before actually
+    // switching to it.
+    // FIXME: Figure out a better way maybe?
+    thread->set_active(true);
+    return *thread;
 }
 
 bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
 {
     if (&thread == Processor::current().idle_thread())
         return true;
-    ScopedSpinLock lock(g_ready_queues_lock);
-    auto priority = thread.m_runnable_priority;
-    if (priority < 0) {
-        ASSERT(!thread.m_ready_queue_node.is_in_list());
-        return false;
-    }
-
     if (check_affinity && !(thread.affinity() & (1 << Processor::current().id())))
         return false;
 
-    ASSERT(g_ready_queues_mask & (1u << priority));
-    auto& ready_queue = g_ready_queues[priority];
-    thread.m_runnable_priority = -1;
-    ready_queue.thread_list.remove(thread);
-    if (ready_queue.thread_list.is_empty())
-        g_ready_queues_mask &= ~(1u << priority);
-    return true;
+    // Processors pick threads without holding the scheduler lock, so the thread may be
+    // taken off its queue (or moved to another one) at any point until we hold its queue's lock.
+    for (;;) {
+        auto processor = thread.m_runnable_processor;
+        auto& ready_queues = g_ready_queues[processor];
+        ScopedSpinLock lock(ready_queues.lock);
+        if (thread.m_runnable_priority < 0)
+            return false;
+        if (thread.m_runnable_processor != processor)
+            continue;
+        ready_queues.remove(thread);
+        if (processor != Processor::current().id()) {
+            ready_queues.migrations_out.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            g_ready_queues[Processor::current().id()].migrations_in.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        }
+        return true;
+    }
 }
 
 void Scheduler::queue_runnable_thread(Thread& thread)
@@ -155,16 +336,30 @@ void Scheduler::queue_runnable_thread(Thread& thread)
     if (&thread == Processor::current().idle_thread())
         return;
     auto priority = thread_priority_to_priority_index(thread.priority());
+    auto processor = select_processor_for(thread);
 
-    ScopedSpinLock lock(g_ready_queues_lock);
-    ASSERT(thread.m_runnable_priority < 0);
-    thread.m_runnable_priority = (int)priority;
-    ASSERT(!thread.m_ready_queue_node.is_in_list());
-    auto& ready_queue = g_ready_queues[priority];
-    bool was_empty = ready_queue.thread_list.is_empty();
-    ready_queue.thread_list.append(thread);
-    if (was_empty)
-        g_ready_queues_mask |= (1u << priority);
+    {
+        auto& ready_queues = g_ready_queues[processor];
+        ScopedSpinLock lock(ready_queues.lock);
+        ASSERT(thread.m_runnable_priority < 0);
+        ready_queues.append(processor, thread, priority);
+    }
+
+    // An idle processor only looks at its queues again once something wakes it up.
+    if (processor != Processor::current().id())
+        Processor::smp_wake_idle_processor(processor);
+}
+
+Scheduler::ProcessorStatistics Scheduler::processor_statistics(u32 processor)
+{
+    ASSERT(processor < g_max_processors);
+    auto& ready_queues = g_ready_queues[processor];
+    ProcessorStatistics statistics;
+    statistics.runnable_threads = ready_queues.thread_count.load(AK::MemoryOrder::memory_order_relaxed);
+    statistics.migrations_in = ready_queues.migrations_in.load(AK::MemoryOrder::memory_order_relaxed);
+    statistics.migrations_out = ready_queues.migrations_out.load(AK::MemoryOrder::memory_order_relaxed);
+    statistics.steals = ready_queues.steals.load(AK::MemoryOrder::memory_order_relaxed);
+    return statistics;
 }
 
 void Scheduler::start()
@@ -178,6 +373,12 @@ void Scheduler::start()
     auto& processor = Processor::current();
     processor.set_scheduler_data(*new SchedulerPerProcessorData());
     ASSERT(processor.is_initialized());
+#if SCHEDULE_ON_ALL_PROCESSORS
+    s_scheduling_processors_mask.fetch_or(1u << processor.get_id(), AK::MemoryOrder::memory_order_release);
+#else
+    if (processor.get_id() == 0)
+        s_scheduling_processors_mask.fetch_or(1u << processor.get_id(), AK::MemoryOrder::memory_order_release);
+#endif
     auto& idle_thread = *processor.idle_thread();
     ASSERT(processor.current_thread() == &idle_thread);
     ASSERT(processor.idle_thread() == &idle_thread);
@@ -212,9 +413,10 @@ bool Scheduler::pick_next()
             scheduler_data.m_in_scheduler = false;
         });
 
-    ScopedSpinLock lock(g_scheduler_lock);
-
-    if (current_thread->should_die() && current_thread->state() == Thread::Running) {
+    auto current_thread_should_die = [&] {
+        return current_thread->should_die() && current_thread->state() == Thread::Running;
+    };
+    if (current_thread_should_die()) {
         // Rather than immediately killing threads, yanking the kernel stack
         // away from them (which can lead to e.g. reference leaks), we always
         // allow Thread::wait_on to return. This allows the kernel stack to
@@ -227,7 +429,10 @@ bool Scheduler::pick_next()
         if constexpr (SCHEDULER_DEBUG)
             dbgln("Scheduler[{}]: Thread {} is dying", Processor::id(), *current_thread);
 
-        current_thread->set_state(Thread::Dying);
+        // Check again now that nobody else can change its state.
+        ScopedSpinLock lock(g_scheduler_lock);
+        if (current_thread_should_die())
+            current_thread->set_state(Thread::Dying);
     }
 
     if constexpr (SCHEDULER_RUNNABLE_DEBUG) {
@@ -257,18 +462,21 @@ bool Scheduler::pick_next()
     }
 
     auto pending_beneficiary = scheduler_data.m_pending_beneficiary.strong_ref();
-    if (pending_beneficiary && dequeue_runnable_thread(*pending_beneficiary, true)) {
-        // The thread we're supposed to donate to still exists and we can
-        const char* reason = scheduler_data.m_pending_donate_reason;
-        scheduler_data.m_pending_beneficiary = nullptr;
-        scheduler_data.m_pending_donate_reason = nullptr;
-
-        // We need to leave our first critical section before switching context,
-        // but since we're still holding the scheduler lock we're still in a critical section
-        critical.leave();
-
-        dbgln<SCHEDULER_DEBUG>("Processing pending donate to {} reason={}", *pending_beneficiary, reason);
-        return donate_to_and_switch(pending_beneficiary.ptr(), reason);
+    if (pending_beneficiary) {
+        ScopedSpinLock lock(g_scheduler_lock);
+        if (dequeue_runnable_thread(*pending_beneficiary, true)) {
+            // The thread we're supposed to donate to still exists and we can
+            const char* reason = scheduler_data.m_pending_donate_reason;
+            scheduler_data.m_pending_beneficiary = nullptr;
+            scheduler_data.m_pending_donate_reason = nullptr;
+
+            // We need to leave our first critical section before switching context,
+            // but since we're still holding the scheduler lock we're still in a critical section
+            critical.leave();
+
+            dbgln<SCHEDULER_DEBUG>("Processing pending donate to {} reason={}", *pending_beneficiary, reason);
+            return donate_to_and_switch(pending_beneficiary.ptr(), reason);
+        }
     }
 
     // Either we're not donating or the beneficiary disappeared.
@@ -276,20 +484,46 @@ bool Scheduler::pick_next()
     scheduler_data.m_pending_beneficiary = nullptr;
     scheduler_data.m_pending_donate_reason = nullptr;
 
-    auto& thread_to_schedule = pull_next_runnable_thread();
+    // Picking the next thread only takes the ready queue locks, so other processors can keep
+    // scheduling while we do it. That also means the thread may have been stopped or killed
+    // by the time we have the scheduler lock, which we still need to switch to it.
+    auto* thread_to_schedule = &pull_next_runnable_thread();
+    ScopedSpinLock lock(g_scheduler_lock);
+    while (!is_still_schedulable(*thread_to_schedule)) {
+        thread_to_schedule->set_active(false);
+        // Whoever killed it couldn't hand it to the finalizer while we had it marked active.
+        if (thread_to_schedule->state() == Thread::Dying)
+            notify_finalizer();
+        lock.unlock();
+        thread_to_schedule = &pull_next_runnable_thread();
+        lock.lock();
+    }
+
     if constexpr (SCHEDULER_DEBUG) {
         dbgln("Scheduler[{}]: Switch to {} @ {:04x}:{:08x}",
             Processor::id(),
-            thread_to_schedule,
-            thread_to_schedule.tss().cs, thread_to_schedule.tss().eip);
+            *thread_to_schedule,
+            thread_to_schedule->tss().cs, thread_to_schedule->tss().eip);
     }
 
     // We need to leave our first critical section before switching context,
     // but since we're still holding the scheduler lock we're still in a critical section
     critical.leave();
 
-    thread_to_schedule.set_ticks_left(time_slice_for(thread_to_schedule));
-    return context_switch(&thread_to_schedule);
+    thread_to_schedule->set_ticks_left(time_slice_for(*thread_to_schedule));
+    return context_switch(thread_to_schedule);
+}
+
+bool Scheduler::is_still_schedulable(Thread& thread)
+{
+    ASSERT(g_scheduler_lock.own_lock());
+    if (&thread == Processor::current().idle_thread())
+        return true;
+    if (thread.state() != Thread::Runnable)
+        return false;
+    // If it was stopped and continued since we took it off its queue, it was queued again.
+    dequeue_runnable_thread(thread);
+    return true;
 }
 
 bool Scheduler::yield()
@@ -494,7 +728,7 @@ void Scheduler::initialize()
 
     RefPtr<Thread> idle_thread;
     g_finalizer_wait_queue = new WaitQueue;
-    g_ready_queues = new ThreadReadyQueue[g_ready_queue_buckets];
+    g_ready_queues = new ProcessorReadyQueues[g_max_processors];
 
     g_finalizer_has_work.store(false, AK::MemoryOrder::memory_order_release);
     s_colonel_process = Process::create_kernel_process(idle_thread, "colonel", idle_loop, nullptr, 1).leak_ref();
@@ -548,6 +782,12 @@ void Scheduler::timer_tick(const RegisterState& regs)
         [[maybe_unused]] auto rc = perf_events.append_with_eip_and_ebp(regs.eip, regs.ebp, PERF_EVENT_SAMPLE, 0, 0);
     }
 
+    auto& scheduler_data = Processor::current().get_scheduler_data();
+    if (++scheduler_data.m_ticks_since_load_balance >= load_balance_interval) {
+        scheduler_data.m_ticks_since_load_balance = 0;
+        scheduler_data.m_should_balance_load = true;
+    }
+
     if (current_thread->tick())
         return;
 
@@ -69,8 +69,17 @@ public:
     static void invoke_async();
     static void notify_finalizer();
     static Thread& pull_next_runnable_thread();
+    static bool is_still_schedulable(Thread&);
     static bool dequeue_runnable_thread(Thread&, bool = false);
     static void queue_runnable_thread(Thread&);
+
+    struct ProcessorStatistics {
+        u32 runnable_threads { 0 };
+        u64 migrations_in { 0 };
+        u64 migrations_out { 0 };
+        u64 steals { 0 };
+    };
+    static ProcessorStatistics processor_statistics(u32 processor);
 };
 
 }
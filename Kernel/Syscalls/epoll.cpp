@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/ScopeGuard.h>
+#include <Kernel/FileSystem/EPoll.h>
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+// Upper bound on the number of events returned by a single epoll_wait() call.
+static constexpr size_t max_epoll_events = 1024;
+
+int Process::sys$epoll_create(int flags)
+{
+    REQUIRE_PROMISE(stdio);
+    if ((flags & O_CLOEXEC) != flags)
+        return -EINVAL;
+
+    int fd = alloc_fd();
+    if (fd < 0)
+        return fd;
+
+    auto description = FileDescription::create(*EPoll::create());
+    if (description.is_error())
+        return description.error();
+
+    u32 fd_flags = (flags & O_CLOEXEC) ? FD_CLOEXEC : 0;
+    m_fds[fd].set(description.release_value(), fd_flags);
+    m_fds[fd].description()->set_readable(true);
+    return fd;
+}
+
+int Process::sys$epoll_ctl(Userspace<const Syscall::SC_epoll_ctl_params*> user_params)
+{
+    REQUIRE_PROMISE(stdio);
+    Syscall::SC_epoll_ctl_params params;
+    if (!copy_from_user(&params, user_params))
+        return -EFAULT;
+
+    auto epoll_description = file_description(params.epfd);
+    if (!epoll_description)
+        return -EBADF;
+    if (!epoll_description->file().is_epoll())
+        return -EINVAL;
+    auto& epoll = static_cast<EPoll&>(epoll_description->file());
+
+    auto description = file_description(params.fd);
+    if (!description)
+        return -EBADF;
+    // FIXME: Support watching an epoll instance from another one.
+    if (description->file().is_epoll())
+        return -EINVAL;
+
+    epoll_event event {};
+    if (params.op != EPOLL_CTL_DEL && !copy_from_user(&event, params.event))
+        return -EFAULT;
+
+    switch (params.op) {
+    case EPOLL_CTL_ADD:
+        return epoll.add(params.fd, *description, event);
+    case EPOLL_CTL_MOD:
+        return epoll.modify(params.fd, *description, event);
+    case EPOLL_CTL_DEL:
+        return epoll.remove(params.fd);
+    default:
+        return -EINVAL;
+    }
+}
+
+int Process::sys$epoll_wait(Userspace<const Syscall::SC_epoll_wait_params*> user_params)
+{
+    REQUIRE_PROMISE(stdio);
+    Syscall::SC_epoll_wait_params params;
+    if (!copy_from_user(&params, user_params))
+        return -EFAULT;
+
+    if (params.maxevents <= 0)
+        return -EINVAL;
+
+    auto epoll_description = file_description(params.epfd);
+    if (!epoll_description)
+        return -EBADF;
+    if (!epoll_description->file().is_epoll())
+        return -EINVAL;
+    auto& epoll = static_cast<EPoll&>(epoll_description->file());
+
+    Thread::BlockTimeout timeout;
+    if (params.timeout) {
+        timespec timeout_copy;
+        if (!copy_from_user(&timeout_copy, params.timeout))
+            return -EFAULT;
+        timeout = Thread::BlockTimeout(false, &timeout_copy);
+    }
+
+    sigset_t sigmask = {};
+    if (params.sigmask && !copy_from_user(&sigmask, params.sigmask))
+        return -EFAULT;
+
+    auto current_thread = Thread::current();
+
+    u32 previous_signal_mask = 0;
+    if (params.sigmask)
+        previous_signal_mask = current_thread->update_signal_mask(sigmask);
+    ScopeGuard rollback_signal_mask([&]() {
+        if (params.sigmask)
+            current_thread->update_signal_mask(previous_signal_mask);
+    });
+
+    Vector<epoll_event> events;
+    events.resize(min((size_t)params.maxevents, max_epoll_events));
+
+    size_t event_count = 0;
+    for (;;) {
+        event_count = epoll.collect_events(*this, events.data(), events.size());
+        if (event_count > 0)
+            break;
+        auto result = current_thread->wait_on(epoll.wait_queue(), timeout);
+        if (result.was_interrupted())
+            return -EINTR;
+        if (result != Thread::BlockResult::WokeNormally) {
+            // Timed out (or the timeout was zero); report whatever became ready in the meantime.
+            event_count = epoll.collect_events(*this, events.data(), events.size());
+            break;
+        }
+    }
+
+    if (event_count > 0 && !copy_to_user(params.events, events.data(), event_count * sizeof(epoll_event)))
+        return -EFAULT;
+    return event_count;
+}
+
+}
@@ -47,7 +47,7 @@
 
 namespace Kernel {
 
-static Vector<ELF::AuxiliaryValue> generate_auxiliary_vector(FlatPtr load_base, FlatPtr entry_eip, uid_t uid, uid_t euid, gid_t gid, gid_t egid, String executable_path, int main_program_fd);
+static Vector<ELF::AuxiliaryValue> generate_auxiliary_vector(FlatPtr load_base, FlatPtr entry_eip, uid_t uid, uid_t euid, gid_t gid, gid_t egid, String executable_path, int main_program_fd, FlatPtr time_page);
 
 static bool validate_stack_size(const Vector<String>& arguments, const Vector<String>& environment)
 {
@@ -315,7 +315,7 @@ KResultOr<Process::LoadResult> Process::load_elf_object(FileDescription& object_
 KResultOr<Process::LoadResult> Process::load(NonnullRefPtr<FileDescription> main_program_description, RefPtr<FileDescription> interpreter_description, const Elf32_Ehdr& main_program_header)
 {
     RefPtr<PageDirectory> old_page_directory;
-    NonnullOwnPtrVector<Region> old_regions;
+    RedBlackTree<FlatPtr, NonnullOwnPtr<Region>> old_regions;
 
     {
         auto page_directory = PageDirectory::create_for_userspace(*this);
@@ -529,6 +529,15 @@ int Process::do_exec(NonnullRefPtr<FileDescription> main_program_description, Ve
     }
     auto& load_result = load_result_or_error.value();
 
+    auto time_page_range = allocate_range({}, PAGE_SIZE);
+    if (!time_page_range.has_value()) {
+        dbgln("do_exec({}): Failed to allocate VM range for time page", path);
+        return ENOMEM;
+    }
+    auto time_page_region_or_error = allocate_region_with_vmobject(time_page_range.value(), TimeManagement::the().time_page_vmobject(), 0, "Time page", PROT_READ, true);
+    if (time_page_region_or_error.is_error())
+        return time_page_region_or_error.error();
+
     // We can commit to the new credentials at this point.
     cred_restore_guard.disarm();
 
@@ -591,7 +600,7 @@ int Process::do_exec(NonnullRefPtr<FileDescription> main_program_description, Ve
     }
     ASSERT(new_main_thread);
 
-    auto auxv = generate_auxiliary_vector(load_result.load_base, load_result.entry_eip, m_uid, m_euid, m_gid, m_egid, path, main_program_fd);
+    auto auxv = generate_auxiliary_vector(load_result.load_base, load_result.entry_eip, m_uid, m_euid, m_gid, m_egid, path, main_program_fd, time_page_region_or_error.value()->vaddr().get());
 
     // NOTE: We create the new stack before disabling interrupts since it will zero-fault
     //       and we don't want to deal with faults after this point.
@@ -647,7 +656,7 @@ int Process::do_exec(NonnullRefPtr<FileDescription> main_program_description, Ve
     return 0;
 }
 
-static Vector<ELF::AuxiliaryValue> generate_auxiliary_vector(FlatPtr load_base, FlatPtr entry_eip, uid_t uid, uid_t euid, gid_t gid, gid_t egid, String executable_path, int main_program_fd)
+static Vector<ELF::AuxiliaryValue> generate_auxiliary_vector(FlatPtr load_base, FlatPtr entry_eip, uid_t uid, uid_t euid, gid_t gid, gid_t egid, String executable_path, int main_program_fd, FlatPtr time_page)
 {
     Vector<ELF::AuxiliaryValue> auxv;
     // PHDR/EXECFD
@@ -681,6 +690,8 @@ static Vector<ELF::AuxiliaryValue> generate_auxiliary_vector(FlatPtr load_base,
 
     auxv.append({ ELF::AuxiliaryValue::ExecFileDescriptor, main_program_fd });
 
+    auxv.append({ ELF::AuxiliaryValue::TimePage, (void*)time_page });
+
     auxv.append({ ELF::AuxiliaryValue::Null, 0L });
     return auxv;
 }
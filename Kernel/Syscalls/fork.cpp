@@ -82,8 +82,8 @@ pid_t Process::sys$fork(RegisterState& regs)
     {
         ScopedSpinLock lock(m_lock);
         for (auto& region : m_regions) {
-            dbgln<FORK_DEBUG>("fork: cloning Region({}) '{}' @ {}", &region, region.name(), region.vaddr());
-            auto region_clone = region.clone(*child);
+            dbgln<FORK_DEBUG>("fork: cloning Region({}) '{}' @ {}", region.ptr(), region->name(), region->vaddr());
+            auto region_clone = region->clone(*child);
             if (!region_clone) {
                 dbgln("fork: Cannot clone region, insufficient memory");
                 // TODO: tear down new process?
@@ -93,7 +93,7 @@ pid_t Process::sys$fork(RegisterState& regs)
             auto& child_region = child->add_region(region_clone.release_nonnull());
             child_region.map(child->page_directory());
 
-            if (&region == m_master_tls_region.unsafe_ptr())
+            if (region.ptr() == m_master_tls_region.unsafe_ptr())
                 child->m_master_tls_region = child_region;
         }
 
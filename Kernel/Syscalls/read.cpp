@@ -64,4 +64,88 @@ ssize_t Process::sys$read(int fd, Userspace<u8*> buffer, ssize_t size)
     return result.value();
 }
 
+ssize_t Process::sys$readv(int fd, Userspace<const struct iovec*> iov, int iov_count)
+{
+    REQUIRE_PROMISE(stdio);
+    Vector<iovec, 32> vecs;
+    if (auto result = copy_iovecs_from_user(vecs, iov, iov_count); result.is_error())
+        return result;
+
+    auto description = file_description(fd);
+    if (!description)
+        return -EBADF;
+    if (!description->is_readable())
+        return -EBADF;
+    if (description->is_directory())
+        return -EISDIR;
+    if (description->is_blocking()) {
+        if (!description->can_read()) {
+            auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+            if (Thread::current()->block<Thread::ReadBlocker>({}, *description, unblock_flags).was_interrupted())
+                return -EINTR;
+            if (!((u32)unblock_flags & (u32)Thread::FileBlocker::BlockFlags::Read))
+                return -EAGAIN;
+        }
+    }
+
+    ssize_t nread = 0;
+    for (auto& vec : vecs) {
+        auto buffer = UserOrKernelBuffer::for_user_buffer((u8*)vec.iov_base, vec.iov_len);
+        if (!buffer.has_value())
+            return -EFAULT;
+        auto result = description->read(buffer.value(), vec.iov_len);
+        if (result.is_error()) {
+            if (nread == 0)
+                return result.error();
+            return nread;
+        }
+        nread += result.value();
+        // Stop at a short read rather than blocking again for the remaining vectors.
+        if (result.value() < vec.iov_len)
+            break;
+    }
+    return nread;
+}
+
+ssize_t Process::sys$preadv(Userspace<const Syscall::SC_positional_io_params*> user_params)
+{
+    REQUIRE_PROMISE(stdio);
+    Syscall::SC_positional_io_params params;
+    if (!copy_from_user(&params, user_params))
+        return -EFAULT;
+    if (params.offset < 0)
+        return -EINVAL;
+
+    Vector<iovec, 32> vecs;
+    if (auto result = copy_iovecs_from_user(vecs, (FlatPtr)params.iov, params.iov_count); result.is_error())
+        return result;
+
+    auto description = file_description(params.fd);
+    if (!description)
+        return -EBADF;
+    if (!description->is_readable())
+        return -EBADF;
+    if (description->is_directory())
+        return -EISDIR;
+    if (!description->file().is_seekable())
+        return -ESPIPE;
+
+    ssize_t nread = 0;
+    for (auto& vec : vecs) {
+        auto buffer = UserOrKernelBuffer::for_user_buffer((u8*)vec.iov_base, vec.iov_len);
+        if (!buffer.has_value())
+            return -EFAULT;
+        auto result = description->read(buffer.value(), params.offset + nread, vec.iov_len);
+        if (result.is_error()) {
+            if (nread == 0)
+                return result.error();
+            return nread;
+        }
+        nread += result.value();
+        if (result.value() < vec.iov_len)
+            break;
+    }
+    return nread;
+}
+
 }
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/KBuffer.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+static constexpr size_t sendfile_chunk_size = 64 * KiB;
+
+ssize_t Process::sys$sendfile(Userspace<const Syscall::SC_sendfile_params*> user_params)
+{
+    REQUIRE_PROMISE(stdio);
+    Syscall::SC_sendfile_params params;
+    if (!copy_from_user(&params, user_params))
+        return -EFAULT;
+
+    auto in_description = file_description(params.in_fd);
+    if (!in_description)
+        return -EBADF;
+    if (!in_description->is_readable())
+        return -EBADF;
+    // FIXME: Support sending from things other than regular files.
+    if (!in_description->file().is_inode() || !in_description->metadata().is_regular_file())
+        return -EINVAL;
+
+    auto out_description = file_description(params.out_fd);
+    if (!out_description)
+        return -EBADF;
+    if (!out_description->is_writable())
+        return -EBADF;
+
+    off_t offset;
+    if (params.offset) {
+        if (!copy_from_user(&offset, params.offset))
+            return -EFAULT;
+        if (offset < 0)
+            return -EINVAL;
+    } else {
+        offset = in_description->offset();
+    }
+
+    size_t count = min(params.count, (size_t)NumericLimits<ssize_t>::max());
+    if (count == 0)
+        return 0;
+
+    // The data takes a single trip through this kernel buffer instead of being copied out to userspace and back.
+    auto& buffer = Thread::current()->sendfile_buffer();
+    if (!buffer) {
+        buffer = KBuffer::try_create_with_size(sendfile_chunk_size, Region::Access::Read | Region::Access::Write, "sendfile");
+        if (!buffer)
+            return -ENOMEM;
+    }
+    auto kernel_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer->data());
+
+    ssize_t total_sent = 0;
+    while ((size_t)total_sent < count) {
+        size_t chunk_size = min(count - total_sent, buffer->capacity());
+        auto nread_or_error = in_description->read(kernel_buffer, offset + total_sent, chunk_size);
+        if (nread_or_error.is_error()) {
+            if (total_sent == 0)
+                return nread_or_error.error();
+            break;
+        }
+        size_t nread = nread_or_error.value();
+        if (nread == 0)
+            break;
+
+        ssize_t nwritten = do_write(*out_description, kernel_buffer, nread);
+        if (nwritten < 0) {
+            if (total_sent == 0)
+                return nwritten;
+            break;
+        }
+        total_sent += nwritten;
+        if ((size_t)nwritten < nread)
+            break;
+    }
+
+    if (params.offset) {
+        off_t new_offset = offset + total_sent;
+        if (!copy_to_user(params.offset, &new_offset))
+            return -EFAULT;
+    } else {
+        in_description->seek(offset + total_sent, SEEK_SET);
+    }
+    return total_sent;
+}
+
+}
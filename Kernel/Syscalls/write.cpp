@@ -31,29 +31,36 @@
 
 namespace Kernel {
 
-ssize_t Process::sys$writev(int fd, Userspace<const struct iovec*> iov, int iov_count)
+KResult Process::copy_iovecs_from_user(Vector<iovec, 32>& vecs, Userspace<const struct iovec*> iov, int iov_count)
 {
-    REQUIRE_PROMISE(stdio);
     if (iov_count < 0)
-        return -EINVAL;
+        return EINVAL;
 
     {
         Checked checked_iov_count = sizeof(iovec);
         checked_iov_count *= iov_count;
         if (checked_iov_count.has_overflow())
-            return -EFAULT;
+            return EFAULT;
     }
 
     u64 total_length = 0;
-    Vector<iovec, 32> vecs;
     vecs.resize(iov_count);
     if (!copy_n_from_user(vecs.data(), iov, iov_count))
-        return -EFAULT;
+        return EFAULT;
     for (auto& vec : vecs) {
         total_length += vec.iov_len;
         if (total_length > NumericLimits<i32>::max())
-            return -EINVAL;
+            return EINVAL;
     }
+    return KSuccess;
+}
+
+ssize_t Process::sys$writev(int fd, Userspace<const struct iovec*> iov, int iov_count)
+{
+    REQUIRE_PROMISE(stdio);
+    Vector<iovec, 32> vecs;
+    if (auto result = copy_iovecs_from_user(vecs, iov, iov_count); result.is_error())
+        return result;
 
     auto description = file_description(fd);
     if (!description)
@@ -79,6 +86,46 @@ ssize_t Process::sys$writev(int fd, Userspace<const struct iovec*> iov, int iov_
     return nwritten;
 }
 
+ssize_t Process::sys$pwritev(Userspace<const Syscall::SC_positional_io_params*> user_params)
+{
+    REQUIRE_PROMISE(stdio);
+    Syscall::SC_positional_io_params params;
+    if (!copy_from_user(&params, user_params))
+        return -EFAULT;
+    if (params.offset < 0)
+        return -EINVAL;
+
+    Vector<iovec, 32> vecs;
+    if (auto result = copy_iovecs_from_user(vecs, (FlatPtr)params.iov, params.iov_count); result.is_error())
+        return result;
+
+    auto description = file_description(params.fd);
+    if (!description)
+        return -EBADF;
+    if (!description->is_writable())
+        return -EBADF;
+    if (!description->file().is_seekable())
+        return -ESPIPE;
+
+    ssize_t nwritten = 0;
+    for (auto& vec : vecs) {
+        auto buffer = UserOrKernelBuffer::for_user_buffer((u8*)vec.iov_base, vec.iov_len);
+        if (!buffer.has_value())
+            return -EFAULT;
+        auto result = description->write(params.offset + nwritten, buffer.value(), vec.iov_len);
+        if (result.is_error()) {
+            if (nwritten == 0)
+                return result.error();
+            return nwritten;
+        }
+        nwritten += result.value();
+        if (result.value() < vec.iov_len)
+            break;
+    }
+
+    return nwritten;
+}
+
 ssize_t Process::do_write(FileDescription& description, const UserOrKernelBuffer& data, size_t data_size)
 {
     ssize_t total_nwritten = 0;
@@ -31,6 +31,7 @@
 #include <Kernel/Arch/i386/CPU.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/KBuffer.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/PerformanceEventBuffer.h>
 #include <Kernel/Process.h>
@@ -935,7 +936,6 @@ void Thread::set_state(State new_state, u8 stop_signal)
 
     if (m_state == Runnable) {
         Scheduler::queue_runnable_thread(*this);
-        Processor::smp_wake_n_idle_processors(1);
     } else if (m_state == Stopped) {
         // We don't want to restore to Running state, only Runnable!
         m_stop_state = previous_state != Running ? previous_state : Runnable;
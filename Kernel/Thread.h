@@ -87,6 +87,7 @@ class Thread
     friend class Process;
     friend class Scheduler;
     friend class ThreadReadyQueue;
+    friend struct ProcessorReadyQueues;
 
     static SpinLock<u8> g_tid_map_lock;
     static HashMap<ThreadID, Thread*>* g_tid_map;
@@ -1015,6 +1016,9 @@ public:
 
     FPUState& fpu_state() { return *m_fpu_state; }
 
+    // Scratch space for sys$sendfile(), kept so that repeated calls don't have to allocate it.
+    OwnPtr<KBuffer>& sendfile_buffer() { return m_sendfile_buffer; }
+
     void set_default_signal_dispositions();
     bool push_value_on_stack(FlatPtr);
 
@@ -1171,6 +1175,7 @@ public:
 private:
     IntrusiveListNode m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    u32 m_runnable_processor { 0 };
 
     friend class WaitQueue;
 
@@ -1254,6 +1259,7 @@ private:
     u32 m_kernel_stack_base { 0 };
     u32 m_kernel_stack_top { 0 };
     OwnPtr<Region> m_kernel_stack_region;
+    OwnPtr<KBuffer> m_sendfile_buffer;
     VirtualAddress m_thread_specific_data;
     SignalActionData m_signal_action_data[32];
     Blocker* m_blocker { nullptr };
@@ -39,6 +39,7 @@
 #include <Kernel/Time/RTC.h>
 #include <Kernel/Time/TimeManagement.h>
 #include <Kernel/TimerQueue.h>
+#include <Kernel/VM/AllocationStrategy.h>
 #include <Kernel/VM/MemoryManager.h>
 
 namespace Kernel {
@@ -92,6 +93,7 @@ void TimeManagement::set_epoch_time(timespec ts)
     InterruptDisabler disabler;
     m_epoch_time = ts;
     m_remaining_epoch_time_adjustment = { 0, 0 };
+    update_time_page();
 }
 
 timespec TimeManagement::monotonic_time(TimePrecision precision) const
@@ -209,6 +211,40 @@ TimeManagement::TimeManagement()
     } else if (!probe_and_set_legacy_hardware_timers()) {
         ASSERT_NOT_REACHED();
     }
+
+    m_time_page_region = MM.allocate_kernel_region(PAGE_SIZE, "Time page", Region::Access::Read | Region::Access::Write, false, AllocationStrategy::AllocateNow);
+    ASSERT(m_time_page_region);
+    auto& time_page = *(TimePage*)m_time_page_region->vaddr().as_ptr();
+    time_page.clock_mask = (1 << CLOCK_REALTIME) | (1 << CLOCK_REALTIME_COARSE) | (1 << CLOCK_MONOTONIC_COARSE);
+    // Without a precise time source, the precise clocks only advance once per tick anyway.
+    if (!m_can_query_precise_time)
+        time_page.clock_mask |= (1 << CLOCK_MONOTONIC) | (1 << CLOCK_MONOTONIC_RAW);
+    update_time_page();
+}
+
+VMObject& TimeManagement::time_page_vmobject()
+{
+    return m_time_page_region->vmobject();
+}
+
+void TimeManagement::update_time_page()
+{
+    if (!m_time_page_region)
+        return;
+    auto& time_page = *(TimePage*)m_time_page_region->vaddr().as_ptr();
+
+    auto update_iteration = AK::atomic_fetch_add(&time_page.update1, 1u, AK::MemoryOrder::memory_order_acquire);
+    // Readers must not see any of the new clock values before the bumped update1.
+    AK::atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+    auto epoch_time = this->epoch_time();
+    auto monotonic_time = this->monotonic_time(TimePrecision::Coarse);
+    for (clockid_t clock_id = 0; clock_id < (clockid_t)TimePage::max_clock_count; ++clock_id) {
+        if (!(time_page.clock_mask & (1 << clock_id)))
+            continue;
+        auto& ts = (clock_id == CLOCK_REALTIME || clock_id == CLOCK_REALTIME_COARSE) ? epoch_time : monotonic_time;
+        time_page.clocks[clock_id] = { ts.tv_sec, ts.tv_nsec };
+    }
+    AK::atomic_store(&time_page.update2, update_iteration + 1, AK::MemoryOrder::memory_order_release);
 }
 
 timeval TimeManagement::now_as_timeval()
@@ -355,6 +391,8 @@ void TimeManagement::increment_time_since_boot_hpet()
     // TODO: Apply m_remaining_epoch_time_adjustment
     timespec_add(m_epoch_time, { (time_t)(delta_ns / 1000000000), (long)(delta_ns % 1000000000) }, m_epoch_time);
     m_update2.store(update_iteration + 1, AK::MemoryOrder::memory_order_release);
+
+    update_time_page();
 }
 
 void TimeManagement::increment_time_since_boot()
@@ -385,6 +423,8 @@ void TimeManagement::increment_time_since_boot()
         m_ticks_this_second = 0;
     }
     m_update2.store(update_iteration + 1, AK::MemoryOrder::memory_order_release);
+
+    update_time_page();
 }
 
 void TimeManagement::system_timer_tick(const RegisterState& regs)
@@ -27,8 +27,11 @@
 #pragma once
 
 #include <AK/NonnullRefPtrVector.h>
+#include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
 #include <AK/Types.h>
+#include <Kernel/API/TimePage.h>
+#include <Kernel/Forward.h>
 #include <Kernel/KResult.h>
 #include <Kernel/UnixTypes.h>
 
@@ -82,6 +85,9 @@ public:
 
     bool can_query_precise_time() const { return m_can_query_precise_time; }
 
+    // The VMObject backing the TimePage that is mapped into every process.
+    VMObject& time_page_vmobject();
+
 private:
     bool probe_and_set_legacy_hardware_timers();
     bool probe_and_set_non_legacy_hardware_timers();
@@ -90,6 +96,7 @@ private:
     NonnullRefPtrVector<HardwareTimerBase> m_hardware_timers;
     void set_system_timer(HardwareTimerBase&);
     static void system_timer_tick(const RegisterState&);
+    void update_time_page();
 
     // Variables between m_update1 and m_update2 are synchronized
     Atomic<u32> m_update1 { 0 };
@@ -104,6 +111,8 @@ private:
 
     RefPtr<HardwareTimerBase> m_system_timer;
     RefPtr<HardwareTimerBase> m_time_keeper_timer;
+
+    OwnPtr<Region> m_time_page_region;
 };
 
 }
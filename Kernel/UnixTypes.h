@@ -481,6 +481,31 @@ struct pollfd {
     short revents;
 };
 
+#define EPOLLIN POLLIN
+#define EPOLLPRI POLLPRI
+#define EPOLLOUT POLLOUT
+#define EPOLLERR POLLERR
+#define EPOLLHUP POLLHUP
+#define EPOLLRDHUP POLLRDHUP
+#define EPOLLONESHOT (1u << 30)
+#define EPOLLET (1u << 31)
+
+#define EPOLL_CTL_ADD 1
+#define EPOLL_CTL_DEL 2
+#define EPOLL_CTL_MOD 3
+
+typedef union epoll_data {
+    void* ptr;
+    int fd;
+    u32 u32_value;
+    u64 u64_value;
+} epoll_data_t;
+
+struct epoll_event {
+    u32 events;
+    epoll_data_t data;
+};
+
 #define AF_MASK 0xff
 #define AF_UNSPEC 0
 #define AF_LOCAL 1
@@ -529,6 +554,8 @@ enum {
 
 #define IP_TTL 2
 
+#define TCP_NODELAY 10
+
 struct ucred {
     pid_t pid;
     uid_t uid;
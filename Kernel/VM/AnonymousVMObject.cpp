@@ -101,8 +101,9 @@ AnonymousVMObject::AnonymousVMObject(size_t size, AllocationStrategy strategy)
 {
     if (strategy == AllocationStrategy::AllocateNow) {
         // Allocate all pages right now. We know we can get all because we committed the amount needed
+        auto pages = MM.allocate_committed_user_physical_pages(page_count(), MemoryManager::ShouldZeroFill::Yes);
         for (size_t i = 0; i < page_count(); ++i)
-            physical_pages()[i] = MM.allocate_committed_user_physical_page(MemoryManager::ShouldZeroFill::Yes);
+            physical_pages()[i] = pages[i];
     } else {
         auto& initial_page = (strategy == AllocationStrategy::Reserve) ? MM.lazy_committed_page() : MM.shared_zero_page();
         for (size_t i = 0; i < page_count(); ++i)
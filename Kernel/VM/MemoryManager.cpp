@@ -34,6 +34,7 @@
 #include <Kernel/Multiboot.h>
 #include <Kernel/Process.h>
 #include <Kernel/StdLib.h>
+#include <Kernel/Tasks/PageZeroingTask.h>
 #include <Kernel/VM/AnonymousVMObject.h>
 #include <Kernel/VM/ContiguousVMObject.h>
 #include <Kernel/VM/MemoryManager.h>
@@ -404,12 +405,10 @@ Region* MemoryManager::kernel_region_from_vaddr(VirtualAddress vaddr)
 Region* MemoryManager::user_region_from_vaddr(Process& process, VirtualAddress vaddr)
 {
     ScopedSpinLock lock(s_mm_lock);
-    // FIXME: Use a binary search tree (maybe red/black?) or some other more appropriate data structure!
-    for (auto& region : process.m_regions) {
-        if (region.contains(vaddr))
-            return &region;
-    }
-    return nullptr;
+    auto* region = process.m_regions.find_largest_not_above(vaddr.get());
+    if (!region || !(*region)->contains(vaddr))
+        return nullptr;
+    return region->ptr();
 }
 
 Region* MemoryManager::find_region_from_vaddr(Process& process, VirtualAddress vaddr)
@@ -543,11 +542,14 @@ OwnPtr<Region> MemoryManager::allocate_kernel_region_with_vmobject(VMObject& vmo
 bool MemoryManager::commit_user_physical_pages(size_t page_count)
 {
     ASSERT(page_count > 0);
-    ScopedSpinLock lock(s_mm_lock);
-    if (m_user_physical_pages_uncommitted < page_count)
-        return false;
+    // Page allocations claim uncommitted pages without holding s_mm_lock,
+    // so we have to do the same here.
+    auto uncommitted = m_user_physical_pages_uncommitted.load();
+    do {
+        if (uncommitted < page_count)
+            return false;
+    } while (!m_user_physical_pages_uncommitted.compare_exchange_strong(uncommitted, uncommitted - page_count));
 
-    m_user_physical_pages_uncommitted -= page_count;
     m_user_physical_pages_committed += page_count;
     return true;
 }
@@ -555,78 +557,243 @@ bool MemoryManager::commit_user_physical_pages(size_t page_count)
 void MemoryManager::uncommit_user_physical_pages(size_t page_count)
 {
     ASSERT(page_count > 0);
-    ScopedSpinLock lock(s_mm_lock);
     ASSERT(m_user_physical_pages_committed >= page_count);
 
-    m_user_physical_pages_uncommitted += page_count;
     m_user_physical_pages_committed -= page_count;
+    m_user_physical_pages_uncommitted += page_count;
 }
 
 void MemoryManager::deallocate_user_physical_page(const PhysicalPage& page)
+{
+    PhysicalAddress overflow[page_cache_batch_size];
+    size_t overflow_count = 0;
+    {
+        InterruptDisabler disabler;
+        auto& mm_data = get_data();
+        {
+            ScopedSpinLock lock(mm_data.m_page_cache_lock);
+            if (mm_data.m_page_cache_count == MemoryManagerData::page_cache_size) {
+                // Hand the oldest half of our cache back to the physical regions,
+                // keeping the most recently freed (and likely cache-hot) pages.
+                overflow_count = page_cache_batch_size;
+                memcpy(overflow, mm_data.m_page_cache, overflow_count * sizeof(PhysicalAddress));
+                mm_data.m_page_cache_count -= overflow_count;
+                memmove(mm_data.m_page_cache, mm_data.m_page_cache + overflow_count, mm_data.m_page_cache_count * sizeof(PhysicalAddress));
+            }
+            mm_data.m_page_cache[mm_data.m_page_cache_count++] = page.paddr();
+        }
+        if (overflow_count)
+            return_free_user_pages_to_regions(overflow, overflow_count);
+    }
+
+    --m_user_physical_pages_used;
+
+    // Always return pages to the uncommitted pool. Pages that were
+    // committed and allocated are only freed upon request. Once
+    // returned there is no guarantee being able to get them back.
+    ++m_user_physical_pages_uncommitted;
+}
+
+size_t MemoryManager::take_free_user_pages_from_regions(PhysicalAddress* pages, size_t count)
 {
     ScopedSpinLock lock(s_mm_lock);
+    size_t taken = 0;
     for (auto& region : m_user_physical_regions) {
-        if (!region.contains(page))
-            continue;
+        taken += region.take_free_pages(pages + taken, count - taken);
+        if (taken == count)
+            break;
+    }
+    return taken;
+}
 
-        region.return_page(page);
-        --m_user_physical_pages_used;
+void MemoryManager::return_free_user_pages_to_regions(const PhysicalAddress* pages, size_t count)
+{
+    ScopedSpinLock lock(s_mm_lock);
+    for (size_t i = 0; i < count; ++i) {
+        bool returned = false;
+        for (auto& region : m_user_physical_regions) {
+            if (!region.contains(pages[i]))
+                continue;
+            region.return_page(pages[i]);
+            returned = true;
+            break;
+        }
+        if (!returned) {
+            klog() << "MM: deallocate_user_physical_page couldn't figure out region for user page @ " << pages[i];
+            ASSERT_NOT_REACHED();
+        }
+    }
+}
 
-        // Always return pages to the uncommitted pool. Pages that were
-        // committed and allocated are only freed upon request. Once
-        // returned there is no guarantee being able to get them back.
-        ++m_user_physical_pages_uncommitted;
-        return;
+Optional<PhysicalAddress> MemoryManager::take_free_user_page()
+{
+    InterruptDisabler disabler;
+    auto& mm_data = get_data();
+    {
+        ScopedSpinLock lock(mm_data.m_page_cache_lock);
+        if (mm_data.m_page_cache_count > 0)
+            return mm_data.m_page_cache[--mm_data.m_page_cache_count];
     }
 
-    klog() << "MM: deallocate_user_physical_page couldn't figure out region for user page @ " << page.paddr();
-    ASSERT_NOT_REACHED();
+    // Our cache is empty, refill it from the physical regions in one go.
+    PhysicalAddress pages[page_cache_batch_size];
+    size_t count = take_free_user_pages_from_regions(pages, page_cache_batch_size);
+    if (count > 0) {
+        ScopedSpinLock lock(mm_data.m_page_cache_lock);
+        for (size_t i = 1; i < count; ++i)
+            mm_data.m_page_cache[mm_data.m_page_cache_count++] = pages[i];
+        return pages[0];
+    }
+
+    // The physical regions have run dry, so any remaining free pages are sitting
+    // in another processor's cache or in the zeroed page pool.
+    Optional<PhysicalAddress> stolen_page;
+    Processor::for_each([&](Processor& processor) {
+        auto& other_mm_data = processor.get_mm_data();
+        ScopedSpinLock lock(other_mm_data.m_page_cache_lock);
+        if (other_mm_data.m_page_cache_count == 0)
+            return IterationDecision::Continue;
+        stolen_page = other_mm_data.m_page_cache[--other_mm_data.m_page_cache_count];
+        return IterationDecision::Break;
+    });
+    if (stolen_page.has_value())
+        return stolen_page;
+    return take_zeroed_user_page();
 }
 
-RefPtr<PhysicalPage> MemoryManager::find_free_user_physical_page(bool committed)
+Optional<PhysicalAddress> MemoryManager::take_zeroed_user_page()
+{
+    Optional<PhysicalAddress> page;
+    {
+        ScopedSpinLock lock(m_zeroed_pages_lock);
+        if (m_zeroed_page_count > 0)
+            page = m_zeroed_pages[--m_zeroed_page_count];
+    }
+    if (m_zeroed_page_count < zeroed_page_pool_low_watermark)
+        PageZeroingTask::wake();
+    return page;
+}
+
+void MemoryManager::fill_zeroed_page_pool()
+{
+    while (m_zeroed_page_count < zeroed_page_pool_size) {
+        // Nobody else can get at the page while we're zeroing it, so don't
+        // get preempted while holding on to it.
+        InterruptDisabler disabler;
+        PhysicalAddress paddr;
+        if (!take_free_user_pages_from_regions(&paddr, 1))
+            return;
+        zero_page(paddr);
+
+        ScopedSpinLock lock(m_zeroed_pages_lock);
+        ASSERT(m_zeroed_page_count < zeroed_page_pool_size);
+        m_zeroed_pages[m_zeroed_page_count++] = paddr;
+    }
+}
+
+void MemoryManager::zero_page(PhysicalAddress paddr)
+{
+    InterruptDisabler disabler;
+    auto* ptr = quickmap_page(paddr);
+    memset(ptr, 0, PAGE_SIZE);
+    unquickmap_page();
+}
+
+RefPtr<PhysicalPage> MemoryManager::find_free_user_physical_page(bool committed, ShouldZeroFill should_zero_fill)
 {
-    ASSERT(s_mm_lock.is_locked());
-    RefPtr<PhysicalPage> page;
     if (committed) {
         // Draw from the committed pages pool. We should always have these pages available
         ASSERT(m_user_physical_pages_committed > 0);
         m_user_physical_pages_committed--;
     } else {
         // We need to make sure we don't touch pages that we have committed to
-        if (m_user_physical_pages_uncommitted == 0)
-            return {};
-        m_user_physical_pages_uncommitted--;
+        auto uncommitted = m_user_physical_pages_uncommitted.load();
+        do {
+            if (uncommitted == 0)
+                return {};
+        } while (!m_user_physical_pages_uncommitted.compare_exchange_strong(uncommitted, uncommitted - 1));
     }
-    for (auto& region : m_user_physical_regions) {
-        page = region.take_free_page(false);
-        if (!page.is_null()) {
-            ++m_user_physical_pages_used;
-            break;
-        }
+
+    Optional<PhysicalAddress> paddr;
+    bool needs_zeroing = should_zero_fill == ShouldZeroFill::Yes;
+    if (needs_zeroing) {
+        paddr = take_zeroed_user_page();
+        needs_zeroing = !paddr.has_value();
     }
-    ASSERT(!committed || !page.is_null());
-    return page;
+
+    if (!paddr.has_value())
+        paddr = take_accounted_free_user_page();
+    if (!paddr.has_value()) {
+        if (committed)
+            m_user_physical_pages_committed++;
+        else
+            m_user_physical_pages_uncommitted++;
+        return {};
+    }
+
+    ++m_user_physical_pages_used;
+    if (needs_zeroing)
+        zero_page(paddr.value());
+    return PhysicalPage::create(paddr.value(), false);
 }
 
-NonnullRefPtr<PhysicalPage> MemoryManager::allocate_committed_user_physical_page(ShouldZeroFill should_zero_fill)
+Optional<PhysicalAddress> MemoryManager::take_accounted_free_user_page()
 {
-    ScopedSpinLock lock(s_mm_lock);
-    auto page = find_free_user_physical_page(true);
-    if (should_zero_fill == ShouldZeroFill::Yes) {
-        auto* ptr = quickmap_page(*page);
-        memset(ptr, 0, PAGE_SIZE);
-        unquickmap_page();
+    // The page has been accounted for, so there is a free one somewhere, but it may briefly
+    // be in flight on another processor. Give it a few chances to land rather than spinning
+    // on it indefinitely.
+    for (size_t attempt = 0; attempt < max_free_user_page_attempts; ++attempt) {
+        if (auto paddr = take_free_user_page(); paddr.has_value())
+            return paddr;
+        Processor::wait_check();
     }
+    klog() << "MM: Couldn't find a free user physical page that was accounted for";
+    return {};
+}
+
+NonnullRefPtr<PhysicalPage> MemoryManager::allocate_committed_user_physical_page(ShouldZeroFill should_zero_fill)
+{
+    auto page = find_free_user_physical_page(true, should_zero_fill);
+    ASSERT(page);
     return page.release_nonnull();
 }
 
+NonnullRefPtrVector<PhysicalPage> MemoryManager::allocate_committed_user_physical_pages(size_t count, ShouldZeroFill should_zero_fill)
+{
+    ASSERT(m_user_physical_pages_committed >= count);
+    m_user_physical_pages_committed -= count;
+
+    NonnullRefPtrVector<PhysicalPage> physical_pages;
+    physical_pages.ensure_capacity(count);
+
+    PhysicalAddress batch[page_cache_batch_size];
+    while (physical_pages.size() < count) {
+        // Take pages from the physical regions in batches, rather than locking them once per page.
+        size_t batch_count = take_free_user_pages_from_regions(batch, min(count - physical_pages.size(), page_cache_batch_size));
+        if (batch_count == 0) {
+            auto paddr = take_accounted_free_user_page();
+            ASSERT(paddr.has_value());
+            batch[0] = paddr.value();
+            batch_count = 1;
+        }
+
+        m_user_physical_pages_used += batch_count;
+        for (size_t i = 0; i < batch_count; ++i) {
+            if (should_zero_fill == ShouldZeroFill::Yes)
+                zero_page(batch[i]);
+            physical_pages.append(PhysicalPage::create(batch[i], false));
+        }
+    }
+    return physical_pages;
+}
+
 RefPtr<PhysicalPage> MemoryManager::allocate_user_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge)
 {
-    ScopedSpinLock lock(s_mm_lock);
-    auto page = find_free_user_physical_page(false);
+    auto page = find_free_user_physical_page(false, should_zero_fill);
     bool purged_pages = false;
 
     if (!page) {
+        ScopedSpinLock lock(s_mm_lock);
         // We didn't have a single free physical page. Let's try to free something up!
         // First, we look for a purgeable VMObject in the volatile state.
         for_each_vmobject([&](auto& vmobject) {
@@ -635,7 +802,7 @@ RefPtr<PhysicalPage> MemoryManager::allocate_user_physical_page(ShouldZeroFill s
             int purged_page_count = static_cast<AnonymousVMObject&>(vmobject).purge_with_interrupts_disabled({});
             if (purged_page_count) {
                 klog() << "MM: Purge saved the day! Purged " << purged_page_count << " pages from AnonymousVMObject{" << &vmobject << "}";
-                page = find_free_user_physical_page(false);
+                page = find_free_user_physical_page(false, should_zero_fill);
                 purged_pages = true;
                 ASSERT(page);
                 return IterationDecision::Break;
@@ -649,12 +816,6 @@ RefPtr<PhysicalPage> MemoryManager::allocate_user_physical_page(ShouldZeroFill s
         }
     }
 
-    if (should_zero_fill == ShouldZeroFill::Yes) {
-        auto* ptr = quickmap_page(*page);
-        memset(ptr, 0, PAGE_SIZE);
-        unquickmap_page();
-    }
-
     if (did_purge)
         *did_purge = purged_pages;
     return page;
@@ -806,19 +967,20 @@ PageTableEntry* MemoryManager::quickmap_pt(PhysicalAddress pt_paddr)
     return (PageTableEntry*)0xffe00000;
 }
 
-u8* MemoryManager::quickmap_page(PhysicalPage& physical_page)
+u8* MemoryManager::quickmap_page(PhysicalAddress paddr)
 {
     ASSERT_INTERRUPTS_DISABLED();
+    // Each processor has its own quickmap slot, so m_quickmap_in_use is all
+    // the locking we need here. This lets us zero pages without s_mm_lock.
     auto& mm_data = get_data();
     mm_data.m_quickmap_prev_flags = mm_data.m_quickmap_in_use.lock();
-    ScopedSpinLock lock(s_mm_lock);
 
     u32 pte_idx = 8 + Processor::id();
     VirtualAddress vaddr(0xffe00000 + pte_idx * PAGE_SIZE);
 
     auto& pte = boot_pd3_pt1023[pte_idx];
-    if (pte.physical_page_base() != physical_page.paddr().as_ptr()) {
-        pte.set_physical_page_base(physical_page.paddr().get());
+    if (pte.physical_page_base() != paddr.as_ptr()) {
+        pte.set_physical_page_base(paddr.get());
         pte.set_present(true);
         pte.set_writable(true);
         pte.set_user_allowed(false);
@@ -830,7 +992,6 @@ u8* MemoryManager::quickmap_page(PhysicalPage& physical_page)
 void MemoryManager::unquickmap_page()
 {
     ASSERT_INTERRUPTS_DISABLED();
-    ScopedSpinLock lock(s_mm_lock);
     auto& mm_data = get_data();
     ASSERT(mm_data.m_quickmap_in_use.is_locked());
     u32 pte_idx = 8 + Processor::id();
@@ -110,11 +110,21 @@ const LogStream& operator<<(const LogStream& stream, const UsedMemoryRange& valu
 #define MM Kernel::MemoryManager::the()
 
 struct MemoryManagerData {
+    static constexpr size_t page_cache_size = 64;
+
     SpinLock<u8> m_quickmap_in_use;
     u32 m_quickmap_prev_flags;
 
     PhysicalAddress m_last_quickmap_pd;
     PhysicalAddress m_last_quickmap_pt;
+
+    // Free user physical pages owned by this processor, so that most page
+    // allocations and deallocations don't need to take s_mm_lock.
+    // Other processors only ever take pages from here once the physical
+    // regions have run dry.
+    SpinLock<u8> m_page_cache_lock;
+    PhysicalAddress m_page_cache[page_cache_size];
+    size_t m_page_cache_count { 0 };
 };
 
 extern RecursiveSpinLock s_mm_lock;
@@ -155,6 +165,7 @@ public:
     bool commit_user_physical_pages(size_t);
     void uncommit_user_physical_pages(size_t);
     NonnullRefPtr<PhysicalPage> allocate_committed_user_physical_page(ShouldZeroFill = ShouldZeroFill::Yes);
+    NonnullRefPtrVector<PhysicalPage> allocate_committed_user_physical_pages(size_t count, ShouldZeroFill = ShouldZeroFill::Yes);
     RefPtr<PhysicalPage> allocate_user_physical_page(ShouldZeroFill = ShouldZeroFill::Yes, bool* did_purge = nullptr);
     RefPtr<PhysicalPage> allocate_supervisor_physical_page();
     NonnullRefPtrVector<PhysicalPage> allocate_contiguous_supervisor_physical_pages(size_t size, size_t physical_alignment = PAGE_SIZE);
@@ -173,6 +184,7 @@ public:
     unsigned user_physical_pages_used() const { return m_user_physical_pages_used; }
     unsigned user_physical_pages_committed() const { return m_user_physical_pages_committed; }
     unsigned user_physical_pages_uncommitted() const { return m_user_physical_pages_uncommitted; }
+    unsigned user_physical_pages_zeroed() const { return m_zeroed_page_count; }
     unsigned super_physical_pages() const { return m_super_physical_pages; }
     unsigned super_physical_pages_used() const { return m_super_physical_pages_used; }
 
@@ -206,10 +218,18 @@ public:
 
     PageDirectory& kernel_page_directory() { return *m_kernel_page_directory; }
 
+    // Called by the PageZeroingTask to top up the pool of pre-zeroed pages.
+    void fill_zeroed_page_pool();
+
     const Vector<UsedMemoryRange>& used_memory_ranges() { return m_used_memory_ranges; }
     bool is_allowed_to_mmap_to_userspace(PhysicalAddress, const Range&) const;
 
 private:
+    static constexpr size_t page_cache_batch_size = MemoryManagerData::page_cache_size / 2;
+    static constexpr size_t zeroed_page_pool_size = 256;
+    static constexpr size_t zeroed_page_pool_low_watermark = zeroed_page_pool_size / 4;
+    static constexpr size_t max_free_user_page_attempts = 1000;
+
     MemoryManager();
     ~MemoryManager();
 
@@ -238,8 +258,16 @@ private:
 
     static Region* find_region_from_vaddr(VirtualAddress);
 
-    RefPtr<PhysicalPage> find_free_user_physical_page(bool);
-    u8* quickmap_page(PhysicalPage&);
+    RefPtr<PhysicalPage> find_free_user_physical_page(bool committed, ShouldZeroFill);
+    Optional<PhysicalAddress> take_free_user_page();
+    Optional<PhysicalAddress> take_accounted_free_user_page();
+    Optional<PhysicalAddress> take_zeroed_user_page();
+    size_t take_free_user_pages_from_regions(PhysicalAddress*, size_t count);
+    void return_free_user_pages_to_regions(const PhysicalAddress*, size_t count);
+    void zero_page(PhysicalAddress);
+
+    u8* quickmap_page(PhysicalAddress);
+    u8* quickmap_page(PhysicalPage& physical_page) { return quickmap_page(physical_page.paddr()); }
     void unquickmap_page();
 
     PageDirectoryEntry* quickmap_pd(PageDirectory&, size_t pdpt_index);
@@ -265,6 +293,12 @@ private:
     NonnullRefPtrVector<PhysicalRegion> m_user_physical_regions;
     NonnullRefPtrVector<PhysicalRegion> m_super_physical_regions;
 
+    // Free user pages that have already been zeroed in the background.
+    SpinLock<u8> m_zeroed_pages_lock;
+    PhysicalAddress m_zeroed_pages[zeroed_page_pool_size];
+    Atomic<unsigned, AK::MemoryOrder::memory_order_relaxed> m_zeroed_page_count { 0 };
+
+
     InlineLinkedList<Region> m_user_regions;
     InlineLinkedList<Region> m_kernel_regions;
     Vector<UsedMemoryRange> m_used_memory_ranges;
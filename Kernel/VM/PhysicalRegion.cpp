@@ -155,6 +155,20 @@ RefPtr<PhysicalPage> PhysicalRegion::take_free_page(bool supervisor)
     return PhysicalPage::create(m_lower.offset(free_index.value() * PAGE_SIZE), supervisor);
 }
 
+size_t PhysicalRegion::take_free_pages(PhysicalAddress* pages, size_t count)
+{
+    ASSERT(m_pages);
+
+    size_t taken = 0;
+    while (taken < count) {
+        auto free_index = find_one_free_page();
+        if (!free_index.has_value())
+            break;
+        pages[taken++] = m_lower.offset(free_index.value() * PAGE_SIZE);
+    }
+    return taken;
+}
+
 void PhysicalRegion::free_page_at(PhysicalAddress addr)
 {
     ASSERT(m_pages);
@@ -174,7 +188,7 @@ void PhysicalRegion::free_page_at(PhysicalAddress addr)
     m_used--;
 }
 
-void PhysicalRegion::return_page(const PhysicalPage& page)
+void PhysicalRegion::return_page(PhysicalAddress paddr)
 {
     auto returned_count = m_recently_returned.size();
     if (returned_count >= m_recently_returned.capacity()) {
@@ -182,10 +196,10 @@ void PhysicalRegion::return_page(const PhysicalPage& page)
         // and replace the entry with this page
         auto& entry = m_recently_returned[get_fast_random<u8>()];
         free_page_at(entry);
-        entry = page.paddr();
+        entry = paddr;
     } else {
         // Still filling the return queue, just append it
-        m_recently_returned.append(page.paddr());
+        m_recently_returned.append(paddr);
     }
 }
 
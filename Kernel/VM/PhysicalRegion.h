@@ -49,11 +49,14 @@ public:
     unsigned size() const { return m_pages; }
     unsigned used() const { return m_used - m_recently_returned.size(); }
     unsigned free() const { return m_pages - m_used + m_recently_returned.size(); }
-    bool contains(const PhysicalPage& page) const { return page.paddr() >= m_lower && page.paddr() <= m_upper; }
+    bool contains(PhysicalAddress paddr) const { return paddr >= m_lower && paddr <= m_upper; }
+    bool contains(const PhysicalPage& page) const { return contains(page.paddr()); }
 
     RefPtr<PhysicalPage> take_free_page(bool supervisor);
+    size_t take_free_pages(PhysicalAddress* pages, size_t count);
     NonnullRefPtrVector<PhysicalPage> take_contiguous_free_pages(size_t count, bool supervisor, size_t physical_alignment = PAGE_SIZE);
-    void return_page(const PhysicalPage& page);
+    void return_page(PhysicalAddress);
+    void return_page(const PhysicalPage& page) { return_page(page.paddr()); }
 
 private:
     unsigned find_contiguous_free_pages(size_t count, size_t physical_alignment = PAGE_SIZE);
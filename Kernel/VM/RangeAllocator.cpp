@@ -24,7 +24,6 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <AK/BinarySearch.h>
 #include <AK/Checked.h>
 #include <AK/QuickSort.h>
 #include <Kernel/Debug.h>
@@ -44,7 +43,7 @@ RangeAllocator::RangeAllocator()
 void RangeAllocator::initialize_with_range(VirtualAddress base, size_t size)
 {
     m_total_range = { base, size };
-    m_available_ranges.append({ base, size });
+    m_available_ranges.insert(base.get(), Range(base, size));
 }
 
 void RangeAllocator::initialize_from_parent(const RangeAllocator& parent_allocator)
@@ -81,16 +80,19 @@ Vector<Range, 2> Range::carve(const Range& taken)
     return parts;
 }
 
-void RangeAllocator::carve_at_index(int index, const Range& range)
+void RangeAllocator::carve_from(const Range& available_range, const Range& range)
 {
     ASSERT(m_lock.is_locked());
-    auto remaining_parts = m_available_ranges[index].carve(range);
-    ASSERT(remaining_parts.size() >= 1);
-    ASSERT(m_total_range.contains(remaining_parts[0]));
-    m_available_ranges[index] = remaining_parts[0];
-    if (remaining_parts.size() == 2) {
-        ASSERT(m_total_range.contains(remaining_parts[1]));
-        m_available_ranges.insert(index + 1, move(remaining_parts[1]));
+    Range original_range = available_range;
+    auto remaining_parts = original_range.carve(range);
+    if (remaining_parts.is_empty() || remaining_parts[0].base() != original_range.base())
+        m_available_ranges.remove(original_range.base().get());
+    for (auto& part : remaining_parts) {
+        ASSERT(m_total_range.contains(part));
+        if (auto* existing_range = m_available_ranges.find(part.base().get()))
+            *existing_range = part;
+        else
+            m_available_ranges.insert(part.base().get(), Range(part));
     }
 }
 
@@ -143,8 +145,7 @@ Optional<Range> RangeAllocator::allocate_anywhere(size_t size, size_t alignment)
         return {};
 
     ScopedSpinLock lock(m_lock);
-    for (size_t i = 0; i < m_available_ranges.size(); ++i) {
-        auto& available_range = m_available_ranges[i];
+    for (auto& available_range : m_available_ranges) {
         // FIXME: This check is probably excluding some valid candidates when using a large alignment.
         if (available_range.size() < (effective_size + alignment))
             continue;
@@ -155,11 +156,7 @@ Optional<Range> RangeAllocator::allocate_anywhere(size_t size, size_t alignment)
         Range allocated_range(VirtualAddress(aligned_base), size);
         ASSERT(m_total_range.contains(allocated_range));
 
-        if (available_range == allocated_range) {
-            m_available_ranges.remove(i);
-            return allocated_range;
-        }
-        carve_at_index(i, allocated_range);
+        carve_from(available_range, allocated_range);
         return allocated_range;
     }
     klog() << "RangeAllocator: Failed to allocate anywhere: " << size << ", " << alignment;
@@ -176,19 +173,12 @@ Optional<Range> RangeAllocator::allocate_specific(VirtualAddress base, size_t si
 
     Range allocated_range(base, size);
     ScopedSpinLock lock(m_lock);
-    for (size_t i = 0; i < m_available_ranges.size(); ++i) {
-        auto& available_range = m_available_ranges[i];
-        ASSERT(m_total_range.contains(allocated_range));
-        if (!available_range.contains(base, size))
-            continue;
-        if (available_range == allocated_range) {
-            m_available_ranges.remove(i);
-            return allocated_range;
-        }
-        carve_at_index(i, allocated_range);
-        return allocated_range;
-    }
-    return {};
+    ASSERT(m_total_range.contains(allocated_range));
+    auto* available_range = m_available_ranges.find_largest_not_above(base.get());
+    if (!available_range || !available_range->contains(base, size))
+        return {};
+    carve_from(*available_range, allocated_range);
+    return allocated_range;
 }
 
 void RangeAllocator::deallocate(const Range& range)
@@ -198,37 +188,23 @@ void RangeAllocator::deallocate(const Range& range)
     ASSERT(range.size());
     ASSERT((range.size() % PAGE_SIZE) == 0);
     ASSERT(range.base() < range.end());
-    ASSERT(!m_available_ranges.is_empty());
-
-    size_t nearby_index = 0;
-    auto* existing_range = binary_search(
-        m_available_ranges.span(),
-        range,
-        &nearby_index,
-        [](auto& a, auto& b) { return a.base().get() - b.end().get(); });
-
-    size_t inserted_index = 0;
-    if (existing_range) {
-        existing_range->m_size += range.size();
-        inserted_index = nearby_index;
-    } else {
-        m_available_ranges.insert_before_matching(
-            Range(range), [&](auto& entry) {
-                return entry.base() >= range.end();
-            },
-            nearby_index, &inserted_index);
-    }
 
-    if (inserted_index < (m_available_ranges.size() - 1)) {
-        // We already merged with previous. Try to merge with next.
-        auto& inserted_range = m_available_ranges[inserted_index];
-        auto& next_range = m_available_ranges[inserted_index + 1];
-        if (inserted_range.end() == next_range.base()) {
-            inserted_range.m_size += next_range.size();
-            m_available_ranges.remove(inserted_index + 1);
+    // Merge with the free ranges directly before and after this one, if any.
+    auto following_range = m_available_ranges.take(range.end().get());
+    size_t following_size = following_range.has_value() ? following_range.value().size() : 0;
+
+    auto* preceding_range = m_available_ranges.find_largest_not_above(range.base().get());
+    if (preceding_range) {
+        ASSERT(preceding_range->end() <= range.base());
+        if (preceding_range->end() == range.base()) {
+            preceding_range->m_size += range.size() + following_size;
             return;
         }
     }
+
+    Range merged_range = range;
+    merged_range.m_size += following_size;
+    m_available_ranges.insert(merged_range.base().get(), move(merged_range));
 }
 
 }
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <AK/RedBlackTree.h>
 #include <AK/String.h>
 #include <AK/Traits.h>
 #include <AK/Vector.h>
@@ -99,9 +100,10 @@ public:
     }
 
 private:
-    void carve_at_index(int, const Range&);
+    void carve_from(const Range& available_range, const Range&);
 
-    Vector<Range> m_available_ranges;
+    // Keyed by base address. Neighbouring free ranges are always merged.
+    RedBlackTree<FlatPtr, Range> m_available_ranges;
     Range m_total_range;
     mutable SpinLock<u8> m_lock;
 };
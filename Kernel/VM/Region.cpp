@@ -438,7 +438,7 @@ PageFaultResponse Region::handle_fault(const PageFault& fault, ScopedSpinLock<Re
             remap_vmobject_page(translate_to_vmobject_page(page_index_in_region));
             return PageFaultResponse::Continue;
         }
-        return handle_zero_fault(page_index_in_region);
+        return handle_zero_fault(page_index_in_region, mm_lock);
 #else
         dbgln("BUG! Unexpected NP fault at {}", fault.vaddr());
         return PageFaultResponse::ShouldCrash;
@@ -450,7 +450,7 @@ PageFaultResponse Region::handle_fault(const PageFault& fault, ScopedSpinLock<Re
         auto* phys_page = physical_page(page_index_in_region);
         if (phys_page->is_shared_zero_page() || phys_page->is_lazy_committed_page()) {
             dbgln<PAGE_FAULT_DEBUG>("NP(zero) fault in Region({})[{}] at {}", this, page_index_in_region, fault.vaddr());
-            return handle_zero_fault(page_index_in_region);
+            return handle_zero_fault(page_index_in_region, mm_lock);
         }
         return handle_cow_fault(page_index_in_region);
     }
@@ -458,13 +458,19 @@ PageFaultResponse Region::handle_fault(const PageFault& fault, ScopedSpinLock<Re
     return PageFaultResponse::ShouldCrash;
 }
 
-PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region)
+PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, ScopedSpinLock<RecursiveSpinLock>& mm_lock)
 {
     ASSERT_INTERRUPTS_DISABLED();
     ASSERT(vmobject().is_anonymous());
 
+    mm_lock.unlock();
+    ASSERT(!s_mm_lock.own_lock());
+    ASSERT(!g_scheduler_lock.own_lock());
+
     LOCKER(vmobject().m_paging_lock);
 
+    mm_lock.lock();
+
     auto& page_slot = physical_page_slot(page_index_in_region);
     auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
 
@@ -485,11 +491,18 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region)
         page_slot = static_cast<AnonymousVMObject&>(*m_vmobject).allocate_committed_page(page_index_in_vmobject);
         dbgln<PAGE_FAULT_DEBUG>("      >> ALLOCATED COMMITTED {}", page_slot->paddr());
     } else {
-        page_slot = MM.allocate_user_physical_page(MemoryManager::ShouldZeroFill::Yes);
-        if (page_slot.is_null()) {
+        // If the zeroed page pool has run dry, the page is zero-filled on the spot,
+        // so don't make everyone else wait for the MM lock while that happens.
+        mm_lock.unlock();
+        auto page = MM.allocate_user_physical_page(MemoryManager::ShouldZeroFill::Yes);
+        mm_lock.lock();
+        if (page.is_null()) {
             klog() << "MM: handle_zero_fault was unable to allocate a physical page";
             return PageFaultResponse::OutOfMemory;
         }
+        // Someone may have faulted the page in through another mapping while we were unlocked.
+        if (page_slot.is_null() || page_slot->is_shared_zero_page() || page_slot->is_lazy_committed_page())
+            page_slot = move(page);
         dbgln<PAGE_FAULT_DEBUG>("      >> ALLOCATED {}", page_slot->paddr());
     }
 
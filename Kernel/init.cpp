@@ -67,6 +67,7 @@
 #include <Kernel/TTY/PTYMultiplexer.h>
 #include <Kernel/TTY/VirtualConsole.h>
 #include <Kernel/Tasks/FinalizerTask.h>
+#include <Kernel/Tasks/PageZeroingTask.h>
 #include <Kernel/Tasks/SyncTask.h>
 #include <Kernel/Time/TimeManagement.h>
 #include <Kernel/VM/MemoryManager.h>
@@ -127,6 +128,7 @@ extern "C" [[noreturn]] void init()
     slab_alloc_init();
 
     s_bsp_processor.initialize(0);
+    kmalloc_init_processor_caches();
 
     CommandLine::initialize();
     MemoryManager::initialize(0);
@@ -190,6 +192,7 @@ extern "C" [[noreturn]] void init_ap(u32 cpu, Processor* processor_info)
     processor_info->early_initialize(cpu);
 
     processor_info->initialize(cpu);
+    kmalloc_init_processor_caches();
     MemoryManager::initialize(cpu);
 
     Scheduler::set_idle_thread(APIC::the().get_idle_thread(cpu));
@@ -224,6 +227,7 @@ void init_stage2(void*)
 
     SyncTask::spawn();
     FinalizerTask::spawn();
+    PageZeroingTask::spawn();
 
     PCI::initialize();
 
@@ -52,6 +52,8 @@ set(CRYPTO_DEBUG ON)
 set(DWARF_DEBUG ON)
 set(HUNKS_DEBUG ON)
 set(JOB_DEBUG ON)
+set(JS_BYTECODE_DEBUG ON)
+set(JS_PROPERTY_CACHE_DEBUG ON)
 set(GIF_DEBUG ON)
 set(JPG_DEBUG ON)
 set(EMOJI_DEBUG ON)
@@ -106,6 +108,7 @@ set(HIGHLIGHT_FOCUSED_FRAME_DEBUG ON)
 set(ITEM_RECTS_DEBUG ON)
 set(SH_LANGUAGE_SERVER_DEBUG ON)
 set(STRINGIMPL_DEBUG ON)
+set(STYLE_RESOLVER_DEBUG ON)
 set(TEXTEDITOR_DEBUG ON)
 set(DEFERRED_INVOKE_DEBUG ON)
 set(DYNAMIC_LOAD_DEBUG ON)
@@ -134,6 +137,7 @@ set(IPV4_DEBUG ON)
 set(IRC_DEBUG ON)
 set(KEYBOARD_DEBUG ON)
 set(KMALLOC_DEBUG_LARGE_ALLOCATIONS ON)
+set(LAYOUT_DEBUG ON)
 set(LEXER_DEBUG ON)
 set(LOOKUPSERVER_DEBUG ON)
 set(MALLOC_DEBUG ON)
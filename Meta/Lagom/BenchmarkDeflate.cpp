@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2020, Andreas Kling <kling@serenityos.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/ByteBuffer.h>
+#include <LibCompress/Deflate.h>
+#include <LibCompress/Gzip.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/File.h>
+#include <stdio.h>
+
+// Compresses a corpus at every level, decompresses it again and reports throughput and ratio.
+// With --gzip, only measures how fast an existing gzip file (e.g. one made by another encoder) is decompressed.
+
+static ByteBuffer generate_corpus(size_t size)
+{
+    // Source-code-like text: a small vocabulary with skewed frequencies and some noise.
+    static const char* tokens[] = {
+        "    ", "return ", "if (", ") {\n", "}\n", "auto ", "const ", "size_t ", "m_", "value", "buffer",
+        " = ", "; ", "++i", "for (", "nullptr", "->", "::", "(", ")", ", ", "\n", "//", " the ",
+    };
+    constexpr size_t token_count = sizeof(tokens) / sizeof(tokens[0]);
+
+    auto corpus = ByteBuffer::create_uninitialized(size);
+    u32 state = 0x9e3779b9;
+    for (size_t i = 0; i < size;) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        if (state % 32 == 0) {
+            corpus[i++] = 'a' + (state >> 8) % 26;
+            continue;
+        }
+        auto index = ((state >> 4) % token_count) * ((state >> 12) % token_count) / token_count;
+        for (auto* token = tokens[index]; *token && i < size; ++token)
+            corpus[i++] = *token;
+    }
+    return corpus;
+}
+
+static double megabytes_per_second(size_t size, i64 microseconds)
+{
+    if (microseconds <= 0)
+        return 0;
+    return static_cast<double>(size) / static_cast<double>(microseconds);
+}
+
+static int benchmark_gzip_decompression(const ByteBuffer& compressed, int iterations)
+{
+    size_t decompressed_size = 0;
+    i64 decompress_time = 0;
+
+    for (int i = 0; i < iterations; ++i) {
+        Core::ElapsedTimer timer;
+        timer.start();
+        auto decompressed = Compress::GzipDecompressor::decompress_all(compressed);
+        decompress_time += timer.elapsed_microseconds();
+        if (!decompressed.has_value()) {
+            fprintf(stderr, "Decompression failed\n");
+            return 1;
+        }
+        decompressed_size = decompressed.value().size();
+    }
+
+    printf("Compressed: %zu bytes, decompressed: %zu bytes\n", compressed.size(), decompressed_size);
+    printf("Inflate: %.2f MB/s of output, %.2f MB/s of input\n",
+        megabytes_per_second(decompressed_size * iterations, decompress_time),
+        megabytes_per_second(compressed.size() * iterations, decompress_time));
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = nullptr;
+    int iterations = 3;
+    bool gzip = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(iterations, "Number of iterations per level", "iterations", 'n', "count");
+    args_parser.add_option(gzip, "Only time the decompression of the given gzip file", "gzip", 'g');
+    args_parser.add_positional_argument(path, "File to use as the corpus (default: 4 MiB of generated text)", "file", Core::ArgsParser::Required::No);
+    args_parser.parse(argc, argv);
+
+    ByteBuffer corpus;
+    if (path) {
+        auto file = Core::File::construct(path);
+        if (!file->open(Core::IODevice::ReadOnly)) {
+            fprintf(stderr, "Unable to open %s\n", path);
+            return 1;
+        }
+        corpus = file->read_all();
+    } else {
+        corpus = generate_corpus(4 * MiB);
+    }
+
+    if (gzip) {
+        if (!path) {
+            fprintf(stderr, "--gzip requires a file\n");
+            return 1;
+        }
+        return benchmark_gzip_decompression(corpus, iterations);
+    }
+
+    printf("Corpus: %zu bytes\n", corpus.size());
+    printf("%-6s %12s %8s %14s %14s\n", "Level", "Compressed", "Ratio", "Compress MB/s", "Inflate MB/s");
+
+    struct {
+        const char* name;
+        Compress::DeflateCompressor::CompressionLevel level;
+    } levels[] = {
+        { "store", Compress::DeflateCompressor::CompressionLevel::Store },
+        { "fast", Compress::DeflateCompressor::CompressionLevel::Fast },
+        { "good", Compress::DeflateCompressor::CompressionLevel::Good },
+        { "great", Compress::DeflateCompressor::CompressionLevel::Great },
+        { "best", Compress::DeflateCompressor::CompressionLevel::Best },
+    };
+
+    for (auto& level : levels) {
+        i64 compress_time = 0;
+        i64 decompress_time = 0;
+        size_t compressed_size = 0;
+
+        for (int i = 0; i < iterations; ++i) {
+            Core::ElapsedTimer timer;
+            timer.start();
+            auto compressed = Compress::DeflateCompressor::compress_all(corpus, level.level);
+            compress_time += timer.elapsed_microseconds();
+            if (!compressed.has_value()) {
+                fprintf(stderr, "Compression failed at level %s\n", level.name);
+                return 1;
+            }
+            compressed_size = compressed.value().size();
+
+            timer.start();
+            auto decompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+            decompress_time += timer.elapsed_microseconds();
+            if (!decompressed.has_value() || decompressed.value() != corpus) {
+                fprintf(stderr, "Round trip failed at level %s\n", level.name);
+                return 1;
+            }
+        }
+
+        printf("%-6s %12zu %7.2f%% %14.2f %14.2f\n",
+            level.name,
+            compressed_size,
+            100.0 * compressed_size / max<size_t>(corpus.size(), 1),
+            megabytes_per_second(corpus.size() * iterations, compress_time),
+            megabytes_per_second(corpus.size() * iterations, decompress_time));
+    }
+
+    return 0;
+}
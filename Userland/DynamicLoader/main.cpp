@@ -30,7 +30,9 @@
 #include <LibELF/AuxiliaryVector.h>
 #include <LibELF/DynamicLinker.h>
 
-char* __static_environ[] = { nullptr }; // We don't get the environment without some libc workarounds..
+// We don't get the environment without some libc workarounds..
+// The second entry terminates an empty auxiliary vector, so getauxval() doesn't run off the end.
+char* __static_environ[] = { nullptr, nullptr };
 
 static void init_libc()
 {
@@ -70,6 +70,21 @@ static LibThread::Lock& malloc_lock()
 constexpr size_t number_of_chunked_blocks_to_keep_around_per_size_class = 4;
 constexpr size_t number_of_big_blocks_to_keep_around_per_size_class = 8;
 
+// Each thread keeps a few free chunks of every size class around, so most
+// malloc() and free() calls don't have to take the malloc lock at all.
+constexpr size_t max_thread_cache_chunks_per_size_class = 64;
+constexpr size_t thread_cache_bytes_per_size_class = 32 * KiB;
+
+static constexpr size_t thread_cache_capacity(size_t chunk_size)
+{
+    return clamp(thread_cache_bytes_per_size_class / chunk_size, (size_t)1, max_thread_cache_chunks_per_size_class);
+}
+
+static constexpr size_t thread_cache_batch_size(size_t chunk_size)
+{
+    return max(thread_cache_capacity(chunk_size) / 2, (size_t)1);
+}
+
 static bool s_log_malloc = false;
 static bool s_scrub_malloc = true;
 static bool s_scrub_free = true;
@@ -95,9 +110,64 @@ struct MallocStats {
     size_t number_of_freed_full_blocks;
     size_t number_of_keeps;
     size_t number_of_frees;
+
+    size_t number_of_thread_cache_hits;
+    size_t number_of_thread_cache_misses;
+    size_t number_of_thread_cache_flushes;
+
+    size_t number_of_lock_acquisitions;
+    size_t number_of_contended_lock_acquisitions;
 };
 static MallocStats g_malloc_stats = {};
 
+struct ThreadCache {
+    struct Bin {
+        FreelistEntry* head;
+        size_t count;
+    };
+    Bin bins[num_size_classes];
+
+    // These are folded into g_malloc_stats whenever the thread takes the malloc lock.
+    size_t number_of_malloc_calls;
+    size_t number_of_free_calls;
+    size_t number_of_hits;
+    size_t number_of_misses;
+    size_t number_of_flushes;
+};
+
+// The dynamic loader's malloc runs before there is any TLS, so it goes straight to the
+// allocators instead. It doesn't keep the per-thread call statistics either.
+#ifndef NO_TLS
+static __thread ThreadCache t_thread_cache;
+#endif
+
+class MallocLocker {
+public:
+    ALWAYS_INLINE MallocLocker()
+    {
+        bool contended = !malloc_lock().try_lock();
+        if (contended)
+            malloc_lock().lock();
+        g_malloc_stats.number_of_lock_acquisitions++;
+        if (contended)
+            g_malloc_stats.number_of_contended_lock_acquisitions++;
+    }
+    ALWAYS_INLINE ~MallocLocker() { malloc_lock().unlock(); }
+};
+
+// NOTE: The malloc lock must be held when calling this.
+static void fold_thread_cache_stats()
+{
+#ifndef NO_TLS
+    auto& cache = t_thread_cache;
+    g_malloc_stats.number_of_malloc_calls += exchange(cache.number_of_malloc_calls, 0);
+    g_malloc_stats.number_of_free_calls += exchange(cache.number_of_free_calls, 0);
+    g_malloc_stats.number_of_thread_cache_hits += exchange(cache.number_of_hits, 0);
+    g_malloc_stats.number_of_thread_cache_misses += exchange(cache.number_of_misses, 0);
+    g_malloc_stats.number_of_thread_cache_flushes += exchange(cache.number_of_flushes, 0);
+#endif
+}
+
 struct Allocator {
     size_t size { 0 };
     size_t block_count { 0 };
@@ -130,16 +200,37 @@ static inline BigAllocator (&big_allocators())[1]
     return reinterpret_cast<BigAllocator(&)[1]>(g_big_allocators_storage);
 }
 
+// Every size class is a multiple of this, which lets us map a size to its
+// size class with a single table lookup.
+constexpr size_t size_class_granularity = 4;
+constexpr size_t largest_size_class = size_classes[num_size_classes - 1];
+
+static constexpr bool size_classes_are_aligned_to_granularity()
+{
+    for (size_t i = 0; i < num_size_classes; ++i) {
+        if (size_classes[i] % size_class_granularity)
+            return false;
+    }
+    return true;
+}
+static_assert(size_classes_are_aligned_to_granularity());
+
+static u8 s_size_class_index_for_size[largest_size_class / size_class_granularity + 1];
+
+static size_t size_class_index(const Allocator& allocator)
+{
+    return &allocator - &allocators()[0];
+}
+
 static Allocator* allocator_for_size(size_t size, size_t& good_size)
 {
-    for (size_t i = 0; size_classes[i]; ++i) {
-        if (size <= size_classes[i]) {
-            good_size = size_classes[i];
-            return &allocators()[i];
-        }
+    if (size > largest_size_class) {
+        good_size = PAGE_ROUND_UP(size);
+        return nullptr;
     }
-    good_size = PAGE_ROUND_UP(size);
-    return nullptr;
+    size_t index = s_size_class_index_for_size[(size + size_class_granularity - 1) / size_class_granularity];
+    good_size = size_classes[index];
+    return &allocators()[index];
 }
 
 #ifdef RECYCLE_BIG_ALLOCATIONS
@@ -166,22 +257,158 @@ static void os_free(void* ptr, size_t size)
     assert(rc == 0);
 }
 
-static void* malloc_impl(size_t size)
+// NOTE: The malloc lock must be held when calling this.
+static void* allocate_chunk(Allocator& allocator)
 {
-    LOCKER(malloc_lock());
+    size_t good_size = allocator.size;
+    ChunkedBlock* block = nullptr;
+
+    for (block = allocator.usable_blocks.head(); block; block = block->next()) {
+        if (block->free_chunks())
+            break;
+    }
+
+    if (!block && allocator.empty_block_count) {
+        g_malloc_stats.number_of_empty_block_hits++;
+        block = allocator.empty_blocks[--allocator.empty_block_count];
+        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
+        bool this_block_was_purged = rc == 1;
+        if (rc < 0) {
+            perror("madvise");
+            ASSERT_NOT_REACHED();
+        }
+        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
+        if (rc < 0) {
+            perror("mprotect");
+            ASSERT_NOT_REACHED();
+        }
+        if (this_block_was_purged) {
+            g_malloc_stats.number_of_empty_block_purge_hits++;
+            new (block) ChunkedBlock(good_size);
+        }
+        allocator.usable_blocks.append(block);
+    }
+
+    if (!block) {
+        g_malloc_stats.number_of_block_allocs++;
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+        block = (ChunkedBlock*)os_alloc(ChunkedBlock::block_size, buffer);
+        new (block) ChunkedBlock(good_size);
+        allocator.usable_blocks.append(block);
+        ++allocator.block_count;
+    }
+
+    --block->m_free_chunks;
+    void* ptr = block->m_freelist;
+    ASSERT(ptr);
+    block->m_freelist = block->m_freelist->next;
+    if (block->is_full()) {
+        g_malloc_stats.number_of_blocks_full++;
+#if MALLOC_DEBUG
+        dbgprintf("Block %p is now full in size class %zu\n", block, good_size);
+#endif
+        allocator.usable_blocks.remove(block);
+        allocator.full_blocks.append(block);
+    }
+#if MALLOC_DEBUG
+    dbgprintf("LibC: allocated %p (chunk in block %p, size %zu)\n", ptr, block, block->bytes_per_chunk());
+#endif
+    return ptr;
+}
+
+// NOTE: The malloc lock must be held when calling this.
+static void release_chunk(ChunkedBlock* block, void* ptr)
+{
+#if MALLOC_DEBUG
+    dbgprintf("LibC: freeing %p in allocator %p (size=%zu, used=%zu)\n", ptr, block, block->bytes_per_chunk(), block->used_chunks());
+#endif
 
+    auto* entry = (FreelistEntry*)ptr;
+    entry->next = block->m_freelist;
+    block->m_freelist = entry;
+
+    if (block->is_full()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+#if MALLOC_DEBUG
+        dbgprintf("Block %p no longer full in size class %zu\n", block, good_size);
+#endif
+        g_malloc_stats.number_of_freed_full_blocks++;
+        allocator->full_blocks.remove(block);
+        allocator->usable_blocks.prepend(block);
+    }
+
+    ++block->m_free_chunks;
+
+    if (!block->used_chunks()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+        if (allocator->block_count < number_of_chunked_blocks_to_keep_around_per_size_class) {
+#if MALLOC_DEBUG
+            dbgprintf("Keeping block %p around for size class %zu\n", block, good_size);
+#endif
+            g_malloc_stats.number_of_keeps++;
+            allocator->usable_blocks.remove(block);
+            allocator->empty_blocks[allocator->empty_block_count++] = block;
+            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
+            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
+            return;
+        }
+#if MALLOC_DEBUG
+        dbgprintf("Releasing block %p for size class %zu\n", block, good_size);
+#endif
+        g_malloc_stats.number_of_frees++;
+        allocator->usable_blocks.remove(block);
+        --allocator->block_count;
+        os_free(block, ChunkedBlock::block_size);
+    }
+}
+
+#ifndef NO_TLS
+static void refill_thread_cache_bin(Allocator& allocator, ThreadCache::Bin& bin)
+{
+    MallocLocker locker;
+    fold_thread_cache_stats();
+    for (size_t i = thread_cache_batch_size(allocator.size); i > 0; --i) {
+        auto* entry = (FreelistEntry*)allocate_chunk(allocator);
+        entry->next = bin.head;
+        bin.head = entry;
+        ++bin.count;
+    }
+}
+
+static void flush_thread_cache_bin(ThreadCache::Bin& bin, size_t count)
+{
+    MallocLocker locker;
+    fold_thread_cache_stats();
+    for (; count > 0 && bin.head; --count) {
+        auto* entry = bin.head;
+        bin.head = entry->next;
+        --bin.count;
+        release_chunk((ChunkedBlock*)((FlatPtr)entry & ChunkedBlock::block_mask), entry);
+    }
+}
+#endif
+
+static void* malloc_impl(size_t size)
+{
     if (s_log_malloc)
         dbgprintf("LibC: malloc(%zu)\n", size);
 
     if (!size)
         return nullptr;
 
-    g_malloc_stats.number_of_malloc_calls++;
+#ifndef NO_TLS
+    auto& cache = t_thread_cache;
+    cache.number_of_malloc_calls++;
+#endif
 
     size_t good_size;
     auto* allocator = allocator_for_size(size, good_size);
 
     if (!allocator) {
+        MallocLocker locker;
         size_t real_size = round_up_to_power_of_two(sizeof(BigAllocationBlock) + size, ChunkedBlock::block_size);
 #ifdef RECYCLE_BIG_ALLOCATIONS
         if (auto* allocator = big_allocator_for_size(real_size)) {
@@ -215,62 +442,29 @@ static void* malloc_impl(size_t size)
         return &block->m_slot[0];
     }
 
-    ChunkedBlock* block = nullptr;
-
-    for (block = allocator->usable_blocks.head(); block; block = block->next()) {
-        if (block->free_chunks())
-            break;
-    }
-
-    if (!block && allocator->empty_block_count) {
-        g_malloc_stats.number_of_empty_block_hits++;
-        block = allocator->empty_blocks[--allocator->empty_block_count];
-        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
-        bool this_block_was_purged = rc == 1;
-        if (rc < 0) {
-            perror("madvise");
-            ASSERT_NOT_REACHED();
-        }
-        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
-        if (rc < 0) {
-            perror("mprotect");
-            ASSERT_NOT_REACHED();
-        }
-        if (this_block_was_purged) {
-            g_malloc_stats.number_of_empty_block_purge_hits++;
-            new (block) ChunkedBlock(good_size);
-        }
-        allocator->usable_blocks.append(block);
+#ifdef NO_TLS
+    void* ptr;
+    {
+        MallocLocker locker;
+        ptr = allocate_chunk(*allocator);
     }
-
-    if (!block) {
-        g_malloc_stats.number_of_block_allocs++;
-        char buffer[64];
-        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-        block = (ChunkedBlock*)os_alloc(ChunkedBlock::block_size, buffer);
-        new (block) ChunkedBlock(good_size);
-        allocator->usable_blocks.append(block);
-        ++allocator->block_count;
+#else
+    auto& bin = cache.bins[size_class_index(*allocator)];
+    if (bin.head) {
+        cache.number_of_hits++;
+    } else {
+        cache.number_of_misses++;
+        refill_thread_cache_bin(*allocator, bin);
     }
 
-    --block->m_free_chunks;
-    void* ptr = block->m_freelist;
+    void* ptr = bin.head;
     ASSERT(ptr);
-    block->m_freelist = block->m_freelist->next;
-    if (block->is_full()) {
-        g_malloc_stats.number_of_blocks_full++;
-#if MALLOC_DEBUG
-        dbgprintf("Block %p is now full in size class %zu\n", block, good_size);
-#endif
-        allocator->usable_blocks.remove(block);
-        allocator->full_blocks.append(block);
-    }
-#if MALLOC_DEBUG
-    dbgprintf("LibC: allocated %p (chunk in block %p, size %zu)\n", ptr, block, block->bytes_per_chunk());
+    bin.head = bin.head->next;
+    --bin.count;
 #endif
 
     if (s_scrub_malloc)
-        memset(ptr, MALLOC_SCRUB_BYTE, block->m_size);
+        memset(ptr, MALLOC_SCRUB_BYTE, good_size);
 
     ue_notify_malloc(ptr, size);
     return ptr;
@@ -283,14 +477,16 @@ static void free_impl(void* ptr)
     if (!ptr)
         return;
 
-    g_malloc_stats.number_of_free_calls++;
-
-    LOCKER(malloc_lock());
+#ifndef NO_TLS
+    auto& cache = t_thread_cache;
+    cache.number_of_free_calls++;
+#endif
 
     void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
     size_t magic = *(size_t*)block_base;
 
     if (magic == MAGIC_BIGALLOC_HEADER) {
+        MallocLocker locker;
         auto* block = (BigAllocationBlock*)block_base;
 #ifdef RECYCLE_BIG_ALLOCATIONS
         if (auto* allocator = big_allocator_for_size(block->m_size)) {
@@ -318,52 +514,28 @@ static void free_impl(void* ptr)
     assert(magic == MAGIC_PAGE_HEADER);
     auto* block = (ChunkedBlock*)block_base;
 
-#if MALLOC_DEBUG
-    dbgprintf("LibC: freeing %p in allocator %p (size=%zu, used=%zu)\n", ptr, block, block->bytes_per_chunk(), block->used_chunks());
-#endif
-
     if (s_scrub_free)
         memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
 
-    auto* entry = (FreelistEntry*)ptr;
-    entry->next = block->m_freelist;
-    block->m_freelist = entry;
-
-    if (block->is_full()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-#if MALLOC_DEBUG
-        dbgprintf("Block %p no longer full in size class %zu\n", block, good_size);
-#endif
-        g_malloc_stats.number_of_freed_full_blocks++;
-        allocator->full_blocks.remove(block);
-        allocator->usable_blocks.prepend(block);
+#ifdef NO_TLS
+    MallocLocker locker;
+    release_chunk(block, ptr);
+#else
+    // The chunk stays accounted to its block while it sits in our cache, so the block can't go away under us.
+    size_t good_size;
+    auto* allocator = allocator_for_size(block->m_size, good_size);
+    auto& bin = cache.bins[size_class_index(*allocator)];
+    size_t capacity = thread_cache_capacity(good_size);
+    if (bin.count >= capacity) {
+        cache.number_of_flushes++;
+        flush_thread_cache_bin(bin, bin.count - capacity / 2);
     }
 
-    ++block->m_free_chunks;
-
-    if (!block->used_chunks()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        if (allocator->block_count < number_of_chunked_blocks_to_keep_around_per_size_class) {
-#if MALLOC_DEBUG
-            dbgprintf("Keeping block %p around for size class %zu\n", block, good_size);
-#endif
-            g_malloc_stats.number_of_keeps++;
-            allocator->usable_blocks.remove(block);
-            allocator->empty_blocks[allocator->empty_block_count++] = block;
-            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
-            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
-            return;
-        }
-#if MALLOC_DEBUG
-        dbgprintf("Releasing block %p for size class %zu\n", block, good_size);
+    auto* entry = (FreelistEntry*)ptr;
+    entry->next = bin.head;
+    bin.head = entry;
+    ++bin.count;
 #endif
-        g_malloc_stats.number_of_frees++;
-        allocator->usable_blocks.remove(block);
-        --allocator->block_count;
-        os_free(block, ChunkedBlock::block_size);
-    }
 }
 
 [[gnu::flatten]] void* malloc(size_t size)
@@ -446,11 +618,30 @@ void __malloc_init()
         allocators()[i].size = size_classes[i];
     }
 
+    for (size_t i = 0, size_class = 0; i < array_size(s_size_class_index_for_size); ++i) {
+        while (i * size_class_granularity > size_classes[size_class])
+            ++size_class;
+        s_size_class_index_for_size[i] = size_class;
+    }
+
     new (&big_allocators()[0])(BigAllocator);
 }
 
+void __malloc_flush_thread_cache()
+{
+#ifndef NO_TLS
+    for (auto& bin : t_thread_cache.bins)
+        flush_thread_cache_bin(bin, bin.count);
+#endif
+}
+
 void serenity_dump_malloc_stats()
 {
+    {
+        LOCKER(malloc_lock());
+        fold_thread_cache_stats();
+    }
+
     dbgln("# malloc() calls: {}", g_malloc_stats.number_of_malloc_calls);
     dbgln();
     dbgln("big alloc hits: {}", g_malloc_stats.number_of_big_allocator_hits);
@@ -470,5 +661,14 @@ void serenity_dump_malloc_stats()
     dbgln("full block frees: {}", g_malloc_stats.number_of_freed_full_blocks);
     dbgln("number of keeps: {}", g_malloc_stats.number_of_keeps);
     dbgln("number of frees: {}", g_malloc_stats.number_of_frees);
+    dbgln();
+    size_t thread_cache_lookups = g_malloc_stats.number_of_thread_cache_hits + g_malloc_stats.number_of_thread_cache_misses;
+    dbgln("thread cache hits: {}", g_malloc_stats.number_of_thread_cache_hits);
+    dbgln("thread cache misses: {}", g_malloc_stats.number_of_thread_cache_misses);
+    dbgln("thread cache hit rate: {}%", thread_cache_lookups ? g_malloc_stats.number_of_thread_cache_hits * 100 / thread_cache_lookups : 0);
+    dbgln("thread cache flushes: {}", g_malloc_stats.number_of_thread_cache_flushes);
+    dbgln();
+    dbgln("lock acquisitions: {}", g_malloc_stats.number_of_lock_acquisitions);
+    dbgln("contended lock acquisitions: {}", g_malloc_stats.number_of_contended_lock_acquisitions);
 }
 }
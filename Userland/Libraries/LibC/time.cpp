@@ -24,20 +24,57 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <AK/Atomic.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
 #include <AK/Time.h>
 #include <Kernel/API/Syscall.h>
+#include <Kernel/API/TimePage.h>
+#include <LibELF/AuxiliaryVector.h>
 #include <assert.h>
 #include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/internals.h>
 #include <sys/time.h>
 #include <sys/times.h>
 #include <time.h>
 
 extern "C" {
 
+static const TimePage* s_time_page;
+
+void __time_init()
+{
+    s_time_page = (const TimePage*)getauxval(AT_TIME_PAGE);
+}
+
+// Reads the clock from the kernel's time page, if it's kept up to date there.
+static bool read_clock_from_time_page(clockid_t clock_id, struct timespec* ts)
+{
+    if (!s_time_page || clock_id < 0 || clock_id >= (clockid_t)TimePage::max_clock_count)
+        return false;
+    if (!(s_time_page->clock_mask & (1 << clock_id)))
+        return false;
+
+    // The kernel bumps update1 before and stores update2 after writing the clocks,
+    // so we have to read them in the opposite order.
+    auto& page_clock = const_cast<const volatile TimePage::Clock&>(s_time_page->clocks[clock_id]);
+    TimePage::Clock clock;
+    u32 update_iteration;
+    do {
+        update_iteration = AK::atomic_load(&s_time_page->update2, AK::MemoryOrder::memory_order_acquire);
+        clock.seconds = page_clock.seconds;
+        clock.nanoseconds = page_clock.nanoseconds;
+        AK::atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+    } while (update_iteration != AK::atomic_load(&s_time_page->update1, AK::MemoryOrder::memory_order_relaxed));
+
+    ts->tv_sec = clock.seconds;
+    ts->tv_nsec = clock.nanoseconds;
+    return true;
+}
+
 time_t time(time_t* tloc)
 {
     struct timeval tv;
@@ -57,6 +94,11 @@ int adjtime(const struct timeval* delta, struct timeval* old_delta)
 
 int gettimeofday(struct timeval* __restrict__ tv, void* __restrict__)
 {
+    struct timespec ts;
+    if (read_clock_from_time_page(CLOCK_REALTIME, &ts)) {
+        TIMESPEC_TO_TIMEVAL(tv, &ts);
+        return 0;
+    }
     int rc = syscall(SC_gettimeofday, tv);
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
@@ -347,6 +389,8 @@ clock_t clock()
 
 int clock_gettime(clockid_t clock_id, struct timespec* ts)
 {
+    if (read_clock_from_time_page(clock_id, ts))
+        return 0;
     int rc = syscall(SC_clock_gettime, clock_id, ts);
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
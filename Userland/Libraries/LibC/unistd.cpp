@@ -42,6 +42,7 @@
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <termios.h>
 #include <time.h>
 #include <unistd.h>
@@ -760,12 +761,14 @@ int unveil(const char* path, const char* permissions)
 
 ssize_t pread(int fd, void* buf, size_t count, off_t offset)
 {
-    // FIXME: This is not thread safe and should be implemented in the kernel instead.
-    off_t old_offset = lseek(fd, 0, SEEK_CUR);
-    lseek(fd, offset, SEEK_SET);
-    ssize_t nread = read(fd, buf, count);
-    lseek(fd, old_offset, SEEK_SET);
-    return nread;
+    iovec vec { buf, count };
+    return preadv(fd, &vec, 1, offset);
+}
+
+ssize_t pwrite(int fd, const void* buf, size_t count, off_t offset)
+{
+    iovec vec { const_cast<void*>(buf), count };
+    return pwritev(fd, &vec, 1, offset);
 }
 
 char* getpass(const char* prompt)
@@ -26,14 +26,26 @@
 
 #include <AK/Array.h>
 #include <AK/Assertions.h>
-#include <AK/BinarySearch.h>
 #include <AK/LogStream.h>
 #include <AK/MemoryStream.h>
+#include <AK/OwnPtr.h>
+#include <AK/QuickSort.h>
+#include <string.h>
 
 #include <LibCompress/Deflate.h>
 
 namespace Compress {
 
+static u16 reverse_bits(u16 value, size_t bit_count)
+{
+    u16 reversed = 0;
+    for (size_t i = 0; i < bit_count; ++i) {
+        reversed = reversed << 1 | (value & 1);
+        value >>= 1;
+    }
+    return reversed;
+}
+
 const CanonicalCode& CanonicalCode::fixed_literal_codes()
 {
     static CanonicalCode code;
@@ -78,7 +90,7 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
     CanonicalCode code;
 
     auto next_code = 0;
-    for (size_t code_length = 1; code_length <= 15; ++code_length) {
+    for (size_t code_length = 1; code_length <= max_code_length; ++code_length) {
         next_code <<= 1;
         auto start_bit = 1 << code_length;
 
@@ -89,34 +101,83 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
             if (next_code > start_bit)
                 return {};
 
-            code.m_symbol_codes.append(start_bit | next_code);
             code.m_symbol_values.append(symbol);
+            code.m_code_counts[code_length]++;
+
+            auto reversed_code = reverse_bits(next_code, code_length);
+            if (code_length <= fast_bits) {
+                for (size_t index = reversed_code; index < code.m_fast_table.size(); index += 1 << code_length)
+                    code.m_fast_table[index] = symbol << 4 | code_length;
+            }
+
+            if (symbol < code.m_bit_codes.size()) {
+                code.m_bit_codes[symbol] = reversed_code;
+                code.m_bit_code_lengths[symbol] = code_length;
+            }
 
             next_code++;
         }
     }
 
-    if (next_code != (1 << 15)) {
+    if (next_code != (1 << max_code_length)) {
         return {};
     }
 
     return code;
 }
 
-u32 CanonicalCode::read_symbol(InputBitStream& stream) const
+void CanonicalCode::write_symbol(OutputBitStream& stream, u32 symbol) const
 {
-    u32 code_bits = 1;
+    ASSERT(m_bit_code_lengths[symbol] != 0);
+    stream.write_bits(m_bit_codes[symbol], m_bit_code_lengths[symbol]);
+}
 
+u32 CanonicalCode::read_symbol(InputBitStream& stream) const
+{
     for (;;) {
-        code_bits = code_bits << 1 | stream.read_bits(1);
-        ASSERT(code_bits < (1 << 16));
+        const auto available_bits = min(stream.buffered_bit_count(), fast_bits);
+        const auto entry = m_fast_table[stream.peek_bits(available_bits)];
+        const size_t code_length = entry & 0xf;
+
+        // Missing bits are peeked as zeroes, so a match is only valid if it doesn't depend on them.
+        if (entry != 0 && code_length <= available_bits) {
+            stream.discard_bits(code_length);
+            return entry >> 4;
+        }
+
+        if (available_bits == fast_bits)
+            return read_long_symbol(stream);
+
+        // Only pull in more input once we know it's needed, so that we never read past the end of the stream.
+        if (!stream.refill_byte())
+            return 0;
+    }
+}
+
+u32 CanonicalCode::read_long_symbol(InputBitStream& stream) const
+{
+    // Huffman codes are stored most significant bit first, so walk down the code lengths one bit at a time.
+    // See https://www.hanshq.net/zip.html#huffdec
+    u32 code = 0;
+    u32 first_code = 0;
+    size_t first_index = 0;
+
+    for (size_t code_length = 1; code_length <= max_code_length; ++code_length) {
+        code |= stream.read_bits(1);
+        if (stream.has_any_error())
+            return 0;
 
-        // FIXME: This is very inefficient and could greatly be improved by implementing this
-        //        algorithm: https://www.hanshq.net/zip.html#huffdec
-        size_t index;
-        if (AK::binary_search(m_symbol_codes.span(), code_bits, &index))
-            return m_symbol_values[index];
+        const auto count = m_code_counts[code_length];
+        if (code - first_code < count)
+            return m_symbol_values[first_index + code - first_code];
+
+        first_index += count;
+        first_code = (first_code + count) << 1;
+        code <<= 1;
     }
+
+    stream.set_fatal_error();
+    return 0;
 }
 
 DeflateDecompressor::CompressedBlock::CompressedBlock(DeflateDecompressor& decompressor, CanonicalCode literal_codes, Optional<CanonicalCode> distance_codes)
@@ -131,31 +192,48 @@ bool DeflateDecompressor::CompressedBlock::try_read_more()
     if (m_eof == true)
         return false;
 
-    const auto symbol = m_literal_codes.read_symbol(m_decompressor.m_input_stream);
+    auto& input_stream = m_decompressor.m_input_stream;
+    auto& output_stream = m_decompressor.m_output_stream;
+
+    // Decode as many symbols as we can while there's guaranteed to be room for the longest back-reference.
+    while (output_stream.remaining_space() >= DeflateCompressor::max_match_length) {
+        const auto symbol = m_literal_codes.read_symbol(input_stream);
+        if (input_stream.has_any_error()) {
+            m_decompressor.set_fatal_error();
+            return false;
+        }
+
+        if (symbol < 256) {
+            output_stream << static_cast<u8>(symbol);
+            continue;
+        }
+
+        if (symbol == 256) {
+            m_eof = true;
+            return true;
+        }
 
-    if (symbol < 256) {
-        m_decompressor.m_output_stream << static_cast<u8>(symbol);
-        return true;
-    } else if (symbol == 256) {
-        m_eof = true;
-        return false;
-    } else {
         if (!m_distance_codes.has_value()) {
             m_decompressor.set_fatal_error();
             return false;
         }
 
         const auto length = m_decompressor.decode_length(symbol);
-        const auto distance = m_decompressor.decode_distance(m_distance_codes.value().read_symbol(m_decompressor.m_input_stream));
+        const auto distance = m_decompressor.decode_distance(m_distance_codes.value().read_symbol(input_stream));
 
-        for (size_t idx = 0; idx < length; ++idx) {
-            u8 byte = 0;
-            m_decompressor.m_output_stream.read({ &byte, sizeof(byte) }, distance);
-            m_decompressor.m_output_stream << byte;
+        if (input_stream.has_any_error()) {
+            m_decompressor.set_fatal_error();
+            return false;
         }
 
-        return true;
+        if (!output_stream.copy_from_seekback(distance, length)) {
+            output_stream.handle_any_error();
+            m_decompressor.set_fatal_error();
+            return false;
+        }
     }
+
+    return true;
 }
 
 DeflateDecompressor::UncompressedBlock::UncompressedBlock(DeflateDecompressor& decompressor, size_t length)
@@ -188,6 +266,8 @@ DeflateDecompressor::~DeflateDecompressor()
         m_compressed_block.~CompressedBlock();
     if (m_state == State::ReadingUncompressedBlock)
         m_uncompressed_block.~UncompressedBlock();
+    // Errors in the bit stream have already been reported through our own error state.
+    m_input_stream.handle_any_error();
 }
 
 size_t DeflateDecompressor::read(Bytes bytes)
@@ -386,6 +466,10 @@ void DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Optional<Can
     Vector<u8> code_lengths;
     while (code_lengths.size() < literal_code_count + distance_code_count) {
         auto symbol = code_length_code.read_symbol(m_input_stream);
+        if (m_input_stream.has_any_error()) {
+            set_fatal_error();
+            return;
+        }
 
         if (symbol <= 15) {
             code_lengths.append(static_cast<u8>(symbol));
@@ -449,4 +533,598 @@ void DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Optional<Can
     distance_code = distance_code_result.value();
 }
 
+static constexpr u16 length_base[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static constexpr u8 length_extra_bits[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static constexpr u16 distance_base[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static constexpr u8 distance_extra_bits[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+static constexpr size_t code_length_order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+static constexpr auto length_to_symbol = [] {
+    Array<u8, DeflateCompressor::max_match_length + 1> table {};
+    for (size_t symbol = 0; symbol < 29; ++symbol) {
+        for (size_t length = length_base[symbol]; length < length_base[symbol] + (1u << length_extra_bits[symbol]) && length <= DeflateCompressor::max_match_length; ++length)
+            table[length] = symbol;
+    }
+    return table;
+}();
+
+static size_t distance_to_symbol(size_t distance)
+{
+    size_t value = distance - 1;
+    if (value < 4)
+        return value;
+    size_t bit_count = 31 - __builtin_clz(value);
+    return 2 * bit_count + ((value >> (bit_count - 1)) & 1);
+}
+
+// Computes optimal code lengths for the given symbol frequencies, using the two-queue method on
+// the symbols sorted by frequency. If the tree gets deeper than max_bit_length, the frequencies
+// are flattened and we try again. At least two symbols always get a code, since a code with a
+// single symbol can't be decoded.
+template<size_t Size>
+static void generate_huffman_lengths(Array<u8, Size>& lengths, const Array<u16, Size>& frequencies, size_t max_bit_length)
+{
+    lengths.span().fill(0);
+
+    Vector<u16, Size> symbols;
+    Array<u32, Size> weights {};
+    for (size_t symbol = 0; symbol < Size; ++symbol) {
+        if (frequencies[symbol] == 0)
+            continue;
+        symbols.append(symbol);
+        weights[symbol] = frequencies[symbol];
+    }
+
+    if (symbols.is_empty()) {
+        lengths[0] = 1;
+        lengths[1] = 1;
+        return;
+    }
+    if (symbols.size() == 1) {
+        lengths[symbols[0]] = 1;
+        lengths[symbols[0] == 0 ? 1 : 0] = 1;
+        return;
+    }
+
+    quick_sort(symbols.begin(), symbols.end(), [&](auto a, auto b) { return weights[a] < weights[b]; });
+
+    const size_t leaf_count = symbols.size();
+    const size_t node_count = 2 * leaf_count - 1;
+    Array<u32, 2 * Size> node_weights;
+    Array<u16, 2 * Size> parents;
+    Array<u8, 2 * Size> depths;
+
+    for (;;) {
+        for (size_t i = 0; i < leaf_count; ++i)
+            node_weights[i] = weights[symbols[i]];
+
+        // Internal nodes are created in order of increasing weight as well, so the lightest
+        // remaining node is always at the front of either the leaf or the internal node queue.
+        size_t next_leaf = 0;
+        size_t next_internal = leaf_count;
+        for (size_t node = leaf_count; node < node_count; ++node) {
+            auto take_lightest_node = [&]() -> size_t {
+                if (next_leaf < leaf_count && (next_internal == node || node_weights[next_leaf] <= node_weights[next_internal]))
+                    return next_leaf++;
+                return next_internal++;
+            };
+            auto first = take_lightest_node();
+            auto second = take_lightest_node();
+            node_weights[node] = node_weights[first] + node_weights[second];
+            parents[first] = node;
+            parents[second] = node;
+        }
+
+        depths[node_count - 1] = 0;
+        for (size_t node = node_count - 1; node-- > leaf_count;)
+            depths[node] = depths[parents[node]] + 1;
+
+        size_t max_depth = 0;
+        for (size_t i = 0; i < leaf_count; ++i)
+            max_depth = max<size_t>(max_depth, depths[parents[i]] + 1);
+
+        if (max_depth <= max_bit_length) {
+            for (size_t i = 0; i < leaf_count; ++i)
+                lengths[symbols[i]] = depths[parents[i]] + 1;
+            return;
+        }
+
+        // This keeps the symbols sorted by weight.
+        for (auto symbol : symbols)
+            weights[symbol] = (weights[symbol] + 1) / 2;
+    }
+}
+
+struct CodeLengthSymbol {
+    u8 symbol;
+    u8 repeat;
+};
+
+// Run-length encodes the literal and distance code lengths with the code length alphabet.
+static size_t encode_huffman_lengths(ReadonlyBytes lengths, Array<CodeLengthSymbol, DeflateCompressor::max_huffman_literals + DeflateCompressor::max_huffman_distances>& encoded_lengths)
+{
+    size_t encoded_count = 0;
+    size_t i = 0;
+    while (i < lengths.size()) {
+        auto length = lengths[i];
+        size_t run_length = 1;
+        while (i + run_length < lengths.size() && lengths[i + run_length] == length)
+            ++run_length;
+
+        if (length == 0) {
+            while (run_length >= 11) {
+                auto count = min<size_t>(run_length, 138);
+                encoded_lengths[encoded_count++] = { 18, static_cast<u8>(count - 11) };
+                run_length -= count;
+                i += count;
+            }
+            if (run_length >= 3) {
+                encoded_lengths[encoded_count++] = { 17, static_cast<u8>(run_length - 3) };
+                i += run_length;
+                run_length = 0;
+            }
+        } else {
+            encoded_lengths[encoded_count++] = { length, 0 };
+            --run_length;
+            ++i;
+            while (run_length >= 3) {
+                auto count = min<size_t>(run_length, 6);
+                encoded_lengths[encoded_count++] = { 16, static_cast<u8>(count - 3) };
+                run_length -= count;
+                i += count;
+            }
+        }
+
+        for (; run_length > 0; --run_length, ++i)
+            encoded_lengths[encoded_count++] = { length, 0 };
+    }
+    return encoded_count;
+}
+
+static size_t code_length_repeat_bits(u8 symbol)
+{
+    switch (symbol) {
+    case 16:
+        return 2;
+    case 17:
+        return 3;
+    case 18:
+        return 7;
+    default:
+        return 0;
+    }
+}
+
+// Everything needed to write the header of a dynamic Huffman block.
+struct DynamicHuffmanHeader {
+    size_t literal_count { 0 };
+    size_t distance_count { 0 };
+    size_t code_length_count { 0 };
+    Array<CodeLengthSymbol, DeflateCompressor::max_huffman_literals + DeflateCompressor::max_huffman_distances> encoded_lengths;
+    size_t encoded_length_count { 0 };
+    Array<u8, 19> code_length_bit_lengths;
+
+    size_t length_in_bits() const
+    {
+        size_t length = 5 + 5 + 4 + 3 * code_length_count;
+        for (size_t i = 0; i < encoded_length_count; ++i) {
+            auto symbol = encoded_lengths[i].symbol;
+            length += code_length_bit_lengths[symbol] + code_length_repeat_bits(symbol);
+        }
+        return length;
+    }
+};
+
+static DynamicHuffmanHeader build_dynamic_huffman_header(const Array<u8, DeflateCompressor::max_huffman_literals>& literal_bit_lengths, const Array<u8, DeflateCompressor::max_huffman_distances>& distance_bit_lengths)
+{
+    DynamicHuffmanHeader header;
+
+    header.literal_count = 286;
+    while (header.literal_count > 257 && literal_bit_lengths[header.literal_count - 1] == 0)
+        --header.literal_count;
+    header.distance_count = 30;
+    while (header.distance_count > 1 && distance_bit_lengths[header.distance_count - 1] == 0)
+        --header.distance_count;
+
+    Array<u8, DeflateCompressor::max_huffman_literals + DeflateCompressor::max_huffman_distances> all_lengths;
+    memcpy(all_lengths.data(), literal_bit_lengths.data(), header.literal_count);
+    memcpy(all_lengths.data() + header.literal_count, distance_bit_lengths.data(), header.distance_count);
+    header.encoded_length_count = encode_huffman_lengths(all_lengths.span().trim(header.literal_count + header.distance_count), header.encoded_lengths);
+
+    Array<u16, 19> code_length_frequencies {};
+    for (size_t i = 0; i < header.encoded_length_count; ++i)
+        ++code_length_frequencies[header.encoded_lengths[i].symbol];
+    generate_huffman_lengths(header.code_length_bit_lengths, code_length_frequencies, 7);
+
+    header.code_length_count = 19;
+    while (header.code_length_count > 4 && header.code_length_bit_lengths[code_length_order[header.code_length_count - 1]] == 0)
+        --header.code_length_count;
+
+    return header;
+}
+
+DeflateCompressor::DeflateCompressor(OutputStream& stream, CompressionLevel compression_level)
+    : m_compression_level(compression_level)
+    , m_compression_constants(compression_constants(compression_level))
+    , m_output_stream(stream)
+{
+    m_symbol_frequencies.span().fill(0);
+    m_distance_frequencies.span().fill(0);
+    m_hash_head.span().fill(empty_slot);
+}
+
+DeflateCompressor::~DeflateCompressor()
+{
+    ASSERT(m_finished);
+}
+
+DeflateCompressor::CompressionConstants DeflateCompressor::compression_constants(CompressionLevel compression_level)
+{
+    switch (compression_level) {
+    case CompressionLevel::Store:
+        return { 0, 0, 0, 0 };
+    case CompressionLevel::Fast:
+        return { 8, 0, 16, 16 };
+    case CompressionLevel::Good:
+        return { 8, 16, 128, 128 };
+    case CompressionLevel::Great:
+        return { 32, 128, 258, 1024 };
+    case CompressionLevel::Best:
+        return { 32, 258, 258, 4096 };
+    }
+    ASSERT_NOT_REACHED();
+}
+
+size_t DeflateCompressor::write(ReadonlyBytes bytes)
+{
+    ASSERT(!m_finished);
+
+    if (has_any_error())
+        return 0;
+
+    size_t nwritten = 0;
+    while (nwritten < bytes.size()) {
+        auto count = min(block_size - m_pending_block_size, bytes.size() - nwritten);
+        bytes.slice(nwritten, count).copy_to(pending_block().slice(m_pending_block_size));
+        m_pending_block_size += count;
+        nwritten += count;
+
+        if (m_pending_block_size == block_size)
+            flush();
+
+        if (m_output_stream.handle_any_error()) {
+            set_fatal_error();
+            break;
+        }
+    }
+
+    return nwritten;
+}
+
+bool DeflateCompressor::write_or_error(ReadonlyBytes bytes)
+{
+    if (write(bytes) < bytes.size()) {
+        set_fatal_error();
+        return false;
+    }
+
+    return true;
+}
+
+void DeflateCompressor::final_flush()
+{
+    ASSERT(!m_finished);
+    m_finished = true;
+
+    compress_block(true);
+    m_output_stream.align_to_byte_boundary();
+
+    if (m_output_stream.handle_any_error())
+        set_fatal_error();
+}
+
+Optional<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, CompressionLevel compression_level)
+{
+    DuplexMemoryStream output_stream;
+    // The compressor carries its window and hash chains inline, so keep it off the stack.
+    auto deflate_stream = make<DeflateCompressor>(output_stream, compression_level);
+
+    deflate_stream->write_or_error(bytes);
+    deflate_stream->final_flush();
+
+    if (deflate_stream->handle_any_error())
+        return {};
+
+    return output_stream.copy_into_contiguous_buffer();
+}
+
+void DeflateCompressor::flush()
+{
+    compress_block(false);
+    slide_window();
+}
+
+void DeflateCompressor::slide_window()
+{
+    // The block we just compressed becomes the window for the next one.
+    memcpy(m_rolling_window.data(), m_rolling_window.data() + window_size, block_size);
+    m_pending_block_size = 0;
+    m_window_is_valid = true;
+
+    auto rebase = [](u16 position) -> u16 {
+        if (position == empty_slot || position < window_size)
+            return empty_slot;
+        return position - window_size;
+    };
+    for (auto& position : m_hash_head)
+        position = rebase(position);
+    for (size_t i = 0; i < window_size; ++i)
+        m_hash_prev[i] = rebase(m_hash_prev[i + window_size]);
+}
+
+u16 DeflateCompressor::hash_sequence(size_t position) const
+{
+    u32 sequence = m_rolling_window[position] | m_rolling_window[position + 1] << 8 | m_rolling_window[position + 2] << 16;
+    return (sequence * 2654435761u) >> (32 - hash_bits);
+}
+
+void DeflateCompressor::insert_hash(size_t position)
+{
+    auto hash = hash_sequence(position);
+    m_hash_prev[position] = m_hash_head[hash];
+    m_hash_head[hash] = position;
+}
+
+size_t DeflateCompressor::find_longest_match(size_t position, size_t end, size_t previous_match_length, size_t& match_distance) const
+{
+    auto max_length = min(max_match_length, end - position);
+    auto best_length = max(previous_match_length, min_match_length - 1);
+    if (best_length >= max_length)
+        return 0;
+
+    auto chain_length = m_compression_constants.max_chain;
+    if (previous_match_length >= m_compression_constants.good_match_length)
+        chain_length >>= 2;
+
+    const u8* window = m_rolling_window.data();
+    size_t found_length = 0;
+
+    for (auto candidate = m_hash_prev[position]; candidate != empty_slot && chain_length > 0; candidate = m_hash_prev[candidate], --chain_length) {
+        if (position - candidate > window_size)
+            break;
+
+        // Cheap rejection: a longer match must at least agree on the byte just past the current best.
+        if (window[candidate + best_length] != window[position + best_length] || window[candidate] != window[position])
+            continue;
+
+        size_t length = 1;
+        while (length < max_length && window[candidate + length] == window[position + length])
+            ++length;
+
+        if (length > best_length) {
+            best_length = length;
+            found_length = length;
+            match_distance = position - candidate;
+            if (length >= m_compression_constants.great_match_length || length == max_length)
+                break;
+        }
+    }
+
+    return found_length;
+}
+
+void DeflateCompressor::emit_literal(u8 literal)
+{
+    auto& symbol = m_symbol_buffer[m_pending_symbol_size++];
+    symbol.distance = 0;
+    symbol.literal = literal;
+    ++m_symbol_frequencies[literal];
+}
+
+void DeflateCompressor::emit_match(size_t length, size_t distance)
+{
+    auto& symbol = m_symbol_buffer[m_pending_symbol_size++];
+    symbol.distance = distance;
+    symbol.length = length;
+    ++m_symbol_frequencies[257 + length_to_symbol[length]];
+    ++m_distance_frequencies[distance_to_symbol(distance)];
+}
+
+void DeflateCompressor::lz77_compress_block()
+{
+    m_pending_symbol_size = 0;
+    m_symbol_frequencies.span().fill(0);
+    m_distance_frequencies.span().fill(0);
+
+    const size_t end = window_size + m_pending_block_size;
+    auto insert_hash_if_possible = [&](size_t position) {
+        if (end - position >= min_match_length)
+            insert_hash(position);
+    };
+
+    // The last two positions of the previous block could not be hashed until now.
+    if (m_window_is_valid) {
+        insert_hash_if_possible(window_size - 2);
+        insert_hash_if_possible(window_size - 1);
+    }
+
+    size_t position = window_size;
+
+    if (m_compression_constants.max_lazy_length == 0) {
+        while (position < end) {
+            size_t match_distance = 0;
+            size_t match_length = 0;
+            if (end - position >= min_match_length) {
+                insert_hash(position);
+                match_length = find_longest_match(position, end, 0, match_distance);
+            }
+
+            if (match_length == 0) {
+                emit_literal(m_rolling_window[position++]);
+                continue;
+            }
+
+            emit_match(match_length, match_distance);
+            for (size_t i = 1; i < match_length; ++i)
+                insert_hash_if_possible(position + i);
+            position += match_length;
+        }
+    } else {
+        // Lazy matching: before taking a match, check whether the next position has a longer one,
+        // in which case the current byte is emitted as a literal instead.
+        size_t previous_match_length = 0;
+        size_t previous_match_distance = 0;
+        bool has_previous_position = false;
+
+        while (position < end) {
+            size_t match_distance = 0;
+            size_t match_length = 0;
+            if (end - position >= min_match_length) {
+                insert_hash(position);
+                if (previous_match_length < m_compression_constants.max_lazy_length)
+                    match_length = find_longest_match(position, end, previous_match_length, match_distance);
+            }
+
+            if (previous_match_length >= min_match_length && match_length == 0) {
+                emit_match(previous_match_length, previous_match_distance);
+                auto match_end = position - 1 + previous_match_length;
+                for (++position; position < match_end; ++position)
+                    insert_hash_if_possible(position);
+                previous_match_length = 0;
+                has_previous_position = false;
+                continue;
+            }
+
+            if (has_previous_position)
+                emit_literal(m_rolling_window[position - 1]);
+            has_previous_position = true;
+            previous_match_length = match_length;
+            previous_match_distance = match_distance;
+            ++position;
+        }
+
+        if (has_previous_position)
+            emit_literal(m_rolling_window[position - 1]);
+    }
+
+    ++m_symbol_frequencies[256];
+}
+
+size_t DeflateCompressor::huffman_block_length(const Array<u8, max_huffman_literals>& literal_bit_lengths, const Array<u8, max_huffman_distances>& distance_bit_lengths) const
+{
+    size_t length = 0;
+
+    for (size_t i = 0; i < 286; ++i) {
+        auto frequency = m_symbol_frequencies[i];
+        length += frequency * literal_bit_lengths[i];
+        if (i >= 257)
+            length += frequency * length_extra_bits[i - 257];
+    }
+
+    for (size_t i = 0; i < 30; ++i) {
+        auto frequency = m_distance_frequencies[i];
+        length += frequency * (distance_bit_lengths[i] + distance_extra_bits[i]);
+    }
+
+    return length;
+}
+
+size_t DeflateCompressor::stored_block_length() const
+{
+    auto padding = (8 - (m_output_stream.bit_offset() + 3) % 8) % 8;
+    return padding + 32 + m_pending_block_size * 8;
+}
+
+void DeflateCompressor::write_stored_block(bool final_block)
+{
+    m_output_stream.write_bit(final_block);
+    m_output_stream.write_bits(0b00, 2);
+    m_output_stream.align_to_byte_boundary();
+
+    LittleEndian<u16> length = static_cast<u16>(m_pending_block_size);
+    LittleEndian<u16> negated_length = static_cast<u16>(~m_pending_block_size);
+    m_output_stream << length << negated_length;
+    m_output_stream.write_or_error(pending_block().trim(m_pending_block_size));
+}
+
+void DeflateCompressor::write_huffman_symbols(const CanonicalCode& literal_code, const CanonicalCode& distance_code)
+{
+    for (size_t i = 0; i < m_pending_symbol_size; ++i) {
+        auto& symbol = m_symbol_buffer[i];
+        if (symbol.distance == 0) {
+            literal_code.write_symbol(m_output_stream, symbol.literal);
+            continue;
+        }
+
+        auto length_symbol = length_to_symbol[symbol.length];
+        literal_code.write_symbol(m_output_stream, 257 + length_symbol);
+        m_output_stream.write_bits(symbol.length - length_base[length_symbol], length_extra_bits[length_symbol]);
+
+        auto distance_symbol = distance_to_symbol(symbol.distance);
+        distance_code.write_symbol(m_output_stream, distance_symbol);
+        m_output_stream.write_bits(symbol.distance - distance_base[distance_symbol], distance_extra_bits[distance_symbol]);
+    }
+
+    literal_code.write_symbol(m_output_stream, 256);
+}
+
+void DeflateCompressor::compress_block(bool final_block)
+{
+    if (m_compression_level == CompressionLevel::Store) {
+        write_stored_block(final_block);
+        return;
+    }
+
+    lz77_compress_block();
+
+    Array<u8, max_huffman_literals> fixed_literal_bit_lengths;
+    fixed_literal_bit_lengths.span().slice(0, 144).fill(8);
+    fixed_literal_bit_lengths.span().slice(144, 256 - 144).fill(9);
+    fixed_literal_bit_lengths.span().slice(256, 280 - 256).fill(7);
+    fixed_literal_bit_lengths.span().slice(280, 288 - 280).fill(8);
+    Array<u8, max_huffman_distances> fixed_distance_bit_lengths;
+    fixed_distance_bit_lengths.span().fill(5);
+
+    Array<u8, max_huffman_literals> dynamic_literal_bit_lengths;
+    Array<u8, max_huffman_distances> dynamic_distance_bit_lengths;
+    generate_huffman_lengths(dynamic_literal_bit_lengths, m_symbol_frequencies, 15);
+    generate_huffman_lengths(dynamic_distance_bit_lengths, m_distance_frequencies, 15);
+    auto dynamic_header = build_dynamic_huffman_header(dynamic_literal_bit_lengths, dynamic_distance_bit_lengths);
+
+    auto stored_length = stored_block_length();
+    auto fixed_length = huffman_block_length(fixed_literal_bit_lengths, fixed_distance_bit_lengths);
+    auto dynamic_length = dynamic_header.length_in_bits() + huffman_block_length(dynamic_literal_bit_lengths, dynamic_distance_bit_lengths);
+
+    if (stored_length <= fixed_length && stored_length <= dynamic_length) {
+        write_stored_block(final_block);
+        return;
+    }
+
+    m_output_stream.write_bit(final_block);
+
+    if (fixed_length <= dynamic_length) {
+        m_output_stream.write_bits(0b01, 2);
+        write_huffman_symbols(CanonicalCode::fixed_literal_codes(), CanonicalCode::fixed_distance_codes());
+        return;
+    }
+
+    m_output_stream.write_bits(0b10, 2);
+    m_output_stream.write_bits(dynamic_header.literal_count - 257, 5);
+    m_output_stream.write_bits(dynamic_header.distance_count - 1, 5);
+    m_output_stream.write_bits(dynamic_header.code_length_count - 4, 4);
+    for (size_t i = 0; i < dynamic_header.code_length_count; ++i)
+        m_output_stream.write_bits(dynamic_header.code_length_bit_lengths[code_length_order[i]], 3);
+
+    auto code_length_code = CanonicalCode::from_bytes(dynamic_header.code_length_bit_lengths).value();
+    for (size_t i = 0; i < dynamic_header.encoded_length_count; ++i) {
+        auto& encoded_length = dynamic_header.encoded_lengths[i];
+        code_length_code.write_symbol(m_output_stream, encoded_length.symbol);
+        m_output_stream.write_bits(encoded_length.repeat, code_length_repeat_bits(encoded_length.symbol));
+    }
+
+    auto literal_code = CanonicalCode::from_bytes(dynamic_literal_bit_lengths.span().trim(dynamic_header.literal_count)).value();
+    auto distance_code = CanonicalCode::from_bytes(dynamic_distance_bit_lengths.span().trim(dynamic_header.distance_count)).value();
+    write_huffman_symbols(literal_code, distance_code);
+}
+
 }
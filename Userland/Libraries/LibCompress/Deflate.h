@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/BitStream.h>
 #include <AK/ByteBuffer.h>
 #include <AK/CircularDuplexStream.h>
@@ -38,6 +39,7 @@ class CanonicalCode {
 public:
     CanonicalCode() = default;
     u32 read_symbol(InputBitStream&) const;
+    void write_symbol(OutputBitStream&, u32) const;
 
     static const CanonicalCode& fixed_literal_codes();
     static const CanonicalCode& fixed_distance_codes();
@@ -45,8 +47,24 @@ public:
     static Optional<CanonicalCode> from_bytes(ReadonlyBytes);
 
 private:
-    Vector<u32> m_symbol_codes;
-    Vector<u32> m_symbol_values;
+    static constexpr size_t fast_bits = 9;
+    static constexpr size_t max_code_length = 15;
+
+    u32 read_long_symbol(InputBitStream&) const;
+
+    // Indexed by the next fast_bits bits of the stream, each entry holds (symbol << 4) | code_length for
+    // codes that are at most fast_bits long, or zero if the code is longer.
+    Array<u16, 1 << fast_bits> m_fast_table {};
+
+    // Longer codes are decoded canonically: the symbols are sorted by code length, and the codes of each length
+    // are consecutive, so the number of codes per length is enough to find a symbol.
+    Array<u16, max_code_length + 1> m_code_counts {};
+    Vector<u16> m_symbol_values;
+
+    // Codes are stored bit-reversed, as DEFLATE writes Huffman codes most significant bit first
+    // into a least significant bit first stream.
+    Array<u16, 288> m_bit_codes {};
+    Array<u8, 288> m_bit_code_lengths {};
 };
 
 class DeflateDecompressor final : public InputStream {
@@ -114,4 +132,95 @@ private:
     CircularDuplexStream<32 * 1024> m_output_stream;
 };
 
+class DeflateCompressor final : public OutputStream {
+public:
+    static constexpr size_t block_size = 32 * KiB;
+    static constexpr size_t window_size = 32 * KiB;
+    static constexpr size_t hash_bits = 15;
+    static constexpr size_t max_huffman_literals = 288;
+    static constexpr size_t max_huffman_distances = 32;
+    static constexpr size_t min_match_length = 3;
+    static constexpr size_t max_match_length = 258;
+    static constexpr u16 empty_slot = NumericLimits<u16>::max();
+
+    enum class CompressionLevel {
+        Store,
+        Fast,
+        Good,
+        Great,
+        Best,
+    };
+
+    DeflateCompressor(OutputStream&, CompressionLevel = CompressionLevel::Good);
+    ~DeflateCompressor();
+
+    size_t write(ReadonlyBytes) override;
+    bool write_or_error(ReadonlyBytes) override;
+
+    // Compresses any buffered input as the final block. No more data may be written afterwards.
+    void final_flush();
+
+    static Optional<ByteBuffer> compress_all(ReadonlyBytes, CompressionLevel = CompressionLevel::Good);
+
+private:
+    struct CompressionConstants {
+        // Once we have a match at least this long, only search a quarter of the hash chain for a better one.
+        size_t good_match_length;
+        // Only look for a longer match at the next position if the current one is shorter than this.
+        // Zero disables lazy matching altogether.
+        size_t max_lazy_length;
+        // Stop searching as soon as we find a match at least this long.
+        size_t great_match_length;
+        size_t max_chain;
+    };
+
+    static CompressionConstants compression_constants(CompressionLevel);
+
+    struct Symbol {
+        // Zero for literals.
+        u16 distance;
+        union {
+            u16 literal;
+            u16 length;
+        };
+    };
+
+    Bytes pending_block() { return { m_rolling_window.data() + window_size, block_size }; }
+
+    void flush();
+    void compress_block(bool final_block);
+    void slide_window();
+
+    u16 hash_sequence(size_t position) const;
+    void insert_hash(size_t position);
+    size_t find_longest_match(size_t position, size_t end, size_t previous_match_length, size_t& match_distance) const;
+    void emit_literal(u8);
+    void emit_match(size_t length, size_t distance);
+    void lz77_compress_block();
+
+    size_t huffman_block_length(const Array<u8, max_huffman_literals>& literal_bit_lengths, const Array<u8, max_huffman_distances>& distance_bit_lengths) const;
+    size_t stored_block_length() const;
+    void write_stored_block(bool final_block);
+    void write_huffman_symbols(const CanonicalCode& literal_code, const CanonicalCode& distance_code);
+
+    bool m_finished { false };
+    CompressionLevel m_compression_level;
+    CompressionConstants m_compression_constants;
+    OutputBitStream m_output_stream;
+
+    // The previous block (used as the match window) followed by the block being filled.
+    Array<u8, window_size + block_size> m_rolling_window;
+    size_t m_pending_block_size { 0 };
+    bool m_window_is_valid { false };
+
+    Array<Symbol, block_size + 1> m_symbol_buffer;
+    size_t m_pending_symbol_size { 0 };
+    Array<u16, max_huffman_literals> m_symbol_frequencies;
+    Array<u16, max_huffman_distances> m_distance_frequencies;
+
+    // Hash chains of positions in the rolling window, newest first.
+    Array<u16, 1 << hash_bits> m_hash_head;
+    Array<u16, window_size + block_size> m_hash_prev;
+};
+
 }
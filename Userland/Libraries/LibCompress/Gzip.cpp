@@ -27,6 +27,7 @@
 #include <LibCompress/Gzip.h>
 
 #include <AK/MemoryStream.h>
+#include <AK/OwnPtr.h>
 #include <AK/String.h>
 
 namespace Compress {
@@ -180,4 +181,77 @@ Optional<ByteBuffer> GzipDecompressor::decompress_all(ReadonlyBytes bytes)
 
 bool GzipDecompressor::unreliable_eof() const { return m_eof; }
 
+GzipCompressor::GzipCompressor(OutputStream& stream, DeflateCompressor::CompressionLevel compression_level)
+    : m_output_stream(stream)
+    , m_compressed_stream(stream, compression_level)
+{
+    u8 extra_flags = 0;
+    if (compression_level == DeflateCompressor::CompressionLevel::Best)
+        extra_flags = 2;
+    else if (compression_level <= DeflateCompressor::CompressionLevel::Fast)
+        extra_flags = 4;
+
+    // No flags, no modification time, and Unix as the operating system.
+    const u8 header[10] = { 0x1f, 0x8b, 0x08, 0, 0, 0, 0, 0, extra_flags, 3 };
+    if (!m_output_stream.write_or_error({ header, sizeof(header) }))
+        set_fatal_error();
+}
+
+GzipCompressor::~GzipCompressor()
+{
+}
+
+size_t GzipCompressor::write(ReadonlyBytes bytes)
+{
+    if (has_any_error())
+        return 0;
+
+    auto nwritten = m_compressed_stream.write(bytes);
+    m_checksum.update(bytes.trim(nwritten));
+    m_input_size += nwritten;
+
+    if (m_compressed_stream.handle_any_error())
+        set_fatal_error();
+
+    return nwritten;
+}
+
+bool GzipCompressor::write_or_error(ReadonlyBytes bytes)
+{
+    if (write(bytes) < bytes.size()) {
+        set_fatal_error();
+        return false;
+    }
+
+    return true;
+}
+
+void GzipCompressor::final_flush()
+{
+    m_compressed_stream.final_flush();
+    if (m_compressed_stream.handle_any_error())
+        set_fatal_error();
+
+    LittleEndian<u32> crc32 = m_checksum.digest();
+    LittleEndian<u32> input_size = static_cast<u32>(m_input_size);
+    m_output_stream << crc32 << input_size;
+
+    if (m_output_stream.handle_any_error())
+        set_fatal_error();
+}
+
+Optional<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes, DeflateCompressor::CompressionLevel compression_level)
+{
+    DuplexMemoryStream output_stream;
+    auto gzip_stream = make<GzipCompressor>(output_stream, compression_level);
+
+    gzip_stream->write_or_error(bytes);
+    gzip_stream->final_flush();
+
+    if (gzip_stream->handle_any_error())
+        return {};
+
+    return output_stream.copy_into_contiguous_buffer();
+}
+
 }
@@ -91,4 +91,24 @@ private:
     bool m_eof { false };
 };
 
+class GzipCompressor final : public OutputStream {
+public:
+    GzipCompressor(OutputStream&, DeflateCompressor::CompressionLevel = DeflateCompressor::CompressionLevel::Good);
+    ~GzipCompressor();
+
+    size_t write(ReadonlyBytes) override;
+    bool write_or_error(ReadonlyBytes) override;
+
+    // Finishes the deflate stream and writes the trailer. No more data may be written afterwards.
+    void final_flush();
+
+    static Optional<ByteBuffer> compress_all(ReadonlyBytes, DeflateCompressor::CompressionLevel = DeflateCompressor::CompressionLevel::Good);
+
+private:
+    OutputStream& m_output_stream;
+    DeflateCompressor m_compressed_stream;
+    Crypto::Checksum::CRC32 m_checksum;
+    size_t m_input_size { 0 };
+};
+
 }
@@ -25,6 +25,8 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/MemoryStream.h>
+#include <AK/OwnPtr.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
@@ -70,10 +72,182 @@ u32 Zlib::checksum()
 {
     if (!m_checksum) {
         auto bytes = m_input_data.slice(m_input_data.size() - 4, 4);
-        m_checksum = bytes.at(0) << 24 | bytes.at(1) << 16 | bytes.at(2) << 8 || bytes.at(3);
+        m_checksum = bytes.at(0) << 24 | bytes.at(1) << 16 | bytes.at(2) << 8 | bytes.at(3);
     }
 
     return m_checksum;
 }
 
+ZlibDecompressor::ZlibDecompressor(InputStream& stream)
+    : m_input_stream(stream)
+    , m_compressed_stream(stream)
+{
+}
+
+ZlibDecompressor::~ZlibDecompressor()
+{
+}
+
+bool ZlibDecompressor::read_header()
+{
+    u8 header[2];
+    if (!m_input_stream.read_or_error({ header, sizeof(header) }))
+        return false;
+
+    u8 compression_method = header[0] & 0xf;
+    u8 compression_info = header[0] >> 4;
+    bool has_dictionary = header[1] & 0x20;
+
+    if (compression_method != 8 || compression_info > 7 || has_dictionary)
+        return false;
+
+    return (header[0] * 256 + header[1]) % 31 == 0;
+}
+
+bool ZlibDecompressor::read_trailer()
+{
+    BigEndian<u32> checksum;
+    if (!m_input_stream.read_or_error({ &checksum, sizeof(checksum) }))
+        return false;
+
+    return checksum == m_checksum.digest();
+}
+
+size_t ZlibDecompressor::read(Bytes bytes)
+{
+    if (has_any_error() || m_eof)
+        return 0;
+
+    if (!m_read_header) {
+        if (!read_header()) {
+            set_fatal_error();
+            return 0;
+        }
+        m_read_header = true;
+    }
+
+    auto nread = m_compressed_stream.read(bytes);
+    if (m_compressed_stream.handle_any_error()) {
+        set_fatal_error();
+        return 0;
+    }
+
+    m_checksum.update(bytes.trim(nread));
+
+    if (m_compressed_stream.unreliable_eof()) {
+        m_eof = true;
+        if (!read_trailer()) {
+            set_fatal_error();
+            return 0;
+        }
+    }
+
+    return nread;
+}
+
+bool ZlibDecompressor::read_or_error(Bytes bytes)
+{
+    if (read(bytes) < bytes.size()) {
+        set_fatal_error();
+        return false;
+    }
+
+    return true;
+}
+
+bool ZlibDecompressor::discard_or_error(size_t count)
+{
+    u8 buffer[4096];
+
+    size_t ndiscarded = 0;
+    while (ndiscarded < count) {
+        if (unreliable_eof()) {
+            set_fatal_error();
+            return false;
+        }
+
+        ndiscarded += read({ buffer, min<size_t>(count - ndiscarded, sizeof(buffer)) });
+    }
+
+    return true;
+}
+
+bool ZlibDecompressor::unreliable_eof() const { return m_eof; }
+
+ZlibCompressor::ZlibCompressor(OutputStream& stream, DeflateCompressor::CompressionLevel compression_level)
+    : m_output_stream(stream)
+    , m_compressed_stream(stream, compression_level)
+{
+    // Deflate with a 32 KiB window, no preset dictionary.
+    u8 compression_info = 0x78;
+
+    u8 level = 2;
+    if (compression_level <= DeflateCompressor::CompressionLevel::Fast)
+        level = 0;
+    else if (compression_level == DeflateCompressor::CompressionLevel::Best)
+        level = 3;
+
+    u8 flags = level << 6;
+    flags |= (31 - (compression_info * 256 + flags) % 31) % 31;
+
+    const u8 header[2] = { compression_info, flags };
+    if (!m_output_stream.write_or_error({ header, sizeof(header) }))
+        set_fatal_error();
+}
+
+ZlibCompressor::~ZlibCompressor()
+{
+}
+
+size_t ZlibCompressor::write(ReadonlyBytes bytes)
+{
+    if (has_any_error())
+        return 0;
+
+    auto nwritten = m_compressed_stream.write(bytes);
+    m_checksum.update(bytes.trim(nwritten));
+
+    if (m_compressed_stream.handle_any_error())
+        set_fatal_error();
+
+    return nwritten;
+}
+
+bool ZlibCompressor::write_or_error(ReadonlyBytes bytes)
+{
+    if (write(bytes) < bytes.size()) {
+        set_fatal_error();
+        return false;
+    }
+
+    return true;
+}
+
+void ZlibCompressor::final_flush()
+{
+    m_compressed_stream.final_flush();
+    if (m_compressed_stream.handle_any_error())
+        set_fatal_error();
+
+    BigEndian<u32> adler32 = m_checksum.digest();
+    m_output_stream << adler32;
+
+    if (m_output_stream.handle_any_error())
+        set_fatal_error();
+}
+
+Optional<ByteBuffer> ZlibCompressor::compress_all(ReadonlyBytes bytes, DeflateCompressor::CompressionLevel compression_level)
+{
+    DuplexMemoryStream output_stream;
+    auto zlib_stream = make<ZlibCompressor>(output_stream, compression_level);
+
+    zlib_stream->write_or_error(bytes);
+    zlib_stream->final_flush();
+
+    if (zlib_stream->handle_any_error())
+        return {};
+
+    return output_stream.copy_into_contiguous_buffer();
+}
+
 }
@@ -29,6 +29,8 @@
 #include <AK/ByteBuffer.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
+#include <LibCompress/Deflate.h>
+#include <LibCrypto/Checksum/Adler32.h>
 
 namespace Compress {
 
@@ -53,4 +55,48 @@ private:
     ReadonlyBytes m_data_bytes;
 };
 
+// Decompresses a zlib stream incrementally, verifying the Adler-32 checksum once the deflate stream ends.
+// Unlike Zlib, malformed headers are reported as errors, so this is safe to use on untrusted input.
+class ZlibDecompressor final : public InputStream {
+public:
+    ZlibDecompressor(InputStream&);
+    ~ZlibDecompressor();
+
+    size_t read(Bytes) override;
+    bool read_or_error(Bytes) override;
+    bool discard_or_error(size_t) override;
+
+    bool unreliable_eof() const override;
+
+private:
+    bool read_header();
+    bool read_trailer();
+
+    InputStream& m_input_stream;
+    DeflateDecompressor m_compressed_stream;
+    Crypto::Checksum::Adler32 m_checksum;
+
+    bool m_read_header { false };
+    bool m_eof { false };
+};
+
+class ZlibCompressor final : public OutputStream {
+public:
+    ZlibCompressor(OutputStream&, DeflateCompressor::CompressionLevel = DeflateCompressor::CompressionLevel::Good);
+    ~ZlibCompressor();
+
+    size_t write(ReadonlyBytes) override;
+    bool write_or_error(ReadonlyBytes) override;
+
+    // Finishes the deflate stream and writes the checksum. No more data may be written afterwards.
+    void final_flush();
+
+    static Optional<ByteBuffer> compress_all(ReadonlyBytes, DeflateCompressor::CompressionLevel = DeflateCompressor::CompressionLevel::Good);
+
+private:
+    OutputStream& m_output_stream;
+    DeflateCompressor m_compressed_stream;
+    Crypto::Checksum::Adler32 m_checksum;
+};
+
 }
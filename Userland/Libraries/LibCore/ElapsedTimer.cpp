@@ -42,6 +42,11 @@ void ElapsedTimer::start()
 }
 
 int ElapsedTimer::elapsed() const
+{
+    return elapsed_microseconds() / 1000;
+}
+
+i64 ElapsedTimer::elapsed_microseconds() const
 {
     ASSERT(is_valid());
     struct timeval now;
@@ -51,7 +56,7 @@ int ElapsedTimer::elapsed() const
     now.tv_usec = now_spec.tv_nsec / 1000;
     struct timeval diff;
     timeval_sub(now, m_origin_time, diff);
-    return diff.tv_sec * 1000 + diff.tv_usec / 1000;
+    return (i64)diff.tv_sec * 1000000 + diff.tv_usec;
 }
 
 }
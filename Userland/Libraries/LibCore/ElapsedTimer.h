@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <AK/Types.h>
 #include <sys/time.h>
 
 namespace Core {
@@ -40,6 +41,7 @@ public:
     bool is_valid() const { return m_valid; }
     void start();
     int elapsed() const;
+    i64 elapsed_microseconds() const;
 
     const struct timeval& origin_time() const { return m_origin_time; }
 
@@ -55,6 +55,12 @@
 #include <time.h>
 #include <unistd.h>
 
+// Serenity and Linux (for Lagom) keep a persistent interest set with epoll; elsewhere we rebuild fd_sets for select().
+#if defined(__serenity__) || defined(__linux__)
+#    define EVENTLOOP_USE_EPOLL
+#    include <sys/epoll.h>
+#endif
+
 namespace Core {
 
 class RPCClient;
@@ -79,11 +85,61 @@ static EventLoop* s_main_event_loop;
 static Vector<EventLoop*>* s_event_loop_stack;
 static NeverDestroyed<IDAllocator> s_id_allocator;
 static HashMap<int, NonnullOwnPtr<EventLoopTimer>>* s_timers;
-static HashTable<Notifier*>* s_notifiers;
+// Several notifiers may watch the same fd (e.g. Core::Socket's read and connect notifiers).
+static HashMap<int, Vector<Notifier*, 1>>* s_notifiers;
 int EventLoop::s_wake_pipe_fds[2];
+#ifdef EVENTLOOP_USE_EPOLL
+static int s_epoll_fd = -1;
+// Fds that epoll refuses to watch (like regular files on Linux). Like select(), we consider them always ready.
+static HashTable<int>* s_unpollable_fds;
+static constexpr int max_epoll_events = 64;
+#endif
 static RefPtr<LocalServer> s_rpc_server;
 HashMap<int, RefPtr<RPCClient>> s_rpc_clients;
 
+#ifdef EVENTLOOP_USE_EPOLL
+static void update_epoll_interest(int fd, int op)
+{
+    if (s_epoll_fd < 0)
+        return;
+
+    if (op == EPOLL_CTL_DEL) {
+        if (s_unpollable_fds->remove(fd))
+            return;
+        // The fd may already be closed, which drops it from the interest set anyway.
+        epoll_ctl(s_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        return;
+    }
+    if (s_unpollable_fds->contains(fd))
+        return;
+
+    epoll_event event {};
+    event.data.fd = fd;
+    for (auto* notifier : s_notifiers->find(fd)->value) {
+        if (notifier->event_mask() & Notifier::Read)
+            event.events |= EPOLLIN;
+        if (notifier->event_mask() & Notifier::Write)
+            event.events |= EPOLLOUT;
+        if (notifier->event_mask() & Notifier::Exceptional)
+            ASSERT_NOT_REACHED();
+    }
+
+    int rc = epoll_ctl(s_epoll_fd, op, fd, &event);
+    if (rc < 0 && op == EPOLL_CTL_MOD && errno == ENOENT) {
+        // The fd was closed and reused behind our back, so the old entry is gone.
+        rc = epoll_ctl(s_epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+    if (rc < 0 && errno == EPERM) {
+        s_unpollable_fds->set(fd);
+        return;
+    }
+    if (rc < 0) {
+        perror("EventLoop: epoll_ctl");
+        ASSERT_NOT_REACHED();
+    }
+}
+#endif
+
 class SignalHandlers : public RefCounted<SignalHandlers> {
     AK_MAKE_NONCOPYABLE(SignalHandlers);
     AK_MAKE_NONMOVABLE(SignalHandlers);
@@ -282,7 +338,10 @@ EventLoop::EventLoop()
     if (!s_event_loop_stack) {
         s_event_loop_stack = new Vector<EventLoop*>;
         s_timers = new HashMap<int, NonnullOwnPtr<EventLoopTimer>>;
-        s_notifiers = new HashTable<Notifier*>;
+        s_notifiers = new HashMap<int, Vector<Notifier*, 1>>;
+#ifdef EVENTLOOP_USE_EPOLL
+        s_unpollable_fds = new HashTable<int>;
+#endif
     }
 
     if (!s_main_event_loop) {
@@ -297,6 +356,18 @@ EventLoop::EventLoop()
 
 #endif
         ASSERT(rc == 0);
+#ifdef EVENTLOOP_USE_EPOLL
+        s_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        ASSERT(s_epoll_fd >= 0);
+        epoll_event wake_event {};
+        wake_event.events = EPOLLIN;
+        wake_event.data.fd = s_wake_pipe_fds[0];
+        rc = epoll_ctl(s_epoll_fd, EPOLL_CTL_ADD, s_wake_pipe_fds[0], &wake_event);
+        ASSERT(rc == 0);
+        // Pick up notifiers that were registered before we had an epoll fd (e.g. right after forking).
+        for (auto& it : *s_notifiers)
+            update_epoll_interest(it.key, EPOLL_CTL_ADD);
+#endif
         s_event_loop_stack->append(this);
 
 #ifdef __serenity__
@@ -600,6 +671,12 @@ void EventLoop::notify_forked(ForkEvent event)
         s_event_loop_stack->clear();
         s_timers->clear();
         s_notifiers->clear();
+#ifdef EVENTLOOP_USE_EPOLL
+        // The epoll fd is shared with our parent, so we mustn't touch its interest set anymore.
+        close(s_epoll_fd);
+        s_epoll_fd = -1;
+        s_unpollable_fds->clear();
+#endif
         if (auto* info = signals_info<false>()) {
             info->signal_handlers.clear();
             info->next_signal_id = 0;
@@ -617,6 +694,10 @@ void EventLoop::notify_forked(ForkEvent event)
 
 void EventLoop::wait_for_event(WaitMode mode)
 {
+#ifdef EVENTLOOP_USE_EPOLL
+    epoll_event events[max_epoll_events];
+retry:
+#else
     fd_set rfds;
     fd_set wfds;
 retry:
@@ -633,14 +714,17 @@ retry:
     int max_fd_added = -1;
     add_fd_to_set(s_wake_pipe_fds[0], rfds);
     max_fd = max(max_fd, max_fd_added);
-    for (auto& notifier : *s_notifiers) {
-        if (notifier->event_mask() & Notifier::Read)
-            add_fd_to_set(notifier->fd(), rfds);
-        if (notifier->event_mask() & Notifier::Write)
-            add_fd_to_set(notifier->fd(), wfds);
-        if (notifier->event_mask() & Notifier::Exceptional)
-            ASSERT_NOT_REACHED();
+    for (auto& it : *s_notifiers) {
+        for (auto* notifier : it.value) {
+            if (notifier->event_mask() & Notifier::Read)
+                add_fd_to_set(notifier->fd(), rfds);
+            if (notifier->event_mask() & Notifier::Write)
+                add_fd_to_set(notifier->fd(), wfds);
+            if (notifier->event_mask() & Notifier::Exceptional)
+                ASSERT_NOT_REACHED();
+        }
     }
+#endif
 
     bool queued_events_is_empty;
     {
@@ -668,8 +752,16 @@ retry:
         }
     }
 
+#ifdef EVENTLOOP_USE_EPOLL
+    int timeout_ms = should_wait_forever ? -1 : timeout.tv_sec * 1000 + (timeout.tv_usec + 999) / 1000;
+    if (!s_unpollable_fds->is_empty())
+        timeout_ms = 0;
+try_select_again:
+    int marked_fd_count = epoll_wait(s_epoll_fd, events, max_epoll_events, timeout_ms);
+#else
 try_select_again:
     int marked_fd_count = select(max_fd + 1, &rfds, &wfds, nullptr, should_wait_forever ? nullptr : &timeout);
+#endif
     if (marked_fd_count < 0) {
         int saved_errno = errno;
         if (saved_errno == EINTR) {
@@ -683,7 +775,17 @@ try_select_again:
         // Blow up, similar to Core::safe_syscall.
         ASSERT_NOT_REACHED();
     }
-    if (FD_ISSET(s_wake_pipe_fds[0], &rfds)) {
+
+#ifdef EVENTLOOP_USE_EPOLL
+    bool wake_pipe_is_readable = false;
+    for (int i = 0; i < marked_fd_count; ++i) {
+        if (events[i].data.fd == s_wake_pipe_fds[0])
+            wake_pipe_is_readable = true;
+    }
+#else
+    bool wake_pipe_is_readable = FD_ISSET(s_wake_pipe_fds[0], &rfds);
+#endif
+    if (wake_pipe_is_readable) {
         int wake_events[8];
         auto nread = read(s_wake_pipe_fds[0], wake_events, sizeof(wake_events));
         if (nread < 0) {
@@ -733,19 +835,35 @@ try_select_again:
         }
     }
 
+    auto post_notifier_events = [&](int fd, bool is_readable, bool is_writable) {
+        auto it = s_notifiers->find(fd);
+        if (it == s_notifiers->end())
+            return;
+        for (auto* notifier : it->value) {
+            if (is_readable && (notifier->event_mask() & Notifier::Event::Read))
+                post_event(*notifier, make<NotifierReadEvent>(fd));
+            if (is_writable && (notifier->event_mask() & Notifier::Event::Write))
+                post_event(*notifier, make<NotifierWriteEvent>(fd));
+        }
+    };
+
+#ifdef EVENTLOOP_USE_EPOLL
+    for (int i = 0; i < marked_fd_count; ++i) {
+        int fd = events[i].data.fd;
+        if (fd == s_wake_pipe_fds[0])
+            continue;
+        // Like select(), treat hang-ups and errors as readability so the notifier gets to see them.
+        post_notifier_events(fd, events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR), events[i].events & (EPOLLOUT | EPOLLERR));
+    }
+    for (int fd : *s_unpollable_fds)
+        post_notifier_events(fd, true, true);
+#else
     if (!marked_fd_count)
         return;
 
-    for (auto& notifier : *s_notifiers) {
-        if (FD_ISSET(notifier->fd(), &rfds)) {
-            if (notifier->event_mask() & Notifier::Event::Read)
-                post_event(*notifier, make<NotifierReadEvent>(notifier->fd()));
-        }
-        if (FD_ISSET(notifier->fd(), &wfds)) {
-            if (notifier->event_mask() & Notifier::Event::Write)
-                post_event(*notifier, make<NotifierWriteEvent>(notifier->fd()));
-        }
-    }
+    for (auto& it : *s_notifiers)
+        post_notifier_events(it.key, FD_ISSET(it.key, &rfds), FD_ISSET(it.key, &wfds));
+#endif
 }
 
 bool EventLoopTimer::has_expired(const timeval& now) const
@@ -808,12 +926,45 @@ bool EventLoop::unregister_timer(int timer_id)
 
 void EventLoop::register_notifier(Badge<Notifier>, Notifier& notifier)
 {
-    s_notifiers->set(&notifier);
+    auto& notifiers = s_notifiers->ensure(notifier.fd());
+    if (notifiers.contains_slow(&notifier))
+        return;
+    notifiers.append(&notifier);
+#ifdef EVENTLOOP_USE_EPOLL
+    update_epoll_interest(notifier.fd(), notifiers.size() == 1 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD);
+#endif
 }
 
 void EventLoop::unregister_notifier(Badge<Notifier>, Notifier& notifier)
 {
-    s_notifiers->remove(&notifier);
+    auto it = s_notifiers->find(notifier.fd());
+    if (it == s_notifiers->end())
+        return;
+    if (!it->value.remove_first_matching([&](auto* entry) { return entry == &notifier; }))
+        return;
+    if (!it->value.is_empty()) {
+#ifdef EVENTLOOP_USE_EPOLL
+        update_epoll_interest(notifier.fd(), EPOLL_CTL_MOD);
+#endif
+        return;
+    }
+    s_notifiers->remove(it);
+#ifdef EVENTLOOP_USE_EPOLL
+    update_epoll_interest(notifier.fd(), EPOLL_CTL_DEL);
+#endif
+}
+
+void EventLoop::update_notifier(Badge<Notifier>, Notifier& notifier)
+{
+#ifdef EVENTLOOP_USE_EPOLL
+    auto it = s_notifiers->find(notifier.fd());
+    if (it == s_notifiers->end() || !it->value.contains_slow(&notifier))
+        return;
+    update_epoll_interest(notifier.fd(), EPOLL_CTL_MOD);
+#else
+    // We rebuild the fd_sets from the notifiers' event masks on every iteration.
+    (void)notifier;
+#endif
 }
 
 void EventLoop::wake()
@@ -32,9 +32,19 @@ namespace Crypto::Checksum {
 
 void Adler32::update(ReadonlyBytes data)
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state_a = (m_state_a + data.at(i)) % 65521;
-        m_state_b = (m_state_b + m_state_a) % 65521;
+    // This is the largest number of bytes we can sum before m_state_b could overflow,
+    // so we only need to reduce the sums modulo 65521 once per chunk of that size.
+    constexpr size_t max_chunk_size = 5552;
+
+    while (!data.is_empty()) {
+        auto chunk_size = min(data.size(), max_chunk_size);
+        for (size_t i = 0; i < chunk_size; i++) {
+            m_state_a += data[i];
+            m_state_b += m_state_a;
+        }
+        m_state_a %= 65521;
+        m_state_b %= 65521;
+        data = data.slice(chunk_size);
     }
 };
 
@@ -31,11 +31,11 @@
 #include <AK/LexicalPath.h>
 #include <AK/MappedFile.h>
 #include <AK/MemoryStream.h>
+#include <AK/SIMD.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/JPGLoader.h>
-#include <math.h>
 
 #define JPG_INVALID 0X0000
 
@@ -176,12 +176,21 @@ struct StartOfFrame {
     u16 width { 0 };
 };
 
+constexpr static size_t huffman_lookup_bits = 9;
+
 struct HuffmanTableSpec {
     u8 type { 0 };
     u8 destination_id { 0 };
     u8 code_counts[16] = { 0 };
     Vector<u8> symbols;
-    Vector<u16> codes;
+
+    // Codes of the same length are consecutive. For each length, this is the first code and the index of its symbol.
+    u32 first_codes[16] = { 0 };
+    u32 first_symbol_indices[16] = { 0 };
+
+    // Indexed by the next huffman_lookup_bits bits of the stream. Each entry is (code_length << 8) | symbol
+    // for codes that are at most huffman_lookup_bits long, and zero otherwise.
+    u16 lookup_table[1 << huffman_lookup_bits] = { 0 };
 };
 
 struct HuffmanStreamState {
@@ -219,51 +228,87 @@ struct JPGLoadingContext {
 
 static void generate_huffman_codes(HuffmanTableSpec& table)
 {
-    unsigned code = 0;
-    for (auto number_of_codes : table.code_counts) {
-        for (int i = 0; i < number_of_codes; i++)
-            table.codes.append(code++);
+    u32 code = 0;
+    u32 symbol_index = 0;
+    for (size_t i = 0; i < 16; i++) {
+        size_t code_length = i + 1;
+        table.first_codes[i] = code;
+        table.first_symbol_indices[i] = symbol_index;
+
+        for (int j = 0; j < table.code_counts[i]; j++) {
+            // Codes that don't fit their length only occur in malformed tables and can't be looked up.
+            if (code_length <= huffman_lookup_bits && code < (1u << code_length)) {
+                auto shift = huffman_lookup_bits - code_length;
+                for (u32 k = 0; k < (1u << shift); k++)
+                    table.lookup_table[(code << shift) | k] = code_length << 8 | table.symbols[symbol_index];
+            }
+            code++;
+            symbol_index++;
+        }
         code <<= 1;
     }
 }
 
+static size_t remaining_huffman_bits(const HuffmanStreamState& hstream)
+{
+    if (hstream.byte_offset >= hstream.stream.size())
+        return 0;
+    return (hstream.stream.size() - hstream.byte_offset) * 8 - hstream.bit_offset;
+}
+
+// Returns the next count (at most 16) bits, MSB first, without consuming them. Bits past the end of the stream read as zero.
+ALWAYS_INLINE static u32 peek_huffman_bits(const HuffmanStreamState& hstream, size_t count)
+{
+    u32 window = 0;
+    for (size_t i = 0; i < 3; i++) {
+        window <<= 8;
+        if (hstream.byte_offset + i < hstream.stream.size())
+            window |= hstream.stream.data()[hstream.byte_offset + i];
+    }
+    return (window >> (24 - hstream.bit_offset - count)) & ((1u << count) - 1);
+}
+
+ALWAYS_INLINE static void skip_huffman_bits(HuffmanStreamState& hstream, size_t count)
+{
+    size_t bit_offset = hstream.bit_offset + count;
+    hstream.byte_offset += bit_offset / 8;
+    hstream.bit_offset = bit_offset % 8;
+}
+
 static Optional<size_t> read_huffman_bits(HuffmanStreamState& hstream, size_t count = 1)
 {
-    if (count > (8 * sizeof(size_t))) {
+    if (count > 16) {
         dbgln<JPG_DEBUG>("Can't read {} bits at once!", count);
         return {};
     }
-    size_t value = 0;
-    while (count--) {
-        if (hstream.byte_offset >= hstream.stream.size()) {
-            dbgln<JPG_DEBUG>("Huffman stream exhausted. This could be an error!");
-            return {};
-        }
-        u8 current_byte = hstream.stream[hstream.byte_offset];
-        u8 current_bit = 1u & (u32)(current_byte >> (7 - hstream.bit_offset)); // MSB first.
-        hstream.bit_offset++;
-        value = (value << 1) | (size_t)current_bit;
-        if (hstream.bit_offset == 8) {
-            hstream.byte_offset++;
-            hstream.bit_offset = 0;
-        }
+    if (count > remaining_huffman_bits(hstream)) {
+        dbgln<JPG_DEBUG>("Huffman stream exhausted. This could be an error!");
+        return {};
     }
+    size_t value = peek_huffman_bits(hstream, count);
+    skip_huffman_bits(hstream, count);
     return value;
 }
 
 static Optional<u8> get_next_symbol(HuffmanStreamState& hstream, const HuffmanTableSpec& table)
 {
-    unsigned code = 0;
-    size_t code_cursor = 0;
-    for (int i = 0; i < 16; i++) { // Codes can't be longer than 16 bits.
-        auto result = read_huffman_bits(hstream);
-        if (!result.has_value())
-            return {};
-        code = (code << 1) | (i32)result.release_value();
-        for (int j = 0; j < table.code_counts[i]; j++) {
-            if (code == table.codes[code_cursor])
-                return table.symbols[code_cursor];
-            code_cursor++;
+    auto remaining_bits = remaining_huffman_bits(hstream);
+
+    auto entry = table.lookup_table[peek_huffman_bits(hstream, huffman_lookup_bits)];
+    size_t code_length = entry >> 8;
+    if (entry != 0 && code_length <= remaining_bits) {
+        skip_huffman_bits(hstream, code_length);
+        return entry & 0xff;
+    }
+
+    // The code is longer than the lookup table, or we're close to the end of the stream.
+    auto bits = peek_huffman_bits(hstream, 16);
+    for (size_t i = 0; i < 16 && i < remaining_bits; i++) { // Codes can't be longer than 16 bits.
+        u32 code = bits >> (15 - i);
+        u32 index_in_length = code - table.first_codes[i];
+        if (index_in_length < table.code_counts[i]) {
+            skip_huffman_bits(hstream, i + 1);
+            return table.symbols[table.first_symbol_indices[i] + index_in_length];
         }
     }
 
@@ -378,61 +423,43 @@ static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& ma
     return true;
 }
 
-static Optional<Vector<Macroblock>> decode_huffman_stream(JPGLoadingContext& context)
+// Decodes the row of MCUs starting at macroblock row vcursor. The macroblocks of the row are stored in
+// `macroblocks` as vsample_factor rows of hpadded_count blocks each.
+static bool decode_huffman_stream(JPGLoadingContext& context, Vector<Macroblock>& macroblocks, u32 vcursor)
 {
-    Vector<Macroblock> macroblocks;
-    macroblocks.resize(context.mblock_meta.padded_total);
-
-    if constexpr (JPG_DEBUG) {
-        dbgln("Image width: {}", context.frame.width);
-        dbgln("Image height: {}", context.frame.height);
-        dbgln("Macroblocks in a row: {}", context.mblock_meta.hpadded_count);
-        dbgln("Macroblocks in a column: {}", context.mblock_meta.vpadded_count);
-        dbgln("Macroblock meta padded total: {}", context.mblock_meta.padded_total);
-    }
-
-    // Compute huffman codes for DC and AC tables.
-    for (auto it = context.dc_tables.begin(); it != context.dc_tables.end(); ++it)
-        generate_huffman_codes(it->value);
-
-    for (auto it = context.ac_tables.begin(); it != context.ac_tables.end(); ++it)
-        generate_huffman_codes(it->value);
-
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            u32 i = vcursor * context.mblock_meta.hpadded_count + hcursor;
-            if (context.dc_reset_interval > 0) {
-                if (i % context.dc_reset_interval == 0) {
-                    context.previous_dc_values[0] = 0;
-                    context.previous_dc_values[1] = 0;
-                    context.previous_dc_values[2] = 0;
-
-                    // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
-                    //  the 0th bit of the next byte.
-                    if (context.huffman_stream.byte_offset < context.huffman_stream.stream.size()) {
-                        if (context.huffman_stream.bit_offset > 0) {
-                            context.huffman_stream.bit_offset = 0;
-                            context.huffman_stream.byte_offset++;
-                        }
-
-                        // Skip the restart marker (RSTn).
+    for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
+        u32 i = vcursor * context.mblock_meta.hpadded_count + hcursor;
+        if (context.dc_reset_interval > 0) {
+            if (i % context.dc_reset_interval == 0) {
+                context.previous_dc_values[0] = 0;
+                context.previous_dc_values[1] = 0;
+                context.previous_dc_values[2] = 0;
+
+                // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
+                //  the 0th bit of the next byte.
+                if (context.huffman_stream.byte_offset < context.huffman_stream.stream.size()) {
+                    if (context.huffman_stream.bit_offset > 0) {
+                        context.huffman_stream.bit_offset = 0;
                         context.huffman_stream.byte_offset++;
                     }
+
+                    // Skip the restart marker (RSTn).
+                    context.huffman_stream.byte_offset++;
                 }
             }
+        }
 
-            if (!build_macroblocks(context, macroblocks, hcursor, vcursor)) {
-                if constexpr (JPG_DEBUG) {
-                    dbgln("Failed to build Macroblock {}", i);
-                    dbgln("Huffman stream byte offset {}", context.huffman_stream.byte_offset);
-                    dbgln("Huffman stream bit offset {}", context.huffman_stream.bit_offset);
-                }
-                return {};
+        if (!build_macroblocks(context, macroblocks, hcursor, 0)) {
+            if constexpr (JPG_DEBUG) {
+                dbgln("Failed to build Macroblock {}", i);
+                dbgln("Huffman stream byte offset {}", context.huffman_stream.byte_offset);
+                dbgln("Huffman stream bit offset {}", context.huffman_stream.bit_offset);
             }
+            return false;
         }
     }
 
-    return macroblocks;
+    return true;
 }
 
 static inline bool bounds_okay(const size_t cursor, const size_t delta, const size_t bound)
@@ -645,7 +672,7 @@ static bool read_huffman_table(InputMemoryStream& stream, JPGLoadingContext& con
             table.code_counts[i] = count;
         }
 
-        table.codes.ensure_capacity(total_codes);
+        table.symbols.ensure_capacity(total_codes);
 
         // Read symbols. Read X bytes, where X is the sum of the counts of codes read in the previous step.
         for (u32 i = 0; i < total_codes; i++) {
@@ -860,188 +887,123 @@ static bool skip_marker_with_length(InputMemoryStream& stream)
     return !stream.handle_any_error();
 }
 
+// The functions below all work on one row of MCUs, as decoded by decode_huffman_stream().
+
 static void dequantize(JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
 {
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            for (auto it = context.components.begin(); it != context.components.end(); ++it) {
-                auto& component = it->value;
-                const u32* table = component.qtable_id == 0 ? context.luma_table : context.chroma_table;
-                for (u32 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
-                    for (u32 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
-                        u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                        Macroblock& block = macroblocks[mb_index];
-                        int* block_component = component.serial_id == 0 ? block.y : (component.serial_id == 1 ? block.cb : block.cr);
-                        for (u32 k = 0; k < 64; k++)
-                            block_component[k] *= table[k];
-                    }
+    for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
+        for (auto it = context.components.begin(); it != context.components.end(); ++it) {
+            auto& component = it->value;
+            const u32* table = component.qtable_id == 0 ? context.luma_table : context.chroma_table;
+            for (u32 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
+                for (u32 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
+                    u32 mb_index = vfactor_i * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
+                    Macroblock& block = macroblocks[mb_index];
+                    int* block_component = component.serial_id == 0 ? block.y : (component.serial_id == 1 ? block.cb : block.cr);
+                    for (u32 k = 0; k < 64; k++)
+                        block_component[k] *= table[k];
                 }
             }
         }
     }
 }
 
-static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+// This is the "islow" integer IDCT from the IJG's libjpeg (a variant of the Loeffler-Ligtenberg-Moschytz algorithm),
+// using 13-bit fixed point constants. Each vector holds one value for all 8 columns (or rows) of the block, so every
+// pass transforms 8 columns at once.
+using AK::SIMD::i32x8;
+
+constexpr static int idct_constant_bits = 13;
+constexpr static int idct_pass1_bits = 2;
+
+template<int descale_bits>
+ALWAYS_INLINE static void inverse_dct_1d(i32x8* v)
 {
-    static const float m0 = 2.0 * cos(1.0 / 16.0 * 2.0 * M_PI);
-    static const float m1 = 2.0 * cos(2.0 / 16.0 * 2.0 * M_PI);
-    static const float m3 = 2.0 * cos(2.0 / 16.0 * 2.0 * M_PI);
-    static const float m5 = 2.0 * cos(3.0 / 16.0 * 2.0 * M_PI);
-    static const float m2 = m0 - m5;
-    static const float m4 = m0 + m5;
-    static const float s0 = cos(0.0 / 16.0 * M_PI) / sqrt(8);
-    static const float s1 = cos(1.0 / 16.0 * M_PI) / 2.0;
-    static const float s2 = cos(2.0 / 16.0 * M_PI) / 2.0;
-    static const float s3 = cos(3.0 / 16.0 * M_PI) / 2.0;
-    static const float s4 = cos(4.0 / 16.0 * M_PI) / 2.0;
-    static const float s5 = cos(5.0 / 16.0 * M_PI) / 2.0;
-    static const float s6 = cos(6.0 / 16.0 * M_PI) / 2.0;
-    static const float s7 = cos(7.0 / 16.0 * M_PI) / 2.0;
+    // Even part.
+    i32x8 z1 = (v[2] + v[6]) * 4433;
+    i32x8 tmp2 = z1 + v[6] * -15137;
+    i32x8 tmp3 = z1 + v[2] * 6270;
+
+    i32x8 tmp0 = (v[0] + v[4]) << idct_constant_bits;
+    i32x8 tmp1 = (v[0] - v[4]) << idct_constant_bits;
+
+    i32x8 tmp10 = tmp0 + tmp3;
+    i32x8 tmp13 = tmp0 - tmp3;
+    i32x8 tmp11 = tmp1 + tmp2;
+    i32x8 tmp12 = tmp1 - tmp2;
+
+    // Odd part.
+    tmp0 = v[7];
+    tmp1 = v[5];
+    tmp2 = v[3];
+    tmp3 = v[1];
+
+    z1 = tmp0 + tmp3;
+    i32x8 z2 = tmp1 + tmp2;
+    i32x8 z3 = tmp0 + tmp2;
+    i32x8 z4 = tmp1 + tmp3;
+    i32x8 z5 = (z3 + z4) * 9633;
+
+    tmp0 = tmp0 * 2446;
+    tmp1 = tmp1 * 16819;
+    tmp2 = tmp2 * 25172;
+    tmp3 = tmp3 * 12299;
+    z1 = z1 * -7373;
+    z2 = z2 * -20995;
+    z3 = z3 * -16069 + z5;
+    z4 = z4 * -3196 + z5;
+
+    tmp0 += z1 + z3;
+    tmp1 += z2 + z4;
+    tmp2 += z2 + z3;
+    tmp3 += z1 + z4;
+
+    constexpr int rounding = 1 << (descale_bits - 1);
+    v[0] = (tmp10 + tmp3 + rounding) >> descale_bits;
+    v[7] = (tmp10 - tmp3 + rounding) >> descale_bits;
+    v[1] = (tmp11 + tmp2 + rounding) >> descale_bits;
+    v[6] = (tmp11 - tmp2 + rounding) >> descale_bits;
+    v[2] = (tmp12 + tmp1 + rounding) >> descale_bits;
+    v[5] = (tmp12 - tmp1 + rounding) >> descale_bits;
+    v[3] = (tmp13 + tmp0 + rounding) >> descale_bits;
+    v[4] = (tmp13 - tmp0 + rounding) >> descale_bits;
+}
 
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            for (auto it = context.components.begin(); it != context.components.end(); ++it) {
-                auto& component = it->value;
-                for (u8 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
-                    for (u8 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
-                        u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                        Macroblock& block = macroblocks[mb_index];
-                        i32* block_component = component.serial_id == 0 ? block.y : (component.serial_id == 1 ? block.cb : block.cr);
-                        for (u32 k = 0; k < 8; ++k) {
-                            const float g0 = block_component[0 * 8 + k] * s0;
-                            const float g1 = block_component[4 * 8 + k] * s4;
-                            const float g2 = block_component[2 * 8 + k] * s2;
-                            const float g3 = block_component[6 * 8 + k] * s6;
-                            const float g4 = block_component[5 * 8 + k] * s5;
-                            const float g5 = block_component[1 * 8 + k] * s1;
-                            const float g6 = block_component[7 * 8 + k] * s7;
-                            const float g7 = block_component[3 * 8 + k] * s3;
-
-                            const float f0 = g0;
-                            const float f1 = g1;
-                            const float f2 = g2;
-                            const float f3 = g3;
-                            const float f4 = g4 - g7;
-                            const float f5 = g5 + g6;
-                            const float f6 = g5 - g6;
-                            const float f7 = g4 + g7;
-
-                            const float e0 = f0;
-                            const float e1 = f1;
-                            const float e2 = f2 - f3;
-                            const float e3 = f2 + f3;
-                            const float e4 = f4;
-                            const float e5 = f5 - f7;
-                            const float e6 = f6;
-                            const float e7 = f5 + f7;
-                            const float e8 = f4 + f6;
-
-                            const float d0 = e0;
-                            const float d1 = e1;
-                            const float d2 = e2 * m1;
-                            const float d3 = e3;
-                            const float d4 = e4 * m2;
-                            const float d5 = e5 * m3;
-                            const float d6 = e6 * m4;
-                            const float d7 = e7;
-                            const float d8 = e8 * m5;
-
-                            const float c0 = d0 + d1;
-                            const float c1 = d0 - d1;
-                            const float c2 = d2 - d3;
-                            const float c3 = d3;
-                            const float c4 = d4 + d8;
-                            const float c5 = d5 + d7;
-                            const float c6 = d6 - d8;
-                            const float c7 = d7;
-                            const float c8 = c5 - c6;
-
-                            const float b0 = c0 + c3;
-                            const float b1 = c1 + c2;
-                            const float b2 = c1 - c2;
-                            const float b3 = c0 - c3;
-                            const float b4 = c4 - c8;
-                            const float b5 = c8;
-                            const float b6 = c6 - c7;
-                            const float b7 = c7;
-
-                            block_component[0 * 8 + k] = b0 + b7;
-                            block_component[1 * 8 + k] = b1 + b6;
-                            block_component[2 * 8 + k] = b2 + b5;
-                            block_component[3 * 8 + k] = b3 + b4;
-                            block_component[4 * 8 + k] = b3 - b4;
-                            block_component[5 * 8 + k] = b2 - b5;
-                            block_component[6 * 8 + k] = b1 - b6;
-                            block_component[7 * 8 + k] = b0 - b7;
-                        }
-                        for (u32 l = 0; l < 8; ++l) {
-                            const float g0 = block_component[l * 8 + 0] * s0;
-                            const float g1 = block_component[l * 8 + 4] * s4;
-                            const float g2 = block_component[l * 8 + 2] * s2;
-                            const float g3 = block_component[l * 8 + 6] * s6;
-                            const float g4 = block_component[l * 8 + 5] * s5;
-                            const float g5 = block_component[l * 8 + 1] * s1;
-                            const float g6 = block_component[l * 8 + 7] * s7;
-                            const float g7 = block_component[l * 8 + 3] * s3;
-
-                            const float f0 = g0;
-                            const float f1 = g1;
-                            const float f2 = g2;
-                            const float f3 = g3;
-                            const float f4 = g4 - g7;
-                            const float f5 = g5 + g6;
-                            const float f6 = g5 - g6;
-                            const float f7 = g4 + g7;
-
-                            const float e0 = f0;
-                            const float e1 = f1;
-                            const float e2 = f2 - f3;
-                            const float e3 = f2 + f3;
-                            const float e4 = f4;
-                            const float e5 = f5 - f7;
-                            const float e6 = f6;
-                            const float e7 = f5 + f7;
-                            const float e8 = f4 + f6;
-
-                            const float d0 = e0;
-                            const float d1 = e1;
-                            const float d2 = e2 * m1;
-                            const float d3 = e3;
-                            const float d4 = e4 * m2;
-                            const float d5 = e5 * m3;
-                            const float d6 = e6 * m4;
-                            const float d7 = e7;
-                            const float d8 = e8 * m5;
-
-                            const float c0 = d0 + d1;
-                            const float c1 = d0 - d1;
-                            const float c2 = d2 - d3;
-                            const float c3 = d3;
-                            const float c4 = d4 + d8;
-                            const float c5 = d5 + d7;
-                            const float c6 = d6 - d8;
-                            const float c7 = d7;
-                            const float c8 = c5 - c6;
-
-                            const float b0 = c0 + c3;
-                            const float b1 = c1 + c2;
-                            const float b2 = c1 - c2;
-                            const float b3 = c0 - c3;
-                            const float b4 = c4 - c8;
-                            const float b5 = c8;
-                            const float b6 = c6 - c7;
-                            const float b7 = c7;
-
-                            block_component[l * 8 + 0] = b0 + b7;
-                            block_component[l * 8 + 1] = b1 + b6;
-                            block_component[l * 8 + 2] = b2 + b5;
-                            block_component[l * 8 + 3] = b3 + b4;
-                            block_component[l * 8 + 4] = b3 - b4;
-                            block_component[l * 8 + 5] = b2 - b5;
-                            block_component[l * 8 + 6] = b1 - b6;
-                            block_component[l * 8 + 7] = b0 - b7;
-                        }
-                    }
+ALWAYS_INLINE static void transpose(i32x8* v)
+{
+    for (size_t i = 0; i < 8; ++i) {
+        for (size_t j = i + 1; j < 8; ++j) {
+            i32 value = v[i][j];
+            v[i][j] = v[j][i];
+            v[j][i] = value;
+        }
+    }
+}
+
+static void inverse_dct_block(i32* block_component)
+{
+    i32x8 rows[8];
+    __builtin_memcpy(rows, block_component, sizeof(rows));
+
+    inverse_dct_1d<idct_constant_bits - idct_pass1_bits>(rows);
+    transpose(rows);
+    inverse_dct_1d<idct_constant_bits + idct_pass1_bits + 3>(rows);
+    transpose(rows);
+
+    __builtin_memcpy(block_component, rows, sizeof(rows));
+}
+
+static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+{
+    for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
+        for (auto it = context.components.begin(); it != context.components.end(); ++it) {
+            auto& component = it->value;
+            for (u8 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
+                for (u8 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
+                    u32 mb_index = vfactor_i * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
+                    Macroblock& block = macroblocks[mb_index];
+                    i32* block_component = component.serial_id == 0 ? block.y : (component.serial_id == 1 ? block.cb : block.cr);
+                    inverse_dct_block(block_component);
                 }
             }
         }
@@ -1050,30 +1012,27 @@ static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& ma
 
 static void ycbcr_to_rgb(const JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
 {
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            const u32 chroma_block_index = vcursor * context.mblock_meta.hpadded_count + hcursor;
-            const Macroblock& chroma = macroblocks[chroma_block_index];
-            // Overflows are intentional.
-            for (u8 vfactor_i = context.vsample_factor - 1; vfactor_i < context.vsample_factor; --vfactor_i) {
-                for (u8 hfactor_i = context.hsample_factor - 1; hfactor_i < context.hsample_factor; --hfactor_i) {
-                    u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
-                    i32* y = macroblocks[mb_index].y;
-                    i32* cb = macroblocks[mb_index].cb;
-                    i32* cr = macroblocks[mb_index].cr;
-                    for (u8 i = 7; i < 8; --i) {
-                        for (u8 j = 7; j < 8; --j) {
-                            const u8 pixel = i * 8 + j;
-                            const u32 chroma_pxrow = (i / context.vsample_factor) + 4 * vfactor_i;
-                            const u32 chroma_pxcol = (j / context.hsample_factor) + 4 * hfactor_i;
-                            const u32 chroma_pixel = chroma_pxrow * 8 + chroma_pxcol;
-                            int r = y[pixel] + 1.402f * chroma.cr[chroma_pixel] + 128;
-                            int g = y[pixel] - 0.344f * chroma.cb[chroma_pixel] - 0.714f * chroma.cr[chroma_pixel] + 128;
-                            int b = y[pixel] + 1.772f * chroma.cb[chroma_pixel] + 128;
-                            y[pixel] = r < 0 ? 0 : (r > 255 ? 255 : r);
-                            cb[pixel] = g < 0 ? 0 : (g > 255 ? 255 : g);
-                            cr[pixel] = b < 0 ? 0 : (b > 255 ? 255 : b);
-                        }
+    for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
+        const Macroblock& chroma = macroblocks[hcursor];
+        // Overflows are intentional.
+        for (u8 vfactor_i = context.vsample_factor - 1; vfactor_i < context.vsample_factor; --vfactor_i) {
+            for (u8 hfactor_i = context.hsample_factor - 1; hfactor_i < context.hsample_factor; --hfactor_i) {
+                u32 mb_index = vfactor_i * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
+                i32* y = macroblocks[mb_index].y;
+                i32* cb = macroblocks[mb_index].cb;
+                i32* cr = macroblocks[mb_index].cr;
+                for (u8 i = 7; i < 8; --i) {
+                    for (u8 j = 7; j < 8; --j) {
+                        const u8 pixel = i * 8 + j;
+                        const u32 chroma_pxrow = (i / context.vsample_factor) + 4 * vfactor_i;
+                        const u32 chroma_pxcol = (j / context.hsample_factor) + 4 * hfactor_i;
+                        const u32 chroma_pixel = chroma_pxrow * 8 + chroma_pxcol;
+                        int r = y[pixel] + 1.402f * chroma.cr[chroma_pixel] + 128;
+                        int g = y[pixel] - 0.344f * chroma.cb[chroma_pixel] - 0.714f * chroma.cr[chroma_pixel] + 128;
+                        int b = y[pixel] + 1.772f * chroma.cb[chroma_pixel] + 128;
+                        y[pixel] = r < 0 ? 0 : (r > 255 ? 255 : r);
+                        cb[pixel] = g < 0 ? 0 : (g > 255 ? 255 : g);
+                        cr[pixel] = b < 0 ? 0 : (b > 255 ? 255 : b);
                     }
                 }
             }
@@ -1081,26 +1040,23 @@ static void ycbcr_to_rgb(const JPGLoadingContext& context, Vector<Macroblock>& m
     }
 }
 
-static bool compose_bitmap(JPGLoadingContext& context, const Vector<Macroblock>& macroblocks)
+static void compose_bitmap(JPGLoadingContext& context, const Vector<Macroblock>& macroblocks, u32 vcursor)
 {
-    context.bitmap = Bitmap::create_purgeable(BitmapFormat::RGB32, { context.frame.width, context.frame.height });
-    if (!context.bitmap)
-        return false;
+    const u32 first_row = vcursor * 8;
+    const u32 end_row = min<u32>(context.frame.height, (vcursor + context.vsample_factor) * 8);
 
-    for (u32 y = context.frame.height - 1; y < context.frame.height; y--) {
-        const u32 block_row = y / 8;
+    for (u32 y = first_row; y < end_row; y++) {
+        const u32 block_row = (y - first_row) / 8;
         const u32 pixel_row = y % 8;
+        auto* scanline = context.bitmap->scanline(y);
         for (u32 x = 0; x < context.frame.width; x++) {
             const u32 block_column = x / 8;
             auto& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
             const u32 pixel_column = x % 8;
             const u32 pixel_index = pixel_row * 8 + pixel_column;
-            const Color color { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index] };
-            context.bitmap->set_pixel(x, y, color);
+            scanline[x] = Color((u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index]).value();
         }
     }
-
-    return true;
 }
 
 static bool parse_header(InputMemoryStream& stream, JPGLoadingContext& context)
@@ -1225,18 +1181,45 @@ static bool decode_jpg(JPGLoadingContext& context)
     if (!scan_huffman_stream(stream, context))
         return false;
 
-    auto result = decode_huffman_stream(context);
-    if (!result.has_value()) {
-        dbgln<JPG_DEBUG>("{}: Failed to decode Macroblocks!", stream.offset());
-        return false;
+    if constexpr (JPG_DEBUG) {
+        dbgln("Image width: {}", context.frame.width);
+        dbgln("Image height: {}", context.frame.height);
+        dbgln("Macroblocks in a row: {}", context.mblock_meta.hpadded_count);
+        dbgln("Macroblocks in a column: {}", context.mblock_meta.vpadded_count);
+        dbgln("Macroblock meta padded total: {}", context.mblock_meta.padded_total);
     }
 
-    auto macroblocks = result.release_value();
-    dequantize(context, macroblocks);
-    inverse_dct(context, macroblocks);
-    ycbcr_to_rgb(context, macroblocks);
-    if (!compose_bitmap(context, macroblocks))
+    // Compute huffman codes for DC and AC tables.
+    for (auto it = context.dc_tables.begin(); it != context.dc_tables.end(); ++it)
+        generate_huffman_codes(it->value);
+
+    for (auto it = context.ac_tables.begin(); it != context.ac_tables.end(); ++it)
+        generate_huffman_codes(it->value);
+
+    context.bitmap = Bitmap::create_purgeable(BitmapFormat::RGB32, { context.frame.width, context.frame.height });
+    if (!context.bitmap)
         return false;
+
+    // Only one row of MCUs is kept in memory. It is fully decoded and written to the bitmap before the next one is read.
+    Vector<Macroblock> macroblocks;
+    macroblocks.resize(context.mblock_meta.hpadded_count * context.vsample_factor);
+
+    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
+        for (auto& block : macroblocks)
+            block = {};
+
+        if (!decode_huffman_stream(context, macroblocks, vcursor)) {
+            dbgln<JPG_DEBUG>("{}: Failed to decode Macroblocks!", stream.offset());
+            context.bitmap = nullptr;
+            return false;
+        }
+
+        dequantize(context, macroblocks);
+        inverse_dct(context, macroblocks);
+        ycbcr_to_rgb(context, macroblocks);
+        compose_bitmap(context, macroblocks, vcursor);
+    }
+
     return true;
 }
 
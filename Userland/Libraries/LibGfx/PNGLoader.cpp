@@ -28,20 +28,16 @@
 #include <AK/Endian.h>
 #include <AK/LexicalPath.h>
 #include <AK/MappedFile.h>
-#include <LibCore/puff.h>
+#include <AK/MemoryStream.h>
+#include <LibCompress/Zlib.h>
 #include <LibGfx/PNGLoader.h>
 #include <fcntl.h>
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
-#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
-#ifdef __serenity__
-#    include <serenity.h>
-#endif
-
 namespace Gfx {
 
 static const u8 png_header[8] = { 0x89, 'P', 'N', 'G', 13, 10, 26, 10 };
@@ -58,11 +54,6 @@ struct PNG_IHDR {
 
 static_assert(sizeof(PNG_IHDR) == 13);
 
-struct Scanline {
-    u8 filter { 0 };
-    ReadonlyBytes data {};
-};
-
 struct [[gnu::packed]] PaletteEntry {
     u8 r;
     u8 g;
@@ -70,27 +61,6 @@ struct [[gnu::packed]] PaletteEntry {
     //u8 a;
 };
 
-template<typename T>
-struct [[gnu::packed]] Tuple {
-    T gray;
-    T a;
-};
-
-template<typename T>
-struct [[gnu::packed]] Triplet {
-    T r;
-    T g;
-    T b;
-};
-
-template<typename T>
-struct [[gnu::packed]] Quad {
-    T r;
-    T g;
-    T b;
-    T a;
-};
-
 enum PngInterlaceMethod {
     Null = 0,
     Adam7 = 1
@@ -118,10 +88,7 @@ struct PNGLoadingContext {
     u8 channels { 0 };
     bool has_seen_zlib_header { false };
     bool has_alpha() const { return color_type & 4 || palette_transparency_data.size() > 0; }
-    Vector<Scanline> scanlines;
     RefPtr<Gfx::Bitmap> bitmap;
-    u8* decompression_buffer { nullptr };
-    size_t decompression_buffer_size { 0 };
     Vector<u8> compressed_data;
     Vector<PaletteEntry> palette_data;
     Vector<u8> palette_transparency_data;
@@ -222,169 +189,113 @@ ALWAYS_INLINE static u8 paeth_predictor(int a, int b, int c)
     return c;
 }
 
-union [[gnu::packed]] Pixel {
-    RGBA32 rgba { 0 };
-    u8 v[4];
-    struct {
-        u8 r;
-        u8 g;
-        u8 b;
-        u8 a;
-    };
-};
-static_assert(sizeof(Pixel) == 4);
-
-template<bool has_alpha, u8 filter_type>
-ALWAYS_INLINE static void unfilter_impl(Gfx::Bitmap& bitmap, int y, const void* dummy_scanline_data)
+ALWAYS_INLINE static RGBA32 make_pixel(u8 r, u8 g, u8 b, u8 a = 0xff)
 {
-    auto* dummy_scanline = (const Pixel*)dummy_scanline_data;
-    if constexpr (filter_type == 0) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        for (int i = 0; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-        }
-    }
+    return a << 24 | r << 16 | g << 8 | b;
+}
 
-    if constexpr (filter_type == 1) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        swap(pixels[0].r, pixels[0].b);
-        for (int i = 1; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-            auto& a = (const Pixel&)pixels[i - 1];
-            x.v[0] += a.v[0];
-            x.v[1] += a.v[1];
-            x.v[2] += a.v[2];
-            if constexpr (has_alpha)
-                x.v[3] += a.v[3];
-        }
+// Reverses the filter of a single scanline in place, using the already unfiltered previous one.
+// Filters operate on bytes, with "pixel to the left" meaning bytes_per_pixel bytes earlier.
+ALWAYS_INLINE static void unfilter_scanline(u8 filter, u8* scanline, const u8* previous_scanline, size_t size, size_t bytes_per_pixel)
+{
+    switch (filter) {
+    case 0:
         return;
-    }
-    if constexpr (filter_type == 2) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        auto* pixels_y_minus_1 = y == 0 ? dummy_scanline : (const Pixel*)bitmap.scanline(y - 1);
-        for (int i = 0; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-            const Pixel& b = pixels_y_minus_1[i];
-            x.v[0] += b.v[0];
-            x.v[1] += b.v[1];
-            x.v[2] += b.v[2];
-            if constexpr (has_alpha)
-                x.v[3] += b.v[3];
-        }
+    case 1:
+        for (size_t i = bytes_per_pixel; i < size; ++i)
+            scanline[i] += scanline[i - bytes_per_pixel];
         return;
-    }
-    if constexpr (filter_type == 3) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        auto* pixels_y_minus_1 = y == 0 ? dummy_scanline : (const Pixel*)bitmap.scanline(y - 1);
-        for (int i = 0; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-            Pixel a;
-            if (i != 0)
-                a = pixels[i - 1];
-            const Pixel& b = pixels_y_minus_1[i];
-            x.v[0] = x.v[0] + ((a.v[0] + b.v[0]) / 2);
-            x.v[1] = x.v[1] + ((a.v[1] + b.v[1]) / 2);
-            x.v[2] = x.v[2] + ((a.v[2] + b.v[2]) / 2);
-            if constexpr (has_alpha)
-                x.v[3] = x.v[3] + ((a.v[3] + b.v[3]) / 2);
-        }
+    case 2:
+        for (size_t i = 0; i < size; ++i)
+            scanline[i] += previous_scanline[i];
         return;
-    }
-    if constexpr (filter_type == 4) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        auto* pixels_y_minus_1 = y == 0 ? dummy_scanline : (Pixel*)bitmap.scanline(y - 1);
-        for (int i = 0; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-            Pixel a;
-            const Pixel& b = pixels_y_minus_1[i];
-            Pixel c;
-            if (i != 0) {
-                a = pixels[i - 1];
-                c = pixels_y_minus_1[i - 1];
-            }
-            x.v[0] += paeth_predictor(a.v[0], b.v[0], c.v[0]);
-            x.v[1] += paeth_predictor(a.v[1], b.v[1], c.v[1]);
-            x.v[2] += paeth_predictor(a.v[2], b.v[2], c.v[2]);
-            if constexpr (has_alpha)
-                x.v[3] += paeth_predictor(a.v[3], b.v[3], c.v[3]);
-        }
+    case 3:
+        for (size_t i = 0; i < bytes_per_pixel; ++i)
+            scanline[i] += previous_scanline[i] / 2;
+        for (size_t i = bytes_per_pixel; i < size; ++i)
+            scanline[i] += (scanline[i - bytes_per_pixel] + previous_scanline[i]) / 2;
+        return;
+    case 4:
+        for (size_t i = 0; i < bytes_per_pixel; ++i)
+            scanline[i] += previous_scanline[i];
+        for (size_t i = bytes_per_pixel; i < size; ++i)
+            scanline[i] += paeth_predictor(scanline[i - bytes_per_pixel], previous_scanline[i], previous_scanline[i - bytes_per_pixel]);
+        return;
+    default:
+        ASSERT_NOT_REACHED();
     }
 }
 
+// 16-bit samples are stored most significant byte first, and that byte is all we keep.
 template<typename T>
-ALWAYS_INLINE static void unpack_grayscale_without_alpha(PNGLoadingContext& context)
+ALWAYS_INLINE static u8 sample_at(const u8* data, size_t index)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* gray_values = reinterpret_cast<const T*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = gray_values[i];
-            pixel.g = gray_values[i];
-            pixel.b = gray_values[i];
-            pixel.a = 0xff;
-        }
-    }
+    return data[index * sizeof(T)];
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_grayscale_with_alpha(PNGLoadingContext& context)
+ALWAYS_INLINE static void unpack_grayscale_without_alpha(PNGLoadingContext& context, RGBA32* pixels, const u8* data)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* tuples = reinterpret_cast<const Tuple<T>*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = tuples[i].gray;
-            pixel.g = tuples[i].gray;
-            pixel.b = tuples[i].gray;
-            pixel.a = tuples[i].a;
-        }
+    for (int i = 0; i < context.width; ++i) {
+        auto gray = sample_at<T>(data, i);
+        pixels[i] = make_pixel(gray, gray, gray);
     }
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_triplets_without_alpha(PNGLoadingContext& context)
+ALWAYS_INLINE static void unpack_grayscale_with_alpha(PNGLoadingContext& context, RGBA32* pixels, const u8* data)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* triplets = reinterpret_cast<const Triplet<T>*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = triplets[i].r;
-            pixel.g = triplets[i].g;
-            pixel.b = triplets[i].b;
-            pixel.a = 0xff;
-        }
+    for (int i = 0; i < context.width; ++i) {
+        auto gray = sample_at<T>(data, i * 2);
+        pixels[i] = make_pixel(gray, gray, gray, sample_at<T>(data, i * 2 + 1));
     }
 }
 
-NEVER_INLINE FLATTEN static bool unfilter(PNGLoadingContext& context)
+template<typename T>
+ALWAYS_INLINE static void unpack_triplets_without_alpha(PNGLoadingContext& context, RGBA32* pixels, const u8* data)
+{
+    for (int i = 0; i < context.width; ++i)
+        pixels[i] = make_pixel(sample_at<T>(data, i * 3), sample_at<T>(data, i * 3 + 1), sample_at<T>(data, i * 3 + 2));
+}
+
+template<typename T>
+ALWAYS_INLINE static void unpack_quads(PNGLoadingContext& context, RGBA32* pixels, const u8* data)
+{
+    for (int i = 0; i < context.width; ++i)
+        pixels[i] = make_pixel(sample_at<T>(data, i * 4), sample_at<T>(data, i * 4 + 1), sample_at<T>(data, i * 4 + 2), sample_at<T>(data, i * 4 + 3));
+}
+
+ALWAYS_INLINE static bool unpack_palette_index(PNGLoadingContext& context, RGBA32& pixel, size_t palette_index)
+{
+    if (palette_index >= context.palette_data.size())
+        return false;
+    auto& color = context.palette_data.at(palette_index);
+    auto transparency = context.palette_transparency_data.size() >= palette_index + 1u
+        ? context.palette_transparency_data.data()[palette_index]
+        : 0xff;
+    pixel = make_pixel(color.r, color.g, color.b, transparency);
+    return true;
+}
+
+// Converts an unfiltered scanline to RGBA and stores it in row y of the bitmap.
+static bool unpack_scanline(PNGLoadingContext& context, int y, const u8* data)
 {
-    // First unpack the scanlines to RGBA:
+    auto* pixels = context.bitmap->scanline(y);
+
     switch (context.color_type) {
     case 0:
         if (context.bit_depth == 8) {
-            unpack_grayscale_without_alpha<u8>(context);
+            unpack_grayscale_without_alpha<u8>(context, pixels, data);
         } else if (context.bit_depth == 16) {
-            unpack_grayscale_without_alpha<u16>(context);
+            unpack_grayscale_without_alpha<u16>(context, pixels, data);
         } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
-            auto bit_depth_squared = context.bit_depth * context.bit_depth;
             auto pixels_per_byte = 8 / context.bit_depth;
             auto mask = (1 << context.bit_depth) - 1;
-            for (int y = 0; y < context.height; ++y) {
-                auto* gray_values = context.scanlines[y].data.data();
-                for (int x = 0; x < context.width; ++x) {
-                    auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (x % pixels_per_byte));
-                    auto value = (gray_values[x / pixels_per_byte] >> bit_offset) & mask;
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[x];
-                    pixel.r = value * (0xff / bit_depth_squared);
-                    pixel.g = value * (0xff / bit_depth_squared);
-                    pixel.b = value * (0xff / bit_depth_squared);
-                    pixel.a = 0xff;
-                }
+            auto scale = 0xff / mask;
+            for (int x = 0; x < context.width; ++x) {
+                auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (x % pixels_per_byte));
+                u8 value = ((data[x / pixels_per_byte] >> bit_offset) & mask) * scale;
+                pixels[x] = make_pixel(value, value, value);
             }
         } else {
             ASSERT_NOT_REACHED();
@@ -392,80 +303,45 @@ NEVER_INLINE FLATTEN static bool unfilter(PNGLoadingContext& context)
         break;
     case 4:
         if (context.bit_depth == 8) {
-            unpack_grayscale_with_alpha<u8>(context);
+            unpack_grayscale_with_alpha<u8>(context, pixels, data);
         } else if (context.bit_depth == 16) {
-            unpack_grayscale_with_alpha<u16>(context);
+            unpack_grayscale_with_alpha<u16>(context, pixels, data);
         } else {
             ASSERT_NOT_REACHED();
         }
         break;
     case 2:
         if (context.bit_depth == 8) {
-            unpack_triplets_without_alpha<u8>(context);
+            unpack_triplets_without_alpha<u8>(context, pixels, data);
         } else if (context.bit_depth == 16) {
-            unpack_triplets_without_alpha<u16>(context);
+            unpack_triplets_without_alpha<u16>(context, pixels, data);
         } else {
             ASSERT_NOT_REACHED();
         }
         break;
     case 6:
         if (context.bit_depth == 8) {
-            for (int y = 0; y < context.height; ++y) {
-                memcpy(context.bitmap->scanline(y), context.scanlines[y].data.data(), context.scanlines[y].data.size());
-            }
+            unpack_quads<u8>(context, pixels, data);
         } else if (context.bit_depth == 16) {
-            for (int y = 0; y < context.height; ++y) {
-                auto* triplets = reinterpret_cast<const Quad<u16>*>(context.scanlines[y].data.data());
-                for (int i = 0; i < context.width; ++i) {
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    pixel.r = triplets[i].r & 0xFF;
-                    pixel.g = triplets[i].g & 0xFF;
-                    pixel.b = triplets[i].b & 0xFF;
-                    pixel.a = triplets[i].a & 0xFF;
-                }
-            }
+            unpack_quads<u16>(context, pixels, data);
         } else {
             ASSERT_NOT_REACHED();
         }
         break;
     case 3:
         if (context.bit_depth == 8) {
-            for (int y = 0; y < context.height; ++y) {
-                auto* palette_index = context.scanlines[y].data.data();
-                for (int i = 0; i < context.width; ++i) {
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    if (palette_index[i] >= context.palette_data.size())
-                        return false;
-                    auto& color = context.palette_data.at((int)palette_index[i]);
-                    auto transparency = context.palette_transparency_data.size() >= palette_index[i] + 1u
-                        ? context.palette_transparency_data.data()[palette_index[i]]
-                        : 0xff;
-                    pixel.r = color.r;
-                    pixel.g = color.g;
-                    pixel.b = color.b;
-                    pixel.a = transparency;
-                }
+            for (int i = 0; i < context.width; ++i) {
+                if (!unpack_palette_index(context, pixels[i], data[i]))
+                    return false;
             }
         } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
             auto pixels_per_byte = 8 / context.bit_depth;
             auto mask = (1 << context.bit_depth) - 1;
-            for (int y = 0; y < context.height; ++y) {
-                auto* palette_indexes = context.scanlines[y].data.data();
-                for (int i = 0; i < context.width; ++i) {
-                    auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (i % pixels_per_byte));
-                    auto palette_index = (palette_indexes[i / pixels_per_byte] >> bit_offset) & mask;
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    if ((size_t)palette_index >= context.palette_data.size())
-                        return false;
-                    auto& color = context.palette_data.at(palette_index);
-                    auto transparency = context.palette_transparency_data.size() >= palette_index + 1u
-                        ? context.palette_transparency_data.data()[palette_index]
-                        : 0xff;
-                    pixel.r = color.r;
-                    pixel.g = color.g;
-                    pixel.b = color.b;
-                    pixel.a = transparency;
-                }
+            for (int i = 0; i < context.width; ++i) {
+                auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (i % pixels_per_byte));
+                auto palette_index = (data[i / pixels_per_byte] >> bit_offset) & mask;
+                if (!unpack_palette_index(context, pixels[i], palette_index))
+                    return false;
             }
         } else {
             ASSERT_NOT_REACHED();
@@ -476,45 +352,43 @@ NEVER_INLINE FLATTEN static bool unfilter(PNGLoadingContext& context)
         break;
     }
 
-    u8 dummy_scanline[context.width * sizeof(RGBA32)];
+    return true;
+}
+
+// Reads, unfilters and unpacks the scanlines of context.bitmap one at a time as they come out of the decompressor,
+// so only two scanlines of decompressed data are ever held in memory.
+NEVER_INLINE FLATTEN static bool decode_scanlines(PNGLoadingContext& context, InputStream& stream)
+{
+    auto row_size = context.compute_row_size_for_width(context.width);
+    if (row_size.has_overflow())
+        return false;
+
+    size_t scanline_size = row_size.value();
+    size_t bytes_per_pixel = max(1, context.channels * context.bit_depth / 8);
+
+    // The scanline before the first one is treated as all zeroes.
+    auto scanline_buffers = ByteBuffer::create_zeroed(2 * scanline_size);
+    u8* scanline = scanline_buffers.data();
+    u8* previous_scanline = scanline_buffers.data() + scanline_size;
 
     for (int y = 0; y < context.height; ++y) {
-        auto filter = context.scanlines[y].filter;
-        if (filter == 0) {
-            if (context.has_alpha())
-                unfilter_impl<true, 0>(*context.bitmap, y, dummy_scanline);
-            else
-                unfilter_impl<false, 0>(*context.bitmap, y, dummy_scanline);
-            continue;
-        }
-        if (filter == 1) {
-            if (context.has_alpha())
-                unfilter_impl<true, 1>(*context.bitmap, y, dummy_scanline);
-            else
-                unfilter_impl<false, 1>(*context.bitmap, y, dummy_scanline);
-            continue;
-        }
-        if (filter == 2) {
-            if (context.has_alpha())
-                unfilter_impl<true, 2>(*context.bitmap, y, dummy_scanline);
-            else
-                unfilter_impl<false, 2>(*context.bitmap, y, dummy_scanline);
-            continue;
-        }
-        if (filter == 3) {
-            if (context.has_alpha())
-                unfilter_impl<true, 3>(*context.bitmap, y, dummy_scanline);
-            else
-                unfilter_impl<false, 3>(*context.bitmap, y, dummy_scanline);
-            continue;
-        }
-        if (filter == 4) {
-            if (context.has_alpha())
-                unfilter_impl<true, 4>(*context.bitmap, y, dummy_scanline);
-            else
-                unfilter_impl<false, 4>(*context.bitmap, y, dummy_scanline);
-            continue;
+        u8 filter;
+        if (!stream.read_or_error({ &filter, sizeof(filter) }))
+            return false;
+
+        if (filter > 4) {
+            dbgln<PNG_DEBUG>("Invalid PNG filter: {}", filter);
+            return false;
         }
+
+        if (!stream.read_or_error({ scanline, scanline_size }))
+            return false;
+
+        unfilter_scanline(filter, scanline, previous_scanline, scanline_size, bytes_per_pixel);
+        if (!unpack_scanline(context, y, scanline))
+            return false;
+
+        swap(scanline, previous_scanline);
     }
 
     return true;
@@ -601,43 +475,13 @@ static bool decode_png_chunks(PNGLoadingContext& context)
     return true;
 }
 
-static bool decode_png_bitmap_simple(PNGLoadingContext& context)
+static bool decode_png_bitmap_simple(PNGLoadingContext& context, InputStream& stream)
 {
-    Streamer streamer(context.decompression_buffer, context.decompression_buffer_size);
-
-    for (int y = 0; y < context.height; ++y) {
-        u8 filter;
-        if (!streamer.read(filter)) {
-            context.state = PNGLoadingContext::State::Error;
-            return false;
-        }
-
-        if (filter > 4) {
-            dbgln<PNG_DEBUG>("Invalid PNG filter: {}", filter);
-            context.state = PNGLoadingContext::State::Error;
-            return false;
-        }
-
-        context.scanlines.append({ filter });
-        auto& scanline_buffer = context.scanlines.last().data;
-        auto row_size = context.compute_row_size_for_width(context.width);
-        if (row_size.has_overflow())
-            return false;
-
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
-            context.state = PNGLoadingContext::State::Error;
-            return false;
-        }
-    }
-
     context.bitmap = Bitmap::create_purgeable(context.has_alpha() ? BitmapFormat::RGBA32 : BitmapFormat::RGB32, { context.width, context.height });
-
-    if (!context.bitmap) {
-        context.state = PNGLoadingContext::State::Error;
+    if (!context.bitmap)
         return false;
-    }
 
-    return unfilter(context);
+    return decode_scanlines(context, stream);
 }
 
 static int adam7_height(PNGLoadingContext& context, int pass)
@@ -690,7 +534,7 @@ static int adam7_startx[8] = { 0, 0, 4, 0, 2, 0, 1, 0 };
 static int adam7_stepy[8] = { 1, 8, 8, 8, 4, 4, 2, 2 };
 static int adam7_stepx[8] = { 1, 8, 8, 4, 4, 2, 2, 1 };
 
-static bool decode_adam7_pass(PNGLoadingContext& context, Streamer& streamer, int pass)
+static bool decode_adam7_pass(PNGLoadingContext& context, InputStream& stream, int pass)
 {
     PNGLoadingContext subimage_context;
     subimage_context.width = adam7_width(context, pass);
@@ -706,37 +550,12 @@ static bool decode_adam7_pass(PNGLoadingContext& context, Streamer& streamer, in
     if (!subimage_context.width || !subimage_context.height)
         return true;
 
-    subimage_context.scanlines.clear_with_capacity();
-    for (int y = 0; y < subimage_context.height; ++y) {
-        u8 filter;
-        if (!streamer.read(filter)) {
-            context.state = PNGLoadingContext::State::Error;
-            return false;
-        }
-
-        if (filter > 4) {
-            dbgln<PNG_DEBUG>("Invalid PNG filter: {}", filter);
-            context.state = PNGLoadingContext::State::Error;
-            return false;
-        }
-
-        subimage_context.scanlines.append({ filter });
-        auto& scanline_buffer = subimage_context.scanlines.last().data;
-
-        auto row_size = context.compute_row_size_for_width(subimage_context.width);
-        if (row_size.has_overflow())
-            return false;
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
-            context.state = PNGLoadingContext::State::Error;
-            return false;
-        }
-    }
-
     subimage_context.bitmap = Bitmap::create(context.bitmap->format(), { subimage_context.width, subimage_context.height });
-    if (!unfilter(subimage_context)) {
-        subimage_context.bitmap = nullptr;
+    if (!subimage_context.bitmap)
+        return false;
+
+    if (!decode_scanlines(subimage_context, stream))
         return false;
-    }
 
     // Copy the subimage data into the main image according to the pass pattern
     for (int y = 0, dy = adam7_starty[pass]; y < subimage_context.height && dy < context.height; ++y, dy += adam7_stepy[pass]) {
@@ -747,15 +566,14 @@ static bool decode_adam7_pass(PNGLoadingContext& context, Streamer& streamer, in
     return true;
 }
 
-static bool decode_png_adam7(PNGLoadingContext& context)
+static bool decode_png_adam7(PNGLoadingContext& context, InputStream& stream)
 {
-    Streamer streamer(context.decompression_buffer, context.decompression_buffer_size);
     context.bitmap = Bitmap::create_purgeable(context.has_alpha() ? BitmapFormat::RGBA32 : BitmapFormat::RGB32, { context.width, context.height });
     if (!context.bitmap)
         return false;
 
     for (int pass = 1; pass <= 7; ++pass) {
-        if (!decode_adam7_pass(context, streamer, pass))
+        if (!decode_adam7_pass(context, stream, pass))
             return false;
     }
     return true;
@@ -777,44 +595,30 @@ static bool decode_png_bitmap(PNGLoadingContext& context)
     if (context.color_type == 3 && context.palette_data.is_empty())
         return false; // Didn't see a PLTE chunk for a palettized image, or it was empty.
 
-    unsigned long srclen = context.compressed_data.size() - 6;
-    unsigned long destlen = 0;
-    int ret = puff(nullptr, &destlen, context.compressed_data.data() + 2, &srclen);
-    if (ret != 0) {
-        context.state = PNGLoadingContext::State::Error;
-        return false;
-    }
-    context.decompression_buffer_size = destlen;
-#ifdef __serenity__
-    context.decompression_buffer = (u8*)mmap_with_name(nullptr, context.decompression_buffer_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0, "PNG decompression buffer");
-#else
-    context.decompression_buffer = (u8*)mmap(nullptr, context.decompression_buffer_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0);
-#endif
+    InputMemoryStream compressed_stream { context.compressed_data };
+    Compress::ZlibDecompressor decompressor { compressed_stream };
 
-    ret = puff(context.decompression_buffer, &destlen, context.compressed_data.data() + 2, &srclen);
-    if (ret != 0) {
-        context.state = PNGLoadingContext::State::Error;
-        return false;
-    }
-    context.compressed_data.clear();
-
-    context.scanlines.ensure_capacity(context.height);
+    bool success = false;
     switch (context.interlace_method) {
     case PngInterlaceMethod::Null:
-        if (!decode_png_bitmap_simple(context))
-            return false;
+        success = decode_png_bitmap_simple(context, decompressor);
         break;
     case PngInterlaceMethod::Adam7:
-        if (!decode_png_adam7(context))
-            return false;
+        success = decode_png_adam7(context, decompressor);
         break;
     default:
         ASSERT_NOT_REACHED();
     }
 
-    munmap(context.decompression_buffer, context.decompression_buffer_size);
-    context.decompression_buffer = nullptr;
-    context.decompression_buffer_size = 0;
+    decompressor.handle_any_error();
+    compressed_stream.handle_any_error();
+    context.compressed_data.clear();
+
+    if (!success) {
+        context.bitmap = nullptr;
+        context.state = PNGLoadingContext::State::Error;
+        return false;
+    }
 
     context.state = PNGLoadingContext::State::BitmapDecoded;
     return true;
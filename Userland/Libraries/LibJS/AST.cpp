@@ -25,6 +25,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <AK/Debug.h>
 #include <AK/Demangle.h>
 #include <AK/HashMap.h>
 #include <AK/HashTable.h>
@@ -79,13 +80,13 @@ static void update_function_name(Value value, const FlyString& name, HashTable<J
     }
 }
 
-static void update_function_name(Value value, const FlyString& name)
+void update_function_name(Value value, const FlyString& name)
 {
     HashTable<JS::Cell*> visited;
     update_function_name(value, name, visited);
 }
 
-static String get_function_name(GlobalObject& global_object, Value value)
+String get_function_name(GlobalObject& global_object, Value value)
 {
     if (value.is_symbol())
         return String::formatted("[{}]", value.as_symbol().description());
@@ -94,6 +95,10 @@ static String get_function_name(GlobalObject& global_object, Value value)
     return value.to_string(global_object);
 }
 
+ScopeNode::~ScopeNode()
+{
+}
+
 Value ScopeNode::execute(Interpreter& interpreter, GlobalObject& global_object) const
 {
     interpreter.enter_node(*this);
@@ -167,8 +172,13 @@ CallExpression::ThisAndCallee CallExpression::compute_this_and_callee(Interprete
         auto property_name = member_expression.computed_property_name(interpreter, global_object);
         if (!property_name.is_valid())
             return {};
-        auto callee = lookup_target.to_object(global_object)->get(property_name).value_or(js_undefined());
-        return { this_value, callee };
+        auto* lookup_object = lookup_target.to_object(global_object);
+        Value callee;
+        if (!is_super_property_lookup && !member_expression.is_computed())
+            callee = lookup_object->get_with_cache(property_name, member_expression.property_cache());
+        else
+            callee = lookup_object->get(property_name);
+        return { this_value, callee.value_or(js_undefined()) };
     }
     return { &global_object, m_callee->execute(interpreter, global_object) };
 }
@@ -682,7 +692,10 @@ Reference MemberExpression::to_reference(Interpreter& interpreter, GlobalObject&
     auto property_name = computed_property_name(interpreter, global_object);
     if (!property_name.is_valid())
         return {};
-    return { object_value, property_name };
+    Reference reference { object_value, property_name };
+    if (!is_computed())
+        reference.set_property_cache(&m_property_cache);
+    return reference;
 }
 
 Value UnaryExpression::execute(Interpreter& interpreter, GlobalObject& global_object) const
@@ -1755,6 +1768,17 @@ void MemberExpression::dump(int indent) const
     m_property->dump(indent + 1);
 }
 
+MemberExpression::~MemberExpression()
+{
+    if constexpr (JS_PROPERTY_CACHE_DEBUG) {
+        if (m_property_cache.hits() || m_property_cache.misses()) {
+            dbgln("Property cache for {} at {}:{}: {} hits, {} misses, {} shapes",
+                to_string_approximation(), source_range().start.line, source_range().start.column,
+                m_property_cache.hits(), m_property_cache.misses(), m_property_cache.entry_count());
+        }
+    }
+}
+
 PropertyName MemberExpression::computed_property_name(Interpreter& interpreter, GlobalObject& global_object) const
 {
     if (!is_computed()) {
@@ -1793,6 +1817,8 @@ Value MemberExpression::execute(Interpreter& interpreter, GlobalObject& global_o
     auto property_name = computed_property_name(interpreter, global_object);
     if (!property_name.is_valid())
         return {};
+    if (!is_computed())
+        return object_result->get_with_cache(property_name, m_property_cache).value_or(js_undefined());
     return object_result->get(property_name).value_or(js_undefined());
 }
 
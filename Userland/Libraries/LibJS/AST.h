@@ -30,10 +30,15 @@
 #include <AK/FlyString.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullRefPtrVector.h>
+#include <AK/Optional.h>
+#include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Register.h>
 #include <LibJS/Forward.h>
+#include <LibJS/Runtime/PropertyCache.h>
 #include <LibJS/Runtime/PropertyName.h>
 #include <LibJS/Runtime/Value.h>
 #include <LibJS/SourceRange.h>
@@ -54,6 +59,7 @@ class ASTNode : public RefCounted<ASTNode> {
 public:
     virtual ~ASTNode() { }
     virtual Value execute(Interpreter&, GlobalObject&) const = 0;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const;
     virtual void dump(int indent) const;
 
     const SourceRange& source_range() const { return m_source_range; }
@@ -92,6 +98,7 @@ public:
     {
     }
     Value execute(Interpreter&, GlobalObject&) const override { return js_undefined(); }
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
 };
 
 class ErrorStatement final : public Statement {
@@ -112,6 +119,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
     const Expression& expression() const { return m_expression; };
@@ -136,6 +144,7 @@ public:
 
     const NonnullRefPtrVector<Statement>& children() const { return m_children; }
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
     void add_variables(NonnullRefPtrVector<VariableDeclaration>);
@@ -143,6 +152,11 @@ public:
     const NonnullRefPtrVector<VariableDeclaration>& variables() const { return m_variables; }
     const NonnullRefPtrVector<FunctionDeclaration>& functions() const { return m_functions; }
 
+    virtual ~ScopeNode() override;
+
+    // Compiles this scope on first use. Returns nullptr if it contains constructs the bytecode generator doesn't support.
+    const Bytecode::Executable* bytecode_executable() const;
+
 protected:
     ScopeNode(SourceRange source_range)
         : Statement(move(source_range))
@@ -153,6 +167,9 @@ private:
     NonnullRefPtrVector<Statement> m_children;
     NonnullRefPtrVector<VariableDeclaration> m_variables;
     NonnullRefPtrVector<FunctionDeclaration> m_functions;
+
+    mutable OwnPtr<Bytecode::Executable> m_bytecode_executable;
+    mutable bool m_bytecode_generation_attempted { false };
 };
 
 class Program final : public ScopeNode {
@@ -256,6 +273,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 };
 
@@ -273,8 +291,11 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
+    bool is_arrow_function() const { return m_is_arrow_function; }
+
 private:
     bool m_is_arrow_function;
 };
@@ -300,6 +321,7 @@ public:
     const Expression* argument() const { return m_argument; }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -321,6 +343,7 @@ public:
     const Statement* alternate() const { return m_alternate; }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -342,6 +365,7 @@ public:
     const Statement& body() const { return *m_body; }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -362,6 +386,7 @@ public:
     const Statement& body() const { return *m_body; }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -406,6 +431,7 @@ public:
     const Statement& body() const { return *m_body; }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -497,6 +523,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -522,6 +549,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -550,6 +578,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -567,6 +596,7 @@ public:
 
     virtual void dump(int indent) const override;
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
 
 private:
     NonnullRefPtrVector<Expression> m_expressions;
@@ -589,6 +619,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -604,6 +635,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -635,6 +667,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
     StringView value() const { return m_value; }
@@ -653,6 +686,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 };
 
@@ -687,6 +721,7 @@ public:
     const FlyString& string() const { return m_string; }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
     virtual Reference to_reference(Interpreter&, GlobalObject&) const override;
 
@@ -796,6 +831,7 @@ public:
     {
     }
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 };
 
@@ -814,6 +850,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -865,6 +902,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -889,6 +927,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -941,6 +980,7 @@ public:
     DeclarationKind declaration_kind() const { return m_declaration_kind; }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
     const NonnullRefPtrVector<VariableDeclarator>& declarations() const { return m_declarations; }
@@ -997,6 +1037,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -1014,6 +1055,7 @@ public:
     const Vector<RefPtr<Expression>>& elements() const { return m_elements; }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -1036,6 +1078,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
     const NonnullRefPtrVector<Expression>& expressions() const { return m_expressions; }
@@ -1073,7 +1116,10 @@ public:
     {
     }
 
+    virtual ~MemberExpression() override;
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
     virtual Reference to_reference(Interpreter&, GlobalObject&) const override;
 
@@ -1085,10 +1131,14 @@ public:
 
     String to_string_approximation() const;
 
+    // Only used for non-computed accesses, as those always name the same property.
+    PropertyCache& property_cache() const { return m_property_cache; }
+
 private:
     NonnullRefPtr<Expression> m_object;
     NonnullRefPtr<Expression> m_property;
     bool m_computed { false };
+    mutable PropertyCache m_property_cache;
 };
 
 class MetaProperty final : public Expression {
@@ -1123,6 +1173,7 @@ public:
 
     virtual void dump(int indent) const override;
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
 
 private:
     NonnullRefPtr<Expression> m_test;
@@ -1236,6 +1287,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
 
     const FlyString& target_label() const { return m_target_label; }
 
@@ -1252,6 +1304,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
 
     const FlyString& target_label() const { return m_target_label; }
 
@@ -1269,4 +1322,7 @@ public:
     virtual Value execute(Interpreter&, GlobalObject&) const override;
 };
 
+void update_function_name(Value, const FlyString& name);
+String get_function_name(GlobalObject&, Value);
+
 }
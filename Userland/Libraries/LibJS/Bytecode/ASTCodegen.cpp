@@ -0,0 +1,707 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/Op.h>
+
+namespace JS {
+
+Optional<Bytecode::Register> ASTNode::generate_bytecode(Bytecode::Generator& generator) const
+{
+    generator.fail(*this);
+    return {};
+}
+
+const Bytecode::Executable* ScopeNode::bytecode_executable() const
+{
+    if (!m_bytecode_generation_attempted) {
+        m_bytecode_executable = Bytecode::Generator::generate(*this);
+        m_bytecode_generation_attempted = true;
+    }
+    return m_bytecode_executable;
+}
+
+Optional<Bytecode::Register> ScopeNode::generate_bytecode(Bytecode::Generator& generator) const
+{
+    // Labelled blocks can be the target of a break, which we don't track outside of loops.
+    if (!label().is_null()) {
+        generator.fail(*this);
+        return {};
+    }
+
+    bool needs_scope = !variables().is_empty() || !functions().is_empty();
+    if (needs_scope)
+        generator.enter_scope(*this);
+    for (auto& child : children())
+        generator.emit_statement(child);
+    if (needs_scope)
+        generator.exit_scope(*this);
+    return {};
+}
+
+Optional<Bytecode::Register> EmptyStatement::generate_bytecode(Bytecode::Generator&) const
+{
+    return {};
+}
+
+Optional<Bytecode::Register> ExpressionStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto value = generator.emit_expression(*m_expression);
+    if (generator.completion_register().has_value())
+        generator.emit<Bytecode::Op::Load>(generator.completion_register().value(), value);
+    return {};
+}
+
+Optional<Bytecode::Register> FunctionDeclaration::generate_bytecode(Bytecode::Generator&) const
+{
+    // Function declarations are hoisted when their scope is entered.
+    return {};
+}
+
+Optional<Bytecode::Register> FunctionExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    generator.emit<Bytecode::Op::NewFunction>(dst, *this);
+    return dst;
+}
+
+Optional<Bytecode::Register> ReturnStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    Optional<Bytecode::Register> value;
+    if (m_argument) {
+        value = generator.emit_expression(*m_argument);
+    } else {
+        value = generator.allocate_register();
+        generator.emit<Bytecode::Op::LoadImmediate>(*value, js_undefined());
+    }
+    generator.emit<Bytecode::Op::Return>(*value);
+    return {};
+}
+
+Optional<Bytecode::Register> IfStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto predicate = generator.emit_expression(*m_predicate);
+    auto else_jump = generator.emit<Bytecode::Op::JumpIfFalse>(predicate);
+    generator.emit_statement(*m_consequent);
+    if (m_alternate) {
+        auto end_jump = generator.emit<Bytecode::Op::Jump>();
+        generator.patch_jump(else_jump, generator.make_label());
+        generator.emit_statement(*m_alternate);
+        generator.patch_jump(end_jump, generator.make_label());
+    } else {
+        generator.patch_jump(else_jump, generator.make_label());
+    }
+    return {};
+}
+
+Optional<Bytecode::Register> WhileStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    generator.begin_loop(m_label);
+    auto test_label = generator.make_label();
+    auto test = generator.emit_expression(*m_test);
+    auto exit_jump = generator.emit<Bytecode::Op::JumpIfFalse>(test);
+    generator.emit_statement(*m_body);
+    generator.emit<Bytecode::Op::Jump>(test_label);
+    auto end_label = generator.make_label();
+    generator.patch_jump(exit_jump, end_label);
+    generator.end_loop(test_label, end_label);
+    return {};
+}
+
+Optional<Bytecode::Register> DoWhileStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    generator.begin_loop(m_label);
+    auto body_label = generator.make_label();
+    generator.emit_statement(*m_body);
+    auto test_label = generator.make_label();
+    auto test = generator.emit_expression(*m_test);
+    generator.emit<Bytecode::Op::JumpIfTrue>(test, body_label);
+    generator.end_loop(test_label, generator.make_label());
+    return {};
+}
+
+Optional<Bytecode::Register> ForStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    // Like the AST interpreter, let/const declarations in the header share one scope for the whole loop.
+    RefPtr<BlockStatement> wrapper;
+    if (m_init && is<VariableDeclaration>(*m_init) && static_cast<const VariableDeclaration&>(*m_init).declaration_kind() != DeclarationKind::Var) {
+        wrapper = create_ast_node<BlockStatement>(source_range());
+        NonnullRefPtrVector<VariableDeclaration> declarations;
+        declarations.append(*static_cast<const VariableDeclaration*>(m_init.ptr()));
+        wrapper->add_variables(declarations);
+        generator.synthesize_scope(*wrapper);
+        generator.enter_scope(*wrapper);
+    }
+
+    if (m_init) {
+        if (is<Expression>(*m_init))
+            generator.emit_expression(static_cast<const Expression&>(*m_init));
+        else
+            generator.emit_statement(static_cast<const Statement&>(*m_init));
+    }
+
+    generator.begin_loop(m_label);
+    auto test_label = generator.make_label();
+    Optional<size_t> exit_jump;
+    if (m_test) {
+        auto test = generator.emit_expression(*m_test);
+        exit_jump = generator.emit<Bytecode::Op::JumpIfFalse>(test);
+    }
+    generator.emit_statement(*m_body);
+    auto update_label = generator.make_label();
+    if (m_update)
+        generator.emit_expression(*m_update);
+    generator.emit<Bytecode::Op::Jump>(test_label);
+    auto end_label = generator.make_label();
+    if (exit_jump.has_value())
+        generator.patch_jump(exit_jump.value(), end_label);
+    generator.end_loop(update_label, end_label);
+
+    if (wrapper)
+        generator.exit_scope(*wrapper);
+    return {};
+}
+
+Optional<Bytecode::Register> BreakStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    generator.emit_break(*this, m_target_label);
+    return {};
+}
+
+Optional<Bytecode::Register> ContinueStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    generator.emit_continue(*this, m_target_label);
+    return {};
+}
+
+Optional<Bytecode::Register> VariableDeclaration::generate_bytecode(Bytecode::Generator& generator) const
+{
+    for (auto& declarator : m_declarations) {
+        if (!declarator.init())
+            continue;
+        auto value = generator.emit_expression(*declarator.init());
+        generator.emit<Bytecode::Op::DeclareVariable>(generator.intern_identifier(declarator.id().string()), value);
+    }
+    return {};
+}
+
+Optional<Bytecode::Register> BooleanLiteral::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    generator.emit<Bytecode::Op::LoadImmediate>(dst, Value(m_value));
+    return dst;
+}
+
+Optional<Bytecode::Register> NumericLiteral::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    generator.emit<Bytecode::Op::LoadImmediate>(dst, Value(m_value));
+    return dst;
+}
+
+Optional<Bytecode::Register> NullLiteral::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    generator.emit<Bytecode::Op::LoadImmediate>(dst, js_null());
+    return dst;
+}
+
+Optional<Bytecode::Register> StringLiteral::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    generator.emit<Bytecode::Op::NewString>(dst, generator.intern_string(m_value));
+    return dst;
+}
+
+Optional<Bytecode::Register> Identifier::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    generator.emit<Bytecode::Op::GetVariable>(dst, generator.intern_identifier(m_string));
+    return dst;
+}
+
+Optional<Bytecode::Register> ThisExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    generator.emit<Bytecode::Op::This>(dst);
+    return dst;
+}
+
+Optional<Bytecode::Register> BinaryExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto lhs = generator.emit_expression(*m_lhs);
+    auto rhs = generator.emit_expression(*m_rhs);
+    auto dst = generator.allocate_register();
+
+    switch (m_op) {
+    case BinaryOp::Addition:
+        generator.emit<Bytecode::Op::Add>(dst, lhs, rhs);
+        break;
+    case BinaryOp::Subtraction:
+        generator.emit<Bytecode::Op::Sub>(dst, lhs, rhs);
+        break;
+    case BinaryOp::Multiplication:
+        generator.emit<Bytecode::Op::Mul>(dst, lhs, rhs);
+        break;
+    case BinaryOp::Division:
+        generator.emit<Bytecode::Op::Div>(dst, lhs, rhs);
+        break;
+    case BinaryOp::Modulo:
+        generator.emit<Bytecode::Op::Mod>(dst, lhs, rhs);
+        break;
+    case BinaryOp::Exponentiation:
+        generator.emit<Bytecode::Op::Exp>(dst, lhs, rhs);
+        break;
+    case BinaryOp::TypedEquals:
+        generator.emit<Bytecode::Op::TypedEquals>(dst, lhs, rhs);
+        break;
+    case BinaryOp::TypedInequals:
+        generator.emit<Bytecode::Op::TypedInequals>(dst, lhs, rhs);
+        break;
+    case BinaryOp::AbstractEquals:
+        generator.emit<Bytecode::Op::AbstractEquals>(dst, lhs, rhs);
+        break;
+    case BinaryOp::AbstractInequals:
+        generator.emit<Bytecode::Op::AbstractInequals>(dst, lhs, rhs);
+        break;
+    case BinaryOp::GreaterThan:
+        generator.emit<Bytecode::Op::GreaterThan>(dst, lhs, rhs);
+        break;
+    case BinaryOp::GreaterThanEquals:
+        generator.emit<Bytecode::Op::GreaterThanEquals>(dst, lhs, rhs);
+        break;
+    case BinaryOp::LessThan:
+        generator.emit<Bytecode::Op::LessThan>(dst, lhs, rhs);
+        break;
+    case BinaryOp::LessThanEquals:
+        generator.emit<Bytecode::Op::LessThanEquals>(dst, lhs, rhs);
+        break;
+    case BinaryOp::BitwiseAnd:
+        generator.emit<Bytecode::Op::BitwiseAnd>(dst, lhs, rhs);
+        break;
+    case BinaryOp::BitwiseOr:
+        generator.emit<Bytecode::Op::BitwiseOr>(dst, lhs, rhs);
+        break;
+    case BinaryOp::BitwiseXor:
+        generator.emit<Bytecode::Op::BitwiseXor>(dst, lhs, rhs);
+        break;
+    case BinaryOp::LeftShift:
+        generator.emit<Bytecode::Op::LeftShift>(dst, lhs, rhs);
+        break;
+    case BinaryOp::RightShift:
+        generator.emit<Bytecode::Op::RightShift>(dst, lhs, rhs);
+        break;
+    case BinaryOp::UnsignedRightShift:
+        generator.emit<Bytecode::Op::UnsignedRightShift>(dst, lhs, rhs);
+        break;
+    case BinaryOp::In:
+        generator.emit<Bytecode::Op::In>(dst, lhs, rhs);
+        break;
+    case BinaryOp::InstanceOf:
+        generator.emit<Bytecode::Op::InstanceOf>(dst, lhs, rhs);
+        break;
+    }
+    return dst;
+}
+
+// Emits the jump that skips evaluating the right-hand side of a short-circuiting operator.
+static size_t emit_short_circuit_jump(Bytecode::Generator& generator, LogicalOp op, Bytecode::Register value)
+{
+    switch (op) {
+    case LogicalOp::And:
+        return generator.emit<Bytecode::Op::JumpIfFalse>(value);
+    case LogicalOp::Or:
+        return generator.emit<Bytecode::Op::JumpIfTrue>(value);
+    case LogicalOp::NullishCoalescing:
+        return generator.emit<Bytecode::Op::JumpIfNotNullish>(value);
+    }
+    ASSERT_NOT_REACHED();
+}
+
+Optional<Bytecode::Register> LogicalExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    auto lhs = generator.emit_expression(*m_lhs);
+    generator.emit<Bytecode::Op::Load>(dst, lhs);
+    auto end_jump = emit_short_circuit_jump(generator, m_op, dst);
+    auto rhs = generator.emit_expression(*m_rhs);
+    generator.emit<Bytecode::Op::Load>(dst, rhs);
+    generator.patch_jump(end_jump, generator.make_label());
+    return dst;
+}
+
+Optional<Bytecode::Register> UnaryExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    if (m_op == UnaryOp::Delete) {
+        generator.fail(*this);
+        return {};
+    }
+
+    auto dst = generator.allocate_register();
+
+    if (m_op == UnaryOp::Typeof && is<Identifier>(*m_lhs)) {
+        generator.emit<Bytecode::Op::TypeofVariable>(dst, generator.intern_identifier(static_cast<const Identifier&>(*m_lhs).string()));
+        return dst;
+    }
+
+    auto src = generator.emit_expression(*m_lhs);
+    switch (m_op) {
+    case UnaryOp::BitwiseNot:
+        generator.emit<Bytecode::Op::BitwiseNot>(dst, src);
+        break;
+    case UnaryOp::Not:
+        generator.emit<Bytecode::Op::Not>(dst, src);
+        break;
+    case UnaryOp::Plus:
+        generator.emit<Bytecode::Op::UnaryPlus>(dst, src);
+        break;
+    case UnaryOp::Minus:
+        generator.emit<Bytecode::Op::UnaryMinus>(dst, src);
+        break;
+    case UnaryOp::Typeof:
+        generator.emit<Bytecode::Op::Typeof>(dst, src);
+        break;
+    case UnaryOp::Void:
+        generator.emit<Bytecode::Op::LoadImmediate>(dst, js_undefined());
+        break;
+    case UnaryOp::Delete:
+        ASSERT_NOT_REACHED();
+    }
+    return dst;
+}
+
+Optional<Bytecode::Register> SequenceExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    Optional<Bytecode::Register> last_value;
+    for (auto& expression : m_expressions)
+        last_value = generator.emit_expression(expression);
+    return last_value;
+}
+
+Optional<Bytecode::Register> ConditionalExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    auto test = generator.emit_expression(*m_test);
+    auto else_jump = generator.emit<Bytecode::Op::JumpIfFalse>(test);
+    generator.emit<Bytecode::Op::Load>(dst, generator.emit_expression(*m_consequent));
+    auto end_jump = generator.emit<Bytecode::Op::Jump>();
+    generator.patch_jump(else_jump, generator.make_label());
+    generator.emit<Bytecode::Op::Load>(dst, generator.emit_expression(*m_alternate));
+    generator.patch_jump(end_jump, generator.make_label());
+    return dst;
+}
+
+Optional<Bytecode::Register> TemplateLiteral::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    generator.emit<Bytecode::Op::NewString>(dst, generator.intern_string(String::empty()));
+    for (auto& expression : m_expressions)
+        generator.emit<Bytecode::Op::AppendString>(dst, generator.emit_expression(expression));
+    return dst;
+}
+
+Optional<Bytecode::Register> MemberExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto object = generator.emit_expression(*m_object);
+    auto dst = generator.allocate_register();
+    if (is_computed()) {
+        auto property = generator.emit_expression(*m_property);
+        generator.emit<Bytecode::Op::GetByValue>(dst, object, property);
+    } else {
+        auto& identifier = static_cast<const Identifier&>(*m_property);
+        generator.emit<Bytecode::Op::GetById>(dst, object, generator.intern_identifier(identifier.string()));
+    }
+    return dst;
+}
+
+Optional<Bytecode::Register> CallExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    if (is<SuperExpression>(*m_callee)) {
+        generator.fail(*m_callee);
+        return {};
+    }
+    for (auto& argument : m_arguments) {
+        if (argument.is_spread) {
+            generator.fail(*this);
+            return {};
+        }
+    }
+
+    bool is_construct = is<NewExpression>(*this);
+    Optional<Bytecode::Register> callee;
+    Optional<Bytecode::Register> this_value;
+
+    if (is_construct) {
+        callee = generator.emit_expression(*m_callee);
+    } else if (is<MemberExpression>(*m_callee)) {
+        auto& member_expression = static_cast<const MemberExpression&>(*m_callee);
+        if (is<SuperExpression>(member_expression.object())) {
+            generator.fail(member_expression.object());
+            return {};
+        }
+        auto base = generator.emit_expression(member_expression.object());
+        this_value = generator.allocate_register();
+        generator.emit<Bytecode::Op::ToObject>(*this_value, base);
+        callee = generator.allocate_register();
+        if (member_expression.is_computed()) {
+            auto property = generator.emit_expression(member_expression.property());
+            generator.emit<Bytecode::Op::GetByValue>(*callee, *this_value, property);
+        } else {
+            auto& identifier = static_cast<const Identifier&>(member_expression.property());
+            generator.emit<Bytecode::Op::GetById>(*callee, *this_value, generator.intern_identifier(identifier.string()));
+        }
+    } else {
+        this_value = generator.allocate_register();
+        generator.emit<Bytecode::Op::LoadGlobalObject>(*this_value);
+        callee = generator.emit_expression(*m_callee);
+    }
+
+    Vector<Bytecode::Register> arguments;
+    arguments.ensure_capacity(m_arguments.size());
+    for (auto& argument : m_arguments)
+        arguments.append(generator.emit_expression(argument.value));
+
+    String expression_string;
+    if (is<Identifier>(*m_callee))
+        expression_string = static_cast<const Identifier&>(*m_callee).string();
+    else if (is<MemberExpression>(*m_callee))
+        expression_string = static_cast<const MemberExpression&>(*m_callee).to_string_approximation();
+    auto expression_string_index = generator.intern_string(expression_string);
+
+    auto dst = generator.allocate_register();
+    if (is_construct)
+        generator.emit_with_extra_register_slots<Bytecode::Op::New>(arguments.size(), dst, *callee, expression_string_index, arguments);
+    else
+        generator.emit_with_extra_register_slots<Bytecode::Op::Call>(arguments.size(), dst, *callee, *this_value, expression_string_index, arguments);
+    return dst;
+}
+
+// Emits dst = lhs <op> rhs for a compound assignment operator.
+static void emit_compound_assignment_op(Bytecode::Generator& generator, AssignmentOp op, Bytecode::Register dst, Bytecode::Register lhs, Bytecode::Register rhs)
+{
+    switch (op) {
+    case AssignmentOp::AdditionAssignment:
+        generator.emit<Bytecode::Op::Add>(dst, lhs, rhs);
+        break;
+    case AssignmentOp::SubtractionAssignment:
+        generator.emit<Bytecode::Op::Sub>(dst, lhs, rhs);
+        break;
+    case AssignmentOp::MultiplicationAssignment:
+        generator.emit<Bytecode::Op::Mul>(dst, lhs, rhs);
+        break;
+    case AssignmentOp::DivisionAssignment:
+        generator.emit<Bytecode::Op::Div>(dst, lhs, rhs);
+        break;
+    case AssignmentOp::ModuloAssignment:
+        generator.emit<Bytecode::Op::Mod>(dst, lhs, rhs);
+        break;
+    case AssignmentOp::ExponentiationAssignment:
+        generator.emit<Bytecode::Op::Exp>(dst, lhs, rhs);
+        break;
+    case AssignmentOp::BitwiseAndAssignment:
+        generator.emit<Bytecode::Op::BitwiseAnd>(dst, lhs, rhs);
+        break;
+    case AssignmentOp::BitwiseOrAssignment:
+        generator.emit<Bytecode::Op::BitwiseOr>(dst, lhs, rhs);
+        break;
+    case AssignmentOp::BitwiseXorAssignment:
+        generator.emit<Bytecode::Op::BitwiseXor>(dst, lhs, rhs);
+        break;
+    case AssignmentOp::LeftShiftAssignment:
+        generator.emit<Bytecode::Op::LeftShift>(dst, lhs, rhs);
+        break;
+    case AssignmentOp::RightShiftAssignment:
+        generator.emit<Bytecode::Op::RightShift>(dst, lhs, rhs);
+        break;
+    case AssignmentOp::UnsignedRightShiftAssignment:
+        generator.emit<Bytecode::Op::UnsignedRightShift>(dst, lhs, rhs);
+        break;
+    default:
+        ASSERT_NOT_REACHED();
+    }
+}
+
+// An assignment target that has been evaluated up to the point of reading or writing it.
+class AssignmentTarget {
+public:
+    static Optional<AssignmentTarget> create(Bytecode::Generator& generator, const Expression& expression)
+    {
+        if (is<Identifier>(expression)) {
+            auto& identifier = static_cast<const Identifier&>(expression);
+            return AssignmentTarget { generator.intern_identifier(identifier.string()) };
+        }
+        if (is<MemberExpression>(expression)) {
+            auto& member_expression = static_cast<const MemberExpression&>(expression);
+            if (is<SuperExpression>(member_expression.object()))
+                return {};
+            auto base = generator.emit_expression(member_expression.object());
+            if (member_expression.is_computed())
+                return AssignmentTarget { base, generator.emit_expression(member_expression.property()) };
+            auto& identifier = static_cast<const Identifier&>(member_expression.property());
+            return AssignmentTarget { base, generator.intern_identifier(identifier.string()) };
+        }
+        return {};
+    }
+
+    void emit_load(Bytecode::Generator& generator, Bytecode::Register dst) const
+    {
+        if (!m_base.has_value())
+            generator.emit<Bytecode::Op::GetVariable>(dst, m_identifier_index);
+        else if (m_property.has_value())
+            generator.emit<Bytecode::Op::GetByValue>(dst, *m_base, *m_property);
+        else
+            generator.emit<Bytecode::Op::GetById>(dst, *m_base, m_identifier_index);
+    }
+
+    void emit_store(Bytecode::Generator& generator, Bytecode::Register src) const
+    {
+        if (!m_base.has_value())
+            generator.emit<Bytecode::Op::SetVariable>(m_identifier_index, src);
+        else if (m_property.has_value())
+            generator.emit<Bytecode::Op::PutByValue>(*m_base, *m_property, src);
+        else
+            generator.emit<Bytecode::Op::PutById>(*m_base, m_identifier_index, src);
+    }
+
+private:
+    explicit AssignmentTarget(size_t identifier_index)
+        : m_identifier_index(identifier_index)
+    {
+    }
+
+    AssignmentTarget(Bytecode::Register base, size_t identifier_index)
+        : m_base(base)
+        , m_identifier_index(identifier_index)
+    {
+    }
+
+    AssignmentTarget(Bytecode::Register base, Bytecode::Register property)
+        : m_base(base)
+        , m_property(property)
+    {
+    }
+
+    Optional<Bytecode::Register> m_base;
+    Optional<Bytecode::Register> m_property;
+    size_t m_identifier_index { 0 };
+};
+
+Optional<Bytecode::Register> AssignmentExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto target = AssignmentTarget::create(generator, *m_lhs);
+    if (!target.has_value()) {
+        generator.fail(*m_lhs);
+        return {};
+    }
+
+    if (m_op == AssignmentOp::Assignment) {
+        auto rhs = generator.emit_expression(*m_rhs);
+        target->emit_store(generator, rhs);
+        return rhs;
+    }
+
+    auto dst = generator.allocate_register();
+    target->emit_load(generator, dst);
+
+    if (m_op == AssignmentOp::AndAssignment || m_op == AssignmentOp::OrAssignment || m_op == AssignmentOp::NullishAssignment) {
+        auto logical_op = m_op == AssignmentOp::AndAssignment ? LogicalOp::And : (m_op == AssignmentOp::OrAssignment ? LogicalOp::Or : LogicalOp::NullishCoalescing);
+        auto end_jump = emit_short_circuit_jump(generator, logical_op, dst);
+        auto rhs = generator.emit_expression(*m_rhs);
+        target->emit_store(generator, rhs);
+        generator.emit<Bytecode::Op::Load>(dst, rhs);
+        generator.patch_jump(end_jump, generator.make_label());
+        return dst;
+    }
+
+    auto rhs = generator.emit_expression(*m_rhs);
+    emit_compound_assignment_op(generator, m_op, dst, dst, rhs);
+    target->emit_store(generator, dst);
+    return dst;
+}
+
+Optional<Bytecode::Register> UpdateExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto target = AssignmentTarget::create(generator, *m_argument);
+    if (!target.has_value()) {
+        generator.fail(*m_argument);
+        return {};
+    }
+
+    auto old_value = generator.allocate_register();
+    target->emit_load(generator, old_value);
+    generator.emit<Bytecode::Op::ToNumeric>(old_value, old_value);
+
+    auto new_value = generator.allocate_register();
+    if (m_op == UpdateOp::Increment)
+        generator.emit<Bytecode::Op::Increment>(new_value, old_value);
+    else
+        generator.emit<Bytecode::Op::Decrement>(new_value, old_value);
+    target->emit_store(generator, new_value);
+
+    return m_prefixed ? new_value : old_value;
+}
+
+Optional<Bytecode::Register> ObjectExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    generator.emit<Bytecode::Op::NewObject>(dst);
+    for (auto& property : m_properties) {
+        if (property.type() != ObjectProperty::Type::KeyValue) {
+            generator.fail(property);
+            return {};
+        }
+        auto key = generator.emit_expression(property.key());
+        auto value = generator.emit_expression(property.value());
+        generator.emit<Bytecode::Op::PutOwnProperty>(dst, key, value, property.is_method());
+    }
+    return dst;
+}
+
+Optional<Bytecode::Register> ArrayExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    Vector<Bytecode::Register> elements;
+    elements.ensure_capacity(m_elements.size());
+    for (auto& element : m_elements) {
+        if (element && is<SpreadExpression>(*element)) {
+            generator.fail(*element);
+            return {};
+        }
+        if (element) {
+            elements.append(generator.emit_expression(*element));
+        } else {
+            // Holes are stored as empty values, just like the AST interpreter does.
+            auto hole = generator.allocate_register();
+            generator.emit<Bytecode::Op::LoadImmediate>(hole, Value());
+            elements.append(hole);
+        }
+    }
+    auto dst = generator.allocate_register();
+    generator.emit_with_extra_register_slots<Bytecode::Op::NewArray>(elements.size(), dst, elements);
+    return dst;
+}
+
+}
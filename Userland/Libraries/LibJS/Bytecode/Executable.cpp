@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/Debug.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Op.h>
+
+namespace JS::Bytecode {
+
+Executable::~Executable()
+{
+    if constexpr (JS_PROPERTY_CACHE_DEBUG) {
+        size_t offset = 0;
+        while (offset < m_bytecode.size()) {
+            auto& instruction = *reinterpret_cast<const Instruction*>(m_bytecode.data() + offset);
+            const PropertyCache* cache = nullptr;
+            if (instruction.type() == Instruction::Type::GetById)
+                cache = &static_cast<const Op::GetById&>(instruction).property_cache();
+            else if (instruction.type() == Instruction::Type::PutById)
+                cache = &static_cast<const Op::PutById&>(instruction).property_cache();
+            if (cache && (cache->hits() || cache->misses()))
+                dbgln("Property cache for [{:4x}] {}: {} hits, {} misses, {} shapes", offset, instruction.to_string(*this), cache->hits(), cache->misses(), cache->entry_count());
+            offset += instruction.length();
+        }
+    }
+}
+
+void Executable::dump() const
+{
+    outln("Executable ({} bytes, {} registers):", m_bytecode.size(), m_register_count);
+    size_t offset = 0;
+    while (offset < m_bytecode.size()) {
+        auto& instruction = *reinterpret_cast<const Instruction*>(m_bytecode.data() + offset);
+        outln("[{:4x}] {}", offset, instruction.to_string(*this));
+        offset += instruction.length();
+    }
+}
+
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/Debug.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Generator.h>
+
+namespace JS::Bytecode {
+
+Generator::Generator()
+    : m_executable(make<Executable>())
+{
+}
+
+OwnPtr<Executable> Generator::generate(const ScopeNode& node)
+{
+    Generator generator;
+
+    if (is<Program>(node)) {
+        // The completion value of a program is that of its last statement, which the REPL prints.
+        auto completion = generator.allocate_register();
+        generator.m_completion_register = completion;
+        generator.emit<Op::LoadImmediate>(completion, js_undefined());
+        for (auto& child : node.children()) {
+            if (!is<ExpressionStatement>(child))
+                generator.emit<Op::LoadImmediate>(completion, js_undefined());
+            generator.emit_statement(child);
+        }
+        generator.emit<Op::Return>(completion);
+    } else {
+        for (auto& child : node.children())
+            generator.emit_statement(child);
+        auto undefined = generator.allocate_register();
+        generator.emit<Op::LoadImmediate>(undefined, js_undefined());
+        generator.emit<Op::Return>(undefined);
+    }
+
+    if (generator.has_failed())
+        return {};
+    return move(generator.m_executable);
+}
+
+Register Generator::allocate_register()
+{
+    return Register { static_cast<u32>(m_executable->m_register_count++) };
+}
+
+size_t Generator::grow(size_t size)
+{
+    auto offset = m_executable->m_bytecode.size();
+    m_executable->m_bytecode.resize(offset + size);
+    return offset;
+}
+
+void Generator::patch_jump(size_t jump_offset, Label target)
+{
+    auto& jump = *reinterpret_cast<Op::Jump*>(m_executable->m_bytecode.data() + jump_offset);
+    jump.set_target(target);
+}
+
+Register Generator::emit_expression(const Expression& expression)
+{
+    auto result = expression.generate_bytecode(*this);
+    if (result.has_value())
+        return result.value();
+    // Keep going so that we always produce well-formed (if useless) code; the result is discarded anyway.
+    fail(expression);
+    return allocate_register();
+}
+
+void Generator::emit_statement(const Statement& statement)
+{
+    [[maybe_unused]] auto result = statement.generate_bytecode(*this);
+}
+
+size_t Generator::intern_string(const String& string)
+{
+    if (!string.is_null()) {
+        if (auto it = m_string_indices.find(string); it != m_string_indices.end())
+            return it->value;
+    }
+    auto index = m_executable->m_strings.size();
+    m_executable->m_strings.append(string);
+    if (!string.is_null())
+        m_string_indices.set(string, index);
+    return index;
+}
+
+size_t Generator::intern_identifier(const FlyString& identifier)
+{
+    if (auto it = m_identifier_indices.find(identifier); it != m_identifier_indices.end())
+        return it->value;
+    auto index = m_executable->m_identifiers.size();
+    m_executable->m_identifiers.append(identifier);
+    m_identifier_indices.set(identifier, index);
+    return index;
+}
+
+void Generator::enter_scope(const ScopeNode& scope_node)
+{
+    emit<Op::EnterScope>(scope_node);
+    m_entered_scopes.append(&scope_node);
+}
+
+void Generator::exit_scope(const ScopeNode& scope_node)
+{
+    ASSERT(m_entered_scopes.last() == &scope_node);
+    m_entered_scopes.take_last();
+    emit<Op::ExitScope>(scope_node);
+}
+
+void Generator::synthesize_scope(NonnullRefPtr<ScopeNode> scope_node)
+{
+    m_executable->m_synthesized_scopes.append(move(scope_node));
+}
+
+void Generator::exit_scopes_down_to(size_t scope_depth)
+{
+    // Exiting a scope also exits everything that was entered after it, so one instruction is enough.
+    if (m_entered_scopes.size() > scope_depth)
+        emit<Op::ExitScope>(*m_entered_scopes[scope_depth]);
+}
+
+void Generator::begin_loop(const FlyString& label)
+{
+    m_loops.append({ label, m_entered_scopes.size(), {}, {} });
+}
+
+void Generator::end_loop(Label continue_target, Label break_target)
+{
+    auto loop = m_loops.take_last();
+    for (auto jump_offset : loop.break_jumps)
+        patch_jump(jump_offset, break_target);
+    for (auto jump_offset : loop.continue_jumps)
+        patch_jump(jump_offset, continue_target);
+}
+
+Generator::LoopScope* Generator::find_loop(const FlyString& label)
+{
+    if (m_loops.is_empty())
+        return nullptr;
+    if (label.is_null())
+        return &m_loops.last();
+    for (ssize_t i = m_loops.size() - 1; i >= 0; --i) {
+        if (m_loops[i].label == label)
+            return &m_loops[i];
+    }
+    return nullptr;
+}
+
+void Generator::emit_break(const Statement& statement, const FlyString& target_label)
+{
+    auto* loop = find_loop(target_label);
+    if (!loop) {
+        fail(statement);
+        return;
+    }
+    exit_scopes_down_to(loop->scope_depth);
+    loop->break_jumps.append(emit<Op::Jump>());
+}
+
+void Generator::emit_continue(const Statement& statement, const FlyString& target_label)
+{
+    auto* loop = find_loop(target_label);
+    if (!loop) {
+        fail(statement);
+        return;
+    }
+    exit_scopes_down_to(loop->scope_depth);
+    loop->continue_jumps.append(emit<Op::Jump>());
+}
+
+void Generator::fail(const ASTNode& node)
+{
+    if (!m_failed)
+        dbgln<JS_BYTECODE_DEBUG>("Bytecode: Can't generate code for {}, falling back to the AST interpreter", node.class_name());
+    m_failed = true;
+}
+
+}
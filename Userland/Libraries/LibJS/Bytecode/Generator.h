@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/FlyString.h>
+#include <AK/HashMap.h>
+#include <AK/OwnPtr.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Vector.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Label.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/Register.h>
+#include <LibJS/Forward.h>
+
+namespace JS::Bytecode {
+
+// Generator walks the AST of a single function body (or program) and emits a flat
+// instruction stream for it. Nodes that don't know how to generate bytecode mark the
+// generator as failed, in which case the caller keeps using the AST interpreter.
+class Generator {
+public:
+    static OwnPtr<Executable> generate(const ScopeNode&);
+
+    Register allocate_register();
+
+    // Returns the offset of the new instruction, which stays valid (unlike a pointer) while more code is emitted.
+    template<typename OpType, typename... Args>
+    size_t emit(Args&&... args)
+    {
+        static_assert(is_trivially_copyable<OpType>());
+        auto offset = grow(sizeof(OpType));
+        new (m_executable->m_bytecode.data() + offset) OpType(forward<Args>(args)...);
+        return offset;
+    }
+
+    template<typename OpType, typename... Args>
+    size_t emit_with_extra_register_slots(size_t extra_register_slots, Args&&... args)
+    {
+        static_assert(is_trivially_copyable<OpType>());
+        auto offset = grow(Op::length_with_register_slots<OpType>(extra_register_slots));
+        new (m_executable->m_bytecode.data() + offset) OpType(forward<Args>(args)...);
+        return offset;
+    }
+
+    Label make_label() const { return Label { m_executable->m_bytecode.size() }; }
+    void patch_jump(size_t jump_offset, Label target);
+
+    // Generates code for an expression and returns the register holding its value.
+    Register emit_expression(const Expression&);
+    void emit_statement(const Statement&);
+
+    size_t intern_string(const String&);
+    size_t intern_identifier(const FlyString&);
+
+    void enter_scope(const ScopeNode&);
+    void exit_scope(const ScopeNode&);
+    void synthesize_scope(NonnullRefPtr<ScopeNode>);
+
+    void begin_loop(const FlyString& label);
+    void end_loop(Label continue_target, Label break_target);
+    void emit_break(const Statement&, const FlyString& target_label);
+    void emit_continue(const Statement&, const FlyString& target_label);
+
+    // Set while generating a program, so that expression statements can record the completion value.
+    const Optional<Register>& completion_register() const { return m_completion_register; }
+
+    void fail(const ASTNode&);
+    bool has_failed() const { return m_failed; }
+
+private:
+    Generator();
+
+    size_t grow(size_t);
+
+    struct LoopScope {
+        FlyString label;
+        size_t scope_depth { 0 };
+        Vector<size_t> break_jumps;
+        Vector<size_t> continue_jumps;
+    };
+    LoopScope* find_loop(const FlyString& label);
+    void exit_scopes_down_to(size_t scope_depth);
+
+    OwnPtr<Executable> m_executable;
+    HashMap<String, size_t> m_string_indices;
+    HashMap<FlyString, size_t> m_identifier_indices;
+    Vector<const ScopeNode*> m_entered_scopes;
+    Vector<LoopScope> m_loops;
+    Optional<Register> m_completion_register;
+    bool m_failed { false };
+};
+
+}
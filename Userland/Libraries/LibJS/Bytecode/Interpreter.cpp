@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Runtime/GlobalObject.h>
+
+namespace JS::Bytecode {
+
+Interpreter::Interpreter(GlobalObject& global_object)
+    : m_vm(global_object.vm())
+    , m_global_object(global_object)
+    , m_registers(global_object.heap())
+{
+}
+
+Interpreter::~Interpreter()
+{
+}
+
+Value Interpreter::run(const Executable& executable)
+{
+    ASSERT(!m_vm.exception());
+
+    m_executable = &executable;
+    m_registers.clear();
+    m_registers.resize(executable.register_count());
+    m_return_value = {};
+    m_pc = 0;
+
+    auto* bytecode = executable.bytecode().data();
+    auto bytecode_size = executable.bytecode().size();
+
+    while (m_pc < bytecode_size) {
+        auto& instruction = *reinterpret_cast<const Instruction*>(bytecode + m_pc);
+        // NOTE: The program counter is advanced before executing, so jumps can simply overwrite it.
+        switch (instruction.type()) {
+#define __BYTECODE_OP(op, ...)                                                  \
+    case Instruction::Type::op: {                                               \
+        auto& op_instruction = static_cast<const Op::op&>(instruction);         \
+        m_pc += op_instruction.length();                                        \
+        op_instruction.execute(*this);                                          \
+        break;                                                                  \
+    }
+            ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+        }
+        if (m_vm.exception())
+            return {};
+    }
+
+    return m_return_value;
+}
+
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/NumericLimits.h>
+#include <LibJS/Bytecode/Register.h>
+#include <LibJS/Forward.h>
+#include <LibJS/Runtime/MarkedValueList.h>
+#include <LibJS/Runtime/Value.h>
+
+namespace JS::Bytecode {
+
+// Runs a single Executable. The register file lives in a MarkedValueList so that
+// temporaries are visible to the garbage collector while the code runs.
+class Interpreter {
+public:
+    explicit Interpreter(GlobalObject&);
+    ~Interpreter();
+
+    GlobalObject& global_object() { return m_global_object; }
+    VM& vm() { return m_vm; }
+
+    // Returns the value passed to the executable's Return instruction, or an empty value if an exception was thrown.
+    Value run(const Executable&);
+
+    const Executable& executable() const { return *m_executable; }
+
+    Value& reg(Register r) { return m_registers[r.index()]; }
+
+    void jump(size_t target) { m_pc = target; }
+    void do_return(Value value)
+    {
+        m_return_value = value;
+        m_pc = NumericLimits<size_t>::max();
+    }
+
+private:
+    VM& m_vm;
+    GlobalObject& m_global_object;
+    const Executable* m_executable { nullptr };
+    MarkedValueList m_registers;
+    size_t m_pc { 0 };
+    Value m_return_value;
+};
+
+}
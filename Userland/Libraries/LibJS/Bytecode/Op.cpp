@@ -0,0 +1,552 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <LibCrypto/BigInt/SignedBigInteger.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Runtime/Array.h>
+#include <LibJS/Runtime/BigInt.h>
+#include <LibJS/Runtime/Error.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/MarkedValueList.h>
+#include <LibJS/Runtime/NativeFunction.h>
+#include <LibJS/Runtime/Reference.h>
+#include <LibJS/Runtime/ScriptFunction.h>
+
+namespace JS::Bytecode::Op {
+
+static Value typed_equals(GlobalObject&, Value lhs, Value rhs)
+{
+    return Value(strict_eq(lhs, rhs));
+}
+
+static Value typed_inequals(GlobalObject&, Value lhs, Value rhs)
+{
+    return Value(!strict_eq(lhs, rhs));
+}
+
+static Value abstract_equals(GlobalObject& global_object, Value lhs, Value rhs)
+{
+    return Value(abstract_eq(global_object, lhs, rhs));
+}
+
+static Value abstract_inequals(GlobalObject& global_object, Value lhs, Value rhs)
+{
+    return Value(!abstract_eq(global_object, lhs, rhs));
+}
+
+static Value logical_not(GlobalObject&, Value value)
+{
+    return Value(!value.to_boolean());
+}
+
+static Value typeof_(GlobalObject& global_object, Value value)
+{
+    auto& vm = global_object.vm();
+    switch (value.type()) {
+    case Value::Type::Undefined:
+        return js_string(vm, "undefined");
+    case Value::Type::Null:
+        return js_string(vm, "object");
+    case Value::Type::Number:
+        return js_string(vm, "number");
+    case Value::Type::String:
+        return js_string(vm, "string");
+    case Value::Type::Object:
+        if (value.is_function())
+            return js_string(vm, "function");
+        return js_string(vm, "object");
+    case Value::Type::Boolean:
+        return js_string(vm, "boolean");
+    case Value::Type::Symbol:
+        return js_string(vm, "symbol");
+    case Value::Type::BigInt:
+        return js_string(vm, "bigint");
+    default:
+        ASSERT_NOT_REACHED();
+    }
+}
+
+static Value to_numeric(GlobalObject& global_object, Value value)
+{
+    return value.to_numeric(global_object);
+}
+
+static Value increment(GlobalObject& global_object, Value value)
+{
+    if (value.is_number())
+        return Value(value.as_double() + 1);
+    return js_bigint(global_object.heap(), value.as_bigint().big_integer().plus(Crypto::SignedBigInteger { 1 }));
+}
+
+static Value decrement(GlobalObject& global_object, Value value)
+{
+    if (value.is_number())
+        return Value(value.as_double() - 1);
+    return js_bigint(global_object.heap(), value.as_bigint().big_integer().minus(Crypto::SignedBigInteger { 1 }));
+}
+
+void Load::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.reg(m_dst) = interpreter.reg(m_src);
+}
+
+void LoadImmediate::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.reg(m_dst) = m_value;
+}
+
+void LoadGlobalObject::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.reg(m_dst) = &interpreter.global_object();
+}
+
+void NewString::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.reg(m_dst) = js_string(interpreter.vm(), interpreter.executable().string(m_string_index));
+}
+
+void NewObject::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.reg(m_dst) = Object::create_empty(interpreter.global_object());
+}
+
+void NewArray::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto* array = Array::create(interpreter.global_object());
+    for (size_t i = 0; i < m_element_count; ++i)
+        array->indexed_properties().append(interpreter.reg(m_elements[i]));
+    interpreter.reg(m_dst) = array;
+}
+
+void NewFunction::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto& vm = interpreter.vm();
+    auto& node = m_function_node;
+    interpreter.reg(m_dst) = ScriptFunction::create(interpreter.global_object(), node.name(), node.body(), node.parameters(), node.function_length(), vm.current_scope(), node.is_strict_mode() || vm.in_strict_mode(), node.is_arrow_function());
+}
+
+void AppendString::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto string = interpreter.reg(m_src).to_string(interpreter.global_object());
+    if (interpreter.vm().exception())
+        return;
+    StringBuilder builder;
+    builder.append(interpreter.reg(m_dst).as_string().string());
+    builder.append(string);
+    interpreter.reg(m_dst) = js_string(interpreter.vm(), builder.build());
+}
+
+void GetVariable::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto& vm = interpreter.vm();
+    auto& name = interpreter.executable().identifier(m_identifier_index);
+    auto value = vm.get_variable(name, interpreter.global_object());
+    if (value.is_empty()) {
+        vm.throw_exception<ReferenceError>(interpreter.global_object(), ErrorType::UnknownIdentifier, name);
+        return;
+    }
+    interpreter.reg(m_dst) = value;
+}
+
+void TypeofVariable::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto& vm = interpreter.vm();
+    auto& name = interpreter.executable().identifier(m_identifier_index);
+    auto value = vm.get_variable(name, interpreter.global_object()).value_or(js_undefined());
+    if (vm.exception())
+        return;
+    interpreter.reg(m_dst) = typeof_(interpreter.global_object(), value);
+}
+
+void SetVariable::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto& name = interpreter.executable().identifier(m_identifier_index);
+    auto value = interpreter.reg(m_src);
+    auto reference = interpreter.vm().get_reference(name);
+    update_function_name(value, name);
+    reference.put(interpreter.global_object(), value);
+}
+
+void DeclareVariable::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto& name = interpreter.executable().identifier(m_identifier_index);
+    auto value = interpreter.reg(m_src);
+    update_function_name(value, name);
+    interpreter.vm().set_variable(name, value, interpreter.global_object(), true);
+}
+
+static void get_property(Bytecode::Interpreter& interpreter, Register dst, Register base, const PropertyName& property_name, PropertyCache* property_cache = nullptr)
+{
+    auto* object = interpreter.reg(base).to_object(interpreter.global_object());
+    if (!object)
+        return;
+    if (property_cache)
+        interpreter.reg(dst) = object->get_with_cache(property_name, *property_cache).value_or(js_undefined());
+    else
+        interpreter.reg(dst) = object->get(property_name).value_or(js_undefined());
+}
+
+static void put_property(Bytecode::Interpreter& interpreter, Register base, const PropertyName& property_name, Register src, PropertyCache* property_cache = nullptr)
+{
+    auto& global_object = interpreter.global_object();
+    auto value = interpreter.reg(src);
+    Reference reference { interpreter.reg(base), property_name };
+    reference.set_property_cache(property_cache);
+    update_function_name(value, get_function_name(global_object, property_name.to_value(interpreter.vm())));
+    reference.put(global_object, value);
+}
+
+void GetById::execute(Bytecode::Interpreter& interpreter) const
+{
+    get_property(interpreter, m_dst, m_object, interpreter.executable().identifier(m_identifier_index), &m_property_cache);
+}
+
+void GetByValue::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto& global_object = interpreter.global_object();
+    auto* object = interpreter.reg(m_object).to_object(global_object);
+    if (!object)
+        return;
+    auto property_name = PropertyName::from_value(global_object, interpreter.reg(m_property));
+    if (!property_name.is_valid())
+        return;
+    interpreter.reg(m_dst) = object->get(property_name).value_or(js_undefined());
+}
+
+void PutById::execute(Bytecode::Interpreter& interpreter) const
+{
+    put_property(interpreter, m_object, interpreter.executable().identifier(m_identifier_index), m_src, &m_property_cache);
+}
+
+void PutByValue::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto property_name = PropertyName::from_value(interpreter.global_object(), interpreter.reg(m_property));
+    if (!property_name.is_valid())
+        return;
+    put_property(interpreter, m_object, property_name, m_src);
+}
+
+void PutOwnProperty::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto& global_object = interpreter.global_object();
+    auto& object = interpreter.reg(m_object).as_object();
+    auto key = interpreter.reg(m_key);
+    auto value = interpreter.reg(m_src);
+
+    if (value.is_function() && m_is_method)
+        value.as_function().set_home_object(&object);
+
+    update_function_name(value, get_function_name(global_object, key));
+    object.define_property(PropertyName::from_value(global_object, key), value);
+}
+
+void ToObject::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto* object = interpreter.reg(m_src).to_object(interpreter.global_object());
+    if (!object)
+        return;
+    interpreter.reg(m_dst) = object;
+}
+
+void Jump::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.jump(m_target);
+}
+
+void JumpIfTrue::execute(Bytecode::Interpreter& interpreter) const
+{
+    if (interpreter.reg(m_condition).to_boolean())
+        interpreter.jump(m_target);
+}
+
+void JumpIfFalse::execute(Bytecode::Interpreter& interpreter) const
+{
+    if (!interpreter.reg(m_condition).to_boolean())
+        interpreter.jump(m_target);
+}
+
+void JumpIfNullish::execute(Bytecode::Interpreter& interpreter) const
+{
+    if (interpreter.reg(m_condition).is_nullish())
+        interpreter.jump(m_target);
+}
+
+void JumpIfNotNullish::execute(Bytecode::Interpreter& interpreter) const
+{
+    if (!interpreter.reg(m_condition).is_nullish())
+        interpreter.jump(m_target);
+}
+
+void Call::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto& vm = interpreter.vm();
+    auto& global_object = interpreter.global_object();
+    auto callee = interpreter.reg(m_callee);
+
+    bool is_construct = type() == Type::New;
+    if (!callee.is_function()
+        || (is_construct && is<NativeFunction>(callee.as_object()) && !static_cast<NativeFunction&>(callee.as_object()).has_constructor())) {
+        auto call_type = is_construct ? "constructor" : "function";
+        auto& expression_string = interpreter.executable().string(m_expression_string_index);
+        if (!expression_string.is_null())
+            vm.throw_exception<TypeError>(global_object, ErrorType::IsNotAEvaluatedFrom, callee.to_string_without_side_effects(), call_type, expression_string);
+        else
+            vm.throw_exception<TypeError>(global_object, ErrorType::IsNotA, callee.to_string_without_side_effects(), call_type);
+        return;
+    }
+
+    auto& function = callee.as_function();
+
+    MarkedValueList arguments(vm.heap());
+    arguments.ensure_capacity(m_argument_count);
+    for (size_t i = 0; i < m_argument_count; ++i)
+        arguments.append(interpreter.reg(m_arguments[i]));
+
+    Value result;
+    if (is_construct)
+        result = vm.construct(function, function, move(arguments), global_object);
+    else
+        result = vm.call(function, interpreter.reg(m_this_value), move(arguments));
+
+    if (vm.exception())
+        return;
+    interpreter.reg(m_dst) = result;
+}
+
+void New::execute(Bytecode::Interpreter& interpreter) const
+{
+    Call::execute(interpreter);
+}
+
+void This::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.reg(m_dst) = interpreter.vm().resolve_this_binding(interpreter.global_object());
+}
+
+void Return::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.do_return(interpreter.reg(m_src));
+}
+
+void EnterScope::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.vm().interpreter().enter_scope(m_scope_node, ScopeType::Block, interpreter.global_object());
+}
+
+void ExitScope::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.vm().interpreter().exit_scope(m_scope_node);
+}
+
+#define JS_DEFINE_BYTECODE_BINARY_OP(OpTitleCase, op_snake_case)                                                                   \
+    void OpTitleCase::execute(Bytecode::Interpreter& interpreter) const                                                             \
+    {                                                                                                                               \
+        interpreter.reg(m_dst) = op_snake_case(interpreter.global_object(), interpreter.reg(m_lhs), interpreter.reg(m_rhs));       \
+    }                                                                                                                               \
+                                                                                                                                    \
+    String OpTitleCase::to_string(const Bytecode::Executable&) const                                                                \
+    {                                                                                                                               \
+        return String::formatted(#OpTitleCase " {}, {}, {}", m_dst.to_string(), m_lhs.to_string(), m_rhs.to_string());           \
+    }
+
+ENUMERATE_BYTECODE_BINARY_OPS(JS_DEFINE_BYTECODE_BINARY_OP)
+#undef JS_DEFINE_BYTECODE_BINARY_OP
+
+#define JS_DEFINE_BYTECODE_UNARY_OP(OpTitleCase, op_snake_case)                                             \
+    void OpTitleCase::execute(Bytecode::Interpreter& interpreter) const                                      \
+    {                                                                                                        \
+        interpreter.reg(m_dst) = op_snake_case(interpreter.global_object(), interpreter.reg(m_src));        \
+    }                                                                                                        \
+                                                                                                             \
+    String OpTitleCase::to_string(const Bytecode::Executable&) const                                         \
+    {                                                                                                        \
+        return String::formatted(#OpTitleCase " {}, {}", m_dst.to_string(), m_src.to_string());             \
+    }
+
+ENUMERATE_BYTECODE_UNARY_OPS(JS_DEFINE_BYTECODE_UNARY_OP)
+#undef JS_DEFINE_BYTECODE_UNARY_OP
+
+String Load::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("Load {}, {}", m_dst.to_string(), m_src.to_string());
+}
+
+String LoadImmediate::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("LoadImmediate {}, {}", m_dst.to_string(), m_value.is_empty() ? "<empty>" : m_value.to_string_without_side_effects());
+}
+
+String LoadGlobalObject::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("LoadGlobalObject {}", m_dst.to_string());
+}
+
+String NewString::to_string(const Bytecode::Executable& executable) const
+{
+    return String::formatted("NewString {}, \"{}\"", m_dst.to_string(), executable.string(m_string_index));
+}
+
+String NewObject::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("NewObject {}", m_dst.to_string());
+}
+
+static String registers_to_string(const Register* registers, size_t count)
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < count; ++i) {
+        if (i != 0)
+            builder.append(", ");
+        builder.append(registers[i].to_string());
+    }
+    return builder.build();
+}
+
+String NewArray::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("NewArray {}, [{}]", m_dst.to_string(), registers_to_string(m_elements, m_element_count));
+}
+
+String NewFunction::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("NewFunction {}, \"{}\"", m_dst.to_string(), m_function_node.name());
+}
+
+String AppendString::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("AppendString {}, {}", m_dst.to_string(), m_src.to_string());
+}
+
+String GetVariable::to_string(const Bytecode::Executable& executable) const
+{
+    return String::formatted("GetVariable {}, {}", m_dst.to_string(), executable.identifier(m_identifier_index));
+}
+
+String TypeofVariable::to_string(const Bytecode::Executable& executable) const
+{
+    return String::formatted("TypeofVariable {}, {}", m_dst.to_string(), executable.identifier(m_identifier_index));
+}
+
+String SetVariable::to_string(const Bytecode::Executable& executable) const
+{
+    return String::formatted("SetVariable {}, {}", executable.identifier(m_identifier_index), m_src.to_string());
+}
+
+String DeclareVariable::to_string(const Bytecode::Executable& executable) const
+{
+    return String::formatted("DeclareVariable {}, {}", executable.identifier(m_identifier_index), m_src.to_string());
+}
+
+String GetById::to_string(const Bytecode::Executable& executable) const
+{
+    return String::formatted("GetById {}, {}, {}", m_dst.to_string(), m_object.to_string(), executable.identifier(m_identifier_index));
+}
+
+String GetByValue::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("GetByValue {}, {}, {}", m_dst.to_string(), m_object.to_string(), m_property.to_string());
+}
+
+String PutById::to_string(const Bytecode::Executable& executable) const
+{
+    return String::formatted("PutById {}, {}, {}", m_object.to_string(), executable.identifier(m_identifier_index), m_src.to_string());
+}
+
+String PutByValue::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("PutByValue {}, {}, {}", m_object.to_string(), m_property.to_string(), m_src.to_string());
+}
+
+String PutOwnProperty::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("PutOwnProperty {}, {}, {}{}", m_object.to_string(), m_key.to_string(), m_src.to_string(), m_is_method ? " (method)" : "");
+}
+
+String ToObject::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("ToObject {}, {}", m_dst.to_string(), m_src.to_string());
+}
+
+String Jump::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("Jump {}", Label { m_target }.to_string());
+}
+
+String JumpIfTrue::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("JumpIfTrue {}, {}", m_condition.to_string(), Label { m_target }.to_string());
+}
+
+String JumpIfFalse::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("JumpIfFalse {}, {}", m_condition.to_string(), Label { m_target }.to_string());
+}
+
+String JumpIfNullish::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("JumpIfNullish {}, {}", m_condition.to_string(), Label { m_target }.to_string());
+}
+
+String JumpIfNotNullish::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("JumpIfNotNullish {}, {}", m_condition.to_string(), Label { m_target }.to_string());
+}
+
+String Call::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("Call {}, {}, {}, [{}]", m_dst.to_string(), m_callee.to_string(), m_this_value.to_string(), registers_to_string(m_arguments, m_argument_count));
+}
+
+String New::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("New {}, {}, [{}]", m_dst.to_string(), m_callee.to_string(), registers_to_string(m_arguments, m_argument_count));
+}
+
+String This::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("This {}", m_dst.to_string());
+}
+
+String Return::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("Return {}", m_src.to_string());
+}
+
+String EnterScope::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("EnterScope {:p}", &m_scope_node);
+}
+
+String ExitScope::to_string(const Bytecode::Executable&) const
+{
+    return String::formatted("ExitScope {:p}", &m_scope_node);
+}
+
+}
@@ -0,0 +1,602 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Vector.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Label.h>
+#include <LibJS/Bytecode/Register.h>
+#include <LibJS/Runtime/PropertyCache.h>
+#include <LibJS/Runtime/Value.h>
+
+namespace JS::Bytecode::Op {
+
+class Load final : public Instruction {
+public:
+    Load(Register dst, Register src)
+        : Instruction(Type::Load)
+        , m_dst(dst)
+        , m_src(src)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    Register m_dst;
+    Register m_src;
+};
+
+// Loads a constant that is not a cell (number, boolean, null, undefined or empty).
+class LoadImmediate final : public Instruction {
+public:
+    LoadImmediate(Register dst, Value value)
+        : Instruction(Type::LoadImmediate)
+        , m_dst(dst)
+        , m_value(value)
+    {
+        ASSERT(!value.is_cell());
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    Register m_dst;
+    Value m_value;
+};
+
+class LoadGlobalObject final : public Instruction {
+public:
+    explicit LoadGlobalObject(Register dst)
+        : Instruction(Type::LoadGlobalObject)
+        , m_dst(dst)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    Register m_dst;
+};
+
+class NewString final : public Instruction {
+public:
+    NewString(Register dst, size_t string_index)
+        : Instruction(Type::NewString)
+        , m_dst(dst)
+        , m_string_index(string_index)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    Register m_dst;
+    size_t m_string_index { 0 };
+};
+
+class NewObject final : public Instruction {
+public:
+    explicit NewObject(Register dst)
+        : Instruction(Type::NewObject)
+        , m_dst(dst)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    Register m_dst;
+};
+
+// Variable-length instructions store their operand registers inline, directly after the fixed part.
+template<typename OpType>
+constexpr size_t length_with_register_slots(size_t register_count)
+{
+    return round_up_to_power_of_two(sizeof(OpType) + register_count * sizeof(Register), alignof(Instruction));
+}
+
+class NewArray final : public Instruction {
+public:
+    NewArray(Register dst, const Vector<Register>& elements)
+        : Instruction(Type::NewArray)
+        , m_dst(dst)
+        , m_element_count(elements.size())
+    {
+        for (size_t i = 0; i < m_element_count; ++i)
+            new (&m_elements[i]) Register(elements[i]);
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return length_with_register_slots<NewArray>(m_element_count); }
+
+private:
+    Register m_dst;
+    size_t m_element_count { 0 };
+    Register m_elements[0];
+};
+
+class NewFunction final : public Instruction {
+public:
+    NewFunction(Register dst, const FunctionExpression& function_node)
+        : Instruction(Type::NewFunction)
+        , m_dst(dst)
+        , m_function_node(function_node)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    Register m_dst;
+    const FunctionExpression& m_function_node;
+};
+
+// Converts src to a string and appends it to the string in dst.
+class AppendString final : public Instruction {
+public:
+    AppendString(Register dst, Register src)
+        : Instruction(Type::AppendString)
+        , m_dst(dst)
+        , m_src(src)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    Register m_dst;
+    Register m_src;
+};
+
+class GetVariable final : public Instruction {
+public:
+    GetVariable(Register dst, size_t identifier_index)
+        : Instruction(Type::GetVariable)
+        , m_dst(dst)
+        , m_identifier_index(identifier_index)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    Register m_dst;
+    size_t m_identifier_index { 0 };
+};
+
+// "typeof identifier" must not throw for unresolvable identifiers, so it gets its own instruction.
+class TypeofVariable final : public Instruction {
+public:
+    TypeofVariable(Register dst, size_t identifier_index)
+        : Instruction(Type::TypeofVariable)
+        , m_dst(dst)
+        , m_identifier_index(identifier_index)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    Register m_dst;
+    size_t m_identifier_index { 0 };
+};
+
+class SetVariable final : public Instruction {
+public:
+    SetVariable(size_t identifier_index, Register src)
+        : Instruction(Type::SetVariable)
+        , m_identifier_index(identifier_index)
+        , m_src(src)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    size_t m_identifier_index { 0 };
+    Register m_src;
+};
+
+// Initializes a variable declared with var, let or const.
+class DeclareVariable final : public Instruction {
+public:
+    DeclareVariable(size_t identifier_index, Register src)
+        : Instruction(Type::DeclareVariable)
+        , m_identifier_index(identifier_index)
+        , m_src(src)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    size_t m_identifier_index { 0 };
+    Register m_src;
+};
+
+class GetById final : public Instruction {
+public:
+    GetById(Register dst, Register object, size_t identifier_index)
+        : Instruction(Type::GetById)
+        , m_dst(dst)
+        , m_object(object)
+        , m_identifier_index(identifier_index)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+    const PropertyCache& property_cache() const { return m_property_cache; }
+
+private:
+    Register m_dst;
+    Register m_object;
+    size_t m_identifier_index { 0 };
+    mutable PropertyCache m_property_cache;
+};
+
+class GetByValue final : public Instruction {
+public:
+    GetByValue(Register dst, Register object, Register property)
+        : Instruction(Type::GetByValue)
+        , m_dst(dst)
+        , m_object(object)
+        , m_property(property)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    Register m_dst;
+    Register m_object;
+    Register m_property;
+};
+
+class PutById final : public Instruction {
+public:
+    PutById(Register object, size_t identifier_index, Register src)
+        : Instruction(Type::PutById)
+        , m_object(object)
+        , m_identifier_index(identifier_index)
+        , m_src(src)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+    const PropertyCache& property_cache() const { return m_property_cache; }
+
+private:
+    Register m_object;
+    size_t m_identifier_index { 0 };
+    Register m_src;
+    mutable PropertyCache m_property_cache;
+};
+
+class PutByValue final : public Instruction {
+public:
+    PutByValue(Register object, Register property, Register src)
+        : Instruction(Type::PutByValue)
+        , m_object(object)
+        , m_property(property)
+        , m_src(src)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    Register m_object;
+    Register m_property;
+    Register m_src;
+};
+
+// Defines a key/value property of an object literal.
+class PutOwnProperty final : public Instruction {
+public:
+    PutOwnProperty(Register object, Register key, Register src, bool is_method)
+        : Instruction(Type::PutOwnProperty)
+        , m_object(object)
+        , m_key(key)
+        , m_src(src)
+        , m_is_method(is_method)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    Register m_object;
+    Register m_key;
+    Register m_src;
+    bool m_is_method { false };
+};
+
+class ToObject final : public Instruction {
+public:
+    ToObject(Register dst, Register src)
+        : Instruction(Type::ToObject)
+        , m_dst(dst)
+        , m_src(src)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    Register m_dst;
+    Register m_src;
+};
+
+class Jump : public Instruction {
+public:
+    explicit Jump(Optional<Label> target = {})
+        : Instruction(Type::Jump)
+    {
+        if (target.has_value())
+            set_target(target.value());
+    }
+
+    void set_target(Label target) { m_target = target.address(); }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+protected:
+    Jump(Type type, Optional<Label> target)
+        : Instruction(type)
+    {
+        if (target.has_value())
+            set_target(target.value());
+    }
+
+    size_t m_target { 0 };
+};
+
+#define JS_DECLARE_BYTECODE_CONDITIONAL_JUMP(OpTitleCase)                   \
+    class OpTitleCase final : public Jump {                                 \
+    public:                                                                 \
+        explicit OpTitleCase(Register condition, Optional<Label> target = {}) \
+            : Jump(Type::OpTitleCase, target)                               \
+            , m_condition(condition)                                        \
+        {                                                                   \
+        }                                                                   \
+                                                                            \
+        void execute(Bytecode::Interpreter&) const;                         \
+        String to_string(const Bytecode::Executable&) const;                \
+        size_t length() const { return sizeof(*this); }                     \
+                                                                            \
+    private:                                                                \
+        Register m_condition;                                               \
+    };
+
+JS_DECLARE_BYTECODE_CONDITIONAL_JUMP(JumpIfTrue)
+JS_DECLARE_BYTECODE_CONDITIONAL_JUMP(JumpIfFalse)
+JS_DECLARE_BYTECODE_CONDITIONAL_JUMP(JumpIfNullish)
+JS_DECLARE_BYTECODE_CONDITIONAL_JUMP(JumpIfNotNullish)
+#undef JS_DECLARE_BYTECODE_CONDITIONAL_JUMP
+
+// Call and New share their layout: the callee, an optional |this| and the argument registers.
+// For diagnostics, expression_string_index names the source of the callee (or a null string).
+class Call : public Instruction {
+public:
+    Call(Register dst, Register callee, Register this_value, size_t expression_string_index, const Vector<Register>& arguments)
+        : Call(Type::Call, dst, callee, this_value, expression_string_index, arguments)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return length_with_register_slots<Call>(m_argument_count); }
+
+protected:
+    Call(Type type, Register dst, Register callee, Register this_value, size_t expression_string_index, const Vector<Register>& arguments)
+        : Instruction(type)
+        , m_dst(dst)
+        , m_callee(callee)
+        , m_this_value(this_value)
+        , m_expression_string_index(expression_string_index)
+        , m_argument_count(arguments.size())
+    {
+        for (size_t i = 0; i < m_argument_count; ++i)
+            new (&m_arguments[i]) Register(arguments[i]);
+    }
+
+    Register m_dst;
+    Register m_callee;
+    Register m_this_value;
+    size_t m_expression_string_index { 0 };
+    size_t m_argument_count { 0 };
+    Register m_arguments[0];
+};
+
+class New final : public Call {
+public:
+    New(Register dst, Register callee, size_t expression_string_index, const Vector<Register>& arguments)
+        : Call(Type::New, dst, callee, callee, expression_string_index, arguments)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return length_with_register_slots<New>(m_argument_count); }
+};
+
+class This final : public Instruction {
+public:
+    explicit This(Register dst)
+        : Instruction(Type::This)
+        , m_dst(dst)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    Register m_dst;
+};
+
+class Return final : public Instruction {
+public:
+    explicit Return(Register src)
+        : Instruction(Type::Return)
+        , m_src(src)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    Register m_src;
+};
+
+// Enters a block scope, hoisting its function declarations and creating a
+// lexical environment for its let/const declarations.
+class EnterScope final : public Instruction {
+public:
+    explicit EnterScope(const ScopeNode& scope_node)
+        : Instruction(Type::EnterScope)
+        , m_scope_node(scope_node)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    const ScopeNode& m_scope_node;
+};
+
+// Leaves scope_node and every scope entered after it.
+class ExitScope final : public Instruction {
+public:
+    explicit ExitScope(const ScopeNode& scope_node)
+        : Instruction(Type::ExitScope)
+        , m_scope_node(scope_node)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Bytecode::Executable&) const;
+    size_t length() const { return sizeof(*this); }
+
+private:
+    const ScopeNode& m_scope_node;
+};
+
+#define JS_DECLARE_BYTECODE_BINARY_OP(OpTitleCase, op_snake_case)  \
+    class OpTitleCase final : public Instruction {                 \
+    public:                                                        \
+        OpTitleCase(Register dst, Register lhs, Register rhs)      \
+            : Instruction(Type::OpTitleCase)                       \
+            , m_dst(dst)                                           \
+            , m_lhs(lhs)                                           \
+            , m_rhs(rhs)                                           \
+        {                                                          \
+        }                                                          \
+                                                                   \
+        void execute(Bytecode::Interpreter&) const;                \
+        String to_string(const Bytecode::Executable&) const;       \
+        size_t length() const { return sizeof(*this); }            \
+                                                                   \
+    private:                                                       \
+        Register m_dst;                                            \
+        Register m_lhs;                                            \
+        Register m_rhs;                                            \
+    };
+
+ENUMERATE_BYTECODE_BINARY_OPS(JS_DECLARE_BYTECODE_BINARY_OP)
+#undef JS_DECLARE_BYTECODE_BINARY_OP
+
+#define JS_DECLARE_BYTECODE_UNARY_OP(OpTitleCase, op_snake_case) \
+    class OpTitleCase final : public Instruction {               \
+    public:                                                      \
+        OpTitleCase(Register dst, Register src)                  \
+            : Instruction(Type::OpTitleCase)                     \
+            , m_dst(dst)                                         \
+            , m_src(src)                                         \
+        {                                                        \
+        }                                                        \
+                                                                 \
+        void execute(Bytecode::Interpreter&) const;              \
+        String to_string(const Bytecode::Executable&) const;     \
+        size_t length() const { return sizeof(*this); }          \
+                                                                 \
+    private:                                                     \
+        Register m_dst;                                          \
+        Register m_src;                                          \
+    };
+
+ENUMERATE_BYTECODE_UNARY_OPS(JS_DECLARE_BYTECODE_UNARY_OP)
+#undef JS_DECLARE_BYTECODE_UNARY_OP
+
+}
@@ -128,6 +128,7 @@ class DeferGC;
 class Error;
 class Exception;
 class Expression;
+class FunctionExpression;
 class Accessor;
 class GlobalObject;
 class HandleImpl;
@@ -139,6 +140,7 @@ class MarkedValueList;
 class NativeFunction;
 class NativeProperty;
 class PrimitiveString;
+class PropertyCache;
 class Reference;
 class ScopeNode;
 class ScopeObject;
@@ -170,4 +172,12 @@ JS_ENUMERATE_TYPED_ARRAYS
 template<class T>
 class Handle;
 
+namespace Bytecode {
+class Executable;
+class Generator;
+class Instruction;
+class Interpreter;
+class Register;
+}
+
 }
@@ -36,6 +36,7 @@
 #include <LibJS/Heap/HeapBlock.h>
 #include <LibJS/Interpreter.h>
 #include <LibJS/Runtime/Object.h>
+#include <LibJS/Runtime/Shape.h>
 #include <setjmp.h>
 
 namespace JS {
@@ -69,16 +70,20 @@ ALWAYS_INLINE Allocator& Heap::allocator_for_size(size_t cell_size)
 
 Cell* Heap::allocate_cell(size_t size)
 {
+    auto& allocator = allocator_for_size(size);
+
     if (should_collect_on_every_allocation()) {
         collect_garbage();
-    } else if (m_allocations_since_last_gc > m_max_allocations_between_gc) {
-        m_allocations_since_last_gc = 0;
-        collect_garbage();
-    } else {
-        ++m_allocations_since_last_gc;
+    } else if (m_marking_incrementally) {
+        if (m_allocated_bytes_since_last_gc + allocator.cell_size() > 2 * m_allocated_bytes_threshold)
+            collect_garbage();
+        else if (m_allocated_bytes_since_last_gc >= m_allocated_bytes_at_next_marking_slice)
+            do_incremental_marking_slice();
+    } else if (m_allocated_bytes_since_last_gc + allocator.cell_size() > m_allocated_bytes_threshold) {
+        start_incremental_marking();
     }
 
-    auto& allocator = allocator_for_size(size);
+    m_allocated_bytes_since_last_gc += allocator.cell_size();
     return allocator.allocate_cell(*this);
 }
 
@@ -87,7 +92,7 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
     ASSERT(!m_collecting_garbage);
     TemporaryChange change(m_collecting_garbage, true);
 
-    Core::ElapsedTimer collection_measurement_timer;
+    Core::ElapsedTimer collection_measurement_timer(true);
     collection_measurement_timer.start();
     if (collection_type == CollectionType::CollectGarbage) {
         if (m_gc_deferrals) {
@@ -97,8 +102,58 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
         HashTable<Cell*> roots;
         gather_roots(roots);
         mark_live_cells(roots);
+        remove_dead_weak_references();
+    } else if (m_marking_incrementally) {
+        cancel_incremental_marking();
     }
     sweep_dead_cells(print_report, collection_measurement_timer);
+
+    m_allocated_bytes_since_last_gc = 0;
+    m_allocated_bytes_threshold = max(minimum_bytes_between_gc, m_live_cell_bytes_after_last_gc * heap_growth_factor);
+
+    if (collection_type == CollectionType::CollectGarbage) {
+        ++m_statistics.collections;
+        record_pause(collection_measurement_timer.elapsed_microseconds());
+    }
+    if (print_report)
+        dump_statistics();
+}
+
+void Heap::record_pause(i64 microseconds)
+{
+    m_statistics.total_pause_microseconds += microseconds;
+    m_statistics.max_pause_microseconds = max(m_statistics.max_pause_microseconds, microseconds);
+
+    size_t bucket = 0;
+    for (auto limit = Statistics::pause_histogram_base_microseconds; microseconds >= limit && bucket < Statistics::pause_histogram_bucket_count - 1; limit *= 2)
+        ++bucket;
+    ++m_statistics.pause_histogram[bucket];
+}
+
+void Heap::dump_statistics() const
+{
+    dbgln("Garbage collection statistics");
+    dbgln("=============================================");
+    dbgln("    Collections: {}", m_statistics.collections);
+    dbgln("Marking slices: {}", m_statistics.incremental_marking_slices);
+    auto pauses = m_statistics.collections + m_statistics.incremental_marking_slices;
+    if (pauses) {
+        dbgln("    Total pause: {} us", m_statistics.total_pause_microseconds);
+        dbgln("  Average pause: {} us", m_statistics.total_pause_microseconds / (i64)pauses);
+        dbgln("      Max pause: {} us", m_statistics.max_pause_microseconds);
+    }
+    dbgln("  Next GC after: {} bytes ({} bytes live)", m_allocated_bytes_threshold, m_live_cell_bytes_after_last_gc);
+    i64 lower_bound = 0;
+    i64 upper_bound = Statistics::pause_histogram_base_microseconds;
+    for (size_t i = 0; i < Statistics::pause_histogram_bucket_count; ++i) {
+        if (i == Statistics::pause_histogram_bucket_count - 1)
+            dbgln("  {:>6} us -      : {}", lower_bound, m_statistics.pause_histogram[i]);
+        else
+            dbgln("  {:>6} us - {:>6}: {}", lower_bound, upper_bound, m_statistics.pause_histogram[i]);
+        lower_bound = upper_bound;
+        upper_bound *= 2;
+    }
+    dbgln("=============================================");
 }
 
 void Heap::gather_roots(HashTable<Cell*>& roots)
@@ -134,30 +189,15 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
     jmp_buf buf;
     setjmp(buf);
 
-    HashTable<FlatPtr> possible_pointers;
-
-    const FlatPtr* raw_jmp_buf = reinterpret_cast<const FlatPtr*>(buf);
-
-    for (size_t i = 0; i < ((size_t)sizeof(buf)) / sizeof(FlatPtr); i += sizeof(FlatPtr))
-        possible_pointers.set(raw_jmp_buf[i]);
-
-    FlatPtr stack_reference = reinterpret_cast<FlatPtr>(&dummy);
-    auto& stack_info = m_vm.stack_info();
-
-    for (FlatPtr stack_address = stack_reference; stack_address < stack_info.top(); stack_address += sizeof(FlatPtr)) {
-        auto data = *reinterpret_cast<FlatPtr*>(stack_address);
-        possible_pointers.set(data);
-    }
-
     HashTable<HeapBlock*> all_live_heap_blocks;
     for_each_block([&](auto& block) {
         all_live_heap_blocks.set(&block);
         return IterationDecision::Continue;
     });
 
-    for (auto possible_pointer : possible_pointers) {
+    auto add_possible_value = [&](FlatPtr possible_pointer) {
         if (!possible_pointer)
-            continue;
+            return;
 #if HEAP_DEBUG
         dbgln("  ? {}", (const void*)possible_pointer);
 #endif
@@ -176,12 +216,28 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
                 }
             }
         }
+    };
+
+    const FlatPtr* raw_jmp_buf = reinterpret_cast<const FlatPtr*>(buf);
+
+    for (size_t i = 0; i < ((size_t)sizeof(buf)) / sizeof(FlatPtr); i += sizeof(FlatPtr))
+        add_possible_value(raw_jmp_buf[i]);
+
+    FlatPtr stack_reference = reinterpret_cast<FlatPtr>(&dummy);
+    auto& stack_info = m_vm.stack_info();
+
+    for (FlatPtr stack_address = stack_reference; stack_address < stack_info.top(); stack_address += sizeof(FlatPtr)) {
+        auto data = *reinterpret_cast<FlatPtr*>(stack_address);
+        add_possible_value(data);
     }
 }
 
 class MarkingVisitor final : public Cell::Visitor {
 public:
-    MarkingVisitor() { }
+    explicit MarkingVisitor(Vector<Cell*>& work_queue)
+        : m_work_queue(work_queue)
+    {
+    }
 
     virtual void visit_impl(Cell* cell)
     {
@@ -191,18 +247,123 @@ public:
         dbgln("  ! {}", cell);
 #endif
         cell->set_marked(true);
-        cell->visit_edges(*this);
+        m_work_queue.append(cell);
+    }
+
+    // Cells are traced from an explicit work list rather than by recursing into
+    // visit_edges(), so that long chains of objects can't exhaust the stack.
+    void mark_all_reachable()
+    {
+        while (!m_work_queue.is_empty())
+            m_work_queue.take_last()->visit_edges(*this);
+    }
+
+    // Returns whether everything reachable got marked before the time ran out.
+    bool mark_reachable_until(const Core::ElapsedTimer& timer, i64 budget_microseconds)
+    {
+        for (size_t visited_cells = 1; !m_work_queue.is_empty(); ++visited_cells) {
+            m_work_queue.take_last()->visit_edges(*this);
+            // Looking at the clock isn't free, so only do it every now and then.
+            if (visited_cells % 64 == 0 && timer.elapsed_microseconds() >= budget_microseconds)
+                return m_work_queue.is_empty();
+        }
+        return true;
     }
+
+private:
+    Vector<Cell*>& m_work_queue;
 };
 
+void Heap::start_incremental_marking()
+{
+    ASSERT(!m_marking_incrementally);
+    Core::ElapsedTimer timer(true);
+    timer.start();
+
+#if HEAP_DEBUG
+    dbgln("start_incremental_marking:");
+#endif
+    HashTable<Cell*> roots;
+    gather_roots(roots);
+    m_marking_incrementally = true;
+    MarkingVisitor visitor(m_cells_to_visit);
+    for (auto* root : roots)
+        visitor.visit(root);
+
+    m_allocated_bytes_at_next_marking_slice = m_allocated_bytes_since_last_gc;
+    ++m_statistics.incremental_marking_slices;
+    record_pause(timer.elapsed_microseconds());
+
+    do_incremental_marking_slice();
+}
+
+void Heap::do_incremental_marking_slice()
+{
+    ASSERT(m_marking_incrementally);
+    Core::ElapsedTimer timer(true);
+    timer.start();
+
+    MarkingVisitor visitor(m_cells_to_visit);
+    bool done = visitor.mark_reachable_until(timer, incremental_marking_slice_microseconds);
+    m_allocated_bytes_at_next_marking_slice = m_allocated_bytes_since_last_gc + incremental_marking_bytes_between_slices;
+    ++m_statistics.incremental_marking_slices;
+    record_pause(timer.elapsed_microseconds());
+
+    if (done)
+        collect_garbage();
+}
+
+void Heap::cancel_incremental_marking()
+{
+    for_each_block([&](auto& block) {
+        block.for_each_cell([&](Cell* cell) {
+            cell->set_marked(false);
+            cell->set_remembered(false);
+        });
+        return IterationDecision::Continue;
+    });
+    m_cells_to_visit.clear();
+    m_remembered_cells.clear();
+    m_marking_incrementally = false;
+}
+
+void Heap::did_write_to_marked_cell(Badge<Cell>, Cell& cell)
+{
+    if (!m_marking_incrementally)
+        return;
+    cell.set_remembered(true);
+    m_remembered_cells.append(&cell);
+}
+
 void Heap::mark_live_cells(const HashTable<Cell*>& roots)
 {
 #if HEAP_DEBUG
     dbgln("mark_live_cells:");
 #endif
-    MarkingVisitor visitor;
+    // If we were marking incrementally, this picks up where the last slice left off.
+    MarkingVisitor visitor(m_cells_to_visit);
     for (auto* root : roots)
         visitor.visit(root);
+    for (auto* cell : m_remembered_cells) {
+        cell->set_remembered(false);
+        cell->visit_edges(visitor);
+    }
+    m_remembered_cells.clear();
+    visitor.mark_all_reachable();
+    m_marking_incrementally = false;
+}
+
+void Heap::remove_dead_weak_references()
+{
+    Vector<Shape*> shapes_without_prototype_transitions;
+    for (auto* shape : m_shapes_with_prototype_transitions) {
+        if (!shape->is_marked())
+            continue;
+        if (!shape->remove_dead_prototype_transitions({}))
+            shapes_without_prototype_transitions.append(shape);
+    }
+    for (auto* shape : shapes_without_prototype_transitions)
+        m_shapes_with_prototype_transitions.remove(shape);
 }
 
 void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measurement_timer)
@@ -266,6 +427,8 @@ void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measure
     });
 #endif
 
+    m_live_cell_bytes_after_last_gc = live_cell_bytes;
+
     int time_spent = measurement_timer.elapsed();
 
     if (print_report) {
@@ -310,6 +473,16 @@ void Heap::did_destroy_marked_value_list(Badge<MarkedValueList>, MarkedValueList
     m_marked_value_lists.remove(&list);
 }
 
+void Heap::did_create_prototype_transition(Badge<Shape>, Shape& shape)
+{
+    m_shapes_with_prototype_transitions.set(&shape);
+}
+
+void Heap::did_destroy_shape_with_prototype_transitions(Badge<Shape>, Shape& shape)
+{
+    m_shapes_with_prototype_transitions.remove(&shape);
+}
+
 void Heap::defer_gc(Badge<DeferGC>)
 {
     ++m_gc_deferrals;
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/HashTable.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullOwnPtr.h>
@@ -53,7 +54,9 @@ public:
     {
         auto* memory = allocate_cell(sizeof(T));
         new (memory) T(forward<Args>(args)...);
-        return static_cast<T*>(memory);
+        auto* cell = static_cast<T*>(memory);
+        did_construct_cell(*cell);
+        return cell;
     }
 
     template<typename T, typename... Args>
@@ -62,6 +65,7 @@ public:
         auto* memory = allocate_cell(sizeof(T));
         new (memory) T(forward<Args>(args)...);
         auto* cell = static_cast<T*>(memory);
+        did_construct_cell(*cell);
         constexpr bool is_object = IsBaseOf<Object, T>::value;
         if constexpr (is_object)
             static_cast<Object*>(cell)->disable_transitions();
@@ -89,19 +93,56 @@ public:
     void did_create_marked_value_list(Badge<MarkedValueList>, MarkedValueList&);
     void did_destroy_marked_value_list(Badge<MarkedValueList>, MarkedValueList&);
 
+    void did_create_prototype_transition(Badge<Shape>, Shape&);
+    void did_destroy_shape_with_prototype_transitions(Badge<Shape>, Shape&);
+
     void defer_gc(Badge<DeferGC>);
     void undefer_gc(Badge<DeferGC>);
 
+    void did_write_to_marked_cell(Badge<Cell>, Cell&);
+
+    struct Statistics {
+        // Bucket 0 counts pauses shorter than 250us, and each following bucket doubles the limit.
+        // The last bucket counts everything that didn't fit in the others (64ms and up).
+        static constexpr size_t pause_histogram_bucket_count = 10;
+        static constexpr i64 pause_histogram_base_microseconds = 250;
+
+        size_t collections { 0 };
+        size_t incremental_marking_slices { 0 };
+        i64 total_pause_microseconds { 0 };
+        i64 max_pause_microseconds { 0 };
+        AK::Array<size_t, pause_histogram_bucket_count> pause_histogram {};
+    };
+
+    const Statistics& statistics() const { return m_statistics; }
+    void dump_statistics() const;
+
 private:
     Cell* allocate_cell(size_t);
 
     void gather_roots(HashTable<Cell*>&);
     void gather_conservative_roots(HashTable<Cell*>&);
+    void start_incremental_marking();
+    void do_incremental_marking_slice();
+    void cancel_incremental_marking();
     void mark_live_cells(const HashTable<Cell*>& live_cells);
+    void remove_dead_weak_references();
     void sweep_dead_cells(bool print_report, const Core::ElapsedTimer&);
+    void record_pause(i64 microseconds);
 
     Allocator& allocator_for_size(size_t);
 
+    // Cells allocated while marking incrementally survive the collection. They are visited once marking
+    // finishes, as initialize() may still store references in them after they have been allocated.
+    ALWAYS_INLINE void did_construct_cell(Cell& cell)
+    {
+        if (!m_marking_incrementally)
+            return;
+        cell.set_marked(true);
+        cell.set_remembered(true);
+        m_remembered_cells.append(&cell);
+    }
+
     template<typename Callback>
     void for_each_block(Callback callback)
     {
@@ -111,8 +152,29 @@ private:
         }
     }
 
-    size_t m_max_allocations_between_gc { 10000 };
-    size_t m_allocations_since_last_gc { false };
+    // Collections are triggered by the number of bytes allocated since the last one, relative to
+    // how much survived it. The bigger the live heap, the more we allocate before paying for
+    // another full mark of it.
+    static constexpr size_t minimum_bytes_between_gc = 2 * MiB;
+    static constexpr size_t heap_growth_factor = 1;
+
+    size_t m_allocated_bytes_since_last_gc { 0 };
+    size_t m_allocated_bytes_threshold { minimum_bytes_between_gc };
+    size_t m_live_cell_bytes_after_last_gc { 0 };
+
+    // Once the threshold is reached, marking starts and runs for up to incremental_marking_slice_microseconds
+    // every incremental_marking_bytes_between_slices of allocation. The roots are marked again and the cells
+    // that were written to after being visited are visited again in the final pause, which also sweeps.
+    // If marking takes so long that we allocate another threshold worth of bytes, it finishes right away.
+    static constexpr size_t incremental_marking_bytes_between_slices = 128 * KiB;
+    static constexpr i64 incremental_marking_slice_microseconds = 1000;
+
+    bool m_marking_incrementally { false };
+    size_t m_allocated_bytes_at_next_marking_slice { 0 };
+    Vector<Cell*> m_cells_to_visit;
+    Vector<Cell*> m_remembered_cells;
+
+    Statistics m_statistics;
 
     bool m_should_collect_on_every_allocation { false };
 
@@ -123,6 +185,8 @@ private:
 
     HashTable<MarkedValueList*> m_marked_value_lists;
 
+    HashTable<Shape*> m_shapes_with_prototype_transitions;
+
     size_t m_gc_deferrals { 0 };
     bool m_should_gc_when_deferral_ends { false };
 
@@ -27,6 +27,7 @@
 #include <AK/Badge.h>
 #include <AK/StringBuilder.h>
 #include <LibJS/AST.h>
+#include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Interpreter.h>
 #include <LibJS/Runtime/Error.h>
 #include <LibJS/Runtime/GlobalObject.h>
@@ -75,7 +76,17 @@ Value Interpreter::run(GlobalObject& global_object, const Program& program)
     global_call_frame.is_strict_mode = program.is_strict_mode();
     vm.push_call_frame(global_call_frame, global_object);
     ASSERT(!vm.exception());
-    auto result = program.execute(*this, global_object);
+    Value result;
+    auto* executable = vm.bytecode_enabled() ? program.bytecode_executable() : nullptr;
+    if (executable) {
+        enter_scope(program, ScopeType::Block, global_object);
+        if (!exception())
+            vm.set_last_value({}, Bytecode::Interpreter(global_object).run(*executable));
+        exit_scope(program);
+        result = js_undefined();
+    } else {
+        result = program.execute(*this, global_object);
+    }
     vm.pop_call_frame();
     return result;
 }
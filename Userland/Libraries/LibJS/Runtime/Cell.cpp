@@ -50,6 +50,11 @@ Heap& Cell::heap() const
     return HeapBlock::from_cell(this)->heap();
 }
 
+void Cell::did_write_while_marked()
+{
+    heap().did_write_to_marked_cell({}, *this);
+}
+
 VM& Cell::vm() const
 {
     return heap().vm();
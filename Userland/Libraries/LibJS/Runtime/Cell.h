@@ -46,6 +46,19 @@ public:
     bool is_marked() const { return m_mark; }
     void set_marked(bool b) { m_mark = b; }
 
+    // Set while the cell waits to be visited again at the end of incremental marking.
+    bool is_remembered() const { return m_remembered; }
+    void set_remembered(bool b) { m_remembered = b; }
+
+    // Has to be called after storing a reference to another cell in this one. The program keeps
+    // running between incremental marking slices, so a cell that was already visited must be
+    // visited again before we can sweep.
+    void write_barrier()
+    {
+        if (m_mark && !m_remembered)
+            did_write_while_marked();
+    }
+
     bool is_live() const { return m_live; }
     void set_live(bool b) { m_live = b; }
 
@@ -69,8 +82,11 @@ protected:
     Cell() { }
 
 private:
+    void did_write_while_marked();
+
     bool m_mark { false };
     bool m_live { true };
+    bool m_remembered { false };
 };
 
 }
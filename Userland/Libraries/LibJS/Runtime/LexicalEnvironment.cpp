@@ -80,6 +80,7 @@ Optional<Variable> LexicalEnvironment::get_from_scope(const FlyString& name) con
 void LexicalEnvironment::put_to_scope(const FlyString& name, Variable variable)
 {
     m_variables.set(name, variable);
+    write_barrier();
 }
 
 bool LexicalEnvironment::has_super_binding() const
@@ -128,6 +129,7 @@ void LexicalEnvironment::bind_this_value(GlobalObject& global_object, Value this
         return;
     }
     m_this_value = this_value;
+    write_barrier();
     m_this_binding_status = ThisBindingStatus::Initialized;
 }
 
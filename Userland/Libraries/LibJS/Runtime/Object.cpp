@@ -35,6 +35,8 @@
 #include <LibJS/Runtime/NativeFunction.h>
 #include <LibJS/Runtime/NativeProperty.h>
 #include <LibJS/Runtime/Object.h>
+#include <LibJS/Runtime/PropertyCache.h>
+#include <LibJS/Runtime/ProxyObject.h>
 #include <LibJS/Runtime/Shape.h>
 #include <LibJS/Runtime/StringObject.h>
 #include <LibJS/Runtime/Value.h>
@@ -99,8 +101,9 @@ Object::Object(ConstructWithoutPrototypeTag, GlobalObject& global_object)
 
 Object::Object(Object& prototype)
 {
-    m_shape = prototype.global_object().empty_object_shape();
-    set_prototype(&prototype);
+    // Objects constructed this way usually add their properties during initialize(), with
+    // transitions disabled, so they need a shape of their own rather than a shared transition.
+    m_shape = heap().allocate_without_global_object<Shape>(*prototype.global_object().empty_object_shape(), &prototype);
 }
 
 Object::Object(Shape& shape)
@@ -137,7 +140,13 @@ bool Object::set_prototype(Object* new_prototype)
         shape().set_prototype_without_transition(new_prototype);
         return true;
     }
+    if (!m_transitions_enabled) {
+        // Properties added from here on mutate the shape in place, so don't share it.
+        m_shape = heap().allocate_without_global_object<Shape>(*m_shape, new_prototype);
+        return true;
+    }
     m_shape = m_shape->create_prototype_transition(new_prototype);
+    write_barrier();
     return true;
 }
 
@@ -345,6 +354,7 @@ void Object::set_shape(Shape& new_shape)
 {
     m_storage.resize(new_shape.property_count());
     m_shape = &new_shape;
+    write_barrier();
 }
 
 bool Object::define_property(const StringOrSymbol& property_name, const Object& descriptor, bool throw_exceptions)
@@ -491,6 +501,7 @@ bool Object::put_own_property(Object& this_object, const StringOrSymbol& propert
         m_shape->add_property_without_transition(property_name, attributes);
         m_storage.resize(m_shape->property_count());
         m_storage[m_shape->property_count() - 1] = value;
+        write_barrier();
         return true;
     }
 
@@ -563,6 +574,7 @@ bool Object::put_own_property(Object& this_object, const StringOrSymbol& propert
         call_native_property_setter(value_here.as_native_property(), &this_object, value);
     } else {
         m_storage[metadata.value().offset] = value;
+        write_barrier();
     }
     return true;
 }
@@ -617,6 +629,7 @@ bool Object::put_own_property_by_index(Object& this_object, u32 property_index,
         call_native_property_setter(value_here.as_native_property(), &this_object, value);
     } else {
         m_indexed_properties.put(&this_object, property_index, value, attributes, mode == PutOwnPropertyMode::Put);
+        write_barrier();
     }
     return true;
 }
@@ -777,6 +790,8 @@ bool Object::put(const PropertyName& property_name, Value value, Value receiver)
                 call_native_property_setter(value_here.as_native_property(), receiver, value);
                 return true;
             }
+            // A data property shadows any setters further up the prototype chain.
+            break;
         }
         object = object->prototype();
         if (vm().exception())
@@ -785,6 +800,84 @@ bool Object::put(const PropertyName& property_name, Value value, Value receiver)
     return put_own_property(*this, string_or_symbol, value, default_attributes, PutOwnPropertyMode::Put);
 }
 
+Value Object::get_with_cache(const PropertyName& property_name, PropertyCache& cache, Value receiver) const
+{
+    ASSERT(property_name.is_valid());
+
+    if (auto* entry = cache.find(shape())) {
+        const Object* holder = this;
+        if (entry->prototype_shape_id) {
+            holder = shape().prototype();
+            if (holder && holder->shape().id() != entry->prototype_shape_id)
+                holder = nullptr;
+        }
+        if (holder && entry->offset < holder->m_storage.size()) {
+            auto value = holder->m_storage[entry->offset];
+            if (!value.is_empty() && !value.is_accessor() && !value.is_native_property()) {
+                cache.did_hit();
+                return value;
+            }
+        }
+    }
+
+    cache.did_miss();
+    auto value = get(property_name, receiver);
+    if (!vm().exception() && !property_name.is_number())
+        update_property_cache(property_name.to_string_or_symbol(), cache);
+    return value;
+}
+
+bool Object::put_with_cache(const PropertyName& property_name, Value value, PropertyCache& cache, Value receiver)
+{
+    ASSERT(property_name.is_valid());
+    ASSERT(!value.is_empty());
+
+    if (receiver.is_empty() || (receiver.is_object() && &receiver.as_object() == this)) {
+        auto* entry = cache.find(shape());
+        if (entry && !entry->prototype_shape_id && entry->is_writable && entry->offset < m_storage.size()) {
+            auto& value_here = m_storage[entry->offset];
+            if (!value_here.is_empty() && !value_here.is_accessor() && !value_here.is_native_property()) {
+                cache.did_hit();
+                value_here = value;
+                write_barrier();
+                return true;
+            }
+        }
+    }
+
+    cache.did_miss();
+    auto result = put(property_name, value, receiver);
+    if (!vm().exception() && !property_name.is_number())
+        update_property_cache(property_name.to_string_or_symbol(), cache);
+    return result;
+}
+
+void Object::update_property_cache(const StringOrSymbol& property_name, PropertyCache& cache) const
+{
+    if (cache.is_megamorphic() || is<ProxyObject>(*this))
+        return;
+
+    auto is_plain_data = [](Value value) {
+        return !value.is_empty() && !value.is_accessor() && !value.is_native_property();
+    };
+
+    if (auto metadata = shape().lookup(property_name); metadata.has_value()) {
+        auto offset = metadata.value().offset;
+        if (offset < m_storage.size() && is_plain_data(m_storage[offset]))
+            cache.add({ shape().id(), 0, static_cast<u32>(offset), metadata.value().attributes.is_writable() });
+        return;
+    }
+
+    auto* prototype = shape().prototype();
+    if (!prototype || is<ProxyObject>(*prototype))
+        return;
+    if (auto metadata = prototype->shape().lookup(property_name); metadata.has_value()) {
+        auto offset = metadata.value().offset;
+        if (offset < prototype->m_storage.size() && is_plain_data(prototype->m_storage[offset]))
+            cache.add({ shape().id(), prototype->shape().id(), static_cast<u32>(offset), false });
+    }
+}
+
 bool Object::define_native_function(const StringOrSymbol& property_name, AK::Function<Value(VM&, GlobalObject&)> native_function, i32 length, PropertyAttributes attribute)
 {
     auto& vm = this->vm();
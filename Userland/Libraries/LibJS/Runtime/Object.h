@@ -94,6 +94,11 @@ public:
 
     virtual bool put(const PropertyName&, Value, Value receiver = {});
 
+    // Like get() and put(), but consult and update a property cache for the access site.
+    // The property name must not be an array index.
+    Value get_with_cache(const PropertyName&, PropertyCache&, Value receiver = {}) const;
+    bool put_with_cache(const PropertyName&, Value, PropertyCache&, Value receiver = {});
+
     Value get_own_property(const PropertyName&, Value receiver) const;
     Value get_own_properties(const Object& this_object, PropertyKind, bool only_enumerable_properties = false, GetOwnPropertyReturnType = GetOwnPropertyReturnType::StringOnly) const;
     virtual Optional<PropertyDescriptor> get_own_property_descriptor(const PropertyName&) const;
@@ -130,7 +135,12 @@ public:
     Value get_direct(size_t index) const { return m_storage[index]; }
 
     const IndexedProperties& indexed_properties() const { return m_indexed_properties; }
-    IndexedProperties& indexed_properties() { return m_indexed_properties; }
+    // Anything may be stored through this, so the object has to be visited again if it was already marked.
+    IndexedProperties& indexed_properties()
+    {
+        write_barrier();
+        return m_indexed_properties;
+    }
     void set_indexed_property_elements(Vector<Value>&& values) { m_indexed_properties = IndexedProperties(move(values)); }
 
     Value invoke(const StringOrSymbol& property_name, Optional<MarkedValueList> arguments = {});
@@ -157,6 +167,7 @@ private:
     void call_native_property_setter(NativeProperty& property, Value this_value, Value) const;
 
     void set_shape(Shape&);
+    void update_property_cache(const StringOrSymbol& property_name, PropertyCache&) const;
 
     bool m_is_extensible { true };
     bool m_transitions_enabled { true };
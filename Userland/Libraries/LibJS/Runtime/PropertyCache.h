@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Debug.h>
+#include <AK/Types.h>
+#include <LibJS/Runtime/Shape.h>
+
+namespace JS {
+
+// A polymorphic inline cache for named property accesses at a single site.
+// Each entry remembers where a property lives for one receiver shape, either
+// in the receiver itself or in its immediate prototype.
+class PropertyCache {
+public:
+    static constexpr size_t max_entries = 4;
+
+    struct Entry {
+        u64 shape_id { 0 };
+        // Zero if the property is an own property of the receiver.
+        u64 prototype_shape_id { 0 };
+        u32 offset { 0 };
+        bool is_writable { false };
+    };
+
+    const Entry* find(const Shape& shape) const
+    {
+        for (size_t i = 0; i < m_entry_count; ++i) {
+            if (m_entries[i].shape_id == shape.id())
+                return &m_entries[i];
+        }
+        return nullptr;
+    }
+
+    void add(const Entry& entry)
+    {
+        for (size_t i = 0; i < m_entry_count; ++i) {
+            if (m_entries[i].shape_id == entry.shape_id) {
+                m_entries[i] = entry;
+                return;
+            }
+        }
+        // Once a site has seen too many shapes, it's megamorphic and we stop caching.
+        if (m_entry_count == max_entries)
+            return;
+        m_entries[m_entry_count++] = entry;
+    }
+
+    bool is_megamorphic() const { return m_entry_count == max_entries; }
+
+    void did_hit()
+    {
+        if constexpr (JS_PROPERTY_CACHE_DEBUG)
+            ++m_hits;
+    }
+
+    void did_miss()
+    {
+        if constexpr (JS_PROPERTY_CACHE_DEBUG)
+            ++m_misses;
+    }
+
+    u32 hits() const { return m_hits; }
+    u32 misses() const { return m_misses; }
+    size_t entry_count() const { return m_entry_count; }
+
+private:
+    Entry m_entries[max_entries];
+    u8 m_entry_count { 0 };
+    u32 m_hits { 0 };
+    u32 m_misses { 0 };
+};
+
+}
@@ -69,6 +69,15 @@ ProxyObject::ProxyObject(Object& target, Object& handler, Object& prototype)
 {
 }
 
+void ProxyObject::initialize(GlobalObject& global_object)
+{
+    Base::initialize(global_object);
+    // Property caches skip get() and put() on a hit, which must never happen for a proxy.
+    // Proxies never populate a cache, so giving them a shape of their own keeps them from
+    // matching an entry recorded for an ordinary object.
+    ensure_shape_is_unique();
+}
+
 ProxyObject::~ProxyObject()
 {
 }
@@ -37,6 +37,7 @@ public:
     static ProxyObject* create(GlobalObject&, Object& target, Object& handler);
 
     ProxyObject(Object& target, Object& handler, Object& prototype);
+    virtual void initialize(GlobalObject&) override;
     virtual ~ProxyObject() override;
 
     virtual Value call() override;
@@ -58,7 +58,10 @@ void Reference::put(GlobalObject& global_object, Value value)
     if (!object)
         return;
 
-    object->put(m_name, value);
+    if (m_property_cache)
+        object->put_with_cache(m_name, value, *m_property_cache);
+    else
+        object->put(m_name, value);
 }
 
 void Reference::throw_reference_error(GlobalObject& global_object)
@@ -100,6 +103,8 @@ Value Reference::get(GlobalObject& global_object)
     if (!object)
         return {};
 
+    if (m_property_cache)
+        return object->get_with_cache(m_name, *m_property_cache).value_or(js_undefined());
     return object->get(m_name).value_or(js_undefined());
 }
 
@@ -85,6 +85,9 @@ public:
         return m_global_variable;
     }
 
+    PropertyCache* property_cache() const { return m_property_cache; }
+    void set_property_cache(PropertyCache* property_cache) { m_property_cache = property_cache; }
+
     void put(GlobalObject&, Value);
     Value get(GlobalObject&);
 
@@ -93,6 +96,7 @@ private:
 
     Value m_base { js_undefined() };
     PropertyName m_name;
+    PropertyCache* m_property_cache { nullptr };
     bool m_strict { false };
     bool m_local_variable { false };
     bool m_global_variable { false };
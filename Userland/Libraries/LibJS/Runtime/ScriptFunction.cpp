@@ -26,6 +26,7 @@
 
 #include <AK/Function.h>
 #include <LibJS/AST.h>
+#include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Interpreter.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/Error.h>
@@ -147,6 +148,16 @@ Value ScriptFunction::execute_function_body()
         vm.current_scope()->put_to_scope(parameter.name, { argument_value, DeclarationKind::Var });
     }
 
+    if (vm.bytecode_enabled() && is<ScopeNode>(*m_body)) {
+        auto& body = static_cast<const ScopeNode&>(*m_body);
+        if (auto* executable = body.bytecode_executable()) {
+            interpreter->enter_scope(body, ScopeType::Function, global_object());
+            auto result = Bytecode::Interpreter(global_object()).run(*executable);
+            interpreter->exit_scope(body);
+            return result;
+        }
+    }
+
     return interpreter->execute_statement(global_object(), m_body, ScopeType::Function);
 }
 
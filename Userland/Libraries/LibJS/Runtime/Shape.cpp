@@ -30,6 +30,8 @@
 
 namespace JS {
 
+static u64 s_next_shape_id = 1;
+
 Shape* Shape::create_unique_clone() const
 {
     ASSERT(m_global_object);
@@ -65,20 +67,41 @@ Shape* Shape::create_configure_transition(const StringOrSymbol& property_name, P
 
 Shape* Shape::create_prototype_transition(Object* new_prototype)
 {
-    return heap().allocate_without_global_object<Shape>(*this, new_prototype);
+    if (auto* existing_shape = m_prototype_transitions.get(new_prototype).value_or(nullptr))
+        return existing_shape;
+    auto* new_shape = heap().allocate_without_global_object<Shape>(*this, new_prototype);
+    if (m_prototype_transitions.is_empty())
+        heap().did_create_prototype_transition({}, *this);
+    m_prototype_transitions.set(new_prototype, new_shape);
+    return new_shape;
+}
+
+bool Shape::remove_dead_prototype_transitions(Badge<Heap>)
+{
+    Vector<Object*> dead_keys;
+    for (auto& it : m_prototype_transitions) {
+        if ((it.key && !it.key->is_marked()) || !it.value->is_marked())
+            dead_keys.append(it.key);
+    }
+    for (auto* key : dead_keys)
+        m_prototype_transitions.remove(key);
+    return !m_prototype_transitions.is_empty();
 }
 
 Shape::Shape(ShapeWithoutGlobalObjectTag)
+    : m_id(s_next_shape_id++)
 {
 }
 
 Shape::Shape(Object& global_object)
-    : m_global_object(&global_object)
+    : m_id(s_next_shape_id++)
+    , m_global_object(&global_object)
 {
 }
 
 Shape::Shape(Shape& previous_shape, const StringOrSymbol& property_name, PropertyAttributes attributes, TransitionType transition_type)
-    : m_attributes(attributes)
+    : m_id(s_next_shape_id++)
+    , m_attributes(attributes)
     , m_transition_type(transition_type)
     , m_global_object(previous_shape.m_global_object)
     , m_previous(&previous_shape)
@@ -89,7 +112,8 @@ Shape::Shape(Shape& previous_shape, const StringOrSymbol& property_name, Propert
 }
 
 Shape::Shape(Shape& previous_shape, Object* new_prototype)
-    : m_transition_type(TransitionType::Prototype)
+    : m_id(s_next_shape_id++)
+    , m_transition_type(TransitionType::Prototype)
     , m_global_object(previous_shape.m_global_object)
     , m_previous(&previous_shape)
     , m_prototype(new_prototype)
@@ -99,6 +123,20 @@ Shape::Shape(Shape& previous_shape, Object* new_prototype)
 
 Shape::~Shape()
 {
+    if (!m_prototype_transitions.is_empty())
+        heap().did_destroy_shape_with_prototype_transitions({}, *this);
+}
+
+void Shape::did_mutate_in_place()
+{
+    m_id = s_next_shape_id++;
+    write_barrier();
+}
+
+void Shape::set_prototype_without_transition(Object* new_prototype)
+{
+    m_prototype = new_prototype;
+    did_mutate_in_place();
 }
 
 void Shape::visit_edges(Cell::Visitor& visitor)
@@ -192,6 +230,7 @@ void Shape::add_property_to_unique_shape(const StringOrSymbol& property_name, Pr
     ASSERT(!m_property_table->contains(property_name));
     m_property_table->set(property_name, { m_property_table->size(), attributes });
     ++m_property_count;
+    did_mutate_in_place();
 }
 
 void Shape::reconfigure_property_in_unique_shape(const StringOrSymbol& property_name, PropertyAttributes attributes)
@@ -202,6 +241,7 @@ void Shape::reconfigure_property_in_unique_shape(const StringOrSymbol& property_
     ASSERT(it != m_property_table->end());
     it->value.attributes = attributes;
     m_property_table->set(property_name, it->value);
+    did_mutate_in_place();
 }
 
 void Shape::remove_property_from_unique_shape(const StringOrSymbol& property_name, size_t offset)
@@ -215,6 +255,7 @@ void Shape::remove_property_from_unique_shape(const StringOrSymbol& property_nam
         if (it.value.offset > offset)
             --it.value.offset;
     }
+    did_mutate_in_place();
 }
 
 void Shape::add_property_without_transition(const StringOrSymbol& property_name, PropertyAttributes attributes)
@@ -222,6 +263,7 @@ void Shape::add_property_without_transition(const StringOrSymbol& property_name,
     ensure_property_table();
     if (m_property_table->set(property_name, { m_property_count, attributes }) == AK::HashSetResult::InsertedNewEntry)
         ++m_property_count;
+    did_mutate_in_place();
 }
 
 }
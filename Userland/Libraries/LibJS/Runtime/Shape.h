@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <AK/Badge.h>
 #include <AK/HashMap.h>
 #include <AK/OwnPtr.h>
 #include <LibJS/Forward.h>
@@ -73,9 +74,18 @@ public:
     Shape* create_configure_transition(const StringOrSymbol&, PropertyAttributes attributes);
     Shape* create_prototype_transition(Object* new_prototype);
 
+    // Prototype transitions are a cache that doesn't keep its prototypes or target shapes alive.
+    // The heap calls this after marking to drop the entries that are about to be swept.
+    // Returns whether any prototype transitions are left.
+    bool remove_dead_prototype_transitions(Badge<Heap>);
+
     void add_property_without_transition(const StringOrSymbol&, PropertyAttributes);
 
     bool is_unique() const { return m_unique; }
+
+    // Never reused, and replaced whenever the shape is mutated in place.
+    // Property caches key on this rather than on the (recyclable) Shape pointer.
+    u64 id() const { return m_id; }
     Shape* create_unique_clone() const;
 
     GlobalObject* global_object() const;
@@ -94,7 +104,7 @@ public:
 
     Vector<Property> property_table_ordered() const;
 
-    void set_prototype_without_transition(Object* new_prototype) { m_prototype = new_prototype; }
+    void set_prototype_without_transition(Object* new_prototype);
 
     void remove_property_from_unique_shape(const StringOrSymbol&, size_t offset);
     void add_property_to_unique_shape(const StringOrSymbol&, PropertyAttributes attributes);
@@ -105,7 +115,9 @@ private:
     virtual void visit_edges(Visitor&) override;
 
     void ensure_property_table() const;
+    void did_mutate_in_place();
 
+    u64 m_id { 0 };
     PropertyAttributes m_attributes { 0 };
     TransitionType m_transition_type : 6 { TransitionType::Invalid };
     bool m_unique : 1 { false };
@@ -115,6 +127,7 @@ private:
     mutable OwnPtr<HashMap<StringOrSymbol, PropertyMetadata>> m_property_table;
 
     HashMap<TransitionKey, Shape*> m_forward_transitions;
+    HashMap<Object*, Shape*> m_prototype_transitions;
     Shape* m_previous { nullptr };
     StringOrSymbol m_property_name;
     Object* m_prototype { nullptr };
@@ -72,6 +72,11 @@ public:
     bool should_log_exceptions() const { return m_should_log_exceptions; }
     void set_should_log_exceptions(bool b) { m_should_log_exceptions = b; }
 
+    // When enabled, programs and function bodies are compiled to bytecode and run by Bytecode::Interpreter.
+    // Code the bytecode generator can't handle still runs in the AST interpreter.
+    bool bytecode_enabled() const { return m_bytecode_enabled; }
+    void set_bytecode_enabled(bool b) { m_bytecode_enabled = b; }
+
     Heap& heap() { return m_heap; }
     const Heap& heap() const { return m_heap; }
 
@@ -276,6 +281,7 @@ private:
     Shape* m_scope_object_shape { nullptr };
 
     bool m_should_log_exceptions { false };
+    bool m_bytecode_enabled { false };
 };
 
 template<>
@@ -9,6 +9,22 @@ describe("correct behavior", () => {
         expect(Object.setPrototypeOf(o, p)).toBe(o);
         expect(Object.getPrototypeOf(o)).toBe(p);
     });
+
+    test("prototypes survive garbage collection", () => {
+        const objects = [];
+        for (let i = 0; i < 10; ++i) {
+            const o = {};
+            Object.setPrototypeOf(o, { value: i });
+            objects.push(o);
+            Object.setPrototypeOf({}, { value: -1 });
+            gc();
+        }
+        for (let i = 0; i < 10; ++i) {
+            expect(objects[i].value).toBe(i);
+            Object.setPrototypeOf(objects[i], null);
+            expect(Object.getPrototypeOf(objects[i])).toBeNull();
+        }
+    });
 });
 
 describe("errors", () => {
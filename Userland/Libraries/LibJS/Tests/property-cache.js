@@ -0,0 +1,89 @@
+// These exercise the same member expression against objects whose shapes change
+// between executions, so that stale property cache entries would be observable.
+
+const getFoo = o => o.foo;
+const setFoo = (o, value) => {
+    o.foo = value;
+};
+
+test("own properties with different shapes", () => {
+    const objects = [{ foo: 1 }, { bar: 0, foo: 2 }, { baz: 0, bar: 0, foo: 3 }, { foo: 4, x: 0 }];
+    for (let i = 0; i < 3; ++i) {
+        objects.forEach((o, index) => expect(getFoo(o)).toBe(index + 1));
+    }
+    expect(getFoo({ a: 0, b: 0, c: 0, d: 0, foo: 5 })).toBe(5);
+    expect(getFoo({})).toBeUndefined();
+});
+
+test("deleting a property", () => {
+    const o = { bar: 1, foo: 2 };
+    expect(getFoo(o)).toBe(2);
+    expect(getFoo(o)).toBe(2);
+    delete o.bar;
+    expect(getFoo(o)).toBe(2);
+    delete o.foo;
+    expect(getFoo(o)).toBeUndefined();
+});
+
+test("prototype properties", () => {
+    const proto = { foo: "proto" };
+    const o = Object.setPrototypeOf({}, proto);
+    expect(getFoo(o)).toBe("proto");
+    expect(getFoo(o)).toBe("proto");
+    proto.foo = "changed";
+    expect(getFoo(o)).toBe("changed");
+    o.foo = "own";
+    expect(getFoo(o)).toBe("own");
+    delete o.foo;
+    expect(getFoo(o)).toBe("changed");
+    Object.setPrototypeOf(o, { foo: "other" });
+    expect(getFoo(o)).toBe("other");
+});
+
+test("accessors replacing data properties", () => {
+    const o = { foo: 1 };
+    expect(getFoo(o)).toBe(1);
+    Object.defineProperty(o, "foo", { get: () => 2, configurable: true });
+    expect(getFoo(o)).toBe(2);
+    expect(getFoo(o)).toBe(2);
+});
+
+test("writes to own properties", () => {
+    const o = { foo: 1 };
+    setFoo(o, 2);
+    setFoo(o, 3);
+    expect(o.foo).toBe(3);
+    Object.defineProperty(o, "foo", { writable: false });
+    setFoo(o, 4);
+    expect(o.foo).toBe(3);
+});
+
+test("own data property shadows a prototype setter", () => {
+    let setterCalls = 0;
+    const proto = {
+        set foo(value) {
+            ++setterCalls;
+        },
+    };
+    const o = Object.setPrototypeOf({}, proto);
+    Object.defineProperty(o, "foo", { value: 1, writable: true });
+    setFoo(o, 2);
+    setFoo(o, 3);
+    expect(o.foo).toBe(3);
+    expect(setterCalls).toBe(0);
+});
+
+test("proxies are never served from the cache", () => {
+    const target = { foo: 1 };
+    let trapCalls = 0;
+    const proxy = new Proxy(target, {
+        get(target, property) {
+            ++trapCalls;
+            return target[property] * 10;
+        },
+    });
+    expect(getFoo(target)).toBe(1);
+    expect(getFoo(proxy)).toBe(10);
+    expect(getFoo(proxy)).toBe(10);
+    expect(trapCalls).toBe(2);
+});
@@ -35,6 +35,7 @@
 #include <signal.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/internals.h>
 #include <sys/mman.h>
 #include <time.h>
 #include <unistd.h>
@@ -102,6 +103,7 @@ static int create_thread(pthread_t* thread, void* (*entry)(void*), void* argumen
 [[noreturn]] static void exit_thread(void* code)
 {
     KeyDestroyer::destroy_for_current_thread();
+    __malloc_flush_thread_cache();
     syscall(SC_exit_thread, code);
     ASSERT_NOT_REACHED();
 }
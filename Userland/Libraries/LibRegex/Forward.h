@@ -40,6 +40,8 @@ class OpCode_Exit;
 class OpCode_Jump;
 class OpCode_ForkJump;
 class OpCode_ForkStay;
+class OpCode_ForkReplaceJump;
+class OpCode_ForkReplaceStay;
 class OpCode_CheckBegin;
 class OpCode_CheckEnd;
 class OpCode_SaveLeftCaptureGroup;
@@ -30,6 +30,7 @@
 #include <AK/Debug.h>
 
 #include <ctype.h>
+#include <string.h>
 
 namespace regex {
 
@@ -136,6 +137,12 @@ ALWAYS_INLINE OpCode* ByteCode::get_opcode_by_id(OpCodeId id) const
             case OpCodeId::ForkStay:
                 s_opcodes.set(i, make<OpCode_ForkStay>(*const_cast<ByteCode*>(this)));
                 break;
+            case OpCodeId::ForkReplaceJump:
+                s_opcodes.set(i, make<OpCode_ForkReplaceJump>(*const_cast<ByteCode*>(this)));
+                break;
+            case OpCodeId::ForkReplaceStay:
+                s_opcodes.set(i, make<OpCode_ForkReplaceStay>(*const_cast<ByteCode*>(this)));
+                break;
             case OpCodeId::FailForks:
                 s_opcodes.set(i, make<OpCode_FailForks>(*const_cast<ByteCode*>(this)));
                 break;
@@ -247,6 +254,20 @@ ALWAYS_INLINE ExecutionResult OpCode_ForkStay::execute(const MatchInput&, MatchS
     return ExecutionResult::Fork_PrioLow;
 }
 
+ALWAYS_INLINE ExecutionResult OpCode_ForkReplaceJump::execute(const MatchInput& input, MatchState& state, MatchOutput&) const
+{
+    state.fork_at_position = state.instruction_position + size() + offset();
+    input.fork_to_replace = state.instruction_position;
+    return ExecutionResult::Fork_PrioHigh;
+}
+
+ALWAYS_INLINE ExecutionResult OpCode_ForkReplaceStay::execute(const MatchInput& input, MatchState& state, MatchOutput&) const
+{
+    state.fork_at_position = state.instruction_position + size() + offset();
+    input.fork_to_replace = state.instruction_position;
+    return ExecutionResult::Fork_PrioLow;
+}
+
 ALWAYS_INLINE ExecutionResult OpCode_CheckBegin::execute(const MatchInput& input, MatchState& state, MatchOutput&) const
 {
     if (0 == state.string_position && (input.regex_options & AllFlags::MatchNotBeginOfLine))
@@ -446,15 +467,14 @@ ALWAYS_INLINE ExecutionResult OpCode_Compare::execute(const MatchInput& input, M
             ASSERT(!current_inversion_state());
 
             const auto& length = m_bytecode->at(offset++);
-            StringBuilder str_builder;
-            for (size_t i = 0; i < length; ++i)
-                str_builder.append(m_bytecode->at(offset++));
+            auto* str = &m_bytecode->at(offset);
+            offset += length;
 
             // We want to compare a string that is definitely longer than the available string
             if (input.view.length() - state.string_position < length)
                 return ExecutionResult::Failed_ExecuteLowPrioForks;
 
-            if (!compare_string(input, state, str_builder.string_view().characters_without_null_termination(), length))
+            if (!compare_string(input, state, str, length))
                 return ExecutionResult::Failed_ExecuteLowPrioForks;
 
         } else if (compare_type == CharacterCompareType::CharClass) {
@@ -542,24 +562,50 @@ ALWAYS_INLINE void OpCode_Compare::compare_char(const MatchInput& input, MatchSt
     }
 }
 
+ALWAYS_INLINE static char to_ascii_lowercase(char ch)
+{
+    if (ch >= 'A' && ch <= 'Z')
+        return ch | 0x20;
+    return ch;
+}
+
 ALWAYS_INLINE bool OpCode_Compare::compare_string(const MatchInput& input, MatchState& state, const char* str, size_t length)
 {
     if (input.view.is_u8_view()) {
-        auto str_view1 = StringView(str, length);
-        auto str_view2 = StringView(&input.view.u8view()[state.string_position], length);
+        auto* characters = input.view.u8view().characters_without_null_termination() + state.string_position;
 
-        String str1, str2;
         if (input.regex_options & AllFlags::Insensitive) {
-            str1 = str_view1.to_string().to_lowercase();
-            str2 = str_view2.to_string().to_lowercase();
-            str_view1 = str1.view();
-            str_view2 = str2.view();
+            for (size_t i = 0; i < length; ++i) {
+                if (to_ascii_lowercase(str[i]) != to_ascii_lowercase(characters[i]))
+                    return false;
+            }
+        } else if (length && memcmp(str, characters, length) != 0) {
+            return false;
         }
 
-        if (str_view1 == str_view2) {
-            state.string_position += length;
-            return true;
+        state.string_position += length;
+        return true;
+    }
+
+    return false;
+}
+
+// String arguments are stored one character per bytecode value.
+ALWAYS_INLINE bool OpCode_Compare::compare_string(const MatchInput& input, MatchState& state, const ByteCodeValueType* str, size_t length)
+{
+    if (input.view.is_u8_view()) {
+        auto* characters = input.view.u8view().characters_without_null_termination() + state.string_position;
+        bool insensitive = input.regex_options & AllFlags::Insensitive;
+
+        for (size_t i = 0; i < length; ++i) {
+            auto ch1 = (char)str[i];
+            auto ch2 = characters[i];
+            if (insensitive ? to_ascii_lowercase(ch1) != to_ascii_lowercase(ch2) : ch1 != ch2)
+                return false;
         }
+
+        state.string_position += length;
+        return true;
     }
 
     return false;
@@ -271,12 +271,17 @@ struct MatchInput {
 
     mutable size_t fail_counter { 0 };
     mutable Vector<size_t> saved_positions;
+
+    // Set by the possessive fork opcodes to the position of the fork, see ForkReplaceJump and ForkReplaceStay.
+    mutable Optional<size_t> fork_to_replace;
 };
 
 struct MatchState {
     size_t string_position { 0 };
     size_t instruction_position { 0 };
     size_t fork_at_position { 0 };
+    // The possessive fork this state was pushed by, if any. A newer state from the same fork replaces it.
+    Optional<size_t> initiating_fork;
 };
 
 struct MatchOutput {
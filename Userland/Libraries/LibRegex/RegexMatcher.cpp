@@ -27,7 +27,9 @@
 #include "RegexMatcher.h"
 #include "RegexDebug.h"
 #include "RegexParser.h"
+#include "RegexPikeVM.h"
 #include <AK/Debug.h>
+#include <AK/MemMem.h>
 #include <AK/ScopedValueRollback.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
@@ -146,6 +148,18 @@ RegexResult Matcher<Parser>::match(const Vector<RegexStringView> views, Optional
     if (input.regex_options.has_flag_set(AllFlags::Internal_Stateful))
         continue_search = false;
 
+    // Whether a failed match moves on to try the next position.
+    bool is_unanchored = continue_search || input.regex_options.has_flag_set(AllFlags::Internal_Stateful);
+
+    auto& optimization = m_pattern.parser_result.optimization;
+    // The PikeVM only holds the scratch state of this call, so concurrent matches against the same pattern don't share any.
+    Optional<PikeVM> pike_vm;
+    if (optimization.can_use_pike_vm)
+        pike_vm.emplace(m_pattern.parser_result.bytecode, optimization);
+
+    auto& literal_prefix = optimization.literal_prefix;
+    bool can_skip_to_literal_prefix = is_unanchored && !literal_prefix.is_empty() && !input.regex_options.has_flag_set(AllFlags::Insensitive);
+
     for (auto& view : views) {
         input.view = view;
         dbgln<REGEX_DEBUG>("[match] Starting match with view ({}): _{}_", view.length(), view);
@@ -197,7 +211,35 @@ RegexResult Matcher<Parser>::match(const Vector<RegexStringView> views, Optional
             state.string_position = view_index;
             state.instruction_position = 0;
 
-            auto success = execute(input, state, output, 0);
+            Optional<bool> success;
+            if (pike_vm.has_value()) {
+                // The PikeVM looks at all the remaining start positions at once, and tells us where the match starts.
+                auto match_start = pike_vm->match(input, state, output, !is_unanchored, match_length_minimum);
+                if (!match_start.has_value() && is_unanchored)
+                    break;
+                if (match_start.has_value())
+                    view_index = match_start.value();
+                success = match_start.has_value();
+            } else {
+                if (can_skip_to_literal_prefix && view.is_u8_view()) {
+                    // A match can only start where the literal prefix does, so skip right to it.
+                    auto* characters = view.u8view().characters_without_null_termination();
+                    auto offset = AK::memmem_optional(characters + view_index, view_length - view_index, literal_prefix.characters(), literal_prefix.length());
+                    if (!offset.has_value()) {
+                        state.string_position = 0;
+                        break;
+                    }
+                    if (offset.value()) {
+                        view_index += offset.value();
+                        state.string_position = 0;
+                        if (match_length_minimum && match_length_minimum > view_length - view_index)
+                            break;
+                        state.string_position = view_index;
+                    }
+                }
+                success = execute(input, state, output, 0);
+            }
+
             if (!success.has_value())
                 return { false, 0, {}, {}, {}, output.operations };
 
@@ -334,9 +376,25 @@ Optional<bool> Matcher<Parser>::execute(const MatchInput& input, MatchState& sta
 
         switch (result) {
         case ExecutionResult::Fork_PrioLow:
-            fork_low_prio_states.prepend(state);
+            if (input.fork_to_replace.has_value()) {
+                state.initiating_fork = input.fork_to_replace.release_value();
+                push_low_prio_state(fork_low_prio_states, state);
+            } else {
+                state.initiating_fork = {};
+                fork_low_prio_states.append(state);
+            }
             continue;
         case ExecutionResult::Fork_PrioHigh:
+            if (input.fork_to_replace.has_value()) {
+                // A possessive loop: instead of recursing, leave the way out of the loop behind as the most recent
+                // low priority fork (replacing the one left by the previous iteration), and go around the loop again.
+                auto exit_state = state;
+                exit_state.fork_at_position = state.instruction_position;
+                exit_state.initiating_fork = input.fork_to_replace.release_value();
+                push_low_prio_state(fork_low_prio_states, exit_state);
+                state.instruction_position = state.fork_at_position;
+                continue;
+            }
             fork_high_prio_state = state;
             fork_high_prio_state.instruction_position = fork_high_prio_state.fork_at_position;
             success = execute(input, fork_high_prio_state, output, ++recursion_level);
@@ -363,10 +421,23 @@ Optional<bool> Matcher<Parser>::execute(const MatchInput& input, MatchState& sta
     ASSERT_NOT_REACHED();
 }
 
+// The states pushed by a possessive fork only ever replace the one pushed by the same fork
+// right before, as nothing else runs in between two iterations of such a loop.
+template<class Parser>
+ALWAYS_INLINE void Matcher<Parser>::push_low_prio_state(Vector<MatchState>& states, const MatchState& state) const
+{
+    if (!states.is_empty() && states.last().initiating_fork == state.initiating_fork)
+        states.last() = state;
+    else
+        states.append(state);
+}
+
 template<class Parser>
-ALWAYS_INLINE Optional<bool> Matcher<Parser>::execute_low_prio_forks(const MatchInput& input, MatchState& original_state, MatchOutput& output, Vector<MatchState> states, size_t recursion_level) const
+ALWAYS_INLINE Optional<bool> Matcher<Parser>::execute_low_prio_forks(const MatchInput& input, MatchState& original_state, MatchOutput& output, Vector<MatchState>& states, size_t recursion_level) const
 {
-    for (auto& state : states) {
+    // The most recently pushed state has the highest priority.
+    for (size_t i = states.size(); i > 0; --i) {
+        auto& state = states[i - 1];
 
         state.instruction_position = state.fork_at_position;
 #if REGEX_DEBUG
@@ -81,7 +81,8 @@ public:
 
 private:
     Optional<bool> execute(const MatchInput& input, MatchState& state, MatchOutput& output, size_t recursion_level) const;
-    ALWAYS_INLINE Optional<bool> execute_low_prio_forks(const MatchInput& input, MatchState& original_state, MatchOutput& output, Vector<MatchState> states, size_t recursion_level) const;
+    ALWAYS_INLINE void push_low_prio_state(Vector<MatchState>& states, const MatchState& state) const;
+    ALWAYS_INLINE Optional<bool> execute_low_prio_forks(const MatchInput& input, MatchState& original_state, MatchOutput& output, Vector<MatchState>& states, size_t recursion_level) const;
 
     const Regex<Parser>& m_pattern;
     const typename ParserTraits<Parser>::OptionsType m_regex_options;
@@ -0,0 +1,512 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "RegexOptimizer.h"
+#include <AK/StringBuilder.h>
+
+#include <ctype.h>
+
+namespace regex {
+
+bool CharacterSet::intersects(const CharacterSet& other) const
+{
+    if (m_may_match_non_ascii && other.m_may_match_non_ascii)
+        return true;
+
+    for (size_t i = 0; i < size / 64; ++i) {
+        if ((m_bits[0][i] | m_bits[1][i]) & (other.m_bits[0][i] | other.m_bits[1][i]))
+            return true;
+    }
+    return false;
+}
+
+void CharacterSet::set_range(u32 from, u32 to, bool insensitive)
+{
+    to = min(to, size - 1);
+    if (from > to)
+        return;
+    for (size_t i = 0; i < size / 64; ++i) {
+        u32 word_start = i * 64;
+        u32 word_end = word_start + 63;
+        if (from > word_end || to < word_start)
+            continue;
+        u32 low = max(from, word_start) - word_start;
+        u32 high = min(to, word_end) - word_start;
+        u64 mask = (high == 63 ? ~0ull : (1ull << (high + 1)) - 1) & ~((1ull << low) - 1);
+        m_bits[insensitive][i] |= mask;
+    }
+}
+
+void CharacterSet::set_lowercased_range(u32 from, u32 to)
+{
+    // All the ASCII letters live in the second word, 32 bits apart.
+    constexpr u64 uppercase_letters = ((1ull << 26) - 1) << ('A' - 64);
+    constexpr u64 lowercase_letters = uppercase_letters << ('a' - 'A');
+
+    CharacterSet range;
+    range.set_range(from, to, true);
+    auto& letters = range.m_bits[true][1];
+    letters = (letters & ~uppercase_letters) | ((letters & lowercase_letters) >> ('a' - 'A'));
+    merge(range);
+}
+
+void CharacterSet::set_all()
+{
+    for (auto& bits : m_bits) {
+        for (auto& word : bits)
+            word = ~0ull;
+    }
+    m_may_match_non_ascii = true;
+}
+
+void CharacterSet::merge(const CharacterSet& other)
+{
+    for (size_t mode = 0; mode < 2; ++mode) {
+        for (size_t i = 0; i < size / 64; ++i)
+            m_bits[mode][i] |= other.m_bits[mode][i];
+    }
+    m_may_match_non_ascii |= other.m_may_match_non_ascii;
+}
+
+static u32 to_ascii_lowercase(u32 ch)
+{
+    if (ch >= 'A' && ch <= 'Z')
+        return ch | 0x20;
+    return ch;
+}
+
+// Mirrors OpCode_Compare::compare_character_class().
+static bool character_class_contains(CharClass character_class, u32 ch, bool insensitive)
+{
+    switch (character_class) {
+    case CharClass::Alnum:
+        return isalnum(ch);
+    case CharClass::Alpha:
+        return isalpha(ch);
+    case CharClass::Blank:
+        return ch == ' ' || ch == '\t';
+    case CharClass::Cntrl:
+        return iscntrl(ch);
+    case CharClass::Digit:
+        return isdigit(ch);
+    case CharClass::Graph:
+        return isgraph(ch);
+    case CharClass::Lower:
+        return islower(ch) || (insensitive && isupper(ch));
+    case CharClass::Print:
+        return isprint(ch);
+    case CharClass::Punct:
+        return ispunct(ch);
+    case CharClass::Space:
+        return isspace(ch);
+    case CharClass::Upper:
+        return isupper(ch) || (insensitive && islower(ch));
+    case CharClass::Word:
+        return isalnum(ch) || ch == '_';
+    case CharClass::Xdigit:
+        return isxdigit(ch);
+    }
+    ASSERT_NOT_REACHED();
+}
+
+static const CharacterSet& character_class_set(CharClass character_class)
+{
+    static constexpr size_t class_count = (size_t)CharClass::Xdigit + 1;
+    static CharacterSet sets[class_count];
+    static bool initialized = false;
+    if (!initialized) {
+        for (size_t i = 0; i < class_count; ++i) {
+            for (u32 ch = 0; ch < CharacterSet::size; ++ch) {
+                if (character_class_contains((CharClass)i, ch, false))
+                    sets[i].set(ch, false);
+                if (character_class_contains((CharClass)i, ch, true))
+                    sets[i].set(ch, true);
+            }
+        }
+        initialized = true;
+    }
+    return sets[(size_t)character_class];
+}
+
+Optional<CharacterSet> CharacterSet::from_compare(const ByteCode& bytecode, size_t instruction_position)
+{
+    CharacterSet character_set;
+    bool inverse = false;
+
+    auto arguments_count = bytecode[instruction_position + 1];
+    size_t offset = instruction_position + 3;
+    for (size_t i = 0; i < arguments_count; ++i) {
+        auto compare_type = (CharacterCompareType)bytecode[offset++];
+        switch (compare_type) {
+        case CharacterCompareType::Inverse:
+            // A leading inversion (as in "[^...]") negates the whole compare, anything else is left to the opcode.
+            if (i != 0)
+                return {};
+            inverse = true;
+            break;
+        case CharacterCompareType::TemporaryInverse:
+            return {};
+        case CharacterCompareType::AnyChar:
+            character_set.set_all();
+            break;
+        case CharacterCompareType::Char: {
+            u32 value = bytecode[offset++];
+            if (value >= CharacterSet::size) {
+                character_set.set_may_match_non_ascii();
+                break;
+            }
+            character_set.set(value, false);
+            character_set.set(value, true);
+            if (to_ascii_lowercase(value) >= 'a' && to_ascii_lowercase(value) <= 'z') {
+                character_set.set(value | 0x20, true);
+                character_set.set(value & ~0x20, true);
+            }
+            break;
+        }
+        case CharacterCompareType::CharRange: {
+            auto range = CharRange(bytecode[offset++]);
+            if (range.to >= CharacterSet::size)
+                character_set.set_may_match_non_ascii();
+            character_set.set_range(range.from, range.to, false);
+            // Case-insensitively, the opcode compares the lowercased character against the lowercased bounds.
+            character_set.set_lowercased_range(to_ascii_lowercase(range.from), to_ascii_lowercase(range.to));
+            break;
+        }
+        case CharacterCompareType::CharClass: {
+            auto character_class = (CharClass)bytecode[offset++];
+            // An inverted alpha class can consume two characters, leave that to the opcode.
+            if (inverse && character_class == CharClass::Alpha)
+                return {};
+            character_set.merge(character_class_set(character_class));
+            break;
+        }
+        case CharacterCompareType::String:
+        case CharacterCompareType::Reference:
+        case CharacterCompareType::NamedReference:
+            // These may consume more than one character.
+            return {};
+        default:
+            ASSERT_NOT_REACHED();
+        }
+    }
+
+    if (inverse)
+        character_set.invert();
+
+    return character_set;
+}
+
+static bool has_backreference(const ByteCode& bytecode, size_t instruction_position)
+{
+    auto arguments_count = bytecode[instruction_position + 1];
+    size_t offset = instruction_position + 3;
+    for (size_t i = 0; i < arguments_count; ++i) {
+        switch ((CharacterCompareType)bytecode[offset++]) {
+        case CharacterCompareType::Reference:
+        case CharacterCompareType::NamedReference:
+            return true;
+        case CharacterCompareType::Inverse:
+        case CharacterCompareType::TemporaryInverse:
+        case CharacterCompareType::AnyChar:
+            break;
+        case CharacterCompareType::String:
+            offset += bytecode[offset] + 1;
+            break;
+        default:
+            ++offset;
+            break;
+        }
+    }
+    return false;
+}
+
+OptimizationInfo Optimizer::optimize(ByteCode& bytecode)
+{
+    OptimizationInfo info;
+    info.can_use_pike_vm = true;
+
+    bool has_lookarounds = false;
+    HashMap<StringView, size_t> named_capture_groups_by_name;
+
+    // The PikeVM keeps the captures of every group separately, so each right paren has to close the
+    // group that the innermost open left paren started.
+    struct OpenGroup {
+        bool is_named { false };
+        size_t id { 0 };
+    };
+    Vector<OpenGroup> open_groups;
+    auto close_group = [&](bool is_named, size_t id) {
+        if (open_groups.is_empty() || open_groups.last().is_named != is_named || open_groups.last().id != id) {
+            info.can_use_pike_vm = false;
+            return;
+        }
+        open_groups.take_last();
+    };
+
+    // Where a possessive loop could start or end.
+    Vector<size_t> forks;
+
+    MatchState state;
+    while (state.instruction_position < bytecode.size()) {
+        auto* opcode = bytecode.get_opcode(state);
+        ASSERT(opcode);
+        auto instruction_position = state.instruction_position;
+
+        switch (opcode->opcode_id()) {
+        case OpCodeId::Compare:
+            if (has_backreference(bytecode, instruction_position))
+                info.can_use_pike_vm = false;
+            break;
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkJump:
+            forks.append(instruction_position);
+            break;
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+        case OpCodeId::FailForks:
+            has_lookarounds = true;
+            info.can_use_pike_vm = false;
+            break;
+        case OpCodeId::Exit:
+            info.can_use_pike_vm = false;
+            break;
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup: {
+            auto id = bytecode[instruction_position + 1];
+            if (id >= info.capture_groups.size())
+                info.capture_groups.resize(id + 1);
+
+            auto& group = info.capture_groups[id];
+            if (!group.has_value())
+                group = OptimizationInfo::CaptureGroup {};
+            if (opcode->opcode_id() == OpCodeId::SaveLeftCaptureGroup) {
+                group.value().left_instruction_position = instruction_position;
+                open_groups.append({ false, id });
+            } else {
+                group.value().right_instruction_position = instruction_position;
+                close_group(false, id);
+            }
+            break;
+        }
+        case OpCodeId::SaveLeftNamedCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup: {
+            StringView name { reinterpret_cast<const char*>(bytecode[instruction_position + 1]), (size_t)bytecode[instruction_position + 2] };
+            auto index = named_capture_groups_by_name.get(name);
+            if (!index.has_value()) {
+                index = info.named_capture_groups.size();
+                info.named_capture_groups.empend();
+                named_capture_groups_by_name.set(name, index.value());
+            }
+
+            auto& group = info.named_capture_groups[index.value()];
+            if (opcode->opcode_id() == OpCodeId::SaveLeftNamedCaptureGroup) {
+                group.left_instruction_position = instruction_position;
+                open_groups.append({ true, index.value() });
+            } else {
+                group.right_instruction_position = instruction_position;
+                close_group(true, index.value());
+            }
+            info.named_capture_group_indices.set(instruction_position, index.value());
+            break;
+        }
+        default:
+            break;
+        }
+
+        state.instruction_position = instruction_position + opcode->size();
+    }
+
+    if (!open_groups.is_empty())
+        info.can_use_pike_vm = false;
+
+    // Possessive loops drop backtracking states, which would throw off the fork counting
+    // that negative lookarounds rely on (see OpCode_FailForks).
+    if (!has_lookarounds)
+        rewrite_possessive_loops(bytecode, forks);
+
+    info.literal_prefix = find_literal_prefix(bytecode);
+    if (info.can_use_pike_vm)
+        build_character_sets(bytecode, info);
+    return info;
+}
+
+void Optimizer::build_character_sets(const ByteCode& bytecode, OptimizationInfo& info)
+{
+    info.character_set_indices.ensure_capacity(bytecode.size());
+    for (size_t i = 0; i < bytecode.size(); ++i)
+        info.character_set_indices.unchecked_append(0);
+
+    MatchState state;
+    while (state.instruction_position < bytecode.size()) {
+        auto* opcode = bytecode.get_opcode(state);
+        ASSERT(opcode);
+        if (opcode->opcode_id() == OpCodeId::Compare) {
+            auto character_set = CharacterSet::from_compare(bytecode, state.instruction_position);
+            if (character_set.has_value()) {
+                info.character_sets.append(character_set.value());
+                info.character_set_indices[state.instruction_position] = info.character_sets.size();
+            }
+        }
+        state.instruction_position += opcode->size();
+    }
+}
+
+void Optimizer::rewrite_possessive_loops(ByteCode& bytecode, const Vector<size_t>& forks)
+{
+    auto compare_size = [&](size_t instruction_position) -> size_t {
+        if (instruction_position >= bytecode.size() || bytecode[instruction_position] != (ByteCodeValueType)OpCodeId::Compare)
+            return 0;
+        return bytecode[instruction_position + 2] + 3;
+    };
+
+    for (auto instruction_position : forks) {
+        auto id = (OpCodeId)bytecode[instruction_position];
+        if (id == OpCodeId::ForkStay) {
+            // A greedy star over a single character:
+            // LABEL _START
+            // FORKSTAY _END
+            // COMPARE
+            // JUMP _START
+            // LABEL _END
+            auto offset = (ssize_t)bytecode[instruction_position + 1];
+            auto body = instruction_position + 2;
+            auto body_size = compare_size(body);
+            if (offset <= 0 || !body_size || (size_t)offset != body_size + 2)
+                continue;
+
+            auto jump = body + body_size;
+            if (bytecode[jump] != (ByteCodeValueType)OpCodeId::Jump || jump + 2 + (ssize_t)bytecode[jump + 1] != instruction_position)
+                continue;
+
+            auto body_set = CharacterSet::from_compare(bytecode, body);
+            if (body_set.has_value() && is_followed_by_disjoint_compare(bytecode, body_set.value(), jump + 2))
+                bytecode[instruction_position] = (ByteCodeValueType)OpCodeId::ForkReplaceStay;
+
+        } else if (id == OpCodeId::ForkJump) {
+            // A greedy plus over a single character:
+            // LABEL _START
+            // COMPARE
+            // FORKJUMP _START
+            auto offset = (ssize_t)bytecode[instruction_position + 1];
+            if (offset >= 0)
+                continue;
+
+            auto body = instruction_position + 2 + offset;
+            auto body_size = compare_size(body);
+            if (!body_size || body + body_size != instruction_position)
+                continue;
+
+            auto body_set = CharacterSet::from_compare(bytecode, body);
+            if (body_set.has_value() && is_followed_by_disjoint_compare(bytecode, body_set.value(), instruction_position + 2))
+                bytecode[instruction_position] = (ByteCodeValueType)OpCodeId::ForkReplaceJump;
+        }
+    }
+}
+
+// Whatever comes after the loop has to reject every character the loop accepts, so that ending
+// the loop any earlier can never lead to a match.
+bool Optimizer::is_followed_by_disjoint_compare(const ByteCode& bytecode, const CharacterSet& loop_set, size_t instruction_position)
+{
+    while (instruction_position < bytecode.size()) {
+        auto id = (OpCodeId)bytecode[instruction_position];
+        if (id == OpCodeId::SaveLeftCaptureGroup || id == OpCodeId::SaveRightCaptureGroup)
+            instruction_position += 2;
+        else if (id == OpCodeId::SaveLeftNamedCaptureGroup || id == OpCodeId::SaveRightNamedCaptureGroup)
+            instruction_position += 3;
+        else
+            break;
+    }
+
+    // Nothing left to match, so the longest run is always the one that matches.
+    if (instruction_position >= bytecode.size())
+        return true;
+
+    if (bytecode[instruction_position] != (ByteCodeValueType)OpCodeId::Compare)
+        return false;
+
+    if (auto follow_set = CharacterSet::from_compare(bytecode, instruction_position); follow_set.has_value())
+        return !loop_set.intersects(follow_set.value());
+
+    if (bytecode[instruction_position + 1] != 1 || bytecode[instruction_position + 3] != (ByteCodeValueType)CharacterCompareType::String)
+        return false;
+
+    auto length = bytecode[instruction_position + 4];
+    if (!length)
+        return false;
+
+    CharacterSet follow_set;
+    auto ch = (u8)bytecode[instruction_position + 5];
+    if (ch < CharacterSet::size) {
+        follow_set.set(ch, false);
+        follow_set.set(tolower(ch), true);
+        follow_set.set(toupper(ch), true);
+    } else {
+        follow_set.set_may_match_non_ascii();
+    }
+    return !loop_set.intersects(follow_set);
+}
+
+// The characters that every match has to start with: the leading Char and String compares.
+String Optimizer::find_literal_prefix(const ByteCode& bytecode)
+{
+    StringBuilder builder;
+
+    size_t instruction_position = 0;
+    while (instruction_position < bytecode.size()) {
+        auto id = (OpCodeId)bytecode[instruction_position];
+        if (id == OpCodeId::SaveLeftCaptureGroup || id == OpCodeId::SaveRightCaptureGroup) {
+            instruction_position += 2;
+            continue;
+        }
+        if (id == OpCodeId::SaveLeftNamedCaptureGroup || id == OpCodeId::SaveRightNamedCaptureGroup) {
+            instruction_position += 3;
+            continue;
+        }
+        if (id != OpCodeId::Compare || bytecode[instruction_position + 1] != 1)
+            break;
+
+        auto compare_type = (CharacterCompareType)bytecode[instruction_position + 3];
+        if (compare_type == CharacterCompareType::Char) {
+            auto ch = bytecode[instruction_position + 4];
+            if (ch >= CharacterSet::size)
+                break;
+            builder.append((char)ch);
+        } else if (compare_type == CharacterCompareType::String) {
+            auto length = bytecode[instruction_position + 4];
+            for (size_t i = 0; i < length; ++i)
+                builder.append((char)bytecode[instruction_position + 5 + i]);
+        } else {
+            break;
+        }
+
+        instruction_position += bytecode[instruction_position + 2] + 3;
+    }
+
+    return builder.to_string();
+}
+
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "RegexByteCode.h"
+
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+
+namespace regex {
+
+// The ASCII characters a single-character Compare accepts, both when matching case-sensitively
+// and case-insensitively. Anything outside of ASCII still has to go through OpCode_Compare.
+// These are only built for the compares that need one: the possessive loop check and the PikeVM.
+class CharacterSet {
+public:
+    static constexpr u32 size = 128;
+
+    ALWAYS_INLINE bool contains(u32 ch, bool insensitive) const
+    {
+        ASSERT(ch < size);
+        return m_bits[insensitive][ch / 64] & (1ull << (ch % 64));
+    }
+
+    void set(u32 ch, bool insensitive)
+    {
+        ASSERT(ch < size);
+        m_bits[insensitive][ch / 64] |= 1ull << (ch % 64);
+    }
+
+    void clear(u32 ch, bool insensitive)
+    {
+        ASSERT(ch < size);
+        m_bits[insensitive][ch / 64] &= ~(1ull << (ch % 64));
+    }
+
+    // Adds the characters from..to (inclusive), clamped to ASCII.
+    void set_range(u32 from, u32 to, bool insensitive);
+    // Adds the characters whose lowercase is in from..to to the case-insensitive set.
+    void set_lowercased_range(u32 from, u32 to);
+    void set_all();
+    void merge(const CharacterSet&);
+
+    // Anything outside of ASCII may match an inverted set.
+    void invert()
+    {
+        for (auto& bits : m_bits) {
+            for (auto& word : bits)
+                word = ~word;
+        }
+        m_may_match_non_ascii = true;
+    }
+
+    bool may_match_non_ascii() const { return m_may_match_non_ascii; }
+    void set_may_match_non_ascii() { m_may_match_non_ascii = true; }
+
+    // Whether some character could be accepted by both sets, in either mode.
+    bool intersects(const CharacterSet&) const;
+
+    // The characters accepted by the Compare at instruction_position, or nothing if it may consume
+    // more than one character or needs the opcode to decide.
+    static Optional<CharacterSet> from_compare(const ByteCode&, size_t instruction_position);
+
+private:
+    u64 m_bits[2][size / 64] {};
+    bool m_may_match_non_ascii { false };
+};
+
+struct OptimizationInfo {
+    // The pattern has no backreferences or lookarounds, so it can be matched by the PikeVM.
+    bool can_use_pike_vm { false };
+
+    // Every match starts with this string, unless matching case-insensitively.
+    String literal_prefix;
+
+    struct CaptureGroup {
+        size_t left_instruction_position { 0 };
+        size_t right_instruction_position { 0 };
+    };
+    // Where the numbered groups are saved, indexed by group id, and where the named groups are saved.
+    // The PikeVM replays these instructions to produce the capture group results of a match.
+    Vector<Optional<CaptureGroup>> capture_groups;
+    Vector<CaptureGroup> named_capture_groups;
+    // Maps the instruction positions saving a named group to its index in named_capture_groups.
+    HashMap<size_t, size_t> named_capture_group_indices;
+
+    // The sets of the compares that the PikeVM can check with a lookup, if it can run the pattern.
+    const CharacterSet* character_set_at(size_t instruction_position) const
+    {
+        auto index = character_set_indices[instruction_position];
+        if (!index)
+            return nullptr;
+        return &character_sets[index - 1];
+    }
+
+    // Indexed by instruction position, zero means the compare has no set, anything else is one plus its index.
+    Vector<u32> character_set_indices;
+    Vector<CharacterSet> character_sets;
+};
+
+class Optimizer {
+public:
+    // Analyzes the bytecode for the matchers, and rewrites the loops that can never give back
+    // what they consumed to use the possessive ForkReplace* opcodes.
+    static OptimizationInfo optimize(ByteCode&);
+
+private:
+    static void rewrite_possessive_loops(ByteCode&, const Vector<size_t>& forks);
+    static bool is_followed_by_disjoint_compare(const ByteCode&, const CharacterSet&, size_t instruction_position);
+    static String find_literal_prefix(const ByteCode&);
+    static void build_character_sets(const ByteCode&, OptimizationInfo&);
+};
+
+}
@@ -144,13 +144,19 @@ Parser::Result Parser::parse(Optional<AllOptions> regex_options)
 #if REGEX_DEBUG
     fprintf(stderr, "[PARSER] Produced bytecode with %lu entries (opcodes + arguments)\n", m_parser_state.bytecode.size());
 #endif
+
+    OptimizationInfo optimization;
+    if (!has_error())
+        optimization = Optimizer::optimize(m_parser_state.bytecode);
+
     return {
         move(m_parser_state.bytecode),
         move(m_parser_state.capture_groups_count),
         move(m_parser_state.named_capture_groups_count),
         move(m_parser_state.match_length_minimum),
         move(m_parser_state.error),
-        move(m_parser_state.error_token)
+        move(m_parser_state.error_token),
+        move(optimization)
     };
 }
 
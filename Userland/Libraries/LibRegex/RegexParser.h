@@ -29,6 +29,7 @@
 #include "RegexByteCode.h"
 #include "RegexError.h"
 #include "RegexLexer.h"
+#include "RegexOptimizer.h"
 #include "RegexOptions.h"
 
 #include <AK/Forward.h>
@@ -67,6 +68,7 @@ public:
         size_t match_length_minimum;
         Error error;
         Token error_token;
+        OptimizationInfo optimization;
     };
 
     explicit Parser(Lexer& lexer)
@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "RegexPikeVM.h"
+#include <AK/MemMem.h>
+
+namespace regex {
+
+PikeVM::PikeVM(const ByteCode& bytecode, const OptimizationInfo& info)
+    : m_bytecode(bytecode)
+    , m_info(info)
+    , m_capture_slot_count((info.capture_groups.size() + info.named_capture_groups.size()) * 3)
+{
+    m_captures.resize(m_capture_slot_count);
+    m_visited.ensure_capacity(bytecode.size() + 1);
+    for (size_t i = 0; i <= bytecode.size(); ++i)
+        m_visited.unchecked_append(0);
+}
+
+Optional<size_t> PikeVM::match(const MatchInput& input, MatchState& state, MatchOutput& output, bool anchored, size_t match_length_minimum)
+{
+    m_input = &input;
+    m_output = &output;
+    m_matched = false;
+
+    auto length = input.view.length();
+    auto start_position = state.string_position;
+
+    auto can_start_at = [&](size_t string_position) {
+        if (m_matched || string_position >= length || (anchored && string_position != start_position))
+            return false;
+        return !match_length_minimum || match_length_minimum <= length - string_position;
+    };
+
+    auto& prefix = m_info.literal_prefix;
+    bool can_skip_to_prefix = !anchored && !prefix.is_empty() && input.view.is_u8_view() && !(input.regex_options & AllFlags::Insensitive);
+
+    m_current.clear();
+    m_current.generation = ++m_generation;
+
+    for (size_t string_position = start_position;; ++string_position) {
+        if (m_current.threads.is_empty()) {
+            if (!can_start_at(string_position))
+                break;
+
+            // No match can start before the next occurrence of the prefix.
+            if (can_skip_to_prefix) {
+                auto* characters = input.view.u8view().characters_without_null_termination();
+                auto offset = AK::memmem_optional(characters + string_position, length - string_position, prefix.characters(), prefix.length());
+                if (!offset.has_value())
+                    break;
+                if (offset.value()) {
+                    string_position += offset.value();
+                    m_current.generation = ++m_generation;
+                    if (!can_start_at(string_position))
+                        break;
+                }
+            }
+        }
+
+        if (can_start_at(string_position)) {
+            for (auto& slot : m_captures)
+                slot = no_position;
+            add_thread(m_current, 0, string_position, string_position);
+        }
+
+        if (m_current.threads.is_empty()) {
+            m_current.generation = ++m_generation;
+            continue;
+        }
+
+        step(string_position);
+        swap(m_current, m_next);
+
+        if (string_position >= length)
+            break;
+    }
+
+    if (!m_matched) {
+        state.string_position = 0;
+        return {};
+    }
+
+    for (size_t id = 0; id < m_info.capture_groups.size(); ++id) {
+        auto& group = m_info.capture_groups[id];
+        if (!group.has_value() || m_match_captures[id * 3 + 2] == no_position)
+            continue;
+        replay_capture(group.value().left_instruction_position, m_match_captures[id * 3 + 1]);
+        replay_capture(group.value().right_instruction_position, m_match_captures[id * 3 + 2]);
+    }
+
+    for (size_t index = 0; index < m_info.named_capture_groups.size(); ++index) {
+        auto slot = (m_info.capture_groups.size() + index) * 3;
+        if (m_match_captures[slot + 2] == no_position)
+            continue;
+        replay_capture(m_info.named_capture_groups[index].left_instruction_position, m_match_captures[slot + 1]);
+        replay_capture(m_info.named_capture_groups[index].right_instruction_position, m_match_captures[slot + 2]);
+    }
+
+    state.string_position = m_match_end;
+    return m_match_start;
+}
+
+// Advances every thread of the current list over the character at string_position into the next list.
+void PikeVM::step(size_t string_position)
+{
+    auto length = m_input->view.length();
+    bool insensitive = m_input->regex_options & AllFlags::Insensitive;
+
+    m_next.clear();
+    m_next.generation = ++m_generation;
+
+    for (size_t i = 0; i < m_current.threads.size(); ++i) {
+        auto thread = m_current.threads[i];
+        ++m_output->operations;
+
+        for (size_t slot = 0; slot < m_capture_slot_count; ++slot)
+            m_captures[slot] = m_current.captures[thread.captures + slot];
+
+        if (thread.resume_position > string_position) {
+            if (thread.resume_position == string_position + 1)
+                add_thread(m_next, thread.instruction_position, string_position + 1, thread.start_position);
+            else
+                append_thread(m_next, thread.instruction_position, thread.resume_position, thread.start_position);
+            continue;
+        }
+
+        if (thread.instruction_position >= m_bytecode.size()) {
+            // This is the highest priority thread that's still around to match, so anything after it can go.
+            m_matched = true;
+            m_match_start = thread.start_position;
+            m_match_end = string_position;
+            m_match_captures = m_captures;
+            return;
+        }
+
+        // Every compare has to consume something.
+        if (string_position >= length)
+            continue;
+
+        auto next_instruction_position = thread.instruction_position + m_bytecode[thread.instruction_position + 2] + 3;
+
+        auto ch = m_input->view[string_position];
+        auto* character_set = m_info.character_set_at(thread.instruction_position);
+        if (character_set && ch < CharacterSet::size) {
+            if (character_set->contains(ch, insensitive))
+                add_thread(m_next, next_instruction_position, string_position + 1, thread.start_position);
+            continue;
+        }
+
+        MatchState state;
+        state.instruction_position = thread.instruction_position;
+        state.string_position = string_position;
+        auto* opcode = m_bytecode.get_opcode(state);
+        if (opcode->execute(*m_input, state, *m_output) != ExecutionResult::Continue)
+            continue;
+
+        if (state.string_position == string_position + 1)
+            add_thread(m_next, next_instruction_position, string_position + 1, thread.start_position);
+        else
+            append_thread(m_next, next_instruction_position, state.string_position, thread.start_position);
+    }
+}
+
+// Follows the instructions that don't consume anything, in priority order, and adds a thread
+// for each compare (or the end of the program) that is reached.
+void PikeVM::add_thread(ThreadList& list, size_t instruction_position, size_t string_position, size_t start_position)
+{
+    for (;;) {
+        if (instruction_position > m_bytecode.size())
+            instruction_position = m_bytecode.size();
+
+        if (m_visited[instruction_position] == list.generation)
+            return;
+        m_visited[instruction_position] = list.generation;
+        ++m_output->operations;
+
+        if (instruction_position == m_bytecode.size()) {
+            append_thread(list, instruction_position, string_position, start_position);
+            return;
+        }
+
+        switch ((OpCodeId)m_bytecode[instruction_position]) {
+        case OpCodeId::Compare:
+            append_thread(list, instruction_position, string_position, start_position);
+            return;
+        case OpCodeId::Jump:
+            instruction_position += 2 + (ssize_t)m_bytecode[instruction_position + 1];
+            continue;
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkReplaceJump:
+            add_thread(list, instruction_position + 2 + (ssize_t)m_bytecode[instruction_position + 1], string_position, start_position);
+            instruction_position += 2;
+            continue;
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkReplaceStay:
+            add_thread(list, instruction_position + 2, string_position, start_position);
+            instruction_position += 2 + (ssize_t)m_bytecode[instruction_position + 1];
+            continue;
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveLeftNamedCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup: {
+            auto id = (OpCodeId)m_bytecode[instruction_position];
+            size_t slot;
+            size_t size;
+            if (id == OpCodeId::SaveLeftCaptureGroup || id == OpCodeId::SaveRightCaptureGroup) {
+                slot = m_bytecode[instruction_position + 1] * 3;
+                size = 2;
+            } else {
+                slot = (m_info.capture_groups.size() + m_info.named_capture_group_indices.get(instruction_position).value()) * 3;
+                size = 3;
+            }
+
+            size_t saved_slots[3] = { m_captures[slot], m_captures[slot + 1], m_captures[slot + 2] };
+            if (id == OpCodeId::SaveLeftCaptureGroup || id == OpCodeId::SaveLeftNamedCaptureGroup) {
+                m_captures[slot] = string_position;
+            } else {
+                m_captures[slot + 1] = m_captures[slot];
+                m_captures[slot + 2] = string_position;
+            }
+
+            add_thread(list, instruction_position + size, string_position, start_position);
+
+            m_captures[slot] = saved_slots[0];
+            m_captures[slot + 1] = saved_slots[1];
+            m_captures[slot + 2] = saved_slots[2];
+            return;
+        }
+        case OpCodeId::CheckBegin:
+        case OpCodeId::CheckEnd:
+        case OpCodeId::CheckBoundary: {
+            MatchState state;
+            state.instruction_position = instruction_position;
+            state.string_position = string_position;
+            auto* opcode = m_bytecode.get_opcode(state);
+            if (opcode->execute(*m_input, state, *m_output) != ExecutionResult::Continue)
+                return;
+            instruction_position += opcode->size();
+            continue;
+        }
+        default:
+            ASSERT_NOT_REACHED();
+        }
+    }
+}
+
+void PikeVM::append_thread(ThreadList& list, size_t instruction_position, size_t resume_position, size_t start_position)
+{
+    list.threads.append({ instruction_position, resume_position, start_position, list.captures.size() });
+    list.captures.append(m_captures.data(), m_capture_slot_count);
+}
+
+// Runs one of the capture group instructions of the match, to fill in the output just like the backtracking matcher does.
+void PikeVM::replay_capture(size_t instruction_position, size_t string_position)
+{
+    MatchState state;
+    state.instruction_position = instruction_position;
+    state.string_position = string_position;
+    m_bytecode.get_opcode(state)->execute(*m_input, state, *m_output);
+}
+
+}
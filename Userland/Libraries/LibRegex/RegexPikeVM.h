@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "RegexByteCode.h"
+#include "RegexMatch.h"
+#include "RegexOptimizer.h"
+
+#include <AK/NumericLimits.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+
+namespace regex {
+
+// Runs patterns without backreferences or lookarounds in a single pass over the input,
+// advancing all alternatives in lockstep (in priority order) instead of backtracking.
+// This finds the same match as the backtracking matcher in linear time.
+class PikeVM {
+public:
+    PikeVM(const ByteCode&, const OptimizationInfo&);
+
+    // Finds the first match that starts at state.string_position, or at any later position unless anchored.
+    // On success, returns where the match starts, leaves its end in state.string_position and writes its
+    // capture groups to the output.
+    Optional<size_t> match(const MatchInput&, MatchState&, MatchOutput&, bool anchored, size_t match_length_minimum);
+
+private:
+    static constexpr size_t no_position = NumericLimits<size_t>::max();
+
+    struct Thread {
+        size_t instruction_position { 0 };
+        // A thread is asleep until the input reaches this position, after a compare that consumed more than one character.
+        size_t resume_position { 0 };
+        size_t start_position { 0 };
+        // The offset of the thread's capture slots in its list's captures.
+        size_t captures { 0 };
+    };
+
+    struct ThreadList {
+        Vector<Thread> threads;
+        Vector<size_t> captures;
+        size_t generation { 0 };
+
+        void clear()
+        {
+            threads.clear_with_capacity();
+            captures.clear_with_capacity();
+        }
+    };
+
+    void add_thread(ThreadList&, size_t instruction_position, size_t string_position, size_t start_position);
+    void append_thread(ThreadList&, size_t instruction_position, size_t resume_position, size_t start_position);
+    void step(size_t string_position);
+    void replay_capture(size_t instruction_position, size_t string_position);
+
+    const ByteCode& m_bytecode;
+    const OptimizationInfo& m_info;
+    const MatchInput* m_input { nullptr };
+    MatchOutput* m_output { nullptr };
+
+    // Every group gets three slots: the position of its last left paren, and the start and end of its last complete capture.
+    size_t m_capture_slot_count { 0 };
+    Vector<size_t> m_captures;
+
+    // The generation of the list that last reached each instruction, so every instruction is only added once per position.
+    Vector<size_t> m_visited;
+    size_t m_generation { 0 };
+
+    ThreadList m_current;
+    ThreadList m_next;
+
+    bool m_matched { false };
+    size_t m_match_start { 0 };
+    size_t m_match_end { 0 };
+    Vector<size_t> m_match_captures;
+};
+
+}
@@ -597,4 +597,133 @@ TEST_CASE(replace)
     }
 }
 
+TEST_CASE(alternation_loop_on_long_line)
+{
+    Regex<PosixExtended> re("(a|b)*c");
+    RegexResult result;
+
+    StringBuilder builder;
+    for (size_t i = 0; i < 5000; ++i)
+        builder.append("ab");
+    auto haystack = builder.to_string();
+
+    EXPECT(re.parser_result.optimization.can_use_pike_vm);
+    EXPECT_EQ(re.search(haystack.view(), result), false);
+
+    haystack = String::formatted("{}c", haystack);
+    EXPECT_EQ(re.search(haystack.view(), result), true);
+    EXPECT_EQ(result.matches.at(0).view.length(), 10001u);
+    EXPECT_EQ(result.capture_group_matches.at(0).at(0).view, "b");
+}
+
+TEST_CASE(pike_vm_captures_match_backtracker)
+{
+    struct _test {
+        const char* pattern;
+        const char* subject;
+        Vector<const char*> groups;
+    };
+
+    _test tests[] {
+        { "(a|ab)(c|bcd)(d*)", "abcd", { "ab", "c", "d" } },
+        { "(a(b(c)))", "abc", { "abc", "bc", "c" } },
+        { "((a)|b)+", "ab", { "b", "a" } },
+    };
+
+    for (auto& test : tests) {
+        // A lookahead can't be run by the Pike VM, so the second pattern uses the backtracking matcher.
+        Regex<ECMA262> pike_re(test.pattern);
+        Regex<ECMA262> backtracking_re(String::formatted("{}(?=)", test.pattern));
+        EXPECT(pike_re.parser_result.optimization.can_use_pike_vm);
+        EXPECT(!backtracking_re.parser_result.optimization.can_use_pike_vm);
+
+        for (auto* re : { &pike_re, &backtracking_re }) {
+            auto result = re->match(test.subject);
+            EXPECT(result.success);
+            EXPECT_EQ(result.matches.at(0).view, test.subject);
+            EXPECT_EQ(result.capture_group_matches.at(0).size(), test.groups.size());
+            for (size_t i = 0; i < test.groups.size(); ++i)
+                EXPECT_EQ(result.capture_group_matches.at(0).at(i).view, test.groups[i]);
+        }
+    }
+}
+
+static bool has_opcode(const regex::ByteCode& bytecode, regex::OpCodeId id)
+{
+    regex::MatchState state;
+    while (state.instruction_position < bytecode.size()) {
+        auto* opcode = bytecode.get_opcode(state);
+        if (opcode->opcode_id() == id)
+            return true;
+        state.instruction_position += opcode->size();
+    }
+    return false;
+}
+
+TEST_CASE(possessive_loops)
+{
+    // Only a loop that can't give anything back to what follows it is made possessive.
+    Regex<ECMA262> re_a_star_b("a*b");
+    EXPECT(has_opcode(re_a_star_b.parser_result.bytecode, regex::OpCodeId::ForkReplaceStay));
+    EXPECT(re_a_star_b.match("aaab").success);
+    EXPECT(!re_a_star_b.match("aaa").success);
+
+    Regex<ECMA262> re_a_star_a("a*a");
+    EXPECT(!has_opcode(re_a_star_a.parser_result.bytecode, regex::OpCodeId::ForkReplaceStay));
+    EXPECT(re_a_star_a.match("aaa").success);
+
+    Regex<ECMA262> re_a_star_upper_a("a*A", ECMAScriptFlags::Insensitive);
+    EXPECT(!has_opcode(re_a_star_upper_a.parser_result.bytecode, regex::OpCodeId::ForkReplaceStay));
+    EXPECT(re_a_star_upper_a.match("aaA").success);
+    EXPECT(re_a_star_upper_a.match("aaa").success);
+    EXPECT(!re_a_star_upper_a.match("aab").success);
+}
+
+TEST_CASE(literal_prefix_skipping)
+{
+    Regex<ECMA262> re("foo\\d");
+    EXPECT_EQ(re.parser_result.optimization.literal_prefix, "foo");
+
+    auto result = re.match("xfoo1\nfoo2y\nbar", ECMAScriptFlags::Multiline);
+    EXPECT_EQ(result.count, 2u);
+    EXPECT_EQ(result.matches.at(0).view, "foo1");
+    EXPECT_EQ(result.matches.at(1).view, "foo2");
+
+    Regex<PosixExtended> posix_re("foo[[:digit:]]");
+    result = posix_re.match("xxfoo1yyfoox2foo3", PosixFlags::Global);
+    EXPECT_EQ(result.count, 2u);
+    EXPECT_EQ(result.matches.at(0).view, "foo1");
+    EXPECT_EQ(result.matches.at(1).view, "foo3");
+
+    EXPECT(!posix_re.match("fofofo", PosixFlags::Global).success);
+}
+
+TEST_CASE(empty_loop_bodies)
+{
+    Regex<ECMA262> re("(a*)*");
+    auto result = re.match("aaa");
+    EXPECT(result.success);
+    EXPECT_EQ(result.matches.at(0).view, "aaa");
+    EXPECT_EQ(result.capture_group_matches.at(0).at(0).view, "aaa");
+
+    Regex<ECMA262> re2("(c|[ab]*)+");
+    result = re2.match("b");
+    EXPECT(result.success);
+    EXPECT_EQ(result.capture_group_matches.at(0).at(0).view, "b");
+
+    Regex<ECMA262> re3("(a|)*b");
+    result = re3.match("aab");
+    EXPECT(result.success);
+    EXPECT_EQ(result.matches.at(0).view, "aab");
+}
+
+TEST_CASE(failed_paths_leave_no_captures)
+{
+    Regex<ECMA262> re("(?:c|(a?)b)");
+    RegexResult result;
+    EXPECT(re.search("c", result));
+    EXPECT_EQ(result.matches.at(0).view, "c");
+    EXPECT(result.capture_group_matches.is_empty() || result.capture_group_matches.at(0).is_empty());
+}
+
 TEST_MAIN(Regex)
@@ -58,6 +58,7 @@ public:
             return *it->value;
         auto* prototype = heap().allocate<T>(*this, *this);
         m_prototypes.set(class_name, prototype);
+        write_barrier();
         return *prototype;
     }
 
@@ -69,6 +70,7 @@ public:
             return *it->value;
         auto* constructor = heap().allocate<T>(*this, *this);
         m_constructors.set(class_name, constructor);
+        write_barrier();
         define_property(class_name, JS::Value(constructor), JS::Attribute::Writable | JS::Attribute::Configurable);
         return *constructor;
     }
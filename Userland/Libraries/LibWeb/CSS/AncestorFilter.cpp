@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/NumericLimits.h>
+#include <LibWeb/CSS/AncestorFilter.h>
+#include <LibWeb/DOM/Element.h>
+#include <LibWeb/HTML/AttributeNames.h>
+
+namespace Web::CSS {
+
+void AncestorFilter::add(u32 hash)
+{
+    for (auto index : { hash & key_mask, (hash >> key_bits) & key_mask }) {
+        if (m_counters[index] != NumericLimits<u8>::max())
+            ++m_counters[index];
+    }
+    m_hashes.append(hash);
+}
+
+void AncestorFilter::remove(u32 hash)
+{
+    for (auto index : { hash & key_mask, (hash >> key_bits) & key_mask }) {
+        ASSERT(m_counters[index]);
+        if (m_counters[index] != NumericLimits<u8>::max())
+            --m_counters[index];
+    }
+}
+
+void AncestorFilter::push(const DOM::Node& node)
+{
+    size_t hashes_before = m_hashes.size();
+    if (is<DOM::Element>(node)) {
+        auto& element = downcast<DOM::Element>(node);
+        add(hash_for_tag_name(element.local_name()));
+        auto id = element.attribute(HTML::AttributeNames::id);
+        if (!id.is_null())
+            add(hash_for_id(id.hash()));
+        for (auto& class_name : element.class_names())
+            add(hash_for_class(class_name));
+    }
+    m_ancestors.append({ &node, m_hashes.size() - hashes_before });
+}
+
+void AncestorFilter::pop(const DOM::Node& node)
+{
+    ASSERT(!m_ancestors.is_empty());
+    auto ancestor = m_ancestors.take_last();
+    ASSERT(ancestor.node == &node);
+    for (size_t i = 0; i < ancestor.hash_count; ++i)
+        remove(m_hashes.take_last());
+}
+
+}
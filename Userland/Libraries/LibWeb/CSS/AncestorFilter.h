@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/FlyString.h>
+#include <AK/Vector.h>
+#include <LibWeb/Forward.h>
+
+namespace Web::CSS {
+
+// A counting Bloom filter of the tag names, ids and classes of the element chain currently being
+// styled. If an identifier that a selector requires on some ancestor is missing from the filter,
+// the selector can't match, and we don't have to walk up the tree to find that out.
+class AncestorFilter {
+public:
+    static constexpr size_t max_selector_hashes = 4;
+
+    static u32 hash_for_tag_name(const FlyString& tag_name) { return tag_name.hash() * tag_name_salt; }
+    static u32 hash_for_id(u32 id_hash) { return id_hash * id_salt; }
+    static u32 hash_for_class(const FlyString& class_name) { return class_name.hash() * class_salt; }
+
+    void push(const DOM::Node&);
+    void pop(const DOM::Node&);
+
+    // The filter is only meaningful if it holds every ancestor of the element, i.e. if the last
+    // node pushed is its parent.
+    bool is_valid_for_parent(const DOM::Node* parent) const { return parent && !m_ancestors.is_empty() && m_ancestors.last().node == parent; }
+
+    bool may_contain(u32 hash) const
+    {
+        return m_counters[hash & key_mask] && m_counters[(hash >> key_bits) & key_mask];
+    }
+
+private:
+    static constexpr size_t key_bits = 12;
+    static constexpr u32 key_mask = (1 << key_bits) - 1;
+    static constexpr u32 tag_name_salt = 13;
+    static constexpr u32 id_salt = 17;
+    static constexpr u32 class_salt = 19;
+
+    void add(u32 hash);
+    void remove(u32 hash);
+
+    struct Ancestor {
+        const DOM::Node* node { nullptr };
+        size_t hash_count { 0 };
+    };
+
+    // Saturated counters are never decremented, so they can only cause false positives.
+    Array<u8, 1 << key_bits> m_counters {};
+    Vector<Ancestor> m_ancestors;
+    Vector<u32> m_hashes;
+};
+
+}
@@ -30,34 +30,47 @@
 
 namespace Web::CSS {
 
-StyleInvalidator::StyleInvalidator(DOM::Document& document)
-    : m_document(document)
+// An attribute change can only affect which selectors match the element itself, its descendants
+// (through descendant and child combinators), and its following siblings and their descendants
+// (through sibling combinators).
+template<typename Callback>
+void StyleInvalidator::for_each_affected_element(Callback callback)
 {
-    if (!m_document.should_invalidate_styles_on_attribute_changes())
+    for (DOM::Node* node = &m_element; node; node = node->next_sibling()) {
+        node->for_each_in_subtree_of_type<DOM::Element>([&](auto& element) {
+            callback(element);
+            return IterationDecision::Continue;
+        });
+    }
+}
+
+StyleInvalidator::StyleInvalidator(DOM::Element& element)
+    : m_element(element)
+{
+    if (!m_element.document().should_invalidate_styles_on_attribute_changes())
         return;
-    auto& style_resolver = m_document.style_resolver();
-    m_document.for_each_in_subtree_of_type<DOM::Element>([&](auto& element) {
+    auto& style_resolver = m_element.document().style_resolver();
+    for_each_affected_element([&](auto& element) {
         m_elements_and_matching_rules_before.set(&element, style_resolver.collect_matching_rules(element));
-        return IterationDecision::Continue;
     });
 }
 
 StyleInvalidator::~StyleInvalidator()
 {
-    if (!m_document.should_invalidate_styles_on_attribute_changes())
+    if (!m_element.document().should_invalidate_styles_on_attribute_changes())
         return;
-    auto& style_resolver = m_document.style_resolver();
-    m_document.for_each_in_subtree_of_type<DOM::Element>([&](auto& element) {
+    auto& style_resolver = m_element.document().style_resolver();
+    for_each_affected_element([&](auto& element) {
         auto maybe_matching_rules_before = m_elements_and_matching_rules_before.get(&element);
         if (!maybe_matching_rules_before.has_value()) {
             element.set_needs_style_update(true);
-            return IterationDecision::Continue;
+            return;
         }
         auto& matching_rules_before = maybe_matching_rules_before.value();
         auto matching_rules_after = style_resolver.collect_matching_rules(element);
         if (matching_rules_before.size() != matching_rules_after.size()) {
             element.set_needs_style_update(true);
-            return IterationDecision::Continue;
+            return;
         }
         style_resolver.sort_matching_rules(matching_rules_before);
         style_resolver.sort_matching_rules(matching_rules_after);
@@ -67,7 +80,6 @@ StyleInvalidator::~StyleInvalidator()
                 break;
             }
         }
-        return IterationDecision::Continue;
     });
 }
 
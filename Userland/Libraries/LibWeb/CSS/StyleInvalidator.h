@@ -35,11 +35,14 @@ namespace Web::CSS {
 
 class StyleInvalidator {
 public:
-    explicit StyleInvalidator(DOM::Document&);
+    explicit StyleInvalidator(DOM::Element&);
     ~StyleInvalidator();
 
 private:
-    DOM::Document& m_document;
+    template<typename Callback>
+    void for_each_affected_element(Callback);
+
+    DOM::Element& m_element;
     HashMap<DOM::Element*, Vector<MatchingRule>> m_elements_and_matching_rules_before;
 };
 
@@ -24,6 +24,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <AK/Debug.h>
 #include <AK/QuickSort.h>
 #include <LibWeb/CSS/Parser/CSSParser.h>
 #include <LibWeb/CSS/SelectorEngine.h>
@@ -32,6 +33,7 @@
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
 #include <LibWeb/Dump.h>
+#include <LibWeb/HTML/AttributeNames.h>
 #include <ctype.h>
 #include <stdio.h>
 
@@ -79,9 +81,52 @@ void StyleResolver::for_each_stylesheet(Callback callback) const
     }
 }
 
-Vector<MatchingRule> StyleResolver::collect_matching_rules(const DOM::Element& element) const
+static size_t collect_ancestor_hashes(const Selector& selector, Array<u32, AncestorFilter::max_selector_hashes>& hashes)
 {
-    Vector<MatchingRule> matching_rules;
+    // A compound selector has to match an ancestor of the element if there is a descendant or child
+    // combinator anywhere to its right. Sibling combinators don't change that, as siblings share ancestors.
+    auto& complex_selectors = selector.complex_selectors();
+    size_t hash_count = 0;
+    bool is_ancestor = false;
+    for (size_t i = complex_selectors.size() - 1; i > 0; --i) {
+        auto relation = complex_selectors[i].relation;
+        if (relation == Selector::ComplexSelector::Relation::Descendant || relation == Selector::ComplexSelector::Relation::ImmediateChild)
+            is_ancestor = true;
+        if (!is_ancestor)
+            continue;
+        for (auto& simple_selector : complex_selectors[i - 1].compound_selector) {
+            if (hash_count == hashes.size())
+                return hash_count;
+            switch (simple_selector.type) {
+            case Selector::SimpleSelector::Type::Id:
+                hashes[hash_count++] = AncestorFilter::hash_for_id(simple_selector.value.hash());
+                break;
+            case Selector::SimpleSelector::Type::Class:
+                hashes[hash_count++] = AncestorFilter::hash_for_class(simple_selector.value);
+                break;
+            case Selector::SimpleSelector::Type::TagName:
+                hashes[hash_count++] = AncestorFilter::hash_for_tag_name(simple_selector.value);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    return hash_count;
+}
+
+void StyleResolver::build_rule_cache() const
+{
+    m_rule_cache = make<RuleCache>();
+
+    auto add_to_bucket = [](HashMap<FlyString, Vector<CachedRule>>& buckets, const FlyString& key, CachedRule&& cached_rule) {
+        auto it = buckets.find(key);
+        if (it == buckets.end()) {
+            buckets.set(key, {});
+            it = buckets.find(key);
+        }
+        it->value.append(move(cached_rule));
+    };
 
     size_t style_sheet_index = 0;
     for_each_stylesheet([&](auto& sheet) {
@@ -89,16 +134,104 @@ Vector<MatchingRule> StyleResolver::collect_matching_rules(const DOM::Element& e
         for (auto& rule : sheet.rules()) {
             size_t selector_index = 0;
             for (auto& selector : rule.selectors()) {
-                if (SelectorEngine::matches(selector, element)) {
-                    matching_rules.append({ rule, style_sheet_index, rule_index, selector_index });
-                    break;
+                CachedRule cached_rule;
+                cached_rule.matching_rule = { rule, style_sheet_index, rule_index, selector_index };
+                cached_rule.ancestor_hash_count = collect_ancestor_hashes(selector, cached_rule.ancestor_hashes);
+
+                const Selector::SimpleSelector* id_selector = nullptr;
+                const Selector::SimpleSelector* class_selector = nullptr;
+                const Selector::SimpleSelector* tag_name_selector = nullptr;
+                for (auto& simple_selector : selector.complex_selectors().last().compound_selector) {
+                    if (simple_selector.type == Selector::SimpleSelector::Type::Id && !id_selector)
+                        id_selector = &simple_selector;
+                    else if (simple_selector.type == Selector::SimpleSelector::Type::Class && !class_selector)
+                        class_selector = &simple_selector;
+                    else if (simple_selector.type == Selector::SimpleSelector::Type::TagName && !tag_name_selector)
+                        tag_name_selector = &simple_selector;
                 }
+
+                if (id_selector)
+                    add_to_bucket(m_rule_cache->rules_by_id, id_selector->value, move(cached_rule));
+                else if (class_selector)
+                    add_to_bucket(m_rule_cache->rules_by_class, class_selector->value, move(cached_rule));
+                else if (tag_name_selector)
+                    add_to_bucket(m_rule_cache->rules_by_tag_name, tag_name_selector->value, move(cached_rule));
+                else
+                    m_rule_cache->other_rules.append(move(cached_rule));
                 ++selector_index;
             }
             ++rule_index;
         }
         ++style_sheet_index;
     });
+}
+
+bool StyleResolver::is_rejected_by_ancestor_filter(const CachedRule& cached_rule) const
+{
+    for (size_t i = 0; i < cached_rule.ancestor_hash_count; ++i) {
+        if (!m_ancestor_filter.may_contain(cached_rule.ancestor_hashes[i]))
+            return true;
+    }
+    return false;
+}
+
+Vector<MatchingRule> StyleResolver::collect_matching_rules(const DOM::Element& element) const
+{
+    if (!m_rule_cache)
+        build_rule_cache();
+
+    Vector<const CachedRule*> candidates;
+    auto add_candidates = [&](const HashMap<FlyString, Vector<CachedRule>>& buckets, const FlyString& key) {
+        auto it = buckets.find(key);
+        if (it == buckets.end())
+            return;
+        for (auto& cached_rule : it->value)
+            candidates.append(&cached_rule);
+    };
+
+    auto id = element.attribute(HTML::AttributeNames::id);
+    if (!id.is_null())
+        add_candidates(m_rule_cache->rules_by_id, id);
+    for (auto& class_name : element.class_names())
+        add_candidates(m_rule_cache->rules_by_class, class_name);
+    add_candidates(m_rule_cache->rules_by_tag_name, element.local_name());
+    for (auto& cached_rule : m_rule_cache->other_rules)
+        candidates.append(&cached_rule);
+
+    // Visit the candidates in document order, so that each rule is matched by its first matching selector.
+    quick_sort(candidates, [](auto* a, auto* b) {
+        auto& a_rule = a->matching_rule;
+        auto& b_rule = b->matching_rule;
+        if (a_rule.style_sheet_index != b_rule.style_sheet_index)
+            return a_rule.style_sheet_index < b_rule.style_sheet_index;
+        if (a_rule.rule_index != b_rule.rule_index)
+            return a_rule.rule_index < b_rule.rule_index;
+        return a_rule.selector_index < b_rule.selector_index;
+    });
+
+    bool can_use_ancestor_filter = m_ancestor_filter.is_valid_for_parent(element.parent());
+
+    Vector<MatchingRule> matching_rules;
+    for (auto* candidate : candidates) {
+        auto& matching_rule = candidate->matching_rule;
+        if (!matching_rules.is_empty()) {
+            auto& last_rule = matching_rules.last();
+            if (last_rule.style_sheet_index == matching_rule.style_sheet_index && last_rule.rule_index == matching_rule.rule_index)
+                continue;
+        }
+        if (can_use_ancestor_filter && is_rejected_by_ancestor_filter(*candidate)) {
+            if constexpr (STYLE_RESOLVER_DEBUG)
+                ++m_rules_rejected_by_ancestor_filter;
+            continue;
+        }
+        if constexpr (STYLE_RESOLVER_DEBUG)
+            ++m_rules_tested;
+        if (SelectorEngine::matches(matching_rule.rule->selectors()[matching_rule.selector_index], element)) {
+            if constexpr (STYLE_RESOLVER_DEBUG)
+                ++m_rules_matched;
+            matching_rules.append(matching_rule);
+        }
+    }
 
     return matching_rules;
 }
@@ -119,6 +252,18 @@ void StyleResolver::sort_matching_rules(Vector<MatchingRule>& matching_rules) co
     });
 }
 
+void StyleResolver::reset_counters() const
+{
+    m_rules_tested = 0;
+    m_rules_rejected_by_ancestor_filter = 0;
+    m_rules_matched = 0;
+}
+
+void StyleResolver::dump_counters() const
+{
+    dbgln("StyleResolver: {} rules tested, {} rejected by the ancestor filter, {} matched", m_rules_tested, m_rules_rejected_by_ancestor_filter, m_rules_matched);
+}
+
 bool StyleResolver::is_inherited_property(CSS::PropertyID property_id)
 {
     static HashTable<CSS::PropertyID> inherited_properties;
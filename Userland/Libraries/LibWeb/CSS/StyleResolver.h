@@ -26,8 +26,10 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/OwnPtr.h>
+#include <LibWeb/CSS/AncestorFilter.h>
 #include <LibWeb/CSS/StyleProperties.h>
 #include <LibWeb/Forward.h>
 
@@ -55,11 +57,46 @@ public:
 
     static bool is_inherited_property(CSS::PropertyID);
 
+    void invalidate_rule_cache() { m_rule_cache = nullptr; }
+
+    // While these are in effect, styling a child of the innermost pushed node can skip
+    // selectors whose ancestor requirements aren't in the ancestor filter.
+    void push_ancestor(const DOM::Node& node) { m_ancestor_filter.push(node); }
+    void pop_ancestor(const DOM::Node& node) { m_ancestor_filter.pop(node); }
+
+    void reset_counters() const;
+    void dump_counters() const;
+
 private:
     template<typename Callback>
     void for_each_stylesheet(Callback) const;
 
+    struct CachedRule {
+        MatchingRule matching_rule;
+        // Hashes of identifiers that some ancestor of a matching element must have.
+        Array<u32, AncestorFilter::max_selector_hashes> ancestor_hashes {};
+        size_t ancestor_hash_count { 0 };
+    };
+
+    // Rules are bucketed by the most specific identifier in the rightmost compound selector,
+    // so an element only has to be matched against the buckets for its own id, classes and tag name.
+    struct RuleCache {
+        HashMap<FlyString, Vector<CachedRule>> rules_by_id;
+        HashMap<FlyString, Vector<CachedRule>> rules_by_class;
+        HashMap<FlyString, Vector<CachedRule>> rules_by_tag_name;
+        Vector<CachedRule> other_rules;
+    };
+
+    void build_rule_cache() const;
+    bool is_rejected_by_ancestor_filter(const CachedRule&) const;
+
     DOM::Document& m_document;
+    mutable OwnPtr<RuleCache> m_rule_cache;
+    AncestorFilter m_ancestor_filter;
+
+    mutable size_t m_rules_tested { 0 };
+    mutable size_t m_rules_rejected_by_ancestor_filter { 0 };
+    mutable size_t m_rules_matched { 0 };
 };
 
 }
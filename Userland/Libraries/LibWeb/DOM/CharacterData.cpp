@@ -25,6 +25,7 @@
  */
 
 #include <LibWeb/DOM/CharacterData.h>
+#include <LibWeb/Layout/Node.h>
 
 namespace Web::DOM {
 
@@ -38,4 +39,11 @@ CharacterData::~CharacterData()
 {
 }
 
+void CharacterData::set_data(const String& data)
+{
+    m_data = data;
+    if (layout_node())
+        layout_node()->set_needs_layout();
+}
+
 }
@@ -24,6 +24,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <AK/Debug.h>
 #include <AK/StringBuilder.h>
 #include <AK/Utf8View.h>
 #include <LibCore/Timer.h>
@@ -386,9 +387,22 @@ void Document::update_layout()
         m_layout_root = static_ptr_cast<Layout::InitialContainingBlockBox>(tree_builder.build(*this));
     }
 
+    // Nothing that affects layout has changed since we last did it.
+    if (!m_layout_root->needs_layout() && !m_layout_root->child_needs_layout())
+        return;
+
     Layout::BlockFormattingContext root_formatting_context(*m_layout_root, nullptr);
     root_formatting_context.run(*m_layout_root, Layout::LayoutMode::Default);
 
+    size_t laid_out_node_count = 0;
+    m_layout_root->for_each_in_subtree([&](auto& layout_node) {
+        layout_node.clear_needs_layout();
+        ++laid_out_node_count;
+        return IterationDecision::Continue;
+    });
+    if constexpr (LAYOUT_DEBUG)
+        dbgln("Layout update: {} layout nodes laid out", laid_out_node_count);
+
     m_layout_root->set_needs_display();
 
     if (frame()->is_main_frame()) {
@@ -397,25 +411,35 @@ void Document::update_layout()
     }
 }
 
-static void update_style_recursively(DOM::Node& node)
+static void update_style_recursively(DOM::Node& node, CSS::StyleResolver& style_resolver, size_t& restyled_element_count)
 {
+    style_resolver.push_ancestor(node);
     node.for_each_child([&](auto& child) {
         if (child.needs_style_update()) {
-            if (is<Element>(child))
+            if (is<Element>(child)) {
                 downcast<Element>(child).recompute_style();
+                ++restyled_element_count;
+            }
             child.set_needs_style_update(false);
         }
         if (child.child_needs_style_update()) {
-            update_style_recursively(child);
+            update_style_recursively(child, style_resolver, restyled_element_count);
             child.set_child_needs_style_update(false);
         }
         return IterationDecision::Continue;
     });
+    style_resolver.pop_ancestor(node);
 }
 
 void Document::update_style()
 {
-    update_style_recursively(*this);
+    size_t restyled_element_count = 0;
+    style_resolver().reset_counters();
+    update_style_recursively(*this, style_resolver(), restyled_element_count);
+    if constexpr (STYLE_RESOLVER_DEBUG) {
+        dbgln("Style update: {} elements restyled", restyled_element_count);
+        style_resolver().dump_counters();
+    }
     update_layout();
 }
 
@@ -471,7 +495,20 @@ void Document::set_hovered_node(Node* node)
     RefPtr<Node> old_hovered_node = move(m_hovered_node);
     m_hovered_node = node;
 
-    invalidate_style();
+    // Only the nodes between each hovered node and the closest common ancestor changed hover state.
+    // Restyle their subtrees, and those of their following siblings in case of sibling combinators.
+    auto invalidate_hover_chain = [](Node* hovered_node, Node* other_hovered_node) {
+        Node* topmost_changed_node = nullptr;
+        for (auto* ancestor = hovered_node; ancestor; ancestor = ancestor->parent()) {
+            if (other_hovered_node && (ancestor == other_hovered_node || ancestor->is_ancestor_of(*other_hovered_node)))
+                break;
+            topmost_changed_node = ancestor;
+        }
+        for (auto* sibling = topmost_changed_node; sibling; sibling = sibling->next_sibling())
+            sibling->invalidate_style();
+    };
+    invalidate_hover_chain(old_hovered_node, m_hovered_node);
+    invalidate_hover_chain(m_hovered_node, old_hovered_node);
 }
 
 NonnullRefPtrVector<Element> Document::get_elements_by_name(const String& name) const
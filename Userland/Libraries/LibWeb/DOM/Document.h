@@ -164,7 +164,11 @@ public:
 
     QuirksMode mode() const { return m_quirks_mode; }
     bool in_quirks_mode() const { return m_quirks_mode == QuirksMode::Yes; }
-    void set_quirks_mode(QuirksMode mode) { m_quirks_mode = mode; }
+    void set_quirks_mode(QuirksMode mode)
+    {
+        m_quirks_mode = mode;
+        m_style_resolver->invalidate_rule_cache();
+    }
 
     void adopt_node(Node&);
 
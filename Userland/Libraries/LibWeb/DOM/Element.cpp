@@ -83,9 +83,18 @@ String Element::attribute(const FlyString& name) const
     return {};
 }
 
+// Most attributes only reach layout through style (including presentational hints), and
+// recompute_style() works out whether that needs a relayout. These are read by layout directly.
+static bool attribute_affects_layout_directly(const FlyString& name)
+{
+    return name == HTML::AttributeNames::width
+        || name == HTML::AttributeNames::height
+        || name == HTML::AttributeNames::colspan;
+}
+
 void Element::set_attribute(const FlyString& name, const String& value)
 {
-    CSS::StyleInvalidator style_invalidator(document());
+    CSS::StyleInvalidator style_invalidator(*this);
 
     if (auto* attribute = find_attribute(name))
         attribute->set_value(value);
@@ -93,13 +102,19 @@ void Element::set_attribute(const FlyString& name, const String& value)
         m_attributes.empend(name, value);
 
     parse_attribute(name, value);
+
+    if (layout_node() && attribute_affects_layout_directly(name))
+        layout_node()->set_needs_layout();
 }
 
 void Element::remove_attribute(const FlyString& name)
 {
-    CSS::StyleInvalidator style_invalidator(document());
+    CSS::StyleInvalidator style_invalidator(*this);
 
     m_attributes.remove_first_matching([&](auto& attribute) { return attribute.name() == name; });
+
+    if (layout_node() && attribute_affects_layout_directly(name))
+        layout_node()->set_needs_layout();
 }
 
 bool Element::has_class(const FlyString& class_name) const
@@ -171,29 +186,59 @@ enum class StyleDifference {
     None,
     NeedsRepaint,
     NeedsRelayout,
+    NeedsLayoutTreeRebuild,
 };
 
-static StyleDifference compute_style_difference(const CSS::StyleProperties& old_style, const CSS::StyleProperties& new_style, const Document& document)
+static bool property_affects_only_painting(CSS::PropertyID property_id)
 {
-    if (old_style == new_style)
-        return StyleDifference::None;
-
-    bool needs_repaint = false;
-    bool needs_relayout = false;
+    switch (property_id) {
+    case CSS::PropertyID::BackgroundColor:
+    case CSS::PropertyID::BorderBottomColor:
+    case CSS::PropertyID::BorderLeftColor:
+    case CSS::PropertyID::BorderRightColor:
+    case CSS::PropertyID::BorderTopColor:
+    case CSS::PropertyID::Color:
+    case CSS::PropertyID::TextDecorationColor:
+    case CSS::PropertyID::TextDecorationLine:
+    case CSS::PropertyID::TextDecorationStyle:
+        return true;
+    default:
+        return false;
+    }
+}
 
-    if (new_style.display() != old_style.display())
-        needs_relayout = true;
+template<typename Callback>
+static void for_each_changed_property(const CSS::StyleProperties& old_style, const CSS::StyleProperties& new_style, Callback callback)
+{
+    old_style.for_each_property([&](auto property_id, auto& old_value) {
+        auto new_value = new_style.property(property_id);
+        if (!new_value.has_value() || old_value.type() != new_value.value()->type() || old_value != *new_value.value())
+            callback(property_id);
+    });
+    new_style.for_each_property([&](auto property_id, auto&) {
+        if (!old_style.property(property_id).has_value())
+            callback(property_id);
+    });
+}
 
-    if (new_style.color_or_fallback(CSS::PropertyID::Color, document, Color::Black) != old_style.color_or_fallback(CSS::PropertyID::Color, document, Color::Black))
-        needs_repaint = true;
-    else if (new_style.color_or_fallback(CSS::PropertyID::BackgroundColor, document, Color::Black) != old_style.color_or_fallback(CSS::PropertyID::BackgroundColor, document, Color::Black))
-        needs_repaint = true;
+static StyleDifference compute_style_difference(const CSS::StyleProperties& old_style, const CSS::StyleProperties& new_style, bool& inherited_property_changed)
+{
+    inherited_property_changed = false;
+    if (old_style == new_style)
+        return StyleDifference::None;
 
-    if (needs_relayout)
-        return StyleDifference::NeedsRelayout;
-    if (needs_repaint)
-        return StyleDifference::NeedsRepaint;
-    return StyleDifference::None;
+    auto difference = StyleDifference::None;
+    for_each_changed_property(old_style, new_style, [&](auto property_id) {
+        if (CSS::StyleResolver::is_inherited_property(property_id))
+            inherited_property_changed = true;
+        auto property_difference = StyleDifference::NeedsRelayout;
+        if (property_id == CSS::PropertyID::Display)
+            property_difference = StyleDifference::NeedsLayoutTreeRebuild;
+        else if (property_affects_only_painting(property_id))
+            property_difference = StyleDifference::NeedsRepaint;
+        difference = max(difference, property_difference);
+    });
+    return difference;
 }
 
 void Element::recompute_style()
@@ -203,6 +248,19 @@ void Element::recompute_style()
     auto old_specified_css_values = m_specified_css_values;
     auto new_specified_css_values = document().style_resolver().resolve_style(*this);
     m_specified_css_values = new_specified_css_values;
+
+    auto diff = StyleDifference::NeedsLayoutTreeRebuild;
+    if (old_specified_css_values) {
+        bool inherited_property_changed = false;
+        diff = compute_style_difference(*old_specified_css_values, *new_specified_css_values, inherited_property_changed);
+        // Our children inherit from us, so they have to be restyled as well.
+        if (inherited_property_changed) {
+            for_each_child_of_type<Element>([&](auto& child) {
+                child.set_needs_style_update(true);
+            });
+        }
+    }
+
     if (!layout_node()) {
         if (new_specified_css_values->display() == CSS::Display::None)
             return;
@@ -216,19 +274,18 @@ void Element::recompute_style()
     if (is<Layout::WidgetBox>(layout_node()))
         return;
 
-    auto diff = StyleDifference::NeedsRelayout;
-    if (old_specified_css_values)
-        diff = compute_style_difference(*old_specified_css_values, *new_specified_css_values, document());
     if (diff == StyleDifference::None)
         return;
-    layout_node()->apply_style(*new_specified_css_values);
-    if (diff == StyleDifference::NeedsRelayout) {
+    if (diff == StyleDifference::NeedsLayoutTreeRebuild) {
         document().schedule_forced_layout();
         return;
     }
-    if (diff == StyleDifference::NeedsRepaint) {
-        layout_node()->set_needs_display();
+    layout_node()->apply_style(*new_specified_css_values);
+    if (diff == StyleDifference::NeedsRelayout) {
+        layout_node()->set_needs_layout();
+        return;
     }
+    layout_node()->set_needs_display();
 }
 
 NonnullRefPtr<CSS::StyleProperties> Element::computed_style()
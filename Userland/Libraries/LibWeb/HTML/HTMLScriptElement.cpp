@@ -231,7 +231,7 @@ void HTMLScriptElement::prepare_script(Badge<HTMLDocumentParser>)
             // FIXME: This load should be made asynchronous and the parser should spin an event loop etc.
             ResourceLoader::the().load_sync(
                 url,
-                [this, url](auto data, auto&) {
+                [this, url](auto data, auto&, auto) {
                     if (data.is_null()) {
                         dbgln("HTMLScriptElement: Failed to load {}", url);
                         return;
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <AK/Optional.h>
 #include <AK/StringView.h>
 #include <AK/Vector.h>
 
@@ -37,7 +38,18 @@ struct EntityMatch {
     StringView entity;
 };
 
-Optional<EntityMatch> code_points_from_entity(const StringView&);
+// Matches a named character reference as its characters are consumed, remembering the longest entity seen so far.
+class EntityMatcher {
+public:
+    // Returns false if no entity continues with this code point. Nothing more should be consumed after that.
+    bool try_consume_code_point(u32);
+
+    Optional<EntityMatch> match() const;
+
+private:
+    size_t m_node_index { 0 };
+    size_t m_entity_index { 0 };
+};
 
 }
 }
@@ -1534,7 +1534,13 @@ _StartOfFunction:
             {
                 size_t byte_offset = m_utf8_view.byte_offset_of(m_prev_utf8_iterator);
 
-                auto match = HTML::code_points_from_entity(m_decoded_input.substring_view(byte_offset, m_decoded_input.length() - byte_offset - 1));
+                HTML::EntityMatcher entity_matcher;
+                for (auto ch : m_decoded_input.substring_view(byte_offset, m_decoded_input.length() - byte_offset - 1)) {
+                    // Entity names are ASCII, so there's no need to decode code points here.
+                    if (!entity_matcher.try_consume_code_point((u8)ch))
+                        break;
+                }
+                auto match = entity_matcher.match();
 
                 if (match.has_value()) {
                     for (size_t i = 0; i < match.value().entity.length() - 1; ++i) {
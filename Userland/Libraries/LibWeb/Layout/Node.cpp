@@ -146,6 +146,13 @@ void Node::split_into_lines(InlineFormattingContext& context, LayoutMode layout_
     });
 }
 
+void Node::set_needs_layout()
+{
+    m_needs_layout = true;
+    for (auto* ancestor = parent(); ancestor && !ancestor->m_child_needs_layout; ancestor = ancestor->parent())
+        ancestor->m_child_needs_layout = true;
+}
+
 void Node::set_needs_display()
 {
     if (auto* block = containing_block()) {
@@ -139,8 +139,8 @@ public:
     NodeWithStyle* parent();
     const NodeWithStyle* parent() const;
 
-    void inserted_into(Node&) { }
-    void removed_from(Node&) { }
+    void inserted_into(Node&) { set_needs_layout(); }
+    void removed_from(Node& old_parent) { old_parent.set_needs_layout(); }
     void children_changed() { }
 
     virtual void split_into_lines(InlineFormattingContext&, LayoutMode);
@@ -150,6 +150,15 @@ public:
 
     virtual void set_needs_display();
 
+    bool needs_layout() const { return m_needs_layout; }
+    bool child_needs_layout() const { return m_child_needs_layout; }
+    void set_needs_layout();
+    void clear_needs_layout()
+    {
+        m_needs_layout = false;
+        m_child_needs_layout = false;
+    }
+
     bool children_are_inline() const { return m_children_are_inline; }
     void set_children_are_inline(bool value) { m_children_are_inline = value; }
 
@@ -198,6 +207,8 @@ private:
     bool m_has_style { false };
     bool m_visible { true };
     bool m_children_are_inline { false };
+    bool m_needs_layout { true };
+    bool m_child_needs_layout { false };
     SelectionState m_selection_state { SelectionState::None };
 };
 
@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/Debug.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/File.h>
+#include <LibWeb/Loader/ResourceCache.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Web {
+
+// Used for responses that say nothing at all about how long they stay fresh.
+static constexpr time_t heuristic_freshness_lifetime = 5 * 60;
+static constexpr time_t max_heuristic_freshness_lifetime = 24 * 60 * 60;
+
+static constexpr const char* disk_store_magic = "LibWeb-cache 1";
+
+struct CacheControl {
+    bool no_store { false };
+    bool no_cache { false };
+    Optional<time_t> max_age;
+};
+
+static CacheControl parse_cache_control(const StringView& value)
+{
+    CacheControl cache_control;
+    for (auto directive : value.split_view(',')) {
+        directive = directive.trim_whitespace();
+        if (directive.equals_ignoring_case("no-store")) {
+            cache_control.no_store = true;
+        } else if (directive.equals_ignoring_case("no-cache")) {
+            cache_control.no_cache = true;
+        } else if (directive.starts_with("max-age=", CaseSensitivity::CaseInsensitive)) {
+            if (auto max_age = directive.substring_view(8).to_uint<u64>(); max_age.has_value())
+                cache_control.max_age = max_age.value();
+        }
+    }
+    return cache_control;
+}
+
+// Parses an HTTP-date in the preferred IMF-fixdate format, e.g. "Sun, 06 Nov 1994 08:49:37 GMT".
+static Optional<time_t> parse_http_date(const StringView& value)
+{
+    static constexpr const char* month_names[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+
+    auto parts = value.split_view(' ');
+    if (parts.size() != 6 || parts[5] != "GMT")
+        return {};
+    auto time_parts = parts[4].split_view(':');
+    if (time_parts.size() != 3)
+        return {};
+
+    auto day = parts[1].to_uint();
+    auto year = parts[3].to_uint();
+    auto hour = time_parts[0].to_uint();
+    auto minute = time_parts[1].to_uint();
+    auto second = time_parts[2].to_uint();
+    if (!day.has_value() || !year.has_value() || !hour.has_value() || !minute.has_value() || !second.has_value())
+        return {};
+
+    for (int month = 0; month < 12; ++month) {
+        if (parts[2] != month_names[month])
+            continue;
+        struct tm tm {};
+        tm.tm_year = year.value() - 1900;
+        tm.tm_mon = month;
+        tm.tm_mday = day.value();
+        tm.tm_hour = hour.value();
+        tm.tm_min = minute.value();
+        tm.tm_sec = second.value();
+        return timegm(&tm);
+    }
+    return {};
+}
+
+static time_t freshness_lifetime(const HashMap<String, String, CaseInsensitiveStringTraits>& headers, time_t response_time)
+{
+    if (auto cache_control = headers.get("Cache-Control"); cache_control.has_value()) {
+        auto directives = parse_cache_control(cache_control.value());
+        if (directives.no_cache)
+            return 0;
+        if (directives.max_age.has_value())
+            return directives.max_age.value();
+    }
+
+    auto date = response_time;
+    if (auto date_header = headers.get("Date"); date_header.has_value())
+        date = parse_http_date(date_header.value()).value_or(response_time);
+
+    if (auto expires = headers.get("Expires"); expires.has_value()) {
+        // An invalid date, such as "0", means that the response has already expired.
+        auto expiry = parse_http_date(expires.value());
+        if (!expiry.has_value() || expiry.value() <= date)
+            return 0;
+        return expiry.value() - date;
+    }
+
+    if (auto last_modified_header = headers.get("Last-Modified"); last_modified_header.has_value()) {
+        auto last_modified = parse_http_date(last_modified_header.value());
+        if (last_modified.has_value() && last_modified.value() < date)
+            return min((date - last_modified.value()) / 10, max_heuristic_freshness_lifetime);
+    }
+
+    return heuristic_freshness_lifetime;
+}
+
+static bool uses_http(const URL& url)
+{
+    return url.protocol() == "http" || url.protocol() == "https";
+}
+
+ResourceCache::ResourceCache(size_t capacity)
+    : m_capacity(capacity)
+{
+}
+
+bool ResourceCache::is_cacheable(const LoadRequest& request)
+{
+    return request.method() == "GET" && request.url().protocol() != "file";
+}
+
+ResourceCache::Entry* ResourceCache::find(const LoadRequest& request)
+{
+    auto it = m_entries.find(request);
+    if (it == m_entries.end())
+        return nullptr;
+    m_lru_list.append(*it->value);
+    return it->value.ptr();
+}
+
+ResourceCache::Entry& ResourceCache::add(const LoadRequest& request, NonnullRefPtr<Resource> resource)
+{
+    remove(request);
+    auto entry = make<Entry>(Entry { request, move(resource), 0, 0, {} });
+    auto& entry_ref = *entry;
+    m_lru_list.append(entry_ref);
+    m_entries.set(request, move(entry));
+    return entry_ref;
+}
+
+void ResourceCache::remove(const LoadRequest& request)
+{
+    auto it = m_entries.find(request);
+    if (it == m_entries.end())
+        return;
+    m_size -= it->value->size;
+    m_entries.remove(it);
+}
+
+void ResourceCache::did_finish_loading(const LoadRequest& request, const Resource& resource, Optional<u32> status_code, Optional<time_t> stored_response_time)
+{
+    auto it = m_entries.find(request);
+    if (it == m_entries.end() || it->value->resource.ptr() != &resource)
+        return;
+    auto& entry = *it->value;
+
+    bool is_storable = resource.is_loaded() && (!status_code.has_value() || status_code.value() == 200);
+    if (auto cache_control = resource.response_headers().get("Cache-Control"); cache_control.has_value())
+        is_storable &= !parse_cache_control(cache_control.value()).no_store;
+
+    size_t size = resource.encoded_data().size();
+    for (auto& header : resource.response_headers())
+        size += header.key.length() + header.value.length();
+
+    // Don't let a single huge response flush everything else out of the cache.
+    if (!is_storable || size > m_capacity / 4) {
+        dbgln<CACHE_DEBUG>("ResourceCache: Not keeping {} ({} bytes, status {})", request.url(), size, status_code.value_or(0));
+        remove(request);
+        if constexpr (CACHE_DEBUG)
+            dump_statistics();
+        return;
+    }
+
+    entry.response_time = stored_response_time.value_or(time(nullptr));
+    entry.size = size;
+    m_size += size;
+
+    if (!stored_response_time.has_value() && !m_disk_store_path.is_null() && uses_http(request.url()) && request.headers().is_empty())
+        write_to_disk(entry);
+
+    evict_if_needed();
+
+    if constexpr (CACHE_DEBUG)
+        dump_statistics();
+}
+
+void ResourceCache::evict_if_needed()
+{
+    while (m_size > m_capacity) {
+        // Entries that are still loading don't take up any space yet, so skip over them.
+        Entry* victim = nullptr;
+        for (auto& entry : m_lru_list) {
+            if (entry.size) {
+                victim = &entry;
+                break;
+            }
+        }
+        if (!victim)
+            break;
+        dbgln<CACHE_DEBUG>("ResourceCache: Evicting {} ({} bytes)", victim->request.url(), victim->size);
+        ++m_statistics.evictions;
+        remove(victim->request);
+    }
+}
+
+bool ResourceCache::is_fresh(const Entry& entry) const
+{
+    // Responses from data:, about: and gemini: URLs never change during the lifetime of the cache.
+    if (!uses_http(entry.request.url()))
+        return true;
+
+    auto& headers = entry.resource->response_headers();
+    time_t age = max(time(nullptr) - entry.response_time, (time_t)0);
+    if (auto age_header = headers.get("Age"); age_header.has_value())
+        age += age_header.value().to_uint<u64>().value_or(0);
+
+    return age < freshness_lifetime(headers, entry.response_time);
+}
+
+bool ResourceCache::has_validators(const Resource& resource)
+{
+    return resource.response_headers().contains("ETag") || resource.response_headers().contains("Last-Modified");
+}
+
+void ResourceCache::add_validators(LoadRequest& request, const Resource& resource)
+{
+    if (auto etag = resource.response_headers().get("ETag"); etag.has_value())
+        request.set_header("If-None-Match", etag.value());
+    if (auto last_modified = resource.response_headers().get("Last-Modified"); last_modified.has_value())
+        request.set_header("If-Modified-Since", last_modified.value());
+}
+
+void ResourceCache::set_disk_store_path(const String& path)
+{
+    if (mkdir(path.characters(), 0700) < 0 && errno != EEXIST) {
+        perror("ResourceCache: mkdir");
+        return;
+    }
+
+    // If it already existed, somebody else may have put it there for us to read their responses from.
+    struct stat st;
+    if (lstat(path.characters(), &st) < 0) {
+        perror("ResourceCache: lstat");
+        return;
+    }
+    if (!S_ISDIR(st.st_mode) || st.st_uid != getuid() || (st.st_mode & 077)) {
+        dbgln("ResourceCache: Not using {} as the disk store, it must be a directory only we have access to", path);
+        return;
+    }
+    m_disk_store_path = path;
+}
+
+String ResourceCache::disk_path_for(const LoadRequest& request) const
+{
+    // Collisions are harmless, the URL stored in the file is checked when reading it back.
+    return String::formatted("{}/{:08x}", m_disk_store_path, request.hash());
+}
+
+// The on-disk format is a small text header followed by the raw response body:
+//
+//     LibWeb-cache 1
+//     <url>
+//     <response time>
+//     <header name>: <header value>
+//     ...
+//     <empty line>
+//     <body>
+void ResourceCache::write_to_disk(const Entry& entry) const
+{
+    StringBuilder builder;
+    builder.append(disk_store_magic);
+    builder.append('\n');
+    builder.appendff("{}\n{}\n", entry.request.url(), (u64)entry.response_time);
+    for (auto& header : entry.resource->response_headers())
+        builder.appendff("{}: {}\n", header.key, header.value);
+    builder.append('\n');
+
+    // Write to a temporary file first, so that other processes never see a partially written response.
+    auto path = disk_path_for(entry.request);
+    auto temporary_path = String::formatted("{}.{}", path, getpid());
+    auto file_or_error = Core::File::open(temporary_path, Core::IODevice::WriteOnly, 0600);
+    if (file_or_error.is_error()) {
+        dbgln<CACHE_DEBUG>("ResourceCache: Failed to open {}: {}", temporary_path, file_or_error.error());
+        return;
+    }
+    auto& file = *file_or_error.value();
+    auto& data = entry.resource->encoded_data();
+    if (!file.write(builder.string_view()) || !file.write(data.data(), data.size())) {
+        file.close();
+        unlink(temporary_path.characters());
+        return;
+    }
+    file.close();
+
+    if (rename(temporary_path.characters(), path.characters()) < 0)
+        unlink(temporary_path.characters());
+}
+
+Optional<ResourceCache::StoredResponse> ResourceCache::read_from_disk(const LoadRequest& request) const
+{
+    if (m_disk_store_path.is_null() || !uses_http(request.url()) || !request.headers().is_empty())
+        return {};
+
+    auto file_or_error = Core::File::open(disk_path_for(request), Core::IODevice::ReadOnly);
+    if (file_or_error.is_error())
+        return {};
+    auto data = file_or_error.value()->read_all();
+    StringView contents { data.data(), data.size() };
+
+    size_t offset = 0;
+    auto next_line = [&]() -> Optional<StringView> {
+        for (size_t i = offset; i < contents.length(); ++i) {
+            if (contents[i] == '\n') {
+                auto line = contents.substring_view(offset, i - offset);
+                offset = i + 1;
+                return line;
+            }
+        }
+        return {};
+    };
+
+    auto magic = next_line();
+    auto url = next_line();
+    auto response_time = next_line();
+    if (!magic.has_value() || magic.value() != disk_store_magic || !url.has_value() || url.value() != request.url().to_string() || !response_time.has_value())
+        return {};
+
+    StoredResponse response;
+    auto time = response_time.value().to_uint<u64>();
+    if (!time.has_value())
+        return {};
+    response.response_time = time.value();
+
+    for (;;) {
+        auto line = next_line();
+        if (!line.has_value())
+            return {};
+        if (line.value().is_empty())
+            break;
+        auto colon = line.value().find_first_of(':');
+        if (!colon.has_value())
+            return {};
+        response.headers.set(line.value().substring_view(0, colon.value()), line.value().substring_view(colon.value() + 1).trim_whitespace());
+    }
+
+    response.body = ByteBuffer::copy(contents.substring_view(offset).bytes());
+    return response;
+}
+
+void ResourceCache::dump_statistics() const
+{
+    auto lookups = m_statistics.hits + m_statistics.disk_hits + m_statistics.misses + m_statistics.revalidations;
+    dbgln("ResourceCache: {} entries, {}/{} bytes, {} lookups: {} hits, {} disk hits, {} misses, {} revalidations ({} not modified), {} evictions, {}% hit rate",
+        m_entries.size(), m_size, m_capacity, lookups,
+        m_statistics.hits, m_statistics.disk_hits, m_statistics.misses,
+        m_statistics.revalidations, m_statistics.not_modified, m_statistics.evictions,
+        lookups ? (m_statistics.hits + m_statistics.disk_hits + m_statistics.not_modified) * 100 / lookups : 0);
+}
+
+}
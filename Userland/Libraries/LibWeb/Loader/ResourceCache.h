@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <LibWeb/Loader/LoadRequest.h>
+#include <LibWeb/Loader/Resource.h>
+#include <time.h>
+
+namespace Web {
+
+// A size-bounded, least-recently-used cache of loaded resources, following the
+// HTTP caching rules (Cache-Control, Expires, ETag and Last-Modified) to decide
+// when a cached response may be reused and when it has to be revalidated.
+// Responses can optionally be mirrored to a directory on disk, so that they are
+// shared between processes and survive a restart.
+class ResourceCache {
+public:
+    static constexpr size_t default_capacity = 32 * MiB;
+
+    struct Entry {
+        LoadRequest request;
+        NonnullRefPtr<Resource> resource;
+        time_t response_time { 0 };
+        size_t size { 0 };
+        IntrusiveListNode lru_list_node;
+    };
+
+    struct StoredResponse {
+        time_t response_time { 0 };
+        HashMap<String, String, CaseInsensitiveStringTraits> headers;
+        ByteBuffer body;
+    };
+
+    struct Statistics {
+        size_t hits { 0 };
+        size_t disk_hits { 0 };
+        size_t misses { 0 };
+        size_t revalidations { 0 };
+        size_t not_modified { 0 };
+        size_t evictions { 0 };
+    };
+
+    explicit ResourceCache(size_t capacity = default_capacity);
+
+    static bool is_cacheable(const LoadRequest&);
+
+    // Returns the entry for this request and marks it as the most recently used one.
+    Entry* find(const LoadRequest&);
+    Entry& add(const LoadRequest&, NonnullRefPtr<Resource>);
+    void remove(const LoadRequest&);
+
+    // Called once a resource that was added while still loading has finished or failed. Responses that
+    // were read back from disk pass their original response time, and aren't written out again.
+    void did_finish_loading(const LoadRequest&, const Resource&, Optional<u32> status_code, Optional<time_t> stored_response_time = {});
+
+    bool is_fresh(const Entry&) const;
+    static bool has_validators(const Resource&);
+    static void add_validators(LoadRequest&, const Resource&);
+
+    void set_disk_store_path(const String&);
+    Optional<StoredResponse> read_from_disk(const LoadRequest&) const;
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+
+    Statistics& statistics() { return m_statistics; }
+    void dump_statistics() const;
+
+private:
+    void evict_if_needed();
+    void write_to_disk(const Entry&) const;
+    String disk_path_for(const LoadRequest&) const;
+
+    HashMap<LoadRequest, NonnullOwnPtr<Entry>> m_entries;
+    IntrusiveList<Entry, &Entry::lru_list_node> m_lru_list;
+    size_t m_size { 0 };
+    size_t m_capacity { 0 };
+    String m_disk_store_path;
+    Statistics m_statistics;
+};
+
+}
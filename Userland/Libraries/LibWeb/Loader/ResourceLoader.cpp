@@ -52,14 +52,14 @@ ResourceLoader::ResourceLoader()
 {
 }
 
-void ResourceLoader::load_sync(const URL& url, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers)> success_callback, Function<void(const String&)> error_callback)
+void ResourceLoader::load_sync(const URL& url, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&)> error_callback)
 {
     Core::EventLoop loop;
 
     load(
         url,
-        [&](auto data, auto& response_headers) {
-            success_callback(data, response_headers);
+        [&](auto data, auto& response_headers, auto status_code) {
+            success_callback(data, response_headers, status_code);
             loop.quit(0);
         },
         [&](auto& string) {
@@ -71,45 +71,110 @@ void ResourceLoader::load_sync(const URL& url, Function<void(ReadonlyBytes, cons
     loop.exec();
 }
 
-static HashMap<LoadRequest, NonnullRefPtr<Resource>> s_resource_cache;
-
 RefPtr<Resource> ResourceLoader::load_resource(Resource::Type type, const LoadRequest& request)
 {
     if (!request.is_valid())
         return nullptr;
 
-    bool use_cache = request.url().protocol() != "file";
+    if (!ResourceCache::is_cacheable(request)) {
+        auto resource = Resource::create({}, type, request);
+        load(
+            request,
+            [=](auto data, auto& headers, auto) {
+                const_cast<Resource&>(*resource).did_load({}, data, headers);
+            },
+            [=](auto& error) {
+                const_cast<Resource&>(*resource).did_fail({}, error);
+            });
+        return resource;
+    }
+
+    if (auto* entry = m_cache.find(request)) {
+        if (entry->resource->type() != type) {
+            dbgln("FIXME: Not using cached resource for {} since there's a type mismatch.", request.url());
+        } else if (!entry->resource->is_loaded() || m_cache.is_fresh(*entry)) {
+            // Resources that are still loading are shared as well, so that we only ever fetch them once.
+            dbgln<CACHE_DEBUG>("Reusing cached resource for: {}", request.url());
+            ++m_cache.statistics().hits;
+            return entry->resource;
+        } else if (ResourceCache::has_validators(*entry->resource)) {
+            return revalidate_resource(type, request, entry->resource);
+        }
+    } else if (auto stored_response = m_cache.read_from_disk(request); stored_response.has_value()) {
+        auto resource = Resource::create({}, type, request);
+        resource->did_load({}, stored_response->body, stored_response->headers);
+        m_cache.add(request, resource);
+        m_cache.did_finish_loading(request, *resource, {}, stored_response->response_time);
 
-    if (use_cache) {
-        auto it = s_resource_cache.find(request);
-        if (it != s_resource_cache.end()) {
-            if (it->value->type() != type) {
-                dbgln("FIXME: Not using cached resource for {} since there's a type mismatch.", request.url());
-            } else {
-                dbgln<CACHE_DEBUG>("Reusing cached resource for: {}", request.url());
-                return it->value;
-            }
+        auto* stored_entry = m_cache.find(request);
+        if (stored_entry && m_cache.is_fresh(*stored_entry)) {
+            dbgln<CACHE_DEBUG>("Reusing resource stored on disk for: {}", request.url());
+            ++m_cache.statistics().disk_hits;
+            return resource;
         }
+        if (ResourceCache::has_validators(*resource))
+            return revalidate_resource(type, request, resource);
     }
 
-    auto resource = Resource::create({}, type, request);
+    ++m_cache.statistics().misses;
 
-    if (use_cache)
-        s_resource_cache.set(request, resource);
+    auto resource = Resource::create({}, type, request);
+    m_cache.add(request, resource);
 
     load(
         request,
-        [=](auto data, auto& headers) {
+        [this, request, resource](auto data, auto& headers, auto status_code) {
+            const_cast<Resource&>(*resource).did_load({}, data, headers);
+            m_cache.did_finish_loading(request, *resource, status_code);
+        },
+        [this, request, resource](auto& error) {
+            const_cast<Resource&>(*resource).did_fail({}, error);
+            m_cache.did_finish_loading(request, *resource, {});
+        });
+
+    return resource;
+}
+
+RefPtr<Resource> ResourceLoader::revalidate_resource(Resource::Type type, const LoadRequest& request, NonnullRefPtr<Resource> cached_resource)
+{
+    dbgln<CACHE_DEBUG>("Revalidating cached resource for: {}", request.url());
+    ++m_cache.statistics().revalidations;
+
+    LoadRequest conditional_request = request;
+    ResourceCache::add_validators(conditional_request, *cached_resource);
+
+    // The new resource replaces the stale one in the cache right away, so that anyone asking
+    // for it while we're waiting for the server shares this revalidation.
+    auto resource = Resource::create({}, type, request);
+    m_cache.add(request, resource);
+
+    load(
+        conditional_request,
+        [this, request, resource, cached_resource](auto data, auto& headers, auto status_code) {
+            if (status_code.has_value() && status_code.value() == 304) {
+                dbgln<CACHE_DEBUG>("Cached resource for {} was not modified", request.url());
+                ++m_cache.statistics().not_modified;
+                auto updated_headers = cached_resource->response_headers();
+                for (auto& header : headers) {
+                    if (!header.key.equals_ignoring_case("Content-Length"))
+                        updated_headers.set(header.key, header.value);
+                }
+                const_cast<Resource&>(*resource).did_load({}, cached_resource->encoded_data(), updated_headers);
+                m_cache.did_finish_loading(request, *resource, 200);
+                return;
+            }
             const_cast<Resource&>(*resource).did_load({}, data, headers);
+            m_cache.did_finish_loading(request, *resource, status_code);
         },
-        [=](auto& error) {
+        [this, request, resource](auto& error) {
             const_cast<Resource&>(*resource).did_fail({}, error);
+            m_cache.did_finish_loading(request, *resource, {});
         });
 
     return resource;
 }
 
-void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers)> success_callback, Function<void(const String&)> error_callback)
+void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&)> error_callback)
 {
     auto& url = request.url();
 
@@ -127,7 +192,7 @@ void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyByte
     if (url.protocol() == "about") {
         dbgln("Loading about: URL {}", url);
         deferred_invoke([success_callback = move(success_callback)](auto&) {
-            success_callback(String::empty().to_byte_buffer(), {});
+            success_callback(String::empty().to_byte_buffer(), {}, {});
         });
         return;
     }
@@ -145,7 +210,7 @@ void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyByte
             data = url.data_payload().to_byte_buffer();
 
         deferred_invoke([data = move(data), success_callback = move(success_callback)](auto&) {
-            success_callback(data, {});
+            success_callback(data, {}, {});
         });
         return;
     }
@@ -162,7 +227,7 @@ void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyByte
 
         auto data = f->read_all();
         deferred_invoke([data = move(data), success_callback = move(success_callback)](auto&) {
-            success_callback(data, {});
+            success_callback(data, {}, {});
         });
         return;
     }
@@ -200,7 +265,7 @@ void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyByte
                 // Clear circular reference of `download` captured by copy
                 const_cast<Protocol::Download&>(*download).on_buffered_download_finish = nullptr;
             });
-            success_callback(payload, response_headers);
+            success_callback(payload, response_headers, status_code);
         };
         download->set_should_buffer_all_input(true);
         download->on_certificate_requested = []() -> Protocol::Download::CertificateAndKey {
@@ -216,7 +281,7 @@ void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyByte
         error_callback(String::formatted("Protocol not implemented: {}", url.protocol()));
 }
 
-void ResourceLoader::load(const URL& url, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers)> success_callback, Function<void(const String&)> error_callback)
+void ResourceLoader::load(const URL& url, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&)> error_callback)
 {
     LoadRequest request;
     request.set_url(url);
@@ -30,6 +30,7 @@
 #include <AK/URL.h>
 #include <LibCore/Object.h>
 #include <LibWeb/Loader/Resource.h>
+#include <LibWeb/Loader/ResourceCache.h>
 
 namespace Protocol {
 class Client;
@@ -44,9 +45,9 @@ public:
 
     RefPtr<Resource> load_resource(Resource::Type, const LoadRequest&);
 
-    void load(const LoadRequest&, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers)> success_callback, Function<void(const String&)> error_callback = nullptr);
-    void load(const URL&, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers)> success_callback, Function<void(const String&)> error_callback = nullptr);
-    void load_sync(const URL&, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers)> success_callback, Function<void(const String&)> error_callback = nullptr);
+    void load(const LoadRequest&, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&)> error_callback = nullptr);
+    void load(const URL&, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&)> error_callback = nullptr);
+    void load_sync(const URL&, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&)> error_callback = nullptr);
 
     Function<void()> on_load_counter_change;
 
@@ -56,14 +57,19 @@ public:
 
     const String& user_agent() const { return m_user_agent; }
 
+    ResourceCache& cache() { return m_cache; }
+
 private:
     ResourceLoader();
     static bool is_port_blocked(int port);
 
+    RefPtr<Resource> revalidate_resource(Resource::Type, const LoadRequest&, NonnullRefPtr<Resource> cached_resource);
+
     int m_pending_loads { 0 };
 
     RefPtr<Protocol::Client> m_protocol_client;
     String m_user_agent;
+    ResourceCache m_cache;
 };
 
 }
@@ -110,8 +110,11 @@ void Frame::set_size(const Gfx::IntSize& size)
     if (m_size == size)
         return;
     m_size = size;
-    if (m_document)
+    if (m_document) {
+        if (auto* layout_root = m_document->layout_node())
+            layout_root->set_needs_layout();
         m_document->update_layout();
+    }
 
     for (auto* client : m_viewport_clients)
         client->frame_did_set_viewport_rect(viewport_rect());
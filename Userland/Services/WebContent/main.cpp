@@ -24,18 +24,24 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <AK/String.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/LocalServer.h>
 #include <LibIPC/ClientConnection.h>
+#include <LibWeb/Loader/ResourceLoader.h>
 #include <WebContent/ClientConnection.h>
+#include <unistd.h>
 
 int main(int, char**)
 {
     Core::EventLoop event_loop;
-    if (pledge("stdio recvfd sendfd accept unix rpath", nullptr) < 0) {
+    if (pledge("stdio recvfd sendfd accept unix rpath wpath cpath", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
+    // Every WebContent process of the same user shares the same on-disk resource cache.
+    auto disk_cache_path = String::formatted("/tmp/webcache-{}", getuid());
+    Web::ResourceLoader::the().cache().set_disk_store_path(disk_cache_path);
     if (unveil("/res", "r") < 0) {
         perror("unveil");
         return 1;
@@ -48,6 +54,10 @@ int main(int, char**)
         perror("unveil");
         return 1;
     }
+    if (unveil(disk_cache_path.characters(), "rwc") < 0) {
+        perror("unveil");
+        return 1;
+    }
     if (unveil(nullptr, nullptr) < 0) {
         perror("unveil");
         return 1;
@@ -37,7 +37,9 @@
 #include <LibCore/FileStream.h>
 #include <LibCore/MimeData.h>
 #include <LibHTTP/HttpRequest.h>
+#include <errno.h>
 #include <stdio.h>
+#include <sys/sendfile.h>
 #include <sys/stat.h>
 #include <time.h>
 #include <unistd.h>
@@ -127,12 +129,40 @@ void Client::handle_request(ReadonlyBytes raw_request)
         return;
     }
 
-    Core::InputFileStream stream { file };
+    send_file_response(file, request, Core::guess_mime_type_based_on_filename(real_path));
+}
+
+void Client::send_file_response(Core::File& file, const HTTP::HttpRequest& request, const String& content_type)
+{
+    send_response_header(request, content_type);
+
+    // Let the kernel move the file contents straight into the socket.
+    bool sent_anything = false;
+    for (;;) {
+        auto nsent = sendfile(m_socket->fd(), file.fd(), nullptr, 1 * MiB);
+        if (nsent == 0)
+            return;
+        if (nsent < 0)
+            break;
+        sent_anything = true;
+    }
 
-    send_response(stream, request, Core::guess_mime_type_based_on_filename(real_path));
+    // sendfile() only reads from regular files, so copy anything else the old-fashioned way.
+    if (errno != EINVAL || sent_anything) {
+        perror("sendfile");
+        return;
+    }
+    Core::InputFileStream stream { file };
+    send_response_body(stream);
 }
 
 void Client::send_response(InputStream& response, const HTTP::HttpRequest& request, const String& content_type)
+{
+    send_response_header(request, content_type);
+    send_response_body(response);
+}
+
+void Client::send_response_header(const HTTP::HttpRequest& request, const String& content_type)
 {
     StringBuilder builder;
     builder.append("HTTP/1.0 200 OK\r\n");
@@ -144,7 +174,10 @@ void Client::send_response(InputStream& response, const HTTP::HttpRequest& reque
 
     m_socket->write(builder.to_string());
     log_response(200, request);
+}
 
+void Client::send_response_body(InputStream& response)
+{
     char buffer[PAGE_SIZE];
     do {
         auto size = response.read({ buffer, sizeof(buffer) });
@@ -31,6 +31,7 @@
 #include <LibCore/ElapsedTimer.h>
 #include <fcntl.h>
 #include <getopt.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -59,11 +60,11 @@ static Result average_result(const Vector<Result>& results)
 
 static void exit_with_usage(int rc)
 {
-    fprintf(stderr, "Usage: disk_benchmark [-h] [-d directory] [-t time_per_benchmark] [-f file_size1,file_size2,...] [-b block_size1,block_size2,...]\n");
+    fprintf(stderr, "Usage: disk_benchmark [-h] [-d directory] [-t time_per_benchmark] [-f file_size1,file_size2,...] [-b block_size1,block_size2,...] [-j reader_threads]\n");
     exit(rc);
 }
 
-static Result benchmark(const String& filename, int file_size, int block_size, ByteBuffer& buffer, bool allow_cache);
+static Result benchmark(const String& filename, int file_size, int block_size, ByteBuffer& buffer, bool allow_cache, int reader_threads);
 
 int main(int argc, char** argv)
 {
@@ -72,9 +73,10 @@ int main(int argc, char** argv)
     Vector<int> file_sizes;
     Vector<int> block_sizes;
     bool allow_cache = false;
+    int reader_threads = 1;
 
     int opt;
-    while ((opt = getopt(argc, argv, "chd:t:f:b:")) != -1) {
+    while ((opt = getopt(argc, argv, "chd:t:f:b:j:")) != -1) {
         switch (opt) {
         case 'h':
             exit_with_usage(0);
@@ -96,6 +98,11 @@ int main(int argc, char** argv)
             for (auto size : String(optarg).split(','))
                 block_sizes.append(atoi(size.characters()));
             break;
+        case 'j':
+            reader_threads = atoi(optarg);
+            if (reader_threads < 1)
+                exit_with_usage(1);
+            break;
         }
     }
 
@@ -119,13 +126,13 @@ int main(int argc, char** argv)
 
             Vector<Result> results;
 
-            printf("Running: file_size=%d block_size=%d\n", file_size, block_size);
+            printf("Running: file_size=%d block_size=%d reader_threads=%d\n", file_size, block_size, reader_threads);
             Core::ElapsedTimer timer;
             timer.start();
             while (timer.elapsed() < time_per_benchmark * 1000) {
                 printf(".");
                 fflush(stdout);
-                results.append(benchmark(filename, file_size, block_size, buffer, allow_cache));
+                results.append(benchmark(filename, file_size, block_size, buffer, allow_cache, reader_threads));
                 usleep(100);
             }
             auto average = average_result(results);
@@ -141,7 +148,63 @@ int main(int argc, char** argv)
     }
 }
 
-Result benchmark(const String& filename, int file_size, int block_size, ByteBuffer& buffer, bool allow_cache)
+struct Reader {
+    pthread_t thread;
+    int fd;
+    int file_size;
+    int block_size;
+    int first_offset;
+    int stride;
+    ByteBuffer buffer;
+    bool failed { false };
+};
+
+static void* reader_thread(void* argument)
+{
+    auto& reader = *static_cast<Reader*>(argument);
+    for (int offset = reader.first_offset; offset < reader.file_size; offset += reader.stride) {
+        if (pread(reader.fd, reader.buffer.data(), reader.block_size, offset) < 0) {
+            perror("pread");
+            reader.failed = true;
+            break;
+        }
+    }
+    return nullptr;
+}
+
+// Reads the file with several threads at once, each one taking every reader_threads-th block.
+// pread() doesn't touch the shared file offset, so the readers don't have to coordinate.
+static bool read_with_threads(int fd, int file_size, int block_size, int reader_threads)
+{
+    Vector<Reader> readers;
+    readers.resize(reader_threads);
+    for (int i = 0; i < reader_threads; ++i) {
+        auto& reader = readers[i];
+        reader.fd = fd;
+        reader.file_size = file_size;
+        reader.block_size = block_size;
+        reader.first_offset = i * block_size;
+        reader.stride = reader_threads * block_size;
+        reader.buffer = ByteBuffer::create_uninitialized(block_size);
+    }
+
+    for (auto& reader : readers) {
+        if (pthread_create(&reader.thread, nullptr, reader_thread, &reader) != 0) {
+            perror("pthread_create");
+            exit(1);
+        }
+    }
+
+    bool success = true;
+    for (auto& reader : readers) {
+        pthread_join(reader.thread, nullptr);
+        if (reader.failed)
+            success = false;
+    }
+    return success;
+}
+
+Result benchmark(const String& filename, int file_size, int block_size, ByteBuffer& buffer, bool allow_cache, int reader_threads)
 {
     int flags = O_CREAT | O_TRUNC | O_RDWR;
     if (!allow_cache)
@@ -182,14 +245,19 @@ Result benchmark(const String& filename, int file_size, int block_size, ByteBuff
     }
 
     timer.start();
-    int nread = 0;
-    while (nread < file_size) {
-        int n = read(fd, buffer.data(), block_size);
-        if (n < 0) {
-            perror("read");
+    if (reader_threads > 1) {
+        if (!read_with_threads(fd, file_size, block_size, reader_threads))
             cleanup_and_exit();
+    } else {
+        int nread = 0;
+        while (nread < file_size) {
+            int n = read(fd, buffer.data(), block_size);
+            if (n < 0) {
+                perror("read");
+                cleanup_and_exit();
+            }
+            nread += n;
         }
-        nread += n;
     }
 
     res.read_bps = (u64)(timer.elapsed() ? (file_size / timer.elapsed()) : file_size) * 1000;
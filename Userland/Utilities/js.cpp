@@ -33,6 +33,7 @@
 #include <LibCore/File.h>
 #include <LibCore/StandardPaths.h>
 #include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
 #include <LibJS/Console.h>
 #include <LibJS/Interpreter.h>
 #include <LibJS/Parser.h>
@@ -78,6 +79,7 @@ private:
 };
 
 static bool s_dump_ast = false;
+static bool s_dump_bytecode = false;
 static bool s_print_last_result = false;
 static RefPtr<Line::Editor> s_editor;
 static String s_history_path = String::formatted("{}/.js-history", Core::StandardPaths::home_directory());
@@ -457,6 +459,13 @@ static bool parse_and_run(JS::Interpreter& interpreter, const StringView& source
     if (s_dump_ast)
         program->dump(0);
 
+    if (s_dump_bytecode && !parser.has_errors()) {
+        if (auto* executable = program->bytecode_executable())
+            executable->dump();
+        else
+            outln("Program could not be compiled to bytecode");
+    }
+
     if (parser.has_errors()) {
         auto error = parser.errors()[0];
         auto hint = error.source_location_hint(source);
@@ -667,14 +676,19 @@ public:
 int main(int argc, char** argv)
 {
     bool gc_on_every_allocation = false;
+    bool print_gc_statistics = false;
     bool disable_syntax_highlight = false;
+    bool use_bytecode = false;
     const char* script_path = nullptr;
 
     Core::ArgsParser args_parser;
     args_parser.set_general_help("This is a JavaScript interpreter.");
     args_parser.add_option(s_dump_ast, "Dump the AST", "dump-ast", 'A');
+    args_parser.add_option(use_bytecode, "Run scripts using the bytecode interpreter", "bytecode", 'b');
+    args_parser.add_option(s_dump_bytecode, "Dump the bytecode generated for the program", "dump-bytecode", 'd');
     args_parser.add_option(s_print_last_result, "Print last result", "print-last-result", 'l');
     args_parser.add_option(gc_on_every_allocation, "GC on every allocation", "gc-on-every-allocation", 'g');
+    args_parser.add_option(print_gc_statistics, "Print GC statistics after running the script", "gc-statistics", 'G');
     args_parser.add_option(disable_syntax_highlight, "Disable live syntax highlighting", "no-syntax-highlight", 's');
     args_parser.add_positional_argument(script_path, "Path to script file", "script", Core::ArgsParser::Required::No);
     args_parser.parse(argc, argv);
@@ -682,6 +696,7 @@ int main(int argc, char** argv)
     bool syntax_highlight = !disable_syntax_highlight;
 
     vm = JS::VM::create();
+    vm->set_bytecode_enabled(use_bytecode);
     OwnPtr<JS::Interpreter> interpreter;
 
     interrupt_interpreter = [&] {
@@ -916,7 +931,10 @@ int main(int argc, char** argv)
             source = file_contents;
         }
 
-        if (!parse_and_run(*interpreter, source))
+        bool success = parse_and_run(*interpreter, source);
+        if (print_gc_statistics)
+            interpreter->heap().dump_statistics();
+        if (!success)
             return 1;
     }
 
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Stresses region bookkeeping in the kernel: every mmap/munmap inserts or removes a region,
+// and every first touch of a page takes a page fault that has to look up its region.
+
+static u32 s_random_state = 0x12345678;
+
+static u32 next_random()
+{
+    s_random_state ^= s_random_state << 13;
+    s_random_state ^= s_random_state >> 17;
+    s_random_state ^= s_random_state << 5;
+    return s_random_state;
+}
+
+static void report(const char* phase, int operations, i64 microseconds)
+{
+    printf("%-10s %8d ops %10lld us %8.2f us/op\n", phase, operations, microseconds, operations ? (double)microseconds / operations : 0.0);
+}
+
+int main(int argc, char** argv)
+{
+    int region_count = 4096;
+    int iterations = 4;
+    int pages_per_region = 1;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(region_count, "Number of regions to keep mapped", "regions", 'n', "count");
+    args_parser.add_option(iterations, "Number of unmap/remap rounds", "iterations", 'i', "count");
+    args_parser.add_option(pages_per_region, "Size of each region in pages", "pages", 'p', "count");
+    args_parser.parse(argc, argv);
+
+    if (region_count <= 0 || iterations < 0 || pages_per_region <= 0) {
+        args_parser.print_usage(stderr, argv[0]);
+        return 1;
+    }
+
+    size_t region_size = pages_per_region * PAGE_SIZE;
+    Vector<u8*> regions;
+    regions.resize(region_count);
+
+    auto map_region = [&](int index) {
+        auto* ptr = mmap(nullptr, region_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0);
+        if (ptr == MAP_FAILED) {
+            perror("mmap");
+            exit(1);
+        }
+        regions[index] = (u8*)ptr;
+    };
+
+    auto unmap_region = [&](int index) {
+        if (munmap(regions[index], region_size) < 0) {
+            perror("munmap");
+            exit(1);
+        }
+        regions[index] = nullptr;
+    };
+
+    Core::ElapsedTimer timer;
+
+    timer.start();
+    for (int i = 0; i < region_count; ++i)
+        map_region(i);
+    report("mmap", region_count, timer.elapsed_microseconds());
+
+    timer.start();
+    for (int i = 0; i < region_count; ++i) {
+        for (int page = 0; page < pages_per_region; ++page)
+            regions[i][page * PAGE_SIZE] = 1;
+    }
+    report("fault", region_count * pages_per_region, timer.elapsed_microseconds());
+
+    i64 unmap_time = 0;
+    i64 remap_time = 0;
+    i64 refault_time = 0;
+    int churned = 0;
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        // Punch holes at random places in the address space and fill them again.
+        Vector<int> victims;
+        Vector<bool> is_victim;
+        is_victim.resize(region_count);
+        is_victim.span().fill(false);
+        for (int i = 0; i < region_count / 2; ++i) {
+            auto index = next_random() % region_count;
+            if (is_victim[index])
+                continue;
+            is_victim[index] = true;
+            victims.append(index);
+        }
+
+        timer.start();
+        for (auto index : victims)
+            unmap_region(index);
+        unmap_time += timer.elapsed_microseconds();
+
+        timer.start();
+        for (auto index : victims)
+            map_region(index);
+        remap_time += timer.elapsed_microseconds();
+
+        timer.start();
+        for (auto index : victims)
+            regions[index][0] = 1;
+        refault_time += timer.elapsed_microseconds();
+
+        churned += victims.size();
+    }
+    report("munmap", churned, unmap_time);
+    report("remap", churned, remap_time);
+    report("refault", churned, refault_time);
+
+    timer.start();
+    for (int i = 0; i < region_count; ++i)
+        unmap_region(i);
+    report("teardown", region_count, timer.elapsed_microseconds());
+
+    return 0;
+}
@@ -28,6 +28,7 @@
 
 #include <AK/Array.h>
 #include <AK/MemoryStream.h>
+#include <AK/OwnPtr.h>
 #include <LibCompress/Deflate.h>
 #include <LibCompress/Gzip.h>
 #include <LibCompress/Zlib.h>
@@ -221,4 +222,151 @@ TEST_CASE(gzip_decompress_repeat_around_buffer)
     EXPECT(uncompressed == decompressed.value().bytes());
 }
 
+static ByteBuffer make_compressible_data(size_t size)
+{
+    // Text-like data with plenty of repetition at various distances, plus some noise.
+    static const char* words[] = { "deflate ", "inflate ", "window ", "huffman ", "literal ", "distance ", "length ", "block\n" };
+    auto buffer = ByteBuffer::create_uninitialized(size);
+    u32 state = 0x2545f491;
+    for (size_t i = 0; i < size;) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        if (state % 16 == 0) {
+            buffer[i++] = static_cast<u8>(state >> 8);
+            continue;
+        }
+        for (auto* word = words[state % 8]; *word && i < size; ++word)
+            buffer[i++] = *word;
+    }
+    return buffer;
+}
+
+static ByteBuffer make_random_data(size_t size)
+{
+    auto buffer = ByteBuffer::create_uninitialized(size);
+    u32 state = 0x12345678;
+    for (size_t i = 0; i < size; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        buffer[i] = static_cast<u8>(state >> 24);
+    }
+    return buffer;
+}
+
+static void expect_deflate_round_trip(ReadonlyBytes uncompressed)
+{
+    for (auto level : { Compress::DeflateCompressor::CompressionLevel::Store, Compress::DeflateCompressor::CompressionLevel::Fast, Compress::DeflateCompressor::CompressionLevel::Good, Compress::DeflateCompressor::CompressionLevel::Great, Compress::DeflateCompressor::CompressionLevel::Best }) {
+        const auto compressed = Compress::DeflateCompressor::compress_all(uncompressed, level);
+        EXPECT(compressed.has_value());
+        const auto decompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+        EXPECT(decompressed.has_value());
+        EXPECT(decompressed.value().bytes() == uncompressed);
+    }
+}
+
+TEST_CASE(deflate_round_trip_empty)
+{
+    expect_deflate_round_trip({});
+}
+
+TEST_CASE(deflate_round_trip_text)
+{
+    expect_deflate_round_trip(make_compressible_data(100 * KiB));
+}
+
+TEST_CASE(deflate_round_trip_zeroes)
+{
+    Array<u8, 100 * 1024> uncompressed {};
+    expect_deflate_round_trip(uncompressed);
+
+    const auto compressed = Compress::DeflateCompressor::compress_all(uncompressed);
+    EXPECT(compressed.value().size() < 1024);
+}
+
+TEST_CASE(deflate_round_trip_random)
+{
+    auto uncompressed = make_random_data(70 * KiB);
+    expect_deflate_round_trip(uncompressed);
+
+    // Incompressible data should fall back to stored blocks rather than grow.
+    const auto compressed = Compress::DeflateCompressor::compress_all(uncompressed);
+    EXPECT(compressed.value().size() < uncompressed.size() + 64);
+}
+
+TEST_CASE(deflate_compress_in_small_writes)
+{
+    auto uncompressed = make_compressible_data(80 * KiB);
+
+    DuplexMemoryStream output_stream;
+    auto deflate_stream = make<Compress::DeflateCompressor>(output_stream);
+    for (size_t offset = 0; offset < uncompressed.size(); offset += 1000)
+        EXPECT(deflate_stream->write_or_error(uncompressed.bytes().slice(offset, min<size_t>(1000, uncompressed.size() - offset))));
+    deflate_stream->final_flush();
+    EXPECT(!deflate_stream->handle_any_error());
+
+    const auto decompressed = Compress::DeflateDecompressor::decompress_all(output_stream.copy_into_contiguous_buffer());
+    EXPECT(decompressed.value().bytes() == uncompressed.bytes());
+}
+
+TEST_CASE(gzip_round_trip)
+{
+    auto uncompressed = make_compressible_data(50 * KiB);
+    const auto compressed = Compress::GzipCompressor::compress_all(uncompressed);
+    EXPECT(compressed.value()[0] == 0x1f && compressed.value()[1] == 0x8b);
+
+    const auto decompressed = Compress::GzipDecompressor::decompress_all(compressed.value());
+    EXPECT(decompressed.value().bytes() == uncompressed.bytes());
+}
+
+TEST_CASE(zlib_round_trip)
+{
+    auto uncompressed = make_compressible_data(50 * KiB);
+    const auto compressed = Compress::ZlibCompressor::compress_all(uncompressed);
+    EXPECT((compressed.value()[0] * 256 + compressed.value()[1]) % 31 == 0);
+
+    Compress::Zlib zlib { compressed.value() };
+    Crypto::Checksum::Adler32 adler32;
+    adler32.update(uncompressed);
+    EXPECT_EQ(zlib.checksum(), adler32.digest());
+
+    const auto decompressed = zlib.decompress();
+    EXPECT(decompressed.value().bytes() == uncompressed.bytes());
+}
+
+TEST_CASE(zlib_decompressor_in_small_reads)
+{
+    auto uncompressed = make_compressible_data(50 * KiB);
+    const auto compressed = Compress::ZlibCompressor::compress_all(uncompressed);
+
+    InputMemoryStream compressed_stream { compressed.value() };
+    Compress::ZlibDecompressor decompressor { compressed_stream };
+
+    auto decompressed = ByteBuffer::create_uninitialized(uncompressed.size());
+    for (size_t offset = 0; offset < decompressed.size(); offset += 1000)
+        decompressor.read(decompressed.bytes().slice(offset, min<size_t>(1000, decompressed.size() - offset)));
+
+    // The end of the stream, and with it the checksum, is only seen once we try to read past it.
+    u8 byte;
+    EXPECT_EQ(decompressor.read({ &byte, sizeof(byte) }), 0u);
+    EXPECT(!decompressor.has_any_error());
+    EXPECT(decompressor.unreliable_eof());
+    EXPECT(decompressed.bytes() == uncompressed.bytes());
+}
+
+TEST_CASE(zlib_decompressor_checksum_mismatch)
+{
+    auto uncompressed = make_compressible_data(1 * KiB);
+    auto compressed = Compress::ZlibCompressor::compress_all(uncompressed).value();
+    compressed[compressed.size() - 1] ^= 1;
+
+    InputMemoryStream compressed_stream { compressed };
+    Compress::ZlibDecompressor decompressor { compressed_stream };
+
+    u8 buffer[2 * KiB];
+    decompressor.read({ buffer, sizeof(buffer) });
+    EXPECT(decompressor.handle_any_error());
+}
+
 TEST_MAIN(Compress)
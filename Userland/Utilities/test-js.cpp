@@ -707,12 +707,14 @@ int main(int argc, char** argv)
 
     bool print_times = false;
     bool test262_parser_tests = false;
+    bool use_bytecode = false;
     const char* specified_test_root = nullptr;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(print_times, "Show duration of each test", "show-time", 't');
     args_parser.add_option(collect_on_every_allocation, "Collect garbage after every allocation", "collect-often", 'g');
     args_parser.add_option(test262_parser_tests, "Run test262 parser tests", "test262-parser-tests", 0);
+    args_parser.add_option(use_bytecode, "Run tests using the bytecode interpreter", "bytecode", 'b');
     args_parser.add_positional_argument(specified_test_root, "Tests root directory", "path", Core::ArgsParser::Required::No);
     args_parser.parse(argc, argv);
 
@@ -753,6 +755,7 @@ int main(int argc, char** argv)
     }
 
     vm = JS::VM::create();
+    vm->set_bytecode_enabled(use_bytecode);
 
     if (test262_parser_tests)
         Test262ParserTestRunner(test_root, print_times).run();
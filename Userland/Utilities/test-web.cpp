@@ -239,7 +239,7 @@ void TestRunner::run()
 
         Web::ResourceLoader::the().load_sync(
             page_to_load,
-            [&](auto data, auto&) {
+            [&](auto data, auto&, auto) {
                 Web::HTML::HTMLDocumentParser parser(*m_page_view->document(), data, "utf-8");
                 parser.run(page_to_load);
             },
@@ -348,7 +348,7 @@ JSFileResult TestRunner::run_file_test(const String& test_path)
 
     Web::ResourceLoader::the().load_sync(
         page_to_load,
-        [&](auto data, auto&) {
+        [&](auto data, auto&, auto) {
             // Create a new parser and immediately get its document to replace the old interpreter.
             auto document = Web::DOM::Document::create();
             Web::HTML::HTMLDocumentParser parser(document, data, "utf-8");